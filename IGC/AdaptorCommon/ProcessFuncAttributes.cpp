@@ -830,6 +830,100 @@ inline void checkKernelSimdSize(Function* F, FunctionInfoMetaDataHandle funcInfo
     }
 }
 
+// Turn stack-call functions called from multiple kernels into external
+// functions, so that they are attached to the default kernel and compiled once
+// per program. Kernels call them through relocations, as with any other
+// externally linked function, instead of cloning them into their own function
+// groups. Return true if any function is turned.
+//
+// As all external functions are compiled in the default kernel, only
+// functions whose callers are kernels with the same required SIMD size are
+// turned. Kernels that do not require a SIMD size form a class of their own:
+// the default kernel is then left without one too, and codegen picks it as it
+// does for function pointers taken in such kernels. Functions with implicit
+// arguments are skipped as external functions cannot receive them.
+static bool shareStackCallFuncs(Module& M, MetaDataUtils* pMdUtils)
+{
+    auto getSimdSize = [pMdUtils](Function* F)->int
+    {
+        return pMdUtils->getFunctionsInfoItem(F)->getSubGroupSize()->getSIMD_size();
+    };
+
+    // SIMD size required by the kernels using existing external functions,
+    // 0 if they do not require one and -1 if there are no such kernels.
+    int programSimdSize = -1;
+    for (auto& F : M)
+    {
+        if (F.isDeclaration() || !F.hasFnAttribute("referenced-indirectly"))
+            continue;
+        for (auto U : F.users())
+        {
+            if (Instruction* I = dyn_cast<Instruction>(U))
+            {
+                Function* caller = I->getParent()->getParent();
+                if (!isEntryFunc(pMdUtils, caller))
+                    continue;
+                int sz = getSimdSize(caller);
+                if (programSimdSize != -1 && programSimdSize != sz)
+                    return false;
+                programSimdSize = sz;
+            }
+        }
+    }
+
+    bool changed = false;
+    for (auto& F : M)
+    {
+        if (F.isDeclaration() || isEntryFunc(pMdUtils, &F) ||
+            F.hasFnAttribute("referenced-indirectly") ||
+            !F.hasFnAttribute("visaStackCall") ||
+            !F.hasFnAttribute(llvm::Attribute::NoInline))
+            continue;
+
+        auto funcInfo = pMdUtils->findFunctionsInfoItem(&F);
+        if (funcInfo != pMdUtils->end_FunctionsInfo() &&
+            !funcInfo->second->empty_ImplicitArgInfoList())
+            continue;
+
+        // All users must be direct calls from kernels with the same SIMD size.
+        SmallPtrSet<Function*, 4> callers;
+        int simdSize = -1;
+        bool canShare = true;
+        for (auto U : F.users())
+        {
+            CallInst* CI = dyn_cast<CallInst>(U);
+            if (!CI || IGCLLVM::getCalledValue(CI) != &F)
+            {
+                canShare = false;
+                break;
+            }
+            Function* caller = CI->getParent()->getParent();
+            if (!isEntryFunc(pMdUtils, caller))
+            {
+                canShare = false;
+                break;
+            }
+            int sz = getSimdSize(caller);
+            if (simdSize != -1 && simdSize != sz)
+            {
+                canShare = false;
+                break;
+            }
+            simdSize = sz;
+            callers.insert(caller);
+        }
+        if (!canShare || callers.size() < 2 ||
+            (programSimdSize != -1 && programSimdSize != simdSize))
+            continue;
+
+        programSimdSize = simdSize;
+        F.addFnAttr("referenced-indirectly");
+        F.setLinkage(GlobalValue::ExternalLinkage);
+        changed = true;
+    }
+    return changed;
+}
+
 bool InsertDummyKernelForSymbolTable::runOnModule(Module& M)
 {
     MetaDataUtilsWrapper& mduw = getAnalysis<MetaDataUtilsWrapper>();
@@ -845,6 +939,12 @@ bool InsertDummyKernelForSymbolTable::runOnModule(Module& M)
     if (IGC_IS_FLAG_ENABLED(EnableFunctionPointer) &&
         pCtx->type == ShaderType::OPENCL_SHADER)
     {
+        if (IGC_IS_FLAG_ENABLED(EnableSharedStackCallFuncs) &&
+            shareStackCallFuncs(M, pMdUtils))
+        {
+            pCtx->m_enableFunctionPointer = true;
+        }
+
         if (pCtx->m_enableFunctionPointer)
         {
             // Symbols are needed for external functions and function pointers
@@ -0,0 +1,398 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (c) 2000-2021 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom
+the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+
+============================= end_copyright_notice ===========================*/
+
+
+#include "AdaptorOCL/KernelCache.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include "common/LLVMWarningsPop.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+using namespace llvm;
+
+namespace TC
+{
+
+namespace
+{
+    const char cEntryMagic[8] = { 'I', 'G', 'C', 'K', 'C', 'A', 'C', '1' };
+    const char* const cEntryExtension = ".igccache";
+
+    struct EntryHeader
+    {
+        char     magic[8];
+        uint8_t  key[20];
+        uint32_t outputSize;
+        uint32_t debugDataSize;
+        uint32_t errorStringSize;
+    };
+
+    // Stores between two scans of the cache directory while the tracked size
+    // stays below the limit; the scan picks up entries of other processes.
+    const unsigned cStoresPerEvictionScan = 64;
+
+    // Serializes evictions within the process; other processes may race with us,
+    // which only results in redundant deletes.
+    std::mutex s_evictionMutex;
+
+    // Path of the binary (library or executable) the compiler was loaded from.
+    std::string getCompilerImagePath()
+    {
+        void* pAnchor = reinterpret_cast<void*>(&getCompilerImagePath);
+#if defined(_WIN32)
+        HMODULE hMod = NULL;
+        if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+                GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                static_cast<LPCSTR>(pAnchor),
+                &hMod))
+        {
+            return "";
+        }
+        char path[MAX_PATH];
+        DWORD size = GetModuleFileNameA(hMod, path, MAX_PATH);
+        if (size == 0 || size == MAX_PATH)
+        {
+            return "";
+        }
+        return std::string(path, size);
+#else
+        Dl_info info;
+        if (dladdr(pAnchor, &info) == 0 || info.dli_fname == nullptr)
+        {
+            return "";
+        }
+        return info.dli_fname;
+#endif
+    }
+
+    // Identifies the compiler build that produces the entries. Release builds
+    // carry TB_BUILD_ID; otherwise the size and modification time of the loaded
+    // compiler image stand in for it, so any rebuild invalidates the entries
+    // without reading the image. Empty if neither is available.
+    const std::string& getCompilerBuildId()
+    {
+        static const std::string s_buildId = []() -> std::string
+        {
+#ifdef TB_BUILD_ID
+            return "build-" + std::to_string(TB_BUILD_ID);
+#else
+            std::string path = getCompilerImagePath();
+            sys::fs::file_status status;
+            if (path.empty() || sys::fs::status(path, status))
+            {
+                return "";
+            }
+            return "image-" + std::to_string(status.getSize()) + "-" +
+                std::to_string(sys::toTimeT(status.getLastModificationTime()));
+#endif
+        }();
+        return s_buildId;
+    }
+}
+
+void KernelCacheKey::add(const void* pData, size_t size)
+{
+    uint64_t size64 = size;
+    m_hasher.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(&size64), sizeof(size64)));
+    if (size > 0)
+    {
+        m_hasher.update(ArrayRef<uint8_t>(static_cast<const uint8_t*>(pData), size));
+    }
+}
+
+void KernelCacheKey::addInputArgs(const STB_TranslateInputArgs& args)
+{
+    add(args.pInput, args.InputSize);
+    add(args.pOptions, args.pOptions ? args.OptionsSize : 0);
+    add(args.pInternalOptions, args.pInternalOptions ? args.InternalOptionsSize : 0);
+    add(args.pSpecConstantsIds, args.pSpecConstantsIds ? args.SpecConstantsSize * sizeof(uint32_t) : 0);
+    add(args.pSpecConstantsValues, args.pSpecConstantsValues ? args.SpecConstantsSize * sizeof(uint64_t) : 0);
+
+    // Regkeys change the generated code, so the non-default ones are part of the key.
+    std::string explicitKeys;
+    GetKeysSetExplicitly(&explicitKeys, nullptr);
+    add(explicitKeys);
+    add(StringRef(IGC_GET_REGKEYSTRING(VISAOptions)));
+    add(StringRef(IGC_GET_REGKEYSTRING(LLVMCommandLine)));
+
+    // The translation block version only changes with the interface, not with
+    // the compiler build.
+    add(getCompilerBuildId());
+}
+
+std::string KernelCacheKey::finalize()
+{
+    return toHex(m_hasher.final(), /*LowerCase=*/true);
+}
+
+KernelCache* KernelCache::get()
+{
+    if (IGC_IS_FLAG_DISABLED(EnableOCLKernelCache))
+    {
+        return nullptr;
+    }
+
+    // The configuration is read once; the cache lives until the process exits.
+    static KernelCache* s_cache = []() -> KernelCache*
+    {
+        // Entries could not be told apart from those of another compiler build.
+        if (getCompilerBuildId().empty())
+        {
+            return nullptr;
+        }
+        SmallString<256> dir(IGC_GET_REGKEYSTRING(OCLKernelCacheDir));
+        if (dir.empty())
+        {
+            if (!sys::path::cache_directory(dir))
+            {
+                sys::path::system_temp_directory(/*ErasedOnReboot=*/false, dir);
+            }
+            sys::path::append(dir, "igc_kernel_cache");
+        }
+        if (sys::fs::create_directories(dir))
+        {
+            return nullptr;
+        }
+        uint64_t maxSize = uint64_t(IGC_GET_FLAG_VALUE(OCLKernelCacheMaxSizeMB)) << 20;
+        return new KernelCache(dir.str().str(), maxSize);
+    }();
+    return s_cache;
+}
+
+bool KernelCache::isCacheable(const STB_TranslateInputArgs& args)
+{
+    // GTPin and tracing requests instrument the binary based on data we do not hash,
+    // and statistics, dumps and overrides are side effects a cached result would skip.
+    return args.GTPinInput == nullptr &&
+        args.pTracingOptions == nullptr &&
+        !args.CompileTimeStatisticsEnable &&
+        IGC_IS_FLAG_DISABLED(ShaderDumpEnable) &&
+        IGC_IS_FLAG_DISABLED(ShaderOverride);
+}
+
+KernelCache::KernelCache(const std::string& dir, uint64_t maxSize) :
+    m_dir(dir), m_maxSize(maxSize), m_sizeEstimate(0), m_storeCount(0)
+{
+}
+
+std::string KernelCache::entryPath(const std::string& key) const
+{
+    SmallString<256> path(m_dir);
+    sys::path::append(path, key + cEntryExtension);
+    return path.str().str();
+}
+
+bool KernelCache::load(const std::string& key, STB_TranslateOutputArgs& outputArgs)
+{
+    const std::string path = entryPath(key);
+    auto bufOrErr = MemoryBuffer::getFile(path, /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+    if (!bufOrErr)
+    {
+        return false;
+    }
+
+    const MemoryBuffer& buf = **bufOrErr;
+    EntryHeader header;
+    if (buf.getBufferSize() < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, buf.getBufferStart(), sizeof(header));
+
+    const std::string rawKey = fromHex(key);
+    const uint64_t payloadSize = uint64_t(header.outputSize) + header.debugDataSize + header.errorStringSize;
+    if (memcmp(header.magic, cEntryMagic, sizeof(cEntryMagic)) != 0 ||
+        rawKey.size() != sizeof(header.key) ||
+        memcmp(header.key, rawKey.data(), sizeof(header.key)) != 0 ||
+        header.outputSize == 0 ||
+        buf.getBufferSize() != sizeof(header) + payloadSize)
+    {
+        // Corrupt or colliding entry; it is overwritten by the next store.
+        return false;
+    }
+
+    const char* pData = buf.getBufferStart() + sizeof(header);
+    auto copyOut = [&pData](uint32_t size, char*& pDst, uint32_t& dstSize)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        pDst = new char[size];
+        memcpy(pDst, pData, size);
+        dstSize = size;
+        pData += size;
+    };
+    copyOut(header.outputSize, outputArgs.pOutput, outputArgs.OutputSize);
+    copyOut(header.debugDataSize, outputArgs.pDebugData, outputArgs.DebugDataSize);
+    copyOut(header.errorStringSize, outputArgs.pErrorString, outputArgs.ErrorStringSize);
+
+    // Refresh the modification time, which the eviction uses as the LRU stamp.
+    int fd;
+    if (!sys::fs::openFileForWrite(path, fd, sys::fs::CD_OpenExisting, sys::fs::OF_Append))
+    {
+        auto now = std::chrono::system_clock::now();
+        sys::fs::setLastAccessAndModificationTime(fd, now, now);
+        sys::Process::SafelyCloseFileDescriptor(fd);
+    }
+
+    return true;
+}
+
+void KernelCache::store(const std::string& key, const STB_TranslateOutputArgs& outputArgs)
+{
+    const std::string rawKey = fromHex(key);
+    if (outputArgs.pOutput == nullptr || outputArgs.OutputSize == 0 ||
+        rawKey.size() != sizeof(EntryHeader::key))
+    {
+        return;
+    }
+
+    EntryHeader header;
+    memcpy(header.magic, cEntryMagic, sizeof(cEntryMagic));
+    memcpy(header.key, rawKey.data(), sizeof(header.key));
+    header.outputSize = outputArgs.OutputSize;
+    header.debugDataSize = outputArgs.pDebugData ? outputArgs.DebugDataSize : 0;
+    header.errorStringSize = outputArgs.pErrorString ? outputArgs.ErrorStringSize : 0;
+
+    SmallString<256> tmpModel(m_dir);
+    sys::path::append(tmpModel, key + "-%%%%%%%%.tmp");
+    SmallString<256> tmpPath;
+    int fd;
+    if (sys::fs::createUniqueFile(tmpModel, fd, tmpPath))
+    {
+        return;
+    }
+
+    bool writeFailed;
+    {
+        raw_fd_ostream os(fd, /*shouldClose=*/true);
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(outputArgs.pOutput, header.outputSize);
+        os.write(outputArgs.pDebugData, header.debugDataSize);
+        os.write(outputArgs.pErrorString, header.errorStringSize);
+        os.close();
+        writeFailed = os.has_error();
+        os.clear_error();
+    }
+
+    // rename() replaces the destination atomically, so readers see either the
+    // previous entry or the complete new one.
+    if (writeFailed || sys::fs::rename(tmpPath, entryPath(key)))
+    {
+        sys::fs::remove(tmpPath);
+        return;
+    }
+
+    if (m_maxSize != 0)
+    {
+        // Only this process' stores are tracked, so the estimate is synchronized
+        // with the directory on the first store and periodically after that.
+        const uint64_t entrySize = sizeof(header) + uint64_t(header.outputSize) +
+            header.debugDataSize + header.errorStringSize;
+        const uint64_t sizeEstimate = m_sizeEstimate.fetch_add(entrySize) + entrySize;
+        if (sizeEstimate > m_maxSize ||
+            m_storeCount.fetch_add(1) % cStoresPerEvictionScan == 0)
+        {
+            evict();
+        }
+    }
+}
+
+void KernelCache::evict()
+{
+    std::lock_guard<std::mutex> lock(s_evictionMutex);
+
+    struct Entry
+    {
+        std::string path;
+        uint64_t size;
+        sys::TimePoint<> lastUse;
+    };
+    std::vector<Entry> entries;
+    uint64_t totalSize = 0;
+
+    std::error_code ec;
+    for (sys::fs::directory_iterator it(m_dir, ec), end; it != end && !ec; it.increment(ec))
+    {
+        if (sys::path::extension(it->path()) != cEntryExtension)
+        {
+            continue;
+        }
+        sys::fs::file_status status;
+        if (sys::fs::status(it->path(), status))
+        {
+            continue;
+        }
+        entries.push_back({ it->path(), status.getSize(), status.getLastModificationTime() });
+        totalSize += status.getSize();
+    }
+
+    if (totalSize <= m_maxSize)
+    {
+        m_sizeEstimate = totalSize;
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+    {
+        return a.lastUse < b.lastUse;
+    });
+    for (const Entry& entry : entries)
+    {
+        if (totalSize <= m_maxSize)
+        {
+            break;
+        }
+        if (!sys::fs::remove(entry.path))
+        {
+            totalSize -= entry.size;
+        }
+    }
+    m_sizeEstimate = totalSize;
+}
+
+} // namespace TC
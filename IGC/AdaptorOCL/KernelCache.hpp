@@ -0,0 +1,98 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (c) 2000-2021 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom
+the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+
+============================= end_copyright_notice ===========================*/
+
+
+#pragma once
+
+#include "AdaptorOCL/TranslationBlock.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/SHA1.h"
+#include "common/LLVMWarningsPop.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace TC
+{
+    /// Builds the key of a KernelCache entry. Every field is hashed together with
+    /// its length so that adjacent fields cannot alias each other.
+    class KernelCacheKey
+    {
+    public:
+        void add(const void* pData, size_t size);
+        void add(llvm::StringRef str) { add(str.data(), str.size()); }
+
+        template <typename T>
+        void addPOD(const T& value) { add(&value, sizeof(T)); }
+
+        /// Hashes the fields of STB_TranslateInputArgs that affect the output.
+        void addInputArgs(const STB_TranslateInputArgs& args);
+
+        /// Returns the key as a hexadecimal string; the builder must not be used afterwards.
+        std::string finalize();
+
+    private:
+        llvm::SHA1 m_hasher;
+    };
+
+    /// Persistent on-disk cache of program binaries produced by TranslateBuild.
+    ///
+    /// Each entry is a single file named after its key. Entries are written to a
+    /// temporary file and renamed into place, so concurrent processes never observe
+    /// a partially written entry. The cache is bounded by size; the least recently
+    /// used entries (by modification time, which is refreshed on every hit) are
+    /// evicted once the stores are estimated to push it over the limit.
+    class KernelCache
+    {
+    public:
+        /// Returns the cache configured through the regkeys, or nullptr if caching
+        /// is disabled or the cache directory cannot be created.
+        static KernelCache* get();
+
+        /// Returns false for requests whose output depends on state that is not
+        /// part of the key (instrumentation, dumps, overrides).
+        static bool isCacheable(const STB_TranslateInputArgs& args);
+
+        /// On a hit, allocates the output, debug data and message buffers with
+        /// new[] exactly like TranslateBuild does and returns true.
+        bool load(const std::string& key, STB_TranslateOutputArgs& outputArgs);
+
+        /// Stores a successful translation. Failures are silently ignored.
+        void store(const std::string& key, const STB_TranslateOutputArgs& outputArgs);
+
+    private:
+        KernelCache(const std::string& dir, uint64_t maxSize);
+
+        std::string entryPath(const std::string& key) const;
+        void evict();
+
+        std::string m_dir;
+        uint64_t m_maxSize;
+        std::atomic<uint64_t> m_sizeEstimate;  //!< Size of the directory as of the last scan plus later stores
+        std::atomic<unsigned> m_storeCount;
+    };
+} // namespace TC
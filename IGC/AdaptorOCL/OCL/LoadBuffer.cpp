@@ -64,8 +64,9 @@ MemoryBuffer *llvm::LoadBufferFromResource(const char *pResName,
         return NULL;
     }
 
-    // Create a copy of the buffer for the caller. This copy is managed
-    return MemoryBuffer::getMemBufferCopy(StringRef((char *)symbol, size)).release();
+    // The symbol lives in the mapped image of this library for the whole process
+    // lifetime, so hand out a view of it instead of copying several MB per call.
+    return MemoryBuffer::getMemBuffer(StringRef((char *)symbol, size), "", false).release();
 }
 
 #endif
@@ -341,15 +341,36 @@ void dumpOCLCos(const IGC::CShader *Kernel, const std::string &stateDebugMsg) {
 void CGen8OpenCLProgram::GetZEBinary(
     llvm::raw_pwrite_stream& programBinary, unsigned pointerSizeInBytes,
     const char* spv, uint32_t spvSize)
+{
+    ZEBinaryBuilder zebuilder(m_Platform, pointerSizeInBytes == 8,
+        m_Context.m_programInfo, (const uint8_t*)spv, spvSize);
+    AddKernelsToZEBinary(zebuilder);
+    zebuilder.getBinaryObject(programBinary);
+}
+
+void CGen8OpenCLProgram::GetZEBinary(
+    char*& programBinary, size_t& programBinarySize, unsigned pointerSizeInBytes,
+    const char* spv, uint32_t spvSize)
+{
+    ZEBinaryBuilder zebuilder(m_Platform, pointerSizeInBytes == 8,
+        m_Context.m_programInfo, (const uint8_t*)spv, spvSize);
+    AddKernelsToZEBinary(zebuilder);
+
+    // The layout is computed first so that the binary is written straight
+    // into its final buffer
+    programBinarySize = static_cast<size_t>(zebuilder.getBinaryObjectSize());
+    programBinary = new char[programBinarySize];
+    uint64_t written = zebuilder.getBinaryObject((uint8_t*)programBinary, programBinarySize);
+    IGC_ASSERT(written == programBinarySize);
+}
+
+void CGen8OpenCLProgram::AddKernelsToZEBinary(ZEBinaryBuilder& zebuilder)
 {
     auto isValidShader = [&](IGC::COpenCLKernel* shader)->bool
     {
         return (shader && shader->ProgramOutput()->m_programSize > 0);
     };
 
-    ZEBinaryBuilder zebuilder(m_Platform, pointerSizeInBytes == 8,
-        m_Context.m_programInfo, (const uint8_t*)spv, spvSize);
-
     for (auto pKernel : m_ShaderProgramList)
     {
         IGC::COpenCLKernel* simd8Shader = static_cast<IGC::COpenCLKernel*>(pKernel->GetShader(SIMDMode::SIMD8));
@@ -403,8 +424,6 @@ void CGen8OpenCLProgram::GetZEBinary(
             }
         }
     }
-
-    zebuilder.getBinaryObject(programBinary);
 }
 
 void CGen8OpenCLProgram::CreateKernelBinaries()
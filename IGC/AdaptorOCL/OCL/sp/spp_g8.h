@@ -107,10 +107,17 @@ public:
     void GetZEBinary(llvm::raw_pwrite_stream& programBinary, unsigned pointerSizeInBytes,
         const char* spv, uint32_t spvSize);
 
+    /// GetZEBinary - create ZE Binary into a buffer allocated with new[] of
+    /// exactly the binary's size. The caller owns the returned buffer
+    void GetZEBinary(char*& programBinary, size_t& programBinarySize,
+        unsigned pointerSizeInBytes, const char* spv, uint32_t spvSize);
+
     // Used to track the kernel info from CodeGen
     std::vector<IGC::CShaderProgram*> m_ShaderProgramList;
 
 private:
+    /// AddKernelsToZEBinary - add the kernels of this program into zebuilder
+    void AddKernelsToZEBinary(ZEBinaryBuilder& zebuilder);
 
     class CLProgramCtxProvider : public CGen8OpenCLStateProcessor::IProgramContext {
     public:
@@ -729,24 +729,45 @@ void ZEBinaryBuilder::addElfSections(void* elfBin, size_t debugDataSize)
     }
 }
 
+void ZEBinaryBuilder::addZEInfoSection()
+{
+    if (!mZEInfoAdded)
+    {
+        mBuilder.addSectionZEInfo(mZEInfoBuilder.getZEInfoContainer());
+        mZEInfoAdded = true;
+    }
+}
+
+uint64_t ZEBinaryBuilder::getBinaryObjectSize()
+{
+    addZEInfoSection();
+    return mBuilder.getBinarySize();
+}
+
 void ZEBinaryBuilder::getBinaryObject(llvm::raw_pwrite_stream& os)
 {
-    mBuilder.addSectionZEInfo(mZEInfoBuilder.getZEInfoContainer());
+    addZEInfoSection();
     mBuilder.finalize(os);
 }
 
+uint64_t ZEBinaryBuilder::getBinaryObject(uint8_t* buffer, uint64_t bufferSize)
+{
+    addZEInfoSection();
+    return mBuilder.finalize(buffer, bufferSize);
+}
+
 void ZEBinaryBuilder::getBinaryObject(Util::BinaryStream& outputStream)
 {
-    llvm::SmallVector<char, 64> buf;
-    llvm::raw_svector_ostream llvm_os(buf);
-    getBinaryObject(llvm_os);
-    outputStream.Write(buf.data(), buf.size());
+    std::vector<uint8_t> buf(getBinaryObjectSize());
+    getBinaryObject(buf.data(), buf.size());
+    outputStream.Write((const char*)buf.data(), buf.size());
 }
 
 void ZEBinaryBuilder::printBinaryObject(const std::string& filename)
 {
     std::error_code EC;
     llvm::raw_fd_ostream os(filename, EC);
+    addZEInfoSection();
     mBuilder.finalize(os);
     os.close();
 }
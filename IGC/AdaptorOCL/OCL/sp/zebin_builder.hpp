@@ -80,9 +80,18 @@ public:
     /// addElfSections - copy every section of ELF file (a buffer in memory) to zeBinary
     void addElfSections(void* elfBin, size_t debugDataSize);
 
+    /// getBinaryObjectSize - get the exact size in bytes of the final ze object
+    /// No kernel may be added afterwards
+    uint64_t getBinaryObjectSize();
+
     /// getBinaryObject - get the final ze object
     void getBinaryObject(llvm::raw_pwrite_stream& os);
 
+    /// getBinaryObject - write the final ze object into the given buffer, which
+    /// must hold at least getBinaryObjectSize() bytes
+    /// return number of written bytes
+    uint64_t getBinaryObject(uint8_t* buffer, uint64_t bufferSize);
+
     // getBinaryObject - write the final object into given Util::BinaryStream
     // Avoid using this function, which has extra buffer copy
     void getBinaryObject(Util::BinaryStream& outputStream);
@@ -108,6 +117,9 @@ private:
     /// add spir-v section
     void addSPIRV(const uint8_t* data, uint32_t size);
 
+    /// add the .ze_info section built by mZEInfoBuilder, once all kernels are added
+    void addZEInfoSection();
+
     /// ------------ kernel scope helper functions ------------
     /// add gen binary
     zebin::ZEELFObjectBuilder::SectionID addKernelBinary(
@@ -180,6 +192,7 @@ private:
     // mZEInfoBuilder - Builder and holder of a zeInfoContainer, which will
     // be added into ZEELFObjectBuilder as .ze_info section
     zebin::ZEInfoBuilder mZEInfoBuilder;
+    bool mZEInfoAdded = false;
 
     const PLATFORM mPlatform;
     G6HWC::SMediaHardwareCapabilities mHWCaps;
@@ -178,7 +178,8 @@ namespace IGC
 static void CommonOCLBasedPasses(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFSymbolIndex* pBiFSymbolIndex)
 {
 #if defined( _DEBUG )
     llvm::verifyModule(*pContext->getModule());
@@ -346,7 +347,7 @@ static void CommonOCLBasedPasses(
 
     mpm.add(new PreBIImportAnalysis());
     mpm.add(createTimeStatsCounterPass(pContext, TIME_Unify_BuiltinImport, STATS_COUNTER_START));
-    mpm.add(createBuiltInImportPass(std::move(BuiltinGenericModule), std::move(BuiltinSizeModule)));
+    mpm.add(createBuiltInImportPass(std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), pBiFSymbolIndex));
     mpm.add(createTimeStatsCounterPass(pContext, TIME_Unify_BuiltinImport, STATS_COUNTER_END));
     mpm.add(new UndefinedReferencesPass());
 
@@ -556,17 +557,19 @@ static void CommonOCLBasedPasses(
 void UnifyIROCL(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFSymbolIndex* pBiFSymbolIndex)
 {
-    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), pBiFSymbolIndex);
 }
 
 void UnifyIRSPIR(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFSymbolIndex* pBiFSymbolIndex)
 {
-    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), pBiFSymbolIndex);
 }
 
 }
@@ -27,13 +27,17 @@ IN THE SOFTWARE.
 
 namespace IGC
 {
+    class BiFSymbolIndex;
+
     void UnifyIROCL(
         OpenCLProgramContext* pContext,
         std::unique_ptr<llvm::Module> BuiltinGenericModule,
-        std::unique_ptr<llvm::Module> BuiltinSizeModule);
+        std::unique_ptr<llvm::Module> BuiltinSizeModule,
+        const BiFSymbolIndex* pBiFSymbolIndex = nullptr);
 
     void UnifyIRSPIR(
         OpenCLProgramContext* pContext,
         std::unique_ptr<llvm::Module> BuiltinGenericModule,
-        std::unique_ptr<llvm::Module> BuiltinSizeModule);
+        std::unique_ptr<llvm::Module> BuiltinSizeModule,
+        const BiFSymbolIndex* pBiFSymbolIndex = nullptr);
 }
\ No newline at end of file
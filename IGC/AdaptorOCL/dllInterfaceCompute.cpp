@@ -33,6 +33,7 @@ IN THE SOFTWARE.
 #include <string>
 #include <stdexcept>
 #include <fstream>
+#include <map>
 #include <mutex>
 
 #include "AdaptorCommon/customApi.hpp"
@@ -42,8 +43,11 @@ IN THE SOFTWARE.
 
 #include "AdaptorOCL/UnifyIROCL.hpp"
 #include "AdaptorOCL/DriverInfoOCL.hpp"
+#include "AdaptorOCL/KernelCache.hpp"
 
 #include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
+#include "Compiler/Optimizer/BuiltInFuncImport.h"
+#include "common/debug/AsyncDump.hpp"
 #include "common/debug/Dump.hpp"
 #include "common/debug/Debug.hpp"
 #include "common/igc_regkeys.hpp"
@@ -192,7 +196,9 @@ CIGCTranslationBlock::CIGCTranslationBlock()
 
 CIGCTranslationBlock::~CIGCTranslationBlock()
 {
-
+    // Writes the LLVM IR dumps still queued and joins the writer thread, which
+    // must not be left to static destruction.
+    IGC::Debug::ShutdownAsyncDump();
 }
 
 static void SetOutputMessage(const std::string& OutputMessage, STB_TranslateOutputArgs& pOutputArgs)
@@ -289,7 +295,63 @@ bool CIGCTranslationBlock::Translate(
         (m_DataFormatInput == TB_DATA_FORMAT_SPIR_V) ||
         (m_DataFormatInput == TB_DATA_FORMAT_LLVM_BINARY))
     {
-        return TC::TranslateBuild(&InputArgsCopy, pOutputArgs, m_DataFormatInput, IGCPlatform, m_ProfilingTimerResolution);
+        TC::KernelCache* pCache = TC::KernelCache::isCacheable(InputArgsCopy) ? TC::KernelCache::get() : nullptr;
+        std::string cacheKey;
+        // Lookups and stores are reported as their own row of the per-shader time
+        // stats; on a miss it is preceded by the row of the compilation itself.
+        std::unique_ptr<TimeStats> cacheTimeStats;
+        auto printCacheTimeStats = [&]()
+        {
+            if (IGC::Debug::GetDebugFlag(IGC::Debug::DebugFlag::TIME_STATS_PER_SHADER))
+            {
+                cacheTimeStats->printTime(ShaderType::OPENCL_SHADER,
+                    ShaderHashOCL(reinterpret_cast<const UINT*>(InputArgsCopy.pInput), InputArgsCopy.InputSize / 4));
+            }
+        };
+        if (pCache)
+        {
+            cacheTimeStats.reset(new TimeStats());
+            cacheTimeStats->recordTimerStart(TIME_TOTAL);
+            // The outcome is only known afterwards, so both intervals are started
+            // and only the matching one is ended.
+            cacheTimeStats->recordTimerStart(TIME_OCL_KernelCacheHit);
+            cacheTimeStats->recordTimerStart(TIME_OCL_KernelCacheMiss);
+
+            TC::KernelCacheKey key;
+            key.addInputArgs(InputArgsCopy);
+            key.addPOD(m_Platform);
+            key.addPOD(m_SkuTable);
+            key.addPOD(m_SysInfo);
+            key.addPOD(m_DataFormatInput);
+            key.addPOD(m_DataFormatOutput);
+            key.addPOD(m_ProfilingTimerResolution);
+            key.addPOD(GetVersion());
+            cacheKey = key.finalize();
+
+            const bool hit = pCache->load(cacheKey, *pOutputArgs);
+            cacheTimeStats->recordTimerEnd(hit ? TIME_OCL_KernelCacheHit : TIME_OCL_KernelCacheMiss);
+            cacheTimeStats->recordTimerEnd(TIME_TOTAL);
+            if (hit)
+            {
+                printCacheTimeStats();
+                return true;
+            }
+        }
+
+        bool success = TC::TranslateBuild(&InputArgsCopy, pOutputArgs, m_DataFormatInput, IGCPlatform, m_ProfilingTimerResolution);
+        if (pCache)
+        {
+            if (success)
+            {
+                cacheTimeStats->recordTimerStart(TIME_TOTAL);
+                cacheTimeStats->recordTimerStart(TIME_OCL_KernelCacheStore);
+                pCache->store(cacheKey, *pOutputArgs);
+                cacheTimeStats->recordTimerEnd(TIME_OCL_KernelCacheStore);
+                cacheTimeStats->recordTimerEnd(TIME_TOTAL);
+            }
+            printCacheTimeStats();
+        }
+        return success;
     }
     else
     {
@@ -840,6 +902,34 @@ static std::unique_ptr<llvm::MemoryBuffer> GetGenericModuleBuffer() {
     return std::unique_ptr<llvm::MemoryBuffer>{llvm::LoadBufferFromResource(Resource, "BC")};
 }
 
+// Returns the call graph index of the builtin modules held in the given buffers.
+// The buffers are views of this library's image, so their addresses identify the
+// bitcode for the whole process and each index is built by the first compilation only.
+static const IGC::BiFSymbolIndex* GetBiFSymbolIndex(
+    llvm::MemoryBufferRef genericBuffer, llvm::MemoryBufferRef sizeBuffer)
+{
+    static std::mutex indexMutex;
+    static std::map<std::pair<const char*, const char*>, std::unique_ptr<IGC::BiFSymbolIndex>> indices;
+
+    std::lock_guard<std::mutex> lock(indexMutex);
+    std::unique_ptr<IGC::BiFSymbolIndex>& pIndex =
+        indices[std::make_pair(genericBuffer.getBufferStart(), sizeBuffer.getBufferStart())];
+    if (!pIndex)
+    {
+        llvm::LLVMContext context;
+        llvm::Expected<std::unique_ptr<llvm::Module>> genericOrErr = llvm::parseBitcodeFile(genericBuffer, context);
+        llvm::Expected<std::unique_ptr<llvm::Module>> sizeOrErr = llvm::parseBitcodeFile(sizeBuffer, context);
+        if (!genericOrErr || !sizeOrErr)
+        {
+            llvm::consumeError(genericOrErr.takeError());
+            llvm::consumeError(sizeOrErr.takeError());
+            return nullptr;
+        }
+        pIndex.reset(new IGC::BiFSymbolIndex(**genericOrErr, sizeOrErr->get()));
+    }
+    return pIndex.get();
+}
+
 static void WriteSpecConstantsDump(const STB_TranslateInputArgs *pInputArgs,
                                    QWORD hash) {
     const char *pOutputFolder = IGC::Debug::GetShaderOutputFolder();
@@ -851,6 +941,62 @@ static void WriteSpecConstantsDump(const STB_TranslateInputArgs *pInputArgs,
                    hash, "_specconst.txt");
 }
 
+// Unified module (kernel module linked with the builtins) taken after UnifyIR,
+// together with the context state UnifyIR derives from it, which
+// CodeGenContext::clear() resets between retries.
+struct RetryCheckpoint
+{
+    std::string bitcode;
+    bool enableFunctionPointer = false;
+    bool enableSubroutine = false;
+
+    bool empty() const { return bitcode.empty(); }
+};
+
+// Serializes the unified module together with its metadata so that retry
+// compilations can start from it instead of re-parsing the input, reloading
+// the BiF modules and re-running UnifyIR.
+// Nothing before OptimizeIR depends on the retry state, so the snapshot is
+// valid for every retry.
+static void SaveRetryCheckpoint(OpenCLProgramContext &oclContext, RetryCheckpoint &checkpoint)
+{
+    oclContext.getMetaDataUtils()->save(*oclContext.getLLVMContext());
+    serialize(*oclContext.getModuleMetaData(), oclContext.getModule());
+
+    checkpoint.bitcode.clear();
+    llvm::raw_string_ostream OStream(checkpoint.bitcode);
+    IGCLLVM::WriteBitcodeToFile(oclContext.getModule(), OStream);
+    OStream.flush();
+
+    checkpoint.enableFunctionPointer = oclContext.m_enableFunctionPointer;
+    checkpoint.enableSubroutine = oclContext.m_enableSubroutine;
+}
+
+// Recreates the module from a checkpoint taken by SaveRetryCheckpoint in the
+// (fresh) LLVMContext of oclContext and restores the module metadata and the
+// UnifyIR context state.
+static bool RestoreRetryCheckpoint(OpenCLProgramContext &oclContext, const RetryCheckpoint &checkpoint)
+{
+    std::unique_ptr<llvm::MemoryBuffer> pBuffer =
+        llvm::MemoryBuffer::getMemBuffer(checkpoint.bitcode, "", false);
+
+    llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
+        llvm::parseBitcodeFile(pBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
+    if (llvm::Error EC = ModuleOrErr.takeError())
+    {
+        llvm::consumeError(std::move(EC));
+        return false;
+    }
+
+    llvm::Module *pModule = ModuleOrErr->release();
+    oclContext.setModule(pModule);
+    deserialize(*oclContext.getModuleMetaData(), pModule);
+
+    oclContext.m_enableFunctionPointer = checkpoint.enableFunctionPointer;
+    oclContext.m_enableSubroutine = checkpoint.enableSubroutine;
+    return true;
+}
+
 bool TranslateBuild(
     const STB_TranslateInputArgs* pInputArgs,
     STB_TranslateOutputArgs* pOutputArgs,
@@ -1023,6 +1169,16 @@ bool TranslateBuild(
     }
 
     oclContext.hash = inputShHash;
+
+    // Written when it goes out of scope, so failed builds are traced as well.
+    std::unique_ptr<CompileTrace> compileTrace;
+    if (IGC_IS_FLAG_ENABLED(DumpCompileTrace))
+    {
+        compileTrace.reset(new CompileTrace(CompileTrace::getFileName(inputShHash.getAsmHash())));
+        oclContext.m_compileTrace = compileTrace.get();
+    }
+    CompileTraceScope programSpan(oclContext.m_compileTrace, "Program", "program");
+
     oclContext.annotater = nullptr;
 
     // Set default denorm.
@@ -1040,124 +1196,148 @@ bool TranslateBuild(
     /// set retry manager
     bool retry = false;
     oclContext.m_retryManager.Enable();
+
+    // Snapshot of the unified module used to restart retry compilations.
+    RetryCheckpoint retryCheckpoint;
+    const bool useRetryCheckpoint = IGC_IS_FLAG_ENABLED(EnableOCLRetryCheckpoint);
     do
     {
-        std::unique_ptr<llvm::Module> BuiltinGenericModule = nullptr;
-        std::unique_ptr<llvm::Module> BuiltinSizeModule = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pGenericBuffer = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pSizeTBuffer = nullptr;
+        CompileTraceScope retrySpan(oclContext.m_compileTrace, "Retry", "retry",
+            oclContext.m_compileTrace ? llvm::json::Object{ { "retry_id", oclContext.m_retryManager.GetRetryId() } }
+                                      : llvm::json::Object());
+
+        if (retryCheckpoint.empty())
         {
-            // IGC has two BIF Modules:
-            //            1. kernel Module (pKernelModule)
-            //            2. BIF Modules:
-            //                 a) generic Module (BuiltinGenericModule)
-            //                 b) size Module (BuiltinSizeModule)
-            //
-            // OCL builtin types, such as clk_event_t/queue_t, etc., are struct (opaque) types. For
-            // those types, its original names are themselves; the derived names are ones with
-            // '.<digit>' appended to the original names. For example,  clk_event_t is the original
-            // name, its derived names are clk_event_t.0, clk_event_t.1, etc.
-            //
-            // When llvm reads in multiple modules, say, M0, M1, under the same llvmcontext, if both
-            // M0 and M1 has the same struct type,  M0 will have the original name and M1 the derived
-            // name for that type.  For example, clk_event_t,  M0 will have clk_event_t, while M1 will
-            // have clk_event_t.2 (number is arbitary). After linking, those two named types should be
-            // mapped to the same type, otherwise, we could have type-mismatch (for example, OCL GAS
-            // builtin_functions tests will assertion fail during inlining due to type-mismatch).  Furthermore,
-            // when linking M1 into M0 (M0 : dstModule, M1 : srcModule), the final type is the type
-            // used in M0.
-
-            // Load the builtin module -  Generic BC
-            // Load the builtin module -  Generic BC
+            std::unique_ptr<llvm::Module> BuiltinGenericModule = nullptr;
+            std::unique_ptr<llvm::Module> BuiltinSizeModule = nullptr;
+            std::unique_ptr<llvm::MemoryBuffer> pGenericBuffer = nullptr;
+            std::unique_ptr<llvm::MemoryBuffer> pSizeTBuffer = nullptr;
+            const IGC::BiFSymbolIndex* pBiFSymbolIndex = nullptr;
             {
-                COMPILER_TIME_START(&oclContext, TIME_OCL_LazyBiFLoading);
+                // IGC has two BIF Modules:
+                //            1. kernel Module (pKernelModule)
+                //            2. BIF Modules:
+                //                 a) generic Module (BuiltinGenericModule)
+                //                 b) size Module (BuiltinSizeModule)
+                //
+                // OCL builtin types, such as clk_event_t/queue_t, etc., are struct (opaque) types. For
+                // those types, its original names are themselves; the derived names are ones with
+                // '.<digit>' appended to the original names. For example,  clk_event_t is the original
+                // name, its derived names are clk_event_t.0, clk_event_t.1, etc.
+                //
+                // When llvm reads in multiple modules, say, M0, M1, under the same llvmcontext, if both
+                // M0 and M1 has the same struct type,  M0 will have the original name and M1 the derived
+                // name for that type.  For example, clk_event_t,  M0 will have clk_event_t, while M1 will
+                // have clk_event_t.2 (number is arbitary). After linking, those two named types should be
+                // mapped to the same type, otherwise, we could have type-mismatch (for example, OCL GAS
+                // builtin_functions tests will assertion fail during inlining due to type-mismatch).  Furthermore,
+                // when linking M1 into M0 (M0 : dstModule, M1 : srcModule), the final type is the type
+                // used in M0.
+
+                // Load the builtin module -  Generic BC
+                // Load the builtin module -  Generic BC
+                {
+                    COMPILER_TIME_START(&oclContext, TIME_OCL_LazyBiFLoading);
 
-                pGenericBuffer = GetGenericModuleBuffer();
+                    pGenericBuffer = GetGenericModuleBuffer();
 
-                if (pGenericBuffer == NULL)
-                {
-                    SetErrorMessage("Error loading the Generic builtin resource", *pOutputArgs);
-                    return false;
-                }
+                    if (pGenericBuffer == NULL)
+                    {
+                        SetErrorMessage("Error loading the Generic builtin resource", *pOutputArgs);
+                        return false;
+                    }
 
-                llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                    getLazyBitcodeModule(pGenericBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
+                    llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
+                        getLazyBitcodeModule(pGenericBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
 
-                if (llvm::Error EC = ModuleOrErr.takeError())
-                {
-                    std::string error_str = "Error lazily loading bitcode for generic builtins,"
-                                            "is bitcode the right version and correctly formed?";
-                    SetErrorMessage(error_str, *pOutputArgs);
-                    return false;
+                    if (llvm::Error EC = ModuleOrErr.takeError())
+                    {
+                        std::string error_str = "Error lazily loading bitcode for generic builtins,"
+                                                "is bitcode the right version and correctly formed?";
+                        SetErrorMessage(error_str, *pOutputArgs);
+                        return false;
+                    }
+                    else
+                    {
+                        BuiltinGenericModule = std::move(*ModuleOrErr);
+                    }
+
+                    if (BuiltinGenericModule == NULL)
+                    {
+                        SetErrorMessage("Error loading the Generic builtin module from buffer", *pOutputArgs);
+                        return false;
+                    }
+                    COMPILER_TIME_END(&oclContext, TIME_OCL_LazyBiFLoading);
                 }
-                else
+
+                // Load the builtin module -  pointer depended
                 {
-                    BuiltinGenericModule = std::move(*ModuleOrErr);
+                    char ResNumber[5] = { '-' };
+                    switch (PtrSzInBits)
+                    {
+                    case 32:
+                        _snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_32);
+                        break;
+                    case 64:
+                        _snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_64);
+                        break;
+                    default:
+                        IGC_ASSERT_MESSAGE(0, "Unknown bitness of compiled module");
+                    }
+
+                    // the MemoryBuffer becomes owned by the module and does not need to be managed
+                    pSizeTBuffer.reset(llvm::LoadBufferFromResource(ResNumber, "BC"));
+                    IGC_ASSERT_MESSAGE(pSizeTBuffer, "Error loading builtin resource");
+
+                    llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
+                        getLazyBitcodeModule(pSizeTBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
+                    if (llvm::Error EC = ModuleOrErr.takeError())
+                        IGC_ASSERT_MESSAGE(0, "Error lazily loading bitcode for size_t builtins");
+                    else
+                        BuiltinSizeModule = std::move(*ModuleOrErr);
+
+                    IGC_ASSERT_MESSAGE(BuiltinSizeModule, "Error loading builtin module from buffer");
                 }
 
-                if (BuiltinGenericModule == NULL)
+                BuiltinGenericModule->setDataLayout(BuiltinSizeModule->getDataLayout());
+                BuiltinGenericModule->setTargetTriple(BuiltinSizeModule->getTargetTriple());
+
+                if (IGC_IS_FLAG_ENABLED(EnableBiFSymbolIndex))
                 {
-                    SetErrorMessage("Error loading the Generic builtin module from buffer", *pOutputArgs);
-                    return false;
+                    pBiFSymbolIndex = GetBiFSymbolIndex(pGenericBuffer->getMemBufferRef(), pSizeTBuffer->getMemBufferRef());
                 }
-                COMPILER_TIME_END(&oclContext, TIME_OCL_LazyBiFLoading);
             }
 
-            // Load the builtin module -  pointer depended
+            oclContext.getModuleMetaData()->csInfo.forcedSIMDSize |= IGC_GET_FLAG_VALUE(ForceOCLSIMDWidth);
+
+            COMPILE_TRACE_BEGIN(&oclContext, "UnifyIR", "phase");
+            if (llvm::StringRef(oclContext.getModule()->getTargetTriple()).startswith("spir"))
             {
-                char ResNumber[5] = { '-' };
-                switch (PtrSzInBits)
+                IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), pBiFSymbolIndex);
+            }
+            else // not SPIR
+            {
+                IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule), pBiFSymbolIndex);
+            }
+            COMPILE_TRACE_END(&oclContext);
+
+            if (oclContext.HasError())
+            {
+                if (oclContext.HasWarning())
                 {
-                case 32:
-                    _snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_32);
-                    break;
-                case 64:
-                    _snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_64);
-                    break;
-                default:
-                    IGC_ASSERT_MESSAGE(0, "Unknown bitness of compiled module");
+                    SetOutputMessage(oclContext.GetErrorAndWarning(), *pOutputArgs);
                 }
-
-                // the MemoryBuffer becomes owned by the module and does not need to be managed
-                pSizeTBuffer.reset(llvm::LoadBufferFromResource(ResNumber, "BC"));
-                IGC_ASSERT_MESSAGE(pSizeTBuffer, "Error loading builtin resource");
-
-                llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                    getLazyBitcodeModule(pSizeTBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
-                if (llvm::Error EC = ModuleOrErr.takeError())
-                    IGC_ASSERT_MESSAGE(0, "Error lazily loading bitcode for size_t builtins");
                 else
-                    BuiltinSizeModule = std::move(*ModuleOrErr);
-
-                IGC_ASSERT_MESSAGE(BuiltinSizeModule, "Error loading builtin module from buffer");
+                {
+                    SetOutputMessage(oclContext.GetError(), *pOutputArgs);
+                }
+                return false;
             }
 
-            BuiltinGenericModule->setDataLayout(BuiltinSizeModule->getDataLayout());
-            BuiltinGenericModule->setTargetTriple(BuiltinSizeModule->getTargetTriple());
-        }
-
-        oclContext.getModuleMetaData()->csInfo.forcedSIMDSize |= IGC_GET_FLAG_VALUE(ForceOCLSIMDWidth);
-
-        if (llvm::StringRef(oclContext.getModule()->getTargetTriple()).startswith("spir"))
-        {
-            IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
-        }
-        else // not SPIR
-        {
-            IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
-        }
-
-        if (oclContext.HasError())
-        {
-            if (oclContext.HasWarning())
-            {
-                SetOutputMessage(oclContext.GetErrorAndWarning(), *pOutputArgs);
-            }
-            else
+            if (useRetryCheckpoint && !oclContext.m_retryManager.IsLastTry())
             {
-                SetOutputMessage(oclContext.GetError(), *pOutputArgs);
+                SaveRetryCheckpoint(oclContext, retryCheckpoint);
             }
-            return false;
         }
 
         // Compiler Options information available after unification.
@@ -1173,10 +1353,14 @@ bool TranslateBuild(
             oclContext.m_retryManager.SetFirstStateId(oclContext.m_retryManager.GetRetryId());
         }
         // Optimize the IR. This happens once for each program, not per-kernel.
+        COMPILE_TRACE_BEGIN(&oclContext, "OptimizeIR", "phase");
         IGC::OptimizeIR(&oclContext);
+        COMPILE_TRACE_END(&oclContext);
 
         // Now, perform code generation
+        COMPILE_TRACE_BEGIN(&oclContext, "CodeGen", "phase");
         IGC::CodeGen(&oclContext);
+        COMPILE_TRACE_END(&oclContext);
 
         retry = (!oclContext.m_retryManager.kernelSet.empty() &&
                  oclContext.m_retryManager.AdvanceState());
@@ -1190,11 +1374,22 @@ bool TranslateBuild(
 
             IGC::Debug::RegisterComputeErrHandlers(*oclContext.getLLVMContext());
 
-            if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *oclContext.getLLVMContext(), inputDataFormatTemp))
+            if (!retryCheckpoint.empty())
             {
-                return false;
+                if (!RestoreRetryCheckpoint(oclContext, retryCheckpoint))
+                {
+                    SetErrorMessage("Error restoring the module checkpoint for retry compilation", *pOutputArgs);
+                    return false;
+                }
+            }
+            else
+            {
+                if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *oclContext.getLLVMContext(), inputDataFormatTemp))
+                {
+                    return false;
+                }
+                oclContext.setModule(pKernelModule);
             }
-            oclContext.setModule(pKernelModule);
         }
     } while (retry);
 
@@ -1235,21 +1430,16 @@ bool TranslateBuild(
         memcpy_s(binaryOutput, binarySize, programBinary.GetLinearPointer(), binarySize);
     } else {
         // ze binary foramt
-        llvm::SmallVector<char, 64> buf;
-        llvm::raw_svector_ostream llvm_os(buf);
         const char* spv_data = nullptr;
         uint32_t spv_size = 0;
         if (inputDataFormatTemp == TB_DATA_FORMAT_SPIR_V) {
             spv_data = pInputArgs->pInput;
             spv_size = pInputArgs->InputSize;
         }
-        oclContext.m_programOutput.GetZEBinary(llvm_os, pointerSizeInBytes,
+        size_t zeBinarySize = 0;
+        oclContext.m_programOutput.GetZEBinary(binaryOutput, zeBinarySize, pointerSizeInBytes,
             spv_data, spv_size);
-
-        // FIXME: try to avoid memory copy here
-        binarySize = buf.size();
-        binaryOutput = new char[binarySize];
-        memcpy_s(binaryOutput, binarySize, buf.data(), buf.size());
+        binarySize = static_cast<int>(zeBinarySize);
     }
 
     if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
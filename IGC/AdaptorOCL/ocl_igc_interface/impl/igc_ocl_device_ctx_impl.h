@@ -40,6 +40,7 @@ IN THE SOFTWARE.
 
 #include "Compiler/CISACodeGen/Platform.hpp"
 #include "common/SystemThread.h"
+#include "common/debug/AsyncDump.hpp"
 
 #include "cif/macros/enable.h"
 
@@ -55,6 +56,13 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclDeviceCtx) : CIF::PimplBase
         igcFeaturesAndWorkarounds.CreateImpl();
     }
 
+    CIF_PIMPL_DECLARE_DESTRUCTOR() override
+    {
+        // Writes the LLVM IR dumps still queued and joins the writer thread, which
+        // must not be left to static destruction.
+        IGC::Debug::ShutdownAsyncDump();
+    }
+
     CIF_PIMPL(Platform) *GetPlatformImpl(){
         return this->platform.GetImpl();
     }
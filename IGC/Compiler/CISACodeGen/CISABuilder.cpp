@@ -3974,6 +3974,10 @@ namespace IGC
         {
             SaveOption(vISA_LocalScheduling, false);
         }
+        if (IGC_IS_FLAG_ENABLED(EnableVISAGlobalSchedule))
+        {
+            SaveOption(vISA_GlobalScheduling, true);
+        }
         if (IGC_IS_FLAG_ENABLED(EnableVISANoBXMLEncoder))
         {
             SaveOption(vISA_BXMLEncoder, false);
@@ -4080,6 +4084,10 @@ namespace IGC
         {
             SaveOption(vISA_HybridRAWithSpill, true);
         }
+        if (IGC_GET_FLAG_VALUE(VISAArenaBudgetMB) != 0)
+        {
+            SaveOption(vISA_ArenaBudgetMB, IGC_GET_FLAG_VALUE(VISAArenaBudgetMB));
+        }
         if (IGC_IS_FLAG_ENABLED(DumpPayloadToScratch))
         {
             SaveOption(vISA_dumpPayload, true);
@@ -4108,6 +4116,14 @@ namespace IGC
         {
             SaveOption(vISA_IGAEncoder, false);
         }
+        if (IGC_IS_FLAG_ENABLED(EnableDirectEncoder))
+        {
+            SaveOption(vISA_DirectEncoder, true);
+        }
+        if (IGC_IS_FLAG_ENABLED(VerifyDirectEncoder))
+        {
+            SaveOption(vISA_VerifyDirectEncoder, true);
+        }
 
         if (IGC_IS_FLAG_ENABLED(SetA0toTdrForSendc))
         {
@@ -4448,6 +4464,10 @@ namespace IGC
         }
 
         COMPILER_TIME_START(m_program->GetContext(), TIME_CG_vISACompile);
+        if (context->m_compileTrace)
+        {
+            CompileTrace::startVISAPhases();
+        }
         bool enableVISADump = IGC_IS_FLAG_ENABLED(EnableVISASlowpath) || IGC_IS_FLAG_ENABLED(ShaderDumpEnable);
         auto builderMode = m_hasInlineAsm ? vISA_ASM_WRITER : vISA_DEFAULT;
         auto builderOpt = (enableVISADump || m_hasInlineAsm) ? VISA_BUILDER_BOTH : VISA_BUILDER_GEN;
@@ -5212,11 +5232,23 @@ namespace IGC
         else
         {
             pMainKernel = vMainKernel;
-            vIsaCompile = vbuilder->Compile(m_enableVISAdump ? GetDumpFileName("isa").c_str() : "");
+            if (m_asyncCompileResult.valid())
+            {
+                vIsaCompile = m_asyncCompileResult.get();
+            }
+            else
+            {
+                vIsaCompile = vbuilder->Compile(m_enableVISAdump ? GetDumpFileName("isa").c_str() : "");
+            }
         }
 
         COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
 
+        if (context->m_compileTrace)
+        {
+            context->m_compileTrace->recordVISAPhases();
+        }
+
 #if GET_TIME_STATS
         // handle the vISA time counters differently here
         if (context->m_compilerTimeStats)
@@ -5467,8 +5499,52 @@ namespace IGC
         pOutput->m_numGRFTotal = jitInfo->numGRFTotal;
     }
 
+    void CEncoder::CompileAsync(ThreadPool& pool)
+    {
+        IGC_ASSERT_MESSAGE(!m_hasInlineAsm, "inline asm requires the synchronous vISA text path");
+        IGC_ASSERT_MESSAGE(!m_asyncCompileResult.valid(), "vISA compilation already started");
+
+        VISABuilder* builder = vbuilder;
+        std::string isaName = m_enableVISAdump ? GetDumpFileName("isa") : "";
+        CompileTrace* trace = m_program->GetContext()->m_compileTrace;
+        std::string kernelName = m_program->entry->getName().str();
+        auto cancelled = std::make_shared<std::atomic<bool>>(false);
+        m_asyncCompileCancelled = cancelled;
+        m_asyncCompileResult = pool.submit([builder, isaName, trace, kernelName, cancelled]()
+        {
+            if (cancelled->load())
+            {
+                return 0;
+            }
+            // vISA phases of an asynchronous compile show up on the worker thread.
+            CompileTraceScope span(trace, kernelName, "kernel");
+            if (trace)
+            {
+                CompileTrace::startVISAPhases();
+            }
+            // Compile() sets vISA's thread-local platform from the builder.
+            int result = builder->Compile(isaName.c_str());
+            if (trace)
+            {
+                trace->recordVISAPhases();
+            }
+            return result;
+        });
+    }
+
+    void CEncoder::CancelAsyncCompile()
+    {
+        IGC_ASSERT_MESSAGE(m_asyncCompileResult.valid(), "no vISA compilation to cancel");
+        m_asyncCompileCancelled->store(true);
+    }
+
     void CEncoder::DestroyVISABuilder()
     {
+        // A cancelled compilation may still be running on the builder.
+        if (m_asyncCompileResult.valid())
+        {
+            m_asyncCompileResult.get();
+        }
         if (vAsmTextBuilder != nullptr)
         {
             V(::DestroyVISABuilder(vAsmTextBuilder));
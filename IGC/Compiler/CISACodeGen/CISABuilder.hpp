@@ -30,6 +30,8 @@ IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/helper.h"
 #include "visa_wa.h"
 #include "inc/common/sku_wa.h"
+#include "common/ThreadPool.hpp"
+#include <atomic>
 
 namespace IGC
 {
@@ -149,6 +151,15 @@ namespace IGC
         void MarkAsOutput(CVariable* var);
         void MarkAsPayloadLiveOut(CVariable* var);
         void Compile(bool hasSymbolTable = false);
+        /// \brief Starts the vISA back-end compilation of the kernel on a
+        /// worker thread. The following Compile() call waits for it and
+        /// collects the results.
+        void CompileAsync(ThreadPool& pool);
+        /// \brief Drops the compilation started by CompileAsync. It is skipped
+        /// if no worker picked it up yet; DestroyVISABuilder waits for it
+        /// otherwise.
+        void CancelAsyncCompile();
+        bool IsCompilePending() const { return m_asyncCompileResult.valid(); }
         std::string GetShaderName();
         void ReportCompilerStatistics(VISAKernel* pMainKernel, SProgramOutput* pOutput);
         int GetThreadCount(SIMDMode simdMode);
@@ -392,6 +403,7 @@ namespace IGC
 
         inline void SetIsCodePatchCandidate(bool v);
         inline bool IsCodePatchCandidate();
+        bool HasInlineAsm() const { return m_hasInlineAsm; }
         inline unsigned int GetPayloadEnd();
         inline void SetPayloadEnd(unsigned int payloadEnd);
         inline void SetHasPrevKernel(bool v);
@@ -641,6 +653,10 @@ namespace IGC
         VISAKernel* vMainKernel;
         VISABuilder* vbuilder;
         VISABuilder* vAsmTextBuilder;
+        // Result of the vbuilder->Compile() call started by CompileAsync
+        std::future<int> m_asyncCompileResult;
+        // Checked by the worker before it starts the compilation
+        std::shared_ptr<std::atomic<bool>> m_asyncCompileCancelled;
 
         // This is for CodePatch to split payload interpolation from a shader
         VISAKernel* vPayloadSection;
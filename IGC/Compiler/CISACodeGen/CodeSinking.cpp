@@ -89,9 +89,40 @@ namespace IGC {
 
         CodeSinking::CodeSinking(bool generalSinking) : FunctionPass(ID) {
         generalCodeSinking = generalSinking;
+        RPE = nullptr;
+        LVA = nullptr;
         initializeCodeSinkingPass(*PassRegistry::getPassRegistry());
     }
 
+    // Move I before InsertBefore, and update the liveness computed by an
+    // earlier pass (PreRAScheduler), so that it does not need to be
+    // recomputed.
+    void CodeSinking::moveInst(Instruction* I, Instruction* InsertBefore)
+    {
+        BasicBlock* FromBB = I->getParent();
+        I->moveBefore(InsertBefore);
+        if (RPE)
+            RPE->instructionMoved(I, FromBB);
+        else if (LVA)
+            LVA->instructionMoved(I, FromBB);
+    }
+
+    void CodeSinking::instsReordered(BasicBlock* BB)
+    {
+        if (RPE)
+            RPE->instructionsReordered(BB);
+        else if (LVA)
+            LVA->instructionsReordered(BB);
+    }
+
+    void CodeSinking::instsAddedOrErased()
+    {
+        if (RPE)
+            RPE->reset();
+        else if (LVA)
+            LVA->reset();
+    }
+
     /// AllUsesDominatedByBlock - Return true if all uses of the specified value
     /// occur in blocks dominated by the specified block.
     bool CodeSinking::AllUsesDominatedByBlock(Instruction* inst,
@@ -244,8 +275,14 @@ namespace IGC {
         PDT = &getAnalysis<PostDominatorTreeWrapperPass>().getPostDomTree();
         LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
         DL = &F.getParent()->getDataLayout();
+        RPE = getAnalysisIfAvailable<RegisterEstimator>();
+        LVA = RPE ? nullptr : getAnalysisIfAvailable<LivenessAnalysis>();
 
         bool changed = hoistCongruentPhi(F);
+        if (changed)
+        {
+            instsAddedOrErased();
+        }
 
         bool madeChange, everMadeChange = false;
         totalGradientMoved = 0;
@@ -425,7 +462,7 @@ namespace IGC {
                     {
                         Instruction* undoLoca = undoLocas[i];
                         IGC_ASSERT(undoLoca);
-                        movedInsts[i]->moveBefore(undoLoca);
+                        moveInst(movedInsts[i], undoLoca);
                     }
                     madeChange = false;
                 }
@@ -687,23 +724,23 @@ namespace IGC {
 
         if (!reducePressure || hasAliasConcern)
         {
-            inst->moveBefore(&(*succToSinkTo->getFirstInsertionPt()));
+            moveInst(inst, &(*succToSinkTo->getFirstInsertionPt()));
         }
         // when alasing is not an issue and reg-pressure is not an issue
         // move it as close to the uses as possible
         else if (usesInBlk.empty())
         {
-            inst->moveBefore(succToSinkTo->getTerminator());
+            moveInst(inst, succToSinkTo->getTerminator());
         }
         else if (usesInBlk.size() == 1)
         {
             Instruction* use = *(usesInBlk.begin());
-            inst->moveBefore(use);
+            moveInst(inst, use);
         }
         else
         {
             // first move to the beginning of the target block
-            inst->moveBefore(&(*succToSinkTo->getFirstInsertionPt()));
+            moveInst(inst, &(*succToSinkTo->getFirstInsertionPt()));
             // later on, move it close to the use
             localBlkSet.insert(succToSinkTo);
             localInstSet.insert(inst);
@@ -734,6 +771,7 @@ namespace IGC {
             }
         }
         if (madeChange) {
+            instsReordered(blk);
             ProcessDbgValueInst(*blk);
         }
         return madeChange;
@@ -1351,6 +1389,7 @@ namespace IGC {
                         {
                             auto* instClone = inst->clone();
                             instClone->insertAfter(def);
+                            instsReordered(def->getParent());
                             Value* undef = UndefValue::get(def->getType());
                             MetadataAsValue* MAV = MetadataAsValue::get(inst->getContext(), ValueAsMetadata::get(undef));
                             cast<CallInst>(inst)->setArgOperand(0, MAV);
@@ -35,6 +35,7 @@ IN THE SOFTWARE.
  //===----------------------------------------------------------------------===//
 
 #pragma once
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Analysis/PostDominators.h>
 #include <llvm/Analysis/LoopInfo.h>
@@ -50,6 +51,10 @@ namespace IGC {
         llvm::LoopInfo* LI;
         const llvm::DataLayout* DL;  // to estimate register pressure
         CodeGenContext* CTX;
+        // Liveness and register pressure of an earlier pass, kept up to date
+        // as instructions are moved. Null if not available.
+        RegisterEstimator* RPE;
+        LivenessAnalysis* LVA;
     public:
         static char ID; // Pass identification
 
@@ -66,8 +71,14 @@ namespace IGC {
             AU.addPreserved<llvm::DominatorTreeWrapperPass>();
             AU.addPreserved<llvm::PostDominatorTreeWrapperPass>();
             AU.addPreserved<llvm::LoopInfoWrapperPass>();
+            AU.addPreserved<LivenessAnalysis>();
+            AU.addPreserved<RegisterEstimator>();
         }
     private:
+        void moveInst(llvm::Instruction* I, llvm::Instruction* InsertBefore);
+        void instsReordered(llvm::BasicBlock* BB);
+        void instsAddedOrErased();
+
         bool ProcessBlock(llvm::BasicBlock& blk);
         bool SinkInstruction(llvm::Instruction* I,
             llvm::SmallPtrSetImpl<llvm::Instruction*>& Stores,
@@ -27,6 +27,7 @@ IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 #include "Compiler/CISACodeGen/ComputeShaderCodeGen.hpp"
 #include "Compiler/CISACodeGen/messageEncoding.hpp"
+#include "Compiler/CISACodeGen/VISACompileQueue.hpp"
 #include "common/allocator.h"
 #include "common/secure_mem.h"
 #include <iStdLib/utility.h>
@@ -383,6 +384,28 @@ namespace IGC
         }
     }
 
+    // skip SIMD8 if LICM threshold is met, unless it's lastTry
+    bool CComputeShader::SkipSIMD8ForLICM()
+    {
+        CodeGenContext* ctx = GetContext();
+        if (!ctx->m_retryManager.IsLastTry() && ctx->instrStat[LICM_STAT][EXCEED_THRESHOLD])
+        {
+            ctx->SetSIMDInfo(SIMD_SKIP_REGPRES, SIMDMode::SIMD8, ShaderDispatchMode::NOT_APPLICABLE);
+            return true;
+        }
+        return false;
+    }
+
+    bool CComputeShader::IsSIMDSizeMoot()
+    {
+        if (!m_simdSizeDeferred)
+        {
+            return false;
+        }
+        m_simdSizeDeferred = false;
+        return SkipSIMD8ForLICM();
+    }
+
     void CComputeShader::PreCompile()
     {
         CreateImplicitArgs();
@@ -433,11 +456,19 @@ namespace IGC
         static const SIMDMode BestSimdMode = SIMDMode::SIMD16;
 
         ComputeShaderContext* ctx = (ComputeShaderContext*)GetContext();
+        m_simdSizeDeferred = false;
 
         CShader* simd8Program = getSIMDEntry(ctx, SIMDMode::SIMD8);
         CShader* simd16Program = getSIMDEntry(ctx, SIMDMode::SIMD16);
         CShader* simd32Program = getSIMDEntry(ctx, SIMDMode::SIMD32);
 
+        // SIMD32 and SIMD8 are decided from the SIMD16 results, wait for them
+        // if SIMD16 is still compiling on the VISACompileQueue.
+        if (simd16Program && simd16Program->GetEncoder().IsCompilePending())
+        {
+            ctx->m_visaCompileQueue->flush();
+        }
+
         bool hasSimd8 = simd8Program && simd8Program->ProgramOutput()->m_programSize > 0;
         bool hasSimd16 = simd16Program && simd16Program->ProgramOutput()->m_programSize > 0;
         bool hasSimd32 = simd32Program && simd32Program->ProgramOutput()->m_programSize > 0;
@@ -508,10 +539,15 @@ namespace IGC
                     ctx->SetSIMDInfo(SIMD_SKIP_PERF, simdMode, ShaderDispatchMode::NOT_APPLICABLE);
                     return false;
                 }
-                else if (!ctx->m_retryManager.IsLastTry() && ctx->instrStat[LICM_STAT][EXCEED_THRESHOLD])
+                else if (simd32Program && simd32Program->GetEncoder().IsCompilePending())
+                {
+                    // Whether this is the last try depends on the SIMD32 spills,
+                    // IsSIMDSizeMoot checks the LICM rule once they are known.
+                    m_simdSizeDeferred = true;
+                    return true;
+                }
+                else if (SkipSIMD8ForLICM())
                 {
-                    // skip SIMD8 if LICM threshold is met, unless it's lastTry
-                    ctx->SetSIMDInfo(SIMD_SKIP_REGPRES, simdMode, ShaderDispatchMode::NOT_APPLICABLE);
                     return false;
                 }
                 else
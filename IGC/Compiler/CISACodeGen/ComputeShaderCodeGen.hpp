@@ -37,6 +37,7 @@ namespace IGC
         void        AllocatePayload() override;
         void        AddPrologue() override;
         bool        CompileSIMDSize(SIMDMode simdMode, EmitPass& EP, llvm::Function& F) override;
+        bool        IsSIMDSizeMoot() override;
         void        InitEncoder(SIMDMode simdMode, bool canAbortOnSpill, ShaderDispatchMode shaderMode = ShaderDispatchMode::NOT_APPLICABLE) override;
 
         void        FillProgram(SComputeShaderKernelProgram* pKernelProgram);
@@ -69,6 +70,7 @@ namespace IGC
         uint                   m_threadGroupModifier_X;
         uint                   m_threadGroupModifier_Y;
     private:
+        bool SkipSIMD8ForLICM();
         CShader* getSIMDEntry(CodeGenContext* ctx, SIMDMode simdMode)
         {
             CShader* prog = ctx->m_retryManager.GetSIMDEntry(simdMode);
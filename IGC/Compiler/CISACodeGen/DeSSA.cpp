@@ -72,6 +72,11 @@ IN THE SOFTWARE.
 // Careful implementation allows for all of the dominator forest interference
 // checks to be performed at once in a single depth-first traversal of the
 // dominator tree, which is what is implemented here.
+//
+// Unlike the paper, interference is decided by liveness alone: two members of
+// a congruence class interfere whenever one is live at the other's def, even if
+// they hold the same value. Values that are known to be equal are instead
+// coalesced up front as aliases (see getAliasee()).
 //===----------------------------------------------------------------------===//
 
 #include "Compiler/CISACodeGen/DeSSA.hpp"
@@ -550,17 +555,20 @@ bool DeSSA::runOnFunction(Function& MF)
     // Perform a depth-first traversal of the dominator tree, splitting
     // interferences amongst PHI-congruence classes.
     if (!RegNodeMap.empty()) {
-        DenseMap<int, Value*> CurrentDominatingParent;
-        DenseMap<Value*, Value*> ImmediateDominatingParent;
+        // Colors are dense in [1, CurrColor], so per-class state is kept in
+        // arrays indexed by color.
+        std::vector<Node*> CurrentDominatingParent(CurrColor + 1, nullptr);
+        CurrentPHIForColor.assign(CurrColor + 1,
+            std::make_pair((Instruction*)nullptr, (Value*)nullptr));
         // first, go through the function arguments
-        SplitInterferencesForArgument(CurrentDominatingParent, ImmediateDominatingParent);
+        SplitInterferencesForArgument(CurrentDominatingParent);
         // Then all the blocks
         for (df_iterator<DomTreeNode*> DI = df_begin(DT->getRootNode()),
             DE = df_end(DT->getRootNode()); DI != DE; ++DI) {
             SplitInterferencesForBasicBlock(DI->getBlock(),
-                CurrentDominatingParent,
-                ImmediateDominatingParent);
+                CurrentDominatingParent);
         }
+        CurrentPHIForColor.clear();
     }
 
     // Handle values that have specific alignment requirement.
@@ -741,13 +749,13 @@ void DeSSA::splitNode(Node* ND)
 
 /// SplitInterferencesForBasicBlock - traverses a basic block, splitting any
 /// interferences found between registers in the same congruence class. It
-/// takes two DenseMaps as arguments that it also updates:
+/// takes an array as argument that it also updates:
 ///
-/// 1) CurrentDominatingParent, which maps a color to the register in that
+/// 1) CurrentDominatingParent, which maps a color to the node in that
 ///    congruence class whose definition was most recently seen.
 ///
-/// 2) ImmediateDominatingParent, which maps a register to the register in the
-///    same congruence class that most immediately dominates it.
+/// It also updates Node::idomParent, which links a node to the node in the
+/// same congruence class that most immediately dominates it.
 ///
 /// This function assumes that it is being called in a depth-first traversal
 /// of the dominator tree.
@@ -781,8 +789,7 @@ void DeSSA::splitNode(Node* ND)
 void
 DeSSA::SplitInterferencesForBasicBlock(
     BasicBlock* MBB,
-    DenseMap<int, Value*>& CurrentDominatingParent,
-    DenseMap<Value*, Value*>& ImmediateDominatingParent) {
+    std::vector<Node*>& CurrentDominatingParent) {
     // Sort defs by their order in the original basic block, as the code below
     // assumes that it is processing definitions in dominance order.
     std::vector<Instruction*>& DefInstrs = PHISrcDefs[MBB];
@@ -792,10 +799,11 @@ DeSSA::SplitInterferencesForBasicBlock(
         BBE = DefInstrs.end(); BBI != BBE; ++BBI) {
 
         Instruction* DefMI = *BBI;
+        Node* DefNode = RegNodeMap[DefMI];
 
         // If the virtual register being defined is not used in any PHI or has
         // already been isolated, then there are no more interferences to check.
-        int RootC = getRootColor(DefMI);
+        int RootC = getRootColor(DefNode);
         if (!RootC)
             continue;
 
@@ -805,12 +813,12 @@ DeSSA::SplitInterferencesForBasicBlock(
         // handle it here by tracking defining machine instructions rather than
         // virtual registers. For now, we just handle the situation conservatively
         // in a way that will possibly lead to false interferences.
-        Value* NewParent = CurrentDominatingParent[RootC];
-        if (NewParent == DefMI)
+        Node* NewParent = CurrentDominatingParent[RootC];
+        if (NewParent == DefNode)
             continue;
 
-        // Pop registers from the stack represented by ImmediateDominatingParent
-        // until we find a parent that dominates the current instruction.
+        // Pop registers from the stack represented by Node::idomParent until we
+        // find a parent that dominates the current instruction.
         while (NewParent) {
             if (getRootColor(NewParent)) {
                 // we have added the another condition because the domination-test
@@ -820,34 +828,36 @@ DeSSA::SplitInterferencesForBasicBlock(
                 //   based on their ordering
                 //  if (isa<PHINode>(A) && isa<PHINode>(B))
                 //    return false;"
-                if (isa<Argument>(NewParent)) {
+                Value* ParentV = NewParent->value;
+                if (isa<Argument>(ParentV)) {
                     break;
                 }
-                else if (DT->dominates(cast<Instruction>(NewParent), DefMI)) {
+                else if (DT->dominates(cast<Instruction>(ParentV), DefMI)) {
                     break;
                 }
-                else if (cast<Instruction>(NewParent)->getParent() == MBB &&
-                    isa<PHINode>(DefMI) && isa<PHINode>(NewParent)) {
+                else if (cast<Instruction>(ParentV)->getParent() == MBB &&
+                    isa<PHINode>(DefMI) && isa<PHINode>(ParentV)) {
                     break;
                 }
             }
-            NewParent = ImmediateDominatingParent[NewParent];
+            NewParent = NewParent->idomParent;
         }
         // If NewParent is nonzero, then its definition dominates the current
         // instruction, so it is only necessary to check for the liveness of
         // NewParent in order to check for an interference.
-        if (NewParent && LV->isLiveAt(NewParent, DefMI)) {
+        if (NewParent && LV->isLiveAt(NewParent->value, DefMI)) {
             // If there is an interference, always isolate the new register. This
             // could be improved by using a heuristic that decides which of the two
             // registers to isolate.
-            isolateReg(DefMI);
+            splitNode(DefNode);
             CurrentDominatingParent[RootC] = NewParent;
         }
         else {
-            // If there is no interference, update ImmediateDominatingParent and set
-            // the CurrentDominatingParent for this color to the current register.
-            ImmediateDominatingParent[DefMI] = NewParent;
-            CurrentDominatingParent[RootC] = DefMI;
+            // If there is no interference, update the immediate dominating
+            // parent and set the CurrentDominatingParent for this color to the
+            // current register.
+            DefNode->idomParent = NewParent;
+            CurrentDominatingParent[RootC] = DefNode;
         }
     }
 
@@ -856,7 +866,10 @@ DeSSA::SplitInterferencesForBasicBlock(
     // the predecessor block. The def of a PHI's destination register is processed
     // along with the other defs in a basic block.
 
-    CurrentPHIForColor.clear();
+    for (int C : CurrentPHIColors) {
+        CurrentPHIForColor[C] = std::make_pair(nullptr, nullptr);
+    }
+    CurrentPHIColors.clear();
 
     for (succ_iterator SI = succ_begin(MBB), E = succ_end(MBB); SI != E; ++SI) {
         for (BasicBlock::iterator BBI = (*SI)->begin(), BBE = (*SI)->end();
@@ -904,23 +917,26 @@ DeSSA::SplitInterferencesForBasicBlock(
                 continue;
             }
             else {
+                if (!CurrentPHI.first)
+                    CurrentPHIColors.push_back(RootC);
                 CurrentPHI = std::make_pair(PHI, PredValue);
             }
 
             // check live-out interference
-            // Pop registers from the stack represented by ImmediateDominatingParent
-            // until we find a parent that dominates the current instruction.
-            Value* NewParent = CurrentDominatingParent[RootC];
+            // Pop registers from the stack represented by Node::idomParent until
+            // we find a parent that dominates the current instruction.
+            Node* NewParent = CurrentDominatingParent[RootC];
             while (NewParent) {
                 if (getRootColor(NewParent)) {
-                    if (isa<Argument>(NewParent)) {
+                    Value* ParentV = NewParent->value;
+                    if (isa<Argument>(ParentV)) {
                         break;
                     }
-                    else if (DT->dominates(cast<Instruction>(NewParent)->getParent(), MBB)) {
+                    else if (DT->dominates(cast<Instruction>(ParentV)->getParent(), MBB)) {
                         break;
                     }
                 }
-                NewParent = ImmediateDominatingParent[NewParent];
+                NewParent = NewParent->idomParent;
             }
             CurrentDominatingParent[RootC] = NewParent;
 
@@ -928,8 +944,9 @@ DeSSA::SplitInterferencesForBasicBlock(
             // register rather than the PHI. It is also possible to isolate the
             // PHI, but that introduces copies for all of the registers involved
             // in that PHI.
-            if (NewParent && NewParent != PredValue && LV->isLiveOut(NewParent, *MBB)) {
-                isolateReg(NewParent);
+            if (NewParent && NewParent->value != PredValue &&
+                LV->isLiveOut(NewParent->value, *MBB)) {
+                splitNode(NewParent);
             }
         }
     }
@@ -937,23 +954,22 @@ DeSSA::SplitInterferencesForBasicBlock(
 
 void
 DeSSA::SplitInterferencesForArgument(
-    DenseMap<int, Value*>& CurrentDominatingParent,
-    DenseMap<Value*, Value*>& ImmediateDominatingParent) {
+    std::vector<Node*>& CurrentDominatingParent) {
     // No two arguments can be in the same congruent class
     for (auto BBI = PHISrcArgs.begin(),
         BBE = PHISrcArgs.end(); BBI != BBE; ++BBI) {
-        Value* AV = *BBI;
+        Node* AN = RegNodeMap[*BBI];
         // If the virtual register being defined is not used in any PHI or has
         // already been isolated, then there are no more interferences to check.
-        int RootC = getRootColor(AV);
+        int RootC = getRootColor(AN);
         if (!RootC)
             continue;
-        Value* NewParent = CurrentDominatingParent[RootC];
+        Node* NewParent = CurrentDominatingParent[RootC];
         if (NewParent) {
-            isolateReg(AV);
+            splitNode(AN);
         }
         else {
-            CurrentDominatingParent[RootC] = AV;
+            CurrentDominatingParent[RootC] = AN;
         }
     }
 }
@@ -66,6 +66,7 @@ IN THE SOFTWARE.
 #include <llvm/ADT/DenseSet.h>
 #include "common/LLVMWarningsPop.hpp"
 #include <map>
+#include <vector>
 #include "Probe/Assertion.h"
 
 namespace IGC {
@@ -97,6 +98,7 @@ namespace IGC {
             PHISrcDefs.clear();
             PHISrcArgs.clear();
             RegNodeMap.clear();
+            CurrentPHIForColor.clear();
             InsEltMap.clear();
             AliasMap.clear();
         }
@@ -139,7 +141,7 @@ namespace IGC {
         struct Node {
             Node(llvm::Value* v, int c, e_alignment align)
                 : parent(this), next(this), prev(this), value(v)
-                , rank(0), alignment(align), color(c)
+                , rank(0), alignment(align), color(c), idomParent(nullptr)
             {
             }
 
@@ -159,6 +161,11 @@ namespace IGC {
             // (in another word, id or label) of a congruent class.
             // Start from 1
             int color;
+
+            // The node in the same congruent class that most immediately
+            // dominates this one. Used as the stack of dominating nodes while
+            // traversing the dominator tree.
+            Node* idomParent;
         };
 
         /// Get the union-root of a register. The root is 0 if the register has been
@@ -169,6 +176,9 @@ namespace IGC {
         // (This is needed during traversal of algo. The color is used as the
         // reprentative of a congruent class that remains unchanged during traversal.)
         int getRootColor(llvm::Value* V);
+        int getRootColor(Node* N) const {
+            return isIsolated(N) ? 0 : N->getLeader()->color;
+        }
 
         // Isolate a register.
         void isolateReg(llvm::Value*);
@@ -181,23 +191,20 @@ namespace IGC {
         void splitNode(Node* ND);
 
         /// Traverses a basic block, splitting any interferences found between
-        /// registers in the same congruence class. It takes two DenseMaps as
-        /// arguments that it also updates: CurrentDominatingParent, which maps
-        /// a color to the register in that congruence class whose definition was
-        /// most recently seen, and ImmediateDominatingParent, which maps a register
-        /// to the register in the same congruence class that most immediately
-        /// dominates it.
+        /// registers in the same congruence class. It takes an array indexed by
+        /// color as argument that it also updates: CurrentDominatingParent, which
+        /// maps a color to the node in that congruence class whose definition was
+        /// most recently seen. Each node keeps the node in the same congruence
+        /// class that most immediately dominates it in Node::idomParent.
         ///
         /// This function assumes that it is being called in a depth-first traversal
         /// of the dominator tree.
         void SplitInterferencesForBasicBlock(
             llvm::BasicBlock*,
-            llvm::DenseMap<int, llvm::Value*>& CurrentDominatingParent,
-            llvm::DenseMap<llvm::Value*, llvm::Value*>& ImmediateDominatingParent);
+            std::vector<Node*>& CurrentDominatingParent);
 
         void SplitInterferencesForArgument(
-            llvm::DenseMap<int, llvm::Value*>& CurrentDominatingParent,
-            llvm::DenseMap<llvm::Value*, llvm::Value*>& ImmediateDominatingParent);
+            std::vector<Node*>& CurrentDominatingParent);
 
         void SplitInterferencesForAlignment();
 
@@ -229,7 +236,10 @@ namespace IGC {
 
         // Maps a color to a pair of a llvm::Instruction* and a virtual register, which
         // is the operand of that PHI corresponding to the current basic block.
-        llvm::DenseMap<int, std::pair<llvm::Instruction*, llvm::Value*> > CurrentPHIForColor;
+        // Colors set for the current basic block are kept in CurrentPHIColors so
+        // that they could be reset for the next one.
+        std::vector<std::pair<llvm::Instruction*, llvm::Value*> > CurrentPHIForColor;
+        llvm::SmallVector<int, 16> CurrentPHIColors;
 
         // Implement reuse for InsertElement only
         // Hierarchical coalescing:
@@ -37,6 +37,7 @@ IN THE SOFTWARE.
 #include "PayloadMapping.hpp"
 #include "VectorProcess.hpp"
 #include "ShaderCodeGen.hpp"
+#include "VISACompileQueue.hpp"
 #include "common/allocator.h"
 #include "common/debug/Dump.hpp"
 #include "common/debug/Dump.hpp"
@@ -526,6 +527,28 @@ void EmitPass::CreateKernelShaderMap(CodeGenContext* ctx, MetaDataUtils* pMdUtil
     }
 }
 
+void EmitPass::UpdateMidThreadPreemption(CShader* shader)
+{
+    if ((shader->GetShaderType() == ShaderType::COMPUTE_SHADER ||
+        shader->GetShaderType() == ShaderType::OPENCL_SHADER) &&
+        shader->m_Platform->supportDisableMidThreadPreemptionSwitch() &&
+        IGC_IS_FLAG_ENABLED(EnableDisableMidThreadPreemptionOpt) &&
+        (shader->GetContext()->m_instrTypes.numLoopInsts == 0) &&
+        (shader->ProgramOutput()->m_InstructionCount < IGC_GET_FLAG_VALUE(MidThreadPreemptionDisableThreshold)))
+    {
+        if (shader->GetShaderType() == ShaderType::COMPUTE_SHADER)
+        {
+            CComputeShader* csProgram = static_cast<CComputeShader*>(shader);
+            csProgram->SetDisableMidthreadPreemption();
+        }
+        else
+        {
+            COpenCLKernel* kernel = static_cast<COpenCLKernel*>(shader);
+            kernel->SetDisableMidthreadPreemption();
+        }
+    }
+}
+
 bool EmitPass::runOnFunction(llvm::Function& F)
 {
     m_currFuncHasSubroutine = false;
@@ -574,6 +597,13 @@ bool EmitPass::runOnFunction(llvm::Function& F)
         }
     }
 
+    // the span name and arguments are only built while a trace is recorded
+    CompileTrace* trace = m_pCtx->m_compileTrace;
+    CompileTraceScope kernelSpan(trace,
+        trace ? F.getName().str() + " (SIMD" + std::to_string(numLanes(m_SimdMode)) + ")" : std::string(), "kernel",
+        trace ? llvm::json::Object{ { "simd", numLanes(m_SimdMode) }, { "retry_id", m_pCtx->m_retryManager.GetRetryId() } }
+              : llvm::json::Object());
+
     bool isCloned = false;
     if (DebugInfoData::hasDebugInfo(m_currShader))
     {
@@ -1040,6 +1070,38 @@ bool EmitPass::runOnFunction(llvm::Function& F)
         {
             compileWithSymbolTable = true;
         }
+
+        // With parallel codegen the vISA back end of a single-function kernel
+        // runs on the compile queue; everything that needs its results is done
+        // when the queue is flushed.
+        if (m_pCtx->m_visaCompileQueue &&
+            !hasStackCall &&
+            !m_encoder->IsCodePatchCandidate() &&
+            !m_currShader->GetDebugInfoData().m_pDebugEmitter &&
+            (!m_FGA || !m_FGA->getGroup(&F) || m_FGA->getGroup(&F)->isSingle()) &&
+            !m_encoder->HasInlineAsm() &&
+            IGC_IS_FLAG_DISABLED(ShaderOverride))
+        {
+            m_pCtx->m_visaCompileQueue->enqueue(m_currShader, compileWithSymbolTable);
+            m_pCtx->m_prevShader = nullptr;
+            IF_DEBUG_INFO(IDebugEmitter::Release(m_pDebugEmitter);)
+            return false;
+        }
+
+        // A SIMD variant accepted while the narrower ones were still on the
+        // queue has to wait for them when it cannot be queued itself.
+        if (m_currShader->m_simdSizeDeferred)
+        {
+            m_pCtx->m_visaCompileQueue->flush();
+            if (m_currShader->IsSIMDSizeMoot())
+            {
+                m_encoder->DestroyVISABuilder();
+                m_pCtx->m_prevShader = nullptr;
+                IF_DEBUG_INFO(IDebugEmitter::Release(m_pDebugEmitter);)
+                return false;
+            }
+        }
+
         m_encoder->Compile(compileWithSymbolTable);
         m_pCtx->m_prevShader = m_currShader;
         // if we are doing stack-call, do the following:
@@ -1074,24 +1136,7 @@ bool EmitPass::runOnFunction(llvm::Function& F)
         }
     }
 
-    if ((m_currShader->GetShaderType() == ShaderType::COMPUTE_SHADER ||
-        m_currShader->GetShaderType() == ShaderType::OPENCL_SHADER) &&
-        m_currShader->m_Platform->supportDisableMidThreadPreemptionSwitch() &&
-        IGC_IS_FLAG_ENABLED(EnableDisableMidThreadPreemptionOpt) &&
-        (m_currShader->GetContext()->m_instrTypes.numLoopInsts == 0) &&
-        (m_currShader->ProgramOutput()->m_InstructionCount < IGC_GET_FLAG_VALUE(MidThreadPreemptionDisableThreshold)))
-    {
-        if (m_currShader->GetShaderType() == ShaderType::COMPUTE_SHADER)
-        {
-            CComputeShader* csProgram = static_cast<CComputeShader*>(m_currShader);
-            csProgram->SetDisableMidthreadPreemption();
-        }
-        else
-        {
-            COpenCLKernel* kernel = static_cast<COpenCLKernel*>(m_currShader);
-            kernel->SetDisableMidthreadPreemption();
-        }
-    }
+    UpdateMidThreadPreemption(m_currShader);
 
     // Temp WA to disable MTP when stack calls are present
     // TODO: Remove when VISA is fixed to copy R0 to dedicated register, so R0 contents won't be corrupted by MTP
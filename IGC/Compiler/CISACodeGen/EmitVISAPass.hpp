@@ -84,6 +84,10 @@ public:
 
     void CreateKernelShaderMap(CodeGenContext* ctx, IGC::IGCMD::MetaDataUtils* pMdUtils, llvm::Function& F);
 
+    /// Disables mid-thread preemption for small loop-free kernels; requires the
+    /// final instruction count, i.e. must run after the vISA compilation.
+    static void UpdateMidThreadPreemption(CShader* shader);
+
     void Frc(const SSource& source, const DstModifier& modifier);
     void Mad(const SSource sources[3], const DstModifier& modifier);
     void Lrp(const SSource sources[3], const DstModifier& modifier);
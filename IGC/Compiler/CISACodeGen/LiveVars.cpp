@@ -419,6 +419,80 @@ void LiveVars::HandleVirtRegDef(Instruction* MI)
         VRInfo.Kills.push_back(MI);
 }
 
+void LiveVars::recomputeLiveness(Value* VL)
+{
+    LiveVars::LVInfo& VRInfo = getLVInfo(VL);
+    VRInfo.AliveBlocks.clear();
+    VRInfo.Kills.clear();
+    VRInfo.NumUses = 0;
+
+    BasicBlock* DefBlk = nullptr;
+    if (Instruction * DefI = dyn_cast<Instruction>(VL)) {
+        // Default it to dead, the same as getLVInfo() does.
+        DefBlk = DefI->getParent();
+        VRInfo.Kills.push_back(DefI);
+    }
+
+    // Group uses by BB. A use by a PHI is a use at the end of the incoming
+    // BB, which is handled after all other uses (see Calculate()).
+    SmallVector<BasicBlock*, 8> UseBlocks;
+    DenseMap<BasicBlock*, SmallVector<Instruction*, 4>> UsesInBB;
+    SmallVector<BasicBlock*, 4> PHIBlocks;
+    for (Use& U : VL->uses()) {
+        Instruction* UI = dyn_cast<Instruction>(U.getUser());
+        if (!UI)
+            continue;
+        if (PHINode * PN = dyn_cast<PHINode>(UI)) {
+            PHIBlocks.push_back(PN->getIncomingBlock(U));
+            continue;
+        }
+        SmallVector<Instruction*, 4>& Uses = UsesInBB[UI->getParent()];
+        if (Uses.empty()) {
+            UseBlocks.push_back(UI->getParent());
+        }
+        Uses.push_back(UI);
+#if VECTOR_COALESCING == 0
+        // special treatment for ExtractElement
+        if (isa<ExtractElementInst>(UI) && UI->getOperand(0) == VL) {
+            for (Use& EU : UI->uses()) {
+                if (PHINode * PN = dyn_cast<PHINode>(EU.getUser()))
+                    PHIBlocks.push_back(PN->getIncomingBlock(EU));
+            }
+        }
+#endif
+    }
+
+    // The defining BB must be handled first as it holds the default kill,
+    // the same order as the depth-first walk of Calculate().
+    auto DBI = std::find(UseBlocks.begin(), UseBlocks.end(), DefBlk);
+    if (DBI != UseBlocks.end()) {
+        std::swap(*DBI, UseBlocks.front());
+    }
+
+    for (BasicBlock* MBB : UseBlocks) {
+        SmallVector<Instruction*, 4>& Uses = UsesInBB[MBB];
+        std::stable_sort(Uses.begin(), Uses.end(),
+            [this](Instruction* A, Instruction* B) {
+                return DistanceMap[A] < DistanceMap[B];
+            });
+        for (Instruction* MI : Uses) {
+            HandleVirtRegUse(VL, MBB, MI, false, true);
+        }
+    }
+
+    for (BasicBlock* MBB : PHIBlocks) {
+        MarkVirtRegAliveInBlock(VRInfo, DefBlk, MBB);
+    }
+}
+
+void LiveVars::updateDistance(BasicBlock* BB)
+{
+    unsigned Dist = 0;
+    for (auto& II : *BB) {
+        DistanceMap[&II] = Dist++;
+    }
+}
+
 void LiveVars::initDistance(Function& F)
 {
     DistanceMap.clear();
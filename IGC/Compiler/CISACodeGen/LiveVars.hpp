@@ -206,6 +206,14 @@ namespace IGC
             bool ScanAllUses = false, bool ScanBBTopDown = false);
         void HandleVirtRegDef(llvm::Instruction* MI);
 
+        /// Recompute LVInfo of LV from its current uses, after LV or some of
+        /// its uses have been moved. Distances of the BBs that have been
+        /// changed must be updated first (see updateDistance()).
+        void recomputeLiveness(llvm::Value* LV);
+
+        /// Renumber the instructions of BB after its instructions are moved.
+        void updateDistance(llvm::BasicBlock* BB);
+
         void ComputeLiveness(llvm::Function*, WIAnalysis*);
 
         // Calculate liveness info for all live variables
@@ -34,6 +34,7 @@ IN THE SOFTWARE.
 #include <llvm/IR/CFG.h>
 #include <llvm/ADT/DenseMap.h>
 #include <llvm/ADT/SetVector.h>
+#include <llvm/ADT/SmallPtrSet.h>
 #include <llvm/ADT/SmallVector.h>
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/InstIterator.h>
@@ -42,6 +43,7 @@ IN THE SOFTWARE.
 #include <llvm/IR/InstIterator.h>
 #include <llvm/Support/MathExtras.h>
 #include "common/LLVMWarningsPop.hpp"
+#include <algorithm>
 #include "Probe/Assertion.h"
 
 using namespace llvm;
@@ -112,11 +114,22 @@ void LivenessAnalysis::clear()
     ValueIds.clear();
     IdValues.clear();
     BBLiveIns.clear();
+    m_DirtyBBs.clear();
 
     delete m_LV;
     m_LV = nullptr;
 }
 
+void LivenessAnalysis::reset()
+{
+    if (!m_F)
+    {
+        return;
+    }
+    clear();
+    initValueIds();
+}
+
 void LivenessAnalysis::initValueIds()
 {
     int ix = 0;
@@ -162,10 +175,25 @@ inline void LivenessAnalysis::setKillInsts(Value* V, Instruction* kill)
     VS.push_back(V);
 }
 
+void LivenessAnalysis::removeKillInsts(Value* V, Instruction* kill)
+{
+    ValueToValueVecMap::iterator KI = KillInsts.find(kill);
+    if (KI == KillInsts.end())
+    {
+        return;
+    }
+    ValueVec& VS = KI->second;
+    VS.erase(std::remove(VS.begin(), VS.end(), V), VS.end());
+    if (VS.empty())
+    {
+        KillInsts.erase(KI);
+    }
+}
+
 bool LivenessAnalysis::isInstLastUseOfValue(Value* V, Instruction* I)
 {
     ValueVec& VS = KillInsts[I];
-    for (int i = 0, e = (int)VS.size(); i < e; ++I)
+    for (int i = 0, e = (int)VS.size(); i < e; ++i)
     {
         if (VS[i] == V)
         {
@@ -235,43 +263,202 @@ void LivenessAnalysis::calculate(Function* F)
             continue;
         }
         int valID = VI->second;
+        addLiveness(V, valID, lvi);
+    }
+    m_DirtyBBs.clear();
+
+    if (IGC_IS_FLAG_ENABLED(EnableLivenessDump))
+    {
+        print(errs());
+    }
+}
+
+// Set live-in and kill info of V from its LVInfo.
+void LivenessAnalysis::addLiveness(Value* V, int ValueID, LiveVars::LVInfo* lvi)
+{
+    // V is either an instruction or an argument. If defBB is nullptr,
+    // V is an argument; otherwise, it is the defining BB.
+    BasicBlock* defBB = nullptr;
+    if (Instruction * defInst = dyn_cast<Instruction>(V))
+    {
+        defBB = defInst->getParent();
+    }
+
+    for (auto II = lvi->AliveBlocks.begin(), IE = lvi->AliveBlocks.end();
+        II != IE; ++II)
+    {
+        BasicBlock* BB = *II;
+        setLiveIn(BB, ValueID);
+    }
+
+    for (std::vector<Instruction*>::iterator II = lvi->Kills.begin(),
+        IE = lvi->Kills.end();
+        II != IE; ++II)
+    {
+        Instruction* inst = *II;
+        setKillInsts(V, inst);
 
-        // V is either an instruction or an argument. If defBB is nullptr,
-        // V is an argument; otherwise, it is the defining BB.
-        BasicBlock* defBB = nullptr;
-        if (Instruction * defInst = dyn_cast<Instruction>(V))
+        // If inst's BB isn't "V"'s defBB, V must be live into this BB.
+        // This condition check also works when "V" is an argument.
+        BasicBlock* useBB = inst->getParent();
+        if (defBB != useBB)
         {
-            defBB = defInst->getParent();
+            setLiveIn(useBB, ValueID);
         }
+    }
+}
 
-        for (auto II = lvi->AliveBlocks.begin(), IE = lvi->AliveBlocks.end();
-            II != IE; ++II)
+// Recompute liveness of V from its current uses. StaleBB, if not null, is
+// a BB that V may still be marked live-in but is no longer recorded in
+// V's LVInfo, i.e. the BB a killing instruction has been moved out of.
+void LivenessAnalysis::updateValue(Value* V, BasicBlock* StaleBB)
+{
+    ValueToIntMap::iterator VI = ValueIds.find(V);
+    if (VI == ValueIds.end())
+    {
+        return;
+    }
+    int valID = VI->second;
+    LiveVars::LVInfo& lvi = m_LV->getLVInfo(V);
+
+    // Remove the old liveness of V, remembering where V was live-in.
+    SmallPtrSet<BasicBlock*, 16> oldLiveIns;
+    auto resetLiveIn = [&](BasicBlock* BB) {
+        BBLiveInMap::iterator BI = BBLiveIns.find(BB);
+        if (BI != BBLiveIns.end() && BI->second.test(valID))
         {
-            BasicBlock* BB = *II;
-            setLiveIn(BB, valID);
+            BI->second.reset(valID);
+            oldLiveIns.insert(BB);
         }
+    };
+    for (BasicBlock* BB : lvi.AliveBlocks)
+    {
+        resetLiveIn(BB);
+    }
+    for (Instruction* kill : lvi.Kills)
+    {
+        removeKillInsts(V, kill);
+        resetLiveIn(kill->getParent());
+        m_DirtyBBs.insert(kill->getParent());
+    }
+    if (StaleBB)
+    {
+        resetLiveIn(StaleBB);
+    }
+
+    m_LV->recomputeLiveness(V);
+    addLiveness(V, valID, &lvi);
 
-        for (std::vector<Instruction*>::iterator II = lvi->Kills.begin(),
-            IE = lvi->Kills.end();
-            II != IE; ++II)
+    // A BB is changed if V's live-in state or its kill is changed.
+    for (BasicBlock* BB : lvi.AliveBlocks)
+    {
+        if (!oldLiveIns.erase(BB))
         {
-            Instruction* inst = *II;
-            setKillInsts(V, inst);
+            m_DirtyBBs.insert(BB);
+        }
+    }
+    for (Instruction* kill : lvi.Kills)
+    {
+        BasicBlock* BB = kill->getParent();
+        oldLiveIns.erase(BB);
+        m_DirtyBBs.insert(BB);
+    }
+    for (BasicBlock* BB : oldLiveIns)
+    {
+        m_DirtyBBs.insert(BB);
+    }
+}
 
-            // If inst's BB isn't "V"'s defBB, V must be live into this BB.
-            // This condition check also works when "V" is an argument.
-            BasicBlock* useBB = inst->getParent();
-            if (defBB != useBB)
-            {
-                setLiveIn(useBB, valID);
-            }
+void LivenessAnalysis::instructionMoved(Instruction* I, BasicBlock* FromBB)
+{
+    if (!m_LV)
+    {
+        return;
+    }
+
+    BasicBlock* ToBB = I->getParent();
+    if (ToBB == FromBB)
+    {
+        instructionsReordered(ToBB);
+        return;
+    }
+
+    m_LV->updateDistance(FromBB);
+    m_LV->updateDistance(ToBB);
+    m_DirtyBBs.insert(FromBB);
+    m_DirtyBBs.insert(ToBB);
+
+    // Only I and its operands may have changed their liveness.
+    updateValue(I, nullptr);
+    SmallPtrSet<Value*, 8> opnds;
+    for (Value* V : I->operand_values())
+    {
+        if ((isa<Instruction>(V) || isa<Argument>(V)) && opnds.insert(V).second)
+        {
+            updateValue(V, FromBB);
         }
     }
+}
 
-    if (IGC_IS_FLAG_ENABLED(EnableLivenessDump))
+void LivenessAnalysis::instructionsReordered(BasicBlock* BB)
+{
+    if (!m_LV)
     {
-        print(errs());
+        return;
+    }
+
+    m_LV->updateDistance(BB);
+    m_DirtyBBs.insert(BB);
+
+    // Reordering within a BB does not change liveness across BBs; only a
+    // kill in BB moves to the new last use of the killed value.
+    SmallVector<std::pair<Value*, Instruction*>, 32> killed;
+    for (auto& I : *BB)
+    {
+        ValueToValueVecMap::iterator KI = KillInsts.find(&I);
+        if (KI == KillInsts.end())
+        {
+            continue;
+        }
+        for (Value* V : KI->second)
+        {
+            killed.push_back(std::make_pair(V, &I));
+        }
+        KillInsts.erase(KI);
     }
+
+    for (auto& KV : killed)
+    {
+        Value* V = KV.first;
+        Instruction* oldKill = KV.second;
+        Instruction* newKill = oldKill;
+        // A dead value is killed by its def.
+        if (V != oldKill)
+        {
+            for (User* U : V->users())
+            {
+                Instruction* useInst = dyn_cast<Instruction>(U);
+                if (useInst && useInst->getParent() == BB &&
+                    !isa<PHINode>(useInst) &&
+                    getDistance(useInst) > getDistance(newKill))
+                {
+                    newKill = useInst;
+                }
+            }
+        }
+        setKillInsts(V, newKill);
+        if (newKill != oldKill)
+        {
+            std::vector<Instruction*>& kills = m_LV->getLVInfo(V).Kills;
+            std::replace(kills.begin(), kills.end(), oldKill, newKill);
+        }
+    }
+}
+
+void LivenessAnalysis::takeDirtyBlocks(SmallVectorImpl<BasicBlock*>& BBs)
+{
+    BBs.append(m_DirtyBBs.begin(), m_DirtyBBs.end());
+    m_DirtyBBs.clear();
 }
 
 void LivenessAnalysis::print_livein(raw_ostream& OS, BasicBlock* BB)
@@ -84,6 +84,28 @@ namespace IGC
         // Entry to compute Liveness
         void calculate(llvm::Function* F);
 
+        bool isCalculated() const { return m_LV != nullptr; }
+
+        // Incremental update. Passes that move instructions call these to
+        // keep BBLiveIns and KillInsts valid without recomputing liveness of
+        // the whole function. BBs whose liveness has changed are recorded and
+        // returned by takeDirtyBlocks(). Nothing is done if liveness has not
+        // been calculated yet.
+        //
+        // I has been moved from FromBB into another BB.
+        void instructionMoved(llvm::Instruction* I, llvm::BasicBlock* FromBB);
+        // Instructions within BB have been reordered. No instruction has been
+        // moved into or out of BB.
+        void instructionsReordered(llvm::BasicBlock* BB);
+
+        // Return BBs changed by incremental updates since the last call.
+        void takeDirtyBlocks(llvm::SmallVectorImpl<llvm::BasicBlock*>& BBs);
+
+        // Instructions have been added or erased, which incremental updates
+        // cannot handle. Renumber values and drop liveness, as runOnFunction()
+        // does; calculate() must be called again before liveness is used.
+        void reset();
+
         llvm::StringRef getPassName() const override { return "LivenessAnalysis"; }
 
         void getAnalysisUsage(llvm::AnalysisUsage& AU) const override
@@ -143,10 +165,16 @@ namespace IGC
         llvm::Function* m_F;
         WIAnalysis* m_WIA;  // Optional
 
+        // BBs changed by incremental updates
+        llvm::SmallSetVector<llvm::BasicBlock*, 16> m_DirtyBBs;
+
         void initValueIds();
         void setLiveIn(llvm::BasicBlock* BB, llvm::Value* V);
         void setLiveIn(llvm::BasicBlock* BB, int ValueID);
         void setKillInsts(llvm::Value* V, llvm::Instruction* kill);
+        void removeKillInsts(llvm::Value* V, llvm::Instruction* kill);
+        void addLiveness(llvm::Value* V, int ValueID, LiveVars::LVInfo* lvi);
+        void updateValue(llvm::Value* V, llvm::BasicBlock* StaleBB);
 
     public:
         // Value --> its ID  & ID --> Value
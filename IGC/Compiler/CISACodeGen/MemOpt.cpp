@@ -24,6 +24,7 @@ IN THE SOFTWARE.
 
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/Config/llvm-config.h"
+#include <llvm/ADT/Optional.h>
 #include <llvm/ADT/STLExtras.h>
 #include <llvmWrapper/Analysis/MemoryLocation.h>
 #include <llvmWrapper/Analysis/TargetLibraryInfo.h>
@@ -50,6 +51,7 @@ IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/WIAnalysis.hpp"
 #include "Compiler/CISACodeGen/MemOpt.h"
 #include "Probe/Assertion.h"
+#include <map>
 
 using namespace llvm;
 using namespace IGC;
@@ -90,11 +92,32 @@ namespace {
         typedef DenseMap<unsigned int, SmallVector<unsigned, 4> > ProfitVectorLengthsMap;
         ProfitVectorLengthsMap ProfitVectorLengths;
 
-        // A list of memory references (within a BB) with the distance to a
-        // previous memory reference in this list.
+        // A list of memory references (within a BB) with their positions in
+        // that BB.
         typedef std::vector<std::pair<Instruction*, unsigned> > MemRefListTy;
         typedef std::vector<Instruction*> TrivialMemRefListTy;
 
+        // Memory references of a BB are bucketed by their base addresses, i.e.
+        // pointers with the constant offset stripped, so that merging
+        // candidates of a leading load/store are looked up from its buckets
+        // instead of scanning all memory references following it. A load or
+        // store is placed into up to 2 buckets, one keyed by the SCEV of its
+        // base and the other keyed by its SymbolicPointer decomposition.
+        struct MemRefInfo {
+            int SCEVBucket = -1;
+            int SymBucket = -1;
+            int64_t SCEVOffset = 0;
+            int64_t SymOffset = 0;
+            // Number of bytes accessed. 0 if it's not a load or store.
+            uint64_t Size = 0;
+        };
+        // Per-BB state, indexed in parallel with MemRefListTy.
+        std::vector<MemRefInfo> MemRefInfos;
+        // Each bucket lists indices of memory references in the program order.
+        std::vector<std::vector<unsigned> > Buckets;
+        // Indices of memory references which may write to memory.
+        std::vector<unsigned> Writers;
+
     public:
         static char ID;
 
@@ -124,6 +147,13 @@ namespace {
         bool mergeStore(StoreInst* LeadingStore, MemRefListTy::iterator MI,
             MemRefListTy& MemRefs, TrivialMemRefListTy& ToOpt);
 
+        void buildMemRefBuckets(const MemRefListTy& MemRefs);
+        void collectMergeCandidates(unsigned Idx, const MemRefListTy& MemRefs,
+            SmallVectorImpl<unsigned>& Candidates) const;
+        bool getConstantOffset(unsigned From, unsigned To, bool IsLoad,
+            int64_t& Off) const;
+        Optional<bool> isDisjoint(unsigned A, unsigned B) const;
+
         unsigned getNumElements(Type* Ty) const {
             return Ty->isVectorTy() ? (unsigned)cast<IGCLLVM::FixedVectorType>(Ty)->getNumElements() : 1;
         }
@@ -191,11 +221,11 @@ namespace {
             return Builder.CreateBitCast(V, DestTy);
         }
 
-        bool isSafeToMergeLoad(const LoadInst* Ld,
-            const SmallVectorImpl<Instruction*>& checkList) const;
+        bool isSafeToMergeLoad(const LoadInst* Ld, unsigned LdIdx,
+            unsigned LeadingIdx, const MemRefListTy& MemRefs) const;
         bool isSafeToMergeStores(
             const SmallVectorImpl<std::tuple<StoreInst*, int64_t, MemRefListTy::iterator>>& Stores,
-            const SmallVectorImpl<Instruction*>& checkList) const;
+            unsigned From, unsigned To, MemRefListTy& MemRefs) const;
 
         bool shouldSkip(const Value* Ptr) const {
             PointerType* PtrTy = cast<PointerType>(Ptr->getType());
@@ -448,21 +478,17 @@ bool MemOpt::runOnFunction(Function& F) {
     bool Changed = false;
 
     for (Function::iterator BB = F.begin(), BBE = F.end(); BB != BBE; ++BB) {
-        // Find all instructions with memory reference. Remember the distance one
-        // by one.
+        // Find all instructions with memory reference. Remember their positions
+        // to bound the distance between merged ones.
         MemRefListTy MemRefs;
         TrivialMemRefListTy MemRefsToOptimize;
-        unsigned Distance = 0;
-        bool FirstMemRef = true;
-        for (auto BI = BB->begin(), BE = BB->end(); BI != BE; ++BI) {
+        unsigned Position = 0;
+        for (auto BI = BB->begin(), BE = BB->end(); BI != BE; ++BI, ++Position) {
             Instruction* I = &(*BI);
-            Distance += FirstMemRef ? 0 : 1;
             // Skip irrelevant instructions.
             if (shouldSkip(I))
                 continue;
-            MemRefs.push_back(std::make_pair(I, Distance));
-            Distance = 0;
-            FirstMemRef = false;
+            MemRefs.push_back(std::make_pair(I, Position));
         }
 
         // Skip BB with no more than 2 loads/stores.
@@ -474,6 +500,8 @@ bool MemOpt::runOnFunction(Function& F) {
         for (auto& M : MemRefs)
             Changed |= canonicalizeGEP64(M.first);
 
+        buildMemRefBuckets(MemRefs);
+
         for (auto MI = MemRefs.begin(), ME = MemRefs.end(); MI != ME; ++MI) {
             Instruction* I = MI->first;
 
@@ -493,6 +521,10 @@ bool MemOpt::runOnFunction(Function& F) {
             Changed |= optimizeGEP64(I);
     }
 
+    MemRefInfos.clear();
+    Buckets.clear();
+    Writers.clear();
+
     DL = nullptr;
     AA = nullptr;
     SE = nullptr;
@@ -553,8 +585,8 @@ bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
     if (NumElts > profitVec[0])
         return false;
 
-    const SCEV* LeadingPtr = SE->getSCEV(LeadingLoad->getPointerOperand());
-    if (isa<SCEVCouldNotCompute>(LeadingPtr))
+    unsigned LeadingIdx = unsigned(MI - MemRefs.begin());
+    if (MemRefInfos[LeadingIdx].SCEVBucket < 0)
         return false;
 
     SmallVector<std::tuple<LoadInst*, int64_t, MemRefListTy::iterator>, 8>
@@ -569,35 +601,28 @@ bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
     // - the right-side edge, the last load (mergable load with the maximal
     //   offset) to the leading load.
     //
-    // A check list is maintained from the leading load to the current
-    // instruction as the list of instrucitons which may read or write memory but
-    // is not able to be merged into that leading load. Since we merge
-    // consecutive loads into the leading load, that check list is accumulated
-    // and each consecutive load needs to check against that accumulated check
-    // list.
+    // Candidates are looked up from the buckets of the leading load, i.e. only
+    // loads with a constant offset to the leading load are visited. Other
+    // memory references between the leading load and a candidate are checked
+    // through the list of writers in this BB. Since we merge consecutive loads
+    // into the leading load, each candidate is checked against all writers
+    // from the leading load.
 
     // Two edges of the region where loads are merged into.
     int64_t HighestOffset = LdSize;
     int64_t LowestOffset = 0;
 
-    // List of instructions need dependency check.
-    SmallVector<Instruction*, 8> CheckList;
-
-    unsigned Limit = IGC_GET_FLAG_VALUE(MemOptWindowSize);
-    auto ME = MemRefs.end();
-    for (++MI; Limit != 0 && MI != ME; Limit -= MI->second, ++MI) {
-        // Bail out if the limit is reached.
-        if (Limit < MI->second)
-            break;
+    SmallVector<unsigned, 16> Candidates;
+    collectMergeCandidates(LeadingIdx, MemRefs, Candidates);
 
+    for (unsigned Idx : Candidates) {
+        MI = MemRefs.begin() + Idx;
         Instruction* NextMemRef = MI->first;
 
         // Skip already merged one.
         if (!NextMemRef)
             continue;
 
-        CheckList.push_back(NextMemRef);
-
         LoadInst* NextLoad = dyn_cast<LoadInst>(NextMemRef);
 
         // Skip non-load instruction.
@@ -613,44 +638,16 @@ bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
         if (!NextLoad->isUnordered())
             break;
 
-        // Skip if that load is from different address spaces.
-        if (NextLoad->getPointerAddressSpace() !=
-            LeadingLoad->getPointerAddressSpace())
-            continue;
-
         Type* NextLoadType = NextLoad->getType();
 
         // Skip if they have different sizes.
         if (!hasSameSize(NextLoadType->getScalarType(), LeadingLoadScalarType))
             continue;
 
-        const SCEV* NextPtr = SE->getSCEV(NextLoad->getPointerOperand());
-        if (isa<SCEVCouldNotCompute>(NextPtr))
-            continue;
-
-        int64_t Off = 0;
-        const SCEVConstant* Offset
-            = dyn_cast<SCEVConstant>(SE->getMinusSCEV(NextPtr, LeadingPtr));
         // Skip load with non-constant distance.
-        if (!Offset) {
-
-            SymbolicPointer LeadingSymPtr;
-            SymbolicPointer NextSymPtr;
-            if (SymbolicPointer::decomposePointer(LeadingLoad->getPointerOperand(),
-                LeadingSymPtr, CGC) ||
-                SymbolicPointer::decomposePointer(NextLoad->getPointerOperand(),
-                    NextSymPtr, CGC) ||
-                NextSymPtr.getConstantOffset(LeadingSymPtr, Off)) {
-                continue;
-            }
-            else {
-                if (!AllowNegativeSymPtrsForLoad && LeadingSymPtr.Offset < 0)
-                    continue;
-            }
-        }
-        else {
-            Off = Offset->getValue()->getSExtValue();
-        }
+        int64_t Off = 0;
+        if (!getConstantOffset(LeadingIdx, Idx, /*IsLoad=*/true, Off))
+            continue;
 
         unsigned NextLoadSize = unsigned(DL->getTypeStoreSize(NextLoadType));
 
@@ -681,12 +678,9 @@ bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
         LowestOffset = newLowestOffset;
         NumElts = static_cast<unsigned>(newNumElts);
 
-        // This load is to be merged. Remove it from check list.
-        CheckList.pop_back();
-
         // If the candidate load cannot be safely merged, merge mergable loads
         // currently found.
-        if (!isSafeToMergeLoad(NextLoad, CheckList))
+        if (!isSafeToMergeLoad(NextLoad, Idx, LeadingIdx, MemRefs))
             break;
 
         LoadsToMerge.push_back(std::make_tuple(NextLoad, Off, MI));
@@ -843,9 +837,6 @@ bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
         RecursivelyDeleteTriviallyDeadInstructions(Ptr);
         // Mark it as already merged.
         std::get<2>(I)->first = nullptr;
-        // Checking zero distance is intentionally omitted here due to the first
-        // memory access won't be able to be checked again.
-        std::get<2>(I)->second -= 1;
     }
 
     return true;
@@ -889,8 +880,8 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
     if (NumElts >= profitVec[0])
         return false;
 
-    const SCEV* LeadingPtr = SE->getSCEV(LeadingStore->getPointerOperand());
-    if (isa<SCEVCouldNotCompute>(LeadingPtr))
+    unsigned LeadingIdx = unsigned(MI - MemRefs.begin());
+    if (MemRefInfos[LeadingIdx].SCEVBucket < 0)
         return false;
 
     SmallVector<std::tuple<StoreInst*, int64_t, MemRefListTy::iterator>, 8>
@@ -905,35 +896,32 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
     // - the right-side edge, the last store (mergable store with the maximal
     //   offset) to the leading store.
     //
-    // A check list is maintained from a previous tailing mergable store to the
-    // new tailing store instruction because all those stores will be merged into
-    // the new tailing store. That is, we need to check all mergable stores each
-    // time a "new" tailing store is found. However, that check list needs not
-    // accumulating as we already check that all stores to be merged are safe to
-    // be merged into the "previous" tailing store.
+    // Memory references from a previous tailing mergable store to the new
+    // tailing store instruction are checked because all those stores will be
+    // merged into the new tailing store. That is, we need to check all mergable
+    // stores each time a "new" tailing store is found. However, references
+    // before the previous tailing store need not checking again as we already
+    // check that all stores to be merged are safe to be merged into the
+    // "previous" tailing store.
 
     // Two edges of the region where stores are merged into.
     int64_t LastToLeading = StSize;
     int64_t LeadingToFirst = 0;
 
-    // List of instructions need dependency check.
-    SmallVector<Instruction*, 8> CheckList;
+    // Index of the previous tailing store.
+    unsigned PrevTailingIdx = LeadingIdx;
 
-    unsigned Limit = IGC_GET_FLAG_VALUE(MemOptWindowSize);
-    auto ME = MemRefs.end();
-    for (++MI; Limit != 0 && MI != ME; Limit -= MI->second, ++MI) {
-        // Bail out if the limit is reached.
-        if (Limit < MI->second)
-            break;
+    SmallVector<unsigned, 16> Candidates;
+    collectMergeCandidates(LeadingIdx, MemRefs, Candidates);
 
+    for (unsigned Idx : Candidates) {
+        MI = MemRefs.begin() + Idx;
         Instruction* NextMemRef = MI->first;
 
         // Skip already merged one.
         if (!NextMemRef)
             continue;
 
-        CheckList.push_back(NextMemRef);
-
         StoreInst* NextStore = dyn_cast<StoreInst>(NextMemRef);
         // Skip non-store instruction.
         if (!NextStore)
@@ -948,11 +936,6 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
         if (!NextStore->isUnordered())
             break;
 
-        // Skip if that store is from different address spaces.
-        if (NextStore->getPointerAddressSpace() !=
-            LeadingStore->getPointerAddressSpace())
-            continue;
-
         Value* NextStoreVal = NextStore->getValueOperand();
         Type* NextStoreType = NextStoreVal->getType();
 
@@ -960,27 +943,10 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
         if (!hasSameSize(NextStoreType->getScalarType(), LeadingStoreScalarType))
             continue;
 
-        const SCEV* NextPtr = SE->getSCEV(NextStore->getPointerOperand());
-        if (isa<SCEVCouldNotCompute>(NextPtr))
-            continue;
-
-        int64_t Off = 0;
-        const SCEVConstant* Offset
-            = dyn_cast<SCEVConstant>(SE->getMinusSCEV(NextPtr, LeadingPtr));
         // Skip store with non-constant distance.
-        if (!Offset) {
-
-            SymbolicPointer LeadingSymPtr;
-            SymbolicPointer NextSymPtr;
-            if (SymbolicPointer::decomposePointer(
-                LeadingStore->getPointerOperand(), LeadingSymPtr, CGC) ||
-                SymbolicPointer::decomposePointer(NextStore->getPointerOperand(),
-                    NextSymPtr, CGC) ||
-                NextSymPtr.getConstantOffset(LeadingSymPtr, Off))
-                continue;
-        }
-        else
-            Off = Offset->getValue()->getSExtValue();
+        int64_t Off = 0;
+        if (!getConstantOffset(LeadingIdx, Idx, /*IsLoad=*/false, Off))
+            continue;
 
         // By assuming dead store elimination always works correctly, if the store
         // on the same location is observed again, that is probably because there
@@ -1000,16 +966,12 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
         if (NumElts > profitVec[0])
             break;
 
-        // This store is to be merged. Remove it from check list.
-        CheckList.pop_back();
-
         // If the candidate store cannot be safely merged, merge mergable stores
         // currently found.
-        if (!isSafeToMergeStores(StoresToMerge, CheckList))
+        if (!isSafeToMergeStores(StoresToMerge, PrevTailingIdx, Idx, MemRefs))
             break;
 
-        // Clear check list.
-        CheckList.clear();
+        PrevTailingIdx = Idx;
 
         StoresToMerge.push_back(std::make_tuple(NextStore, Off, MI));
         if (Off > 0)
@@ -1137,6 +1099,17 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
     Instruction* NewOne = NewStore;
     std::swap(ToOpt.back(), NewOne);
 
+    // The new store takes the slot of the tailing store but accesses from the
+    // pointer of the first store.
+    unsigned FirstIdx = unsigned(std::get<2>(StoresToMerge.front()) - MemRefs.begin());
+    for (auto& I : StoresToMerge) {
+        if (std::get<0>(I) != TailingStore)
+            continue;
+        unsigned TailingIdx = unsigned(std::get<2>(I) - MemRefs.begin());
+        MemRefInfos[TailingIdx] = MemRefInfos[FirstIdx];
+        MemRefInfos[TailingIdx].Size = DL->getTypeStoreSize(NewStoreType);
+    }
+
     for (auto& I : StoresToMerge) {
         StoreInst* ST = cast<StoreInst>(std::get<0>(I));
         Value* Ptr = ST->getPointerOperand();
@@ -1154,29 +1127,198 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
             // Otherwise the sequence could be merged to sequence L4567, S1234 with
             // unordered L4,S4 accesses.
             std::get<2>(I)->first = NewStore;
-        else {
+        else
             // Mark it as already merged.
             std::get<2>(I)->first = nullptr;
-            // Checking zero distance is intentionally omitted here due to the first
-            // memory access won't be able to be checked again.
-            std::get<2>(I)->second -= 1;
-        }
 
     }
 
     return true;
 }
 
+/// buildMemRefBuckets() - bucket memory references of a BB by their base
+/// addresses and collect ones which may write to memory.
+void MemOpt::buildMemRefBuckets(const MemRefListTy& MemRefs) {
+    MemRefInfos.assign(MemRefs.size(), MemRefInfo());
+    Buckets.clear();
+    Writers.clear();
+
+    DenseMap<std::pair<const SCEV*, unsigned>, int> SCEVBuckets;
+    std::map<std::vector<uint64_t>, int> SymBuckets;
+
+    for (unsigned i = 0, e = MemRefs.size(); i != e; ++i) {
+        Instruction* I = MemRefs[i].first;
+        if (I->mayWriteToMemory())
+            Writers.push_back(i);
+
+        Value* Ptr = nullptr;
+        Type* ValTy = nullptr;
+        if (LoadInst * LD = dyn_cast<LoadInst>(I)) {
+            Ptr = LD->getPointerOperand();
+            ValTy = LD->getType();
+        }
+        else if (StoreInst * ST = dyn_cast<StoreInst>(I)) {
+            Ptr = ST->getPointerOperand();
+            ValTy = ST->getValueOperand()->getType();
+        }
+        else
+            continue;
+
+        unsigned AS = Ptr->getType()->getPointerAddressSpace();
+        MemRefInfo& Info = MemRefInfos[i];
+        Info.Size = DL->getTypeStoreSize(ValTy);
+
+        const SCEV* S = SE->getSCEV(Ptr);
+        if (!isa<SCEVCouldNotCompute>(S)) {
+            // Strip the constant offset, which is always the first operand of
+            // an add expression.
+            const SCEV* Base = S;
+            if (auto Add = dyn_cast<SCEVAddExpr>(S)) {
+                if (auto C = dyn_cast<SCEVConstant>(Add->getOperand(0))) {
+                    Info.SCEVOffset = C->getValue()->getSExtValue();
+                    Base = SE->getMinusSCEV(S, C);
+                }
+            }
+            auto R = SCEVBuckets.insert(
+                std::make_pair(std::make_pair(Base, AS), int(Buckets.size())));
+            if (R.second)
+                Buckets.emplace_back();
+            Info.SCEVBucket = R.first->second;
+            Buckets[Info.SCEVBucket].push_back(i);
+        }
+
+        SymbolicPointer SymPtr;
+        if (SymbolicPointer::decomposePointer(Ptr, SymPtr, CGC) ||
+            !SymPtr.BasePtr)
+            continue;
+
+        // Null base pointers are treated as the same base. Terms are sorted
+        // so that the key doesn't depend on the decomposition order.
+        std::vector<std::pair<uint64_t, uint64_t> > Terms;
+        for (auto& T : SymPtr.Terms)
+            Terms.push_back(std::make_pair(
+                uint64_t(reinterpret_cast<uintptr_t>(T.Idx.getOpaqueValue())),
+                uint64_t(T.Scale)));
+        std::sort(Terms.begin(), Terms.end());
+
+        std::vector<uint64_t> Key;
+        Key.push_back(AS);
+        Key.push_back(isa<ConstantPointerNull>(SymPtr.BasePtr) ? 0 :
+            uint64_t(reinterpret_cast<uintptr_t>(SymPtr.BasePtr)));
+        for (auto& T : Terms) {
+            Key.push_back(T.first);
+            Key.push_back(T.second);
+        }
+
+        auto R = SymBuckets.insert(std::make_pair(Key, int(Buckets.size())));
+        if (R.second)
+            Buckets.emplace_back();
+        Info.SymBucket = R.first->second;
+        Info.SymOffset = SymPtr.Offset;
+        Buckets[Info.SymBucket].push_back(i);
+    }
+}
+
+/// collectMergeCandidates() - collect memory references following the
+/// specified one in the program order and sharing a bucket with it. Only
+/// ones within the window from it are collected to avoid creating long
+/// liveranges.
+void MemOpt::collectMergeCandidates(unsigned Idx, const MemRefListTy& MemRefs,
+    SmallVectorImpl<unsigned>& Candidates) const {
+    unsigned Limit = IGC_GET_FLAG_VALUE(MemOptWindowSize);
+    unsigned Pos = MemRefs[Idx].second;
+    const MemRefInfo& Info = MemRefInfos[Idx];
+
+    for (int B : { Info.SCEVBucket, Info.SymBucket }) {
+        if (B < 0)
+            continue;
+        const std::vector<unsigned>& Bucket = Buckets[B];
+        auto BI = std::upper_bound(Bucket.begin(), Bucket.end(), Idx);
+        for (auto BE = Bucket.end(); BI != BE; ++BI) {
+            if (MemRefs[*BI].second - Pos > Limit)
+                break;
+            Candidates.push_back(*BI);
+        }
+    }
+
+    // Merge candidates from both buckets into the program order.
+    std::sort(Candidates.begin(), Candidates.end());
+    Candidates.erase(std::unique(Candidates.begin(), Candidates.end()),
+        Candidates.end());
+}
+
+/// getConstantOffset() - get the constant offset from the memory reference
+/// 'From' to the memory reference 'To'. Return false if they don't share a
+/// bucket.
+bool MemOpt::getConstantOffset(unsigned From, unsigned To, bool IsLoad,
+    int64_t& Off) const {
+    const MemRefInfo& A = MemRefInfos[From];
+    const MemRefInfo& B = MemRefInfos[To];
+
+    if (A.SCEVBucket >= 0 && A.SCEVBucket == B.SCEVBucket) {
+        Off = B.SCEVOffset - A.SCEVOffset;
+        return true;
+    }
+
+    if (A.SymBucket >= 0 && A.SymBucket == B.SymBucket) {
+        if (IsLoad && !AllowNegativeSymPtrsForLoad && A.SymOffset < 0)
+            return false;
+        Off = B.SymOffset - A.SymOffset;
+        return true;
+    }
+
+    return false;
+}
+
+/// isDisjoint() - check whether the specified memory references access
+/// disjoint locations when they share a bucket, i.e. they are known to access
+/// from the same base address. Return None if that cannot be decided from
+/// their offsets.
+Optional<bool> MemOpt::isDisjoint(unsigned A, unsigned B) const {
+    const MemRefInfo& IA = MemRefInfos[A];
+    const MemRefInfo& IB = MemRefInfos[B];
+
+    if (!IA.Size || !IB.Size)
+        return None;
+
+    int64_t OffA = 0, OffB = 0;
+    if (IA.SCEVBucket >= 0 && IA.SCEVBucket == IB.SCEVBucket) {
+        OffA = IA.SCEVOffset;
+        OffB = IB.SCEVOffset;
+    }
+    else if (IA.SymBucket >= 0 && IA.SymBucket == IB.SymBucket) {
+        OffA = IA.SymOffset;
+        OffB = IB.SymOffset;
+    }
+    else
+        return None;
+
+    return OffA + int64_t(IA.Size) <= OffB || OffB + int64_t(IB.Size) <= OffA;
+}
+
 /// isSafeToMergeLoad() - checks whether there is any alias from the specified
-/// load to any one in the check list, which may write to that location.
-bool MemOpt::isSafeToMergeLoad(const LoadInst* Ld,
-    const SmallVectorImpl<Instruction*>& CheckList) const {
+/// load to any writer between the leading load and it.
+bool MemOpt::isSafeToMergeLoad(const LoadInst* Ld, unsigned LdIdx,
+    unsigned LeadingIdx, const MemRefListTy& MemRefs) const {
     MemoryLocation A = MemoryLocation::get(Ld);
 
-    for (auto* I : CheckList) {
-        // Skip instructions never writing to memory.
-        if (!I->mayWriteToMemory())
+    auto WI = std::upper_bound(Writers.begin(), Writers.end(), LeadingIdx);
+    for (auto WE = Writers.end(); WI != WE && *WI < LdIdx; ++WI) {
+        Instruction* I = MemRefs[*WI].first;
+
+        // Skip already merged one.
+        if (!I)
+            continue;
+
+        // Bail out on volatile or ordered loads.
+        if (isa<LoadInst>(I))
+            return false;
+
+        if (Optional<bool> Disjoint = isDisjoint(LdIdx, *WI)) {
+            if (!*Disjoint)
+                return false;
             continue;
+        }
 
         MemoryLocation B = getLocation(I);
 
@@ -1188,20 +1330,38 @@ bool MemOpt::isSafeToMergeLoad(const LoadInst* Ld,
 }
 
 /// isSafeToMergeStores() - checks whether there is any alias from the
-/// specified store set to any one in the check list, which may read/write to
-/// that location.
+/// specified store set to any memory reference between 'From' and 'To', which
+/// may read/write to that location.
 bool MemOpt::isSafeToMergeStores(
     const SmallVectorImpl<std::tuple<StoreInst*, int64_t, MemRefListTy::iterator> >& Stores,
-    const SmallVectorImpl<Instruction*>& CheckList) const {
-    // Arrange CheckList as the outer loop to favor the case where there are
-    // back-to-back stores only.
-    for (auto* I : CheckList) {
+    unsigned From, unsigned To, MemRefListTy& MemRefs) const {
+    // Arrange memory references as the outer loop to favor the case where
+    // there are back-to-back stores only.
+    for (unsigned i = From + 1; i < To; ++i) {
+        Instruction* I = MemRefs[i].first;
+
+        // Skip already merged one.
+        if (!I)
+            continue;
+
         if (I->getMetadata(LLVMContext::MD_invariant_load))
             continue;
 
+        // Bail out on volatile or ordered stores.
+        if (StoreInst * ST = dyn_cast<StoreInst>(I))
+            if (!ST->isSimple() || !ST->isUnordered())
+                return false;
+
         MemoryLocation A = getLocation(I);
 
         for (auto& S : Stores) {
+            unsigned SIdx = unsigned(std::get<2>(S) - MemRefs.begin());
+            if (Optional<bool> Disjoint = isDisjoint(i, SIdx)) {
+                if (!*Disjoint)
+                    return false;
+                continue;
+            }
+
             MemoryLocation B = getLocation(std::get<0>(S));
 
             if (!A.Ptr || !B.Ptr || AA->alias(A, B))
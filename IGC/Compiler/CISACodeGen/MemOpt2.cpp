@@ -37,6 +37,7 @@ IN THE SOFTWARE.
 #include "GenISAIntrinsics/GenIntrinsics.h"
 
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
 #include "Compiler/IGCPassSupport.h"
 #include "Compiler/MetaDataUtilsWrapper.h"
 
@@ -83,6 +84,10 @@ namespace {
             AU.addRequired<AAResultsWrapperPass>();
             AU.addRequired<CodeGenContextWrapper>();
             AU.addRequired<MetaDataUtilsWrapper>();
+            // Instructions are only reordered within a BB, and the register
+            // pressure estimate is updated if it is available.
+            AU.addPreserved<LivenessAnalysis>();
+            AU.addPreserved<RegisterEstimator>();
         }
 
         bool clusterSampler(BasicBlock* BB);
@@ -200,7 +205,6 @@ FunctionPass* createMemOpt2Pass(int MLT) {
 IGC_INITIALIZE_PASS_BEGIN(MemOpt2, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
 IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
 IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
-IGC_INITIALIZE_PASS_DEPENDENCY(RegisterPressureEstimate)
 IGC_INITIALIZE_PASS_END(MemOpt2, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 bool MemOpt2::runOnFunction(Function& F) {
@@ -213,6 +217,8 @@ bool MemOpt2::runOnFunction(Function& F) {
     IGC::CodeGenContext* cgCtx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
     DL = &F.getParent()->getDataLayout();
     AA = &getAnalysis<AAResultsWrapperPass>().getAAResults();
+    LivenessAnalysis* LVA = getAnalysisIfAvailable<LivenessAnalysis>();
+    RegisterEstimator* RPE = getAnalysisIfAvailable<RegisterEstimator>();
 
     bool Changed = false;
     for (auto& BB : F) {
@@ -233,7 +239,12 @@ bool MemOpt2::runOnFunction(Function& F) {
         // TODO: Revise that later
         // considering sampler and load together.
         if (!LocalChanged && cgCtx->type == ShaderType::OPENCL_SHADER)
-            Changed |= clusterLoad(&BB);
+            LocalChanged = clusterLoad(&BB);
+
+        if (LocalChanged && RPE)
+            RPE->instructionsReordered(&BB);
+        else if (LocalChanged && LVA)
+            LVA->instructionsReordered(&BB);
         Changed |= LocalChanged;
     }
 
@@ -1248,6 +1248,7 @@ CVariable* CPixelShader::GetCurrentPhaseCounter()
 
 bool CPixelShader::CompileSIMDSize(SIMDMode simdMode, EmitPass& EP, llvm::Function& F)
 {
+    m_simdSizeDeferred = false;
     if (!CompileSIMDSizeInCommon(simdMode))
         return false;
 
@@ -1333,9 +1334,14 @@ bool CPixelShader::CompileSIMDSize(SIMDMode simdMode, EmitPass& EP, llvm::Functi
             return true;
         }
         CShader* simd8Program = m_parent->GetShader(SIMDMode::SIMD8);
-        if (simd8Program != nullptr && simd8Program->ProgramOutput()->m_scratchSpaceUsedBySpills > 0)
+        if (simd8Program != nullptr && simd8Program->GetEncoder().IsCompilePending())
+        {
+            // SIMD8 is still compiling on the VISACompileQueue, IsSIMDSizeMoot
+            // checks its spills before the SIMD16 results are used.
+            m_simdSizeDeferred = true;
+        }
+        else if (!NarrowerSIMDAllows(simdMode, EP.m_ShaderDispatchMode))
         {
-            ctx->SetSIMDInfo(SIMD_SKIP_REGPRES, simdMode, EP.m_ShaderDispatchMode);
             return false;
         }
     }
@@ -1351,12 +1357,12 @@ bool CPixelShader::CompileSIMDSize(SIMDMode simdMode, EmitPass& EP, llvm::Functi
             return true;
         }
 
+        // While SIMD16 is still compiling on the VISACompileQueue, the rules
+        // depending on its results are left to IsSIMDSizeMoot.
         CShader* simd16Program = m_parent->GetShader(SIMDMode::SIMD16);
-        if ((simd16Program == nullptr ||
-            simd16Program->ProgramOutput()->m_programBin == 0 ||
-            simd16Program->ProgramOutput()->m_scratchSpaceUsedBySpills > 0))
+        bool deferred = simd16Program != nullptr && simd16Program->GetEncoder().IsCompilePending();
+        if (!deferred && !NarrowerSIMDAllows(simdMode, EP.m_ShaderDispatchMode))
         {
-            ctx->SetSIMDInfo(SIMD_SKIP_REGPRES, simdMode, EP.m_ShaderDispatchMode);
             return false;
         }
 
@@ -1390,43 +1396,96 @@ bool CPixelShader::CompileSIMDSize(SIMDMode simdMode, EmitPass& EP, llvm::Functi
         }
 
         Simd32ProfitabilityAnalysis& PA = EP.getAnalysis<Simd32ProfitabilityAnalysis>();
-        if (PA.isSimd32Profitable())
+        m_simd32Profitable = PA.isSimd32Profitable();
+        m_simdSizeDeferred = deferred;
+        if (m_simd32Profitable || deferred)
         {
             return true;
         }
-        else
+        return Simd32StallAllows(EP.m_ShaderDispatchMode);
+    }
+    return true;
+}
+
+// Rules of CompileSIMDSize that depend on the narrower variants: SIMD16 is
+// skipped if SIMD8 spilled, SIMD32 if SIMD16 did not compile or spilled.
+bool CPixelShader::NarrowerSIMDAllows(SIMDMode simdMode, ShaderDispatchMode shaderMode)
+{
+    CodeGenContext* ctx = GetContext();
+    if (simdMode == SIMDMode::SIMD16)
+    {
+        CShader* simd8Program = m_parent->GetShader(SIMDMode::SIMD8);
+        if (simd8Program != nullptr && simd8Program->ProgramOutput()->m_scratchSpaceUsedBySpills > 0)
         {
-            ctx->SetSIMDInfo(SIMD_SKIP_PERF, simdMode, EP.m_ShaderDispatchMode);
+            ctx->SetSIMDInfo(SIMD_SKIP_REGPRES, simdMode, shaderMode);
+            return false;
         }
-
-        if (simd16Program && static_cast<CPixelShader*>(simd16Program)->m_sendStallCycle == 0)
+    }
+    else if (simdMode == SIMDMode::SIMD32)
+    {
+        CShader* simd16Program = m_parent->GetShader(SIMDMode::SIMD16);
+        if ((simd16Program == nullptr ||
+            simd16Program->ProgramOutput()->m_programBin == 0 ||
+            simd16Program->ProgramOutput()->m_scratchSpaceUsedBySpills > 0))
         {
-            // simd16 doesn't have any latency issue, no need to try simd32
-            ctx->SetSIMDInfo(SIMD_SKIP_STALL, simdMode, EP.m_ShaderDispatchMode);
+            ctx->SetSIMDInfo(SIMD_SKIP_REGPRES, simdMode, shaderMode);
             return false;
         }
+    }
+    return true;
+}
+
+// Decides SIMD32 from the send stalls of SIMD16 when
+// Simd32ProfitabilityAnalysis did not find it profitable.
+bool CPixelShader::Simd32StallAllows(ShaderDispatchMode shaderMode)
+{
+    CodeGenContext* ctx = GetContext();
+    const SIMDMode simdMode = SIMDMode::SIMD32;
+    ctx->SetSIMDInfo(SIMD_SKIP_PERF, simdMode, shaderMode);
+
+    CShader* simd16Program = m_parent->GetShader(SIMDMode::SIMD16);
+    if (simd16Program && static_cast<CPixelShader*>(simd16Program)->m_sendStallCycle == 0)
+    {
+        // simd16 doesn't have any latency issue, no need to try simd32
+        ctx->SetSIMDInfo(SIMD_SKIP_STALL, simdMode, shaderMode);
+        return false;
+    }
+
+    if (ctx->platform.psSimd32SkipStallHeuristic() && ctx->m_DriverInfo.AlwaysEnableSimd32())
+    {
+        return true;
+    }
 
-        if (ctx->platform.psSimd32SkipStallHeuristic() && ctx->m_DriverInfo.AlwaysEnableSimd32())
+    if (simd16Program)
+    {
+        uint sendStallCycle = static_cast<CPixelShader*>(simd16Program)->m_sendStallCycle;
+        uint staticCycle = static_cast<CPixelShader*>(simd16Program)->m_staticCycle;
+        if (sendStallCycle / (float)staticCycle > 0.4)
         {
             return true;
         }
-
-        if (simd16Program)
+        else
         {
-            uint sendStallCycle = static_cast<CPixelShader*>(simd16Program)->m_sendStallCycle;
-            uint staticCycle = static_cast<CPixelShader*>(simd16Program)->m_staticCycle;
-            if (sendStallCycle / (float)staticCycle > 0.4)
-            {
-                return true;
-            }
-            else
-            {
-                ctx->SetSIMDInfo(SIMD_SKIP_STALL, simdMode, EP.m_ShaderDispatchMode);
-            }
+            ctx->SetSIMDInfo(SIMD_SKIP_STALL, simdMode, shaderMode);
         }
+    }
+    return false;
+}
+
+bool CPixelShader::IsSIMDSizeMoot()
+{
+    if (!m_simdSizeDeferred)
+    {
         return false;
     }
-    return true;
+    m_simdSizeDeferred = false;
+    if (!NarrowerSIMDAllows(m_dispatchSize, m_ShaderDispatchMode))
+    {
+        return true;
+    }
+    return m_dispatchSize == SIMDMode::SIMD32 &&
+        !m_simd32Profitable &&
+        !Simd32StallAllows(m_ShaderDispatchMode);
 }
 
 void linkProgram(const SProgramOutput& cps, const SProgramOutput& ps, SProgramOutput& linked)
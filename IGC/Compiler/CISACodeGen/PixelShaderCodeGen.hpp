@@ -83,6 +83,7 @@ public:
     void PreAnalysisPass() override;
     void AddEpilogue(llvm::ReturnInst* ret) override;
     bool CompileSIMDSize(SIMDMode simdMode, EmitPass& EP, llvm::Function& F) override;
+    bool IsSIMDSizeMoot() override;
     void ExtractGlobalVariables() override;
 
     void        AllocatePSPayload();
@@ -135,6 +136,8 @@ protected:
 
 private:
     PSSignature::DispatchSignature& GetDispatchSignature();
+    bool NarrowerSIMDAllows(SIMDMode simdMode, ShaderDispatchMode shaderMode);
+    bool Simd32StallAllows(ShaderDispatchMode shaderMode);
     USC::GFX3DSTATE_SF_ATTRIBUTE_ACTIVE_COMPONENT GetActiveComponents(uint attribute) const;
 
     CVariable* m_R1;
@@ -174,6 +177,8 @@ private:
     uint       m_ConstantInterpolationMask = 0;
 
     bool       m_HasDiscard;
+    /// result of Simd32ProfitabilityAnalysis, kept for deferred SIMD32 checks
+    bool       m_simd32Profitable = false;
 
     // Multi phase shader properties
     PixelShaderPhaseType m_phase;
@@ -174,6 +174,9 @@ namespace IGC {
             AU.addRequired<CodeGenContextWrapper>();
             AU.addRequired<LivenessAnalysis>();
             AU.addRequired<RegisterEstimator>();
+            // Both are kept up to date as each BB is scheduled.
+            AU.addPreserved<LivenessAnalysis>();
+            AU.addPreserved<RegisterEstimator>();
         }
 
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_DUMP)
@@ -968,7 +971,13 @@ bool PreRAScheduler::runOnFunction(Function& F) {
 
         //dumpPriorityQueueContents();
         // Schedule until we process the entire DDG
-        Changed |= ScheduleReadyNodes(BB, RPTracker);
+        if (ScheduleReadyNodes(BB, RPTracker))
+        {
+            // Live-in and live-out of BB do not change, so only BB's
+            // register pressure needs to be updated.
+            m_pRPE->instructionsReordered(BB);
+            Changed = true;
+        }
     }
 
     if (Changed)
@@ -983,6 +992,7 @@ bool PreRAScheduler::fixExtractValue(Function& F) const {
     // Find 'extractvalue' and pull them just after the definition of their
     // aggregation source.
     for (auto& BB : F) {
+        bool BBChanged = false;
         for (auto BI = BB.begin(), BE = BB.end(); BI != BE; /*EMPTY*/) {
             auto EVI = dyn_cast<ExtractValueInst>(&*BI++);
             if (!EVI)
@@ -992,6 +1002,10 @@ bool PreRAScheduler::fixExtractValue(Function& F) const {
                 continue;
             // Move this 'extractvalue' just after the aggregate value.
             EVI->moveBefore(&*std::next(I->getIterator()));
+            BBChanged = true;
+        }
+        if (BBChanged) {
+            m_pRPE->instructionsReordered(&BB);
             Changed = true;
         }
     }
@@ -203,111 +203,172 @@ void RegisterEstimator::calculate(bool doRPEPerInst)
     m_BBMaxLiveVirtRegs.reserve(mapCap2);
     m_BBLiveInVirtRegs.reserve(mapCap2);
 
-    BBLiveInMap& BBLiveIns = m_LVA->BBLiveIns;
-    ValueToIntMap& ValueIds = m_LVA->ValueIds;
-    ValueToValueVecMap& KillInfo = m_LVA->KillInsts;
+    m_RPEPerInst = doRPEPerInst;
     for (Function::iterator BI = m_F->begin(), BE = m_F->end();
         BI != BE; ++BI)
     {
         BasicBlock* BB = &*BI;
-        SBitVector& BitVec = BBLiveIns[BB];
-        RegUsage nCurrLiveIns;
+        RegUsage& bbMaxRegs = calculateBB(BB, doRPEPerInst);
 
-        // Calculate the number of live-ins at entry to BB
-        for (SBitVector::iterator I = BitVec.begin(), E = BitVec.end();
-            I != E; ++I)
+        for (int i = 0; i < REGISTER_CLASS_TOTAL; ++i)
         {
-            int id = *I;
-            if (const RegUse * pregs = getRegUse(id))
+            RegUse& ruse_max = m_MaxRegs.allUses[(RegClass)i];
+            RegUse& ruse_curr = bbMaxRegs.allUses[(RegClass)i];
+            if (ruse_max < ruse_curr)
             {
-                nCurrLiveIns.allUses[pregs->rClass] += (*pregs);
+                ruse_max = ruse_curr;
             }
         }
+    }
 
-        m_BBLiveInVirtRegs.insert(std::make_pair(BB, nCurrLiveIns));
+#if 0
+    // Sort LiveVirtRegs in decreasing order. As Map cannot be sorted, a list
+    // is used for sorting it.
+    for (ValueToIntMap::iterator I = m_LiveVirtRegs.begin(),
+        E = m_LiveVirtRegs.end();
+        I != E; ++I)
+    {
+        Value* V = I->first;
+        m_AllValues.push_back(V);
+    }
+    std::sort(m_AllValues.begin(), m_AllValues.end(), isNRegGreater(m_LiveVirtRegs));
+#endif
+    int dumpLevel = IGC_GET_FLAG_VALUE(RPEDumpLevel);
+    if (dumpLevel > FLAG_LEVEL_0)
+    {
+        print(errs(), dumpLevel);
+    }
+}
 
-        RegUsage bbMaxRegs = nCurrLiveIns;
+// Calculate register pressure of BB. Return BB's max register usage.
+RegUsage& RegisterEstimator::calculateBB(BasicBlock* BB, bool doRPEPerInst)
+{
+    ValueToIntMap& ValueIds = m_LVA->ValueIds;
+    ValueToValueVecMap& KillInfo = m_LVA->KillInsts;
+    SBitVector& BitVec = m_LVA->BBLiveIns[BB];
+    RegUsage nCurrLiveIns;
 
-        // Calculate the number of lives for each instruction of this BB.
-        // For simplicity, the number of lives are the one that is at exit
-        // of the instruction, not at entry (nor the largest of the both).
-        for (BasicBlock::iterator I = BB->begin(), E = BB->end(); I != E; ++I)
+    // Calculate the number of live-ins at entry to BB
+    for (SBitVector::iterator I = BitVec.begin(), E = BitVec.end();
+        I != E; ++I)
+    {
+        int id = *I;
+        if (const RegUse * pregs = getRegUse(id))
         {
-            Instruction* Inst = &*I;
-            ValueToIntMap::iterator IDef = ValueIds.find(Inst);
-            if (IDef != ValueIds.end())
+            nCurrLiveIns.allUses[pregs->rClass] += (*pregs);
+        }
+    }
+
+    m_BBLiveInVirtRegs[BB] = nCurrLiveIns;
+
+    RegUsage bbMaxRegs = nCurrLiveIns;
+
+    // Calculate the number of lives for each instruction of this BB.
+    // For simplicity, the number of lives are the one that is at exit
+    // of the instruction, not at entry (nor the largest of the both).
+    for (BasicBlock::iterator I = BB->begin(), E = BB->end(); I != E; ++I)
+    {
+        Instruction* Inst = &*I;
+        ValueToIntMap::iterator IDef = ValueIds.find(Inst);
+        if (IDef != ValueIds.end())
+        {
+            if (const RegUse * pregs = getRegUse(Inst))
             {
-                if (const RegUse * pregs = getRegUse(Inst))
-                {
-                    RegUse& ruse_curr = nCurrLiveIns.allUses[pregs->rClass];
-                    ruse_curr += (*pregs);
-                }
+                RegUse& ruse_curr = nCurrLiveIns.allUses[pregs->rClass];
+                ruse_curr += (*pregs);
             }
+        }
 
-            // Kills
-            ValueToValueVecMap::iterator IKill = KillInfo.find(Inst);
-            if (IKill != KillInfo.end())
+        // Kills
+        ValueToValueVecMap::iterator IKill = KillInfo.find(Inst);
+        if (IKill != KillInfo.end())
+        {
+            ValueVec& VS = IKill->second;
+            for (int i = 0, e = (int)VS.size(); i < e; ++i)
             {
-                ValueVec& VS = IKill->second;
-                for (int i = 0, e = (int)VS.size(); i < e; ++i)
+                Value* killVal = VS[i];
+                if (const RegUse * pregs = getRegUse(killVal))
                 {
-                    Value* killVal = VS[i];
-                    if (const RegUse * pregs = getRegUse(killVal))
-                    {
-                        RegUse& ruse_curr = nCurrLiveIns.allUses[pregs->rClass];
-                        ruse_curr -= (*pregs);
-                    }
+                    RegUse& ruse_curr = nCurrLiveIns.allUses[pregs->rClass];
+                    ruse_curr -= (*pregs);
                 }
             }
+        }
 
-            for (int i = 0; i < REGISTER_CLASS_TOTAL; ++i)
-            {
-                RegClass RC = (RegClass)i;
-                RegUse& ruse1 = bbMaxRegs.allUses[RC];
-                RegUse& ruse2 = nCurrLiveIns.allUses[RC];
+        for (int i = 0; i < REGISTER_CLASS_TOTAL; ++i)
+        {
+            RegClass RC = (RegClass)i;
+            RegUse& ruse1 = bbMaxRegs.allUses[RC];
+            RegUse& ruse2 = nCurrLiveIns.allUses[RC];
 
-                if (ruse1 < ruse2)
-                {
-                    ruse1 = ruse2;
-                }
-            }
-            if (doRPEPerInst)
+            if (ruse1 < ruse2)
             {
-                m_LiveVirtRegs.insert(std::make_pair(Inst, nCurrLiveIns));
+                ruse1 = ruse2;
             }
         }
+        if (doRPEPerInst)
+        {
+            m_LiveVirtRegs[Inst] = nCurrLiveIns;
+        }
+    }
+
+    // save it in map
+    RegUsage& bbMax = m_BBMaxLiveVirtRegs[BB];
+    bbMax = bbMaxRegs;
+    return bbMax;
+}
+
+// Recompute the register pressure of BBs whose liveness has been changed
+// by incremental updates of LivenessAnalysis.
+void RegisterEstimator::update()
+{
+    SmallVector<BasicBlock*, 16> dirtyBBs;
+    m_LVA->takeDirtyBlocks(dirtyBBs);
+    if (dirtyBBs.empty() || m_BBMaxLiveVirtRegs.empty())
+    {
+        // Nothing changed or RPE not computed yet.
+        return;
+    }
 
-        // save it in map
-        m_BBMaxLiveVirtRegs.insert(std::make_pair(BB, bbMaxRegs));
+    for (BasicBlock* BB : dirtyBBs)
+    {
+        calculateBB(BB, m_RPEPerInst);
+    }
 
+    // The max of this function may decrease, so recompute it from all BBs.
+    m_MaxRegs.clear();
+    for (auto& BBMax : m_BBMaxLiveVirtRegs)
+    {
         for (int i = 0; i < REGISTER_CLASS_TOTAL; ++i)
         {
             RegUse& ruse_max = m_MaxRegs.allUses[(RegClass)i];
-            RegUse& ruse_curr = bbMaxRegs.allUses[(RegClass)i];
+            RegUse& ruse_curr = BBMax.second.allUses[(RegClass)i];
             if (ruse_max < ruse_curr)
             {
                 ruse_max = ruse_curr;
             }
         }
     }
+}
 
-#if 0
-    // Sort LiveVirtRegs in decreasing order. As Map cannot be sorted, a list
-    // is used for sorting it.
-    for (ValueToIntMap::iterator I = m_LiveVirtRegs.begin(),
-        E = m_LiveVirtRegs.end();
-        I != E; ++I)
-    {
-        Value* V = I->first;
-        m_AllValues.push_back(V);
-    }
-    std::sort(m_AllValues.begin(), m_AllValues.end(), isNRegGreater(m_LiveVirtRegs));
-#endif
-    int dumpLevel = IGC_GET_FLAG_VALUE(RPEDumpLevel);
-    if (dumpLevel > FLAG_LEVEL_0)
-    {
-        print(errs(), dumpLevel);
-    }
+void RegisterEstimator::instructionMoved(Instruction* I, BasicBlock* FromBB)
+{
+    m_LVA->instructionMoved(I, FromBB);
+    update();
+}
+
+void RegisterEstimator::instructionsReordered(BasicBlock* BB)
+{
+    m_LVA->instructionsReordered(BB);
+    update();
+}
+
+void RegisterEstimator::reset()
+{
+    clear();
+    m_LVA->reset();
+    m_ValueRegUses.clear();
+    initValueRegUses();
 }
 
 int RegisterEstimator::getNUsesInBB(Value* V, BasicBlock* BB)
@@ -332,6 +393,21 @@ bool RegisterEstimator::runOnFunction(Function& F)
 
     m_WIA = getAnalysisIfAvailable<WIAnalysis>();
 
+    initValueRegUses();
+
+    // Note that runOnFunction does not do RPE calculation unless ForceRPE
+    // is enabled (for debugging).  The RPE is calcualted for users to call
+    // calculate() explicitly.
+    if (IGC_IS_FLAG_ENABLED(ForceRPE))
+    {
+        // Calculate register pressure for each BB
+        calculate();
+    }
+    return false;
+}
+
+void RegisterEstimator::initValueRegUses()
+{
     uint32_t nVals = (uint32_t)m_LVA->IdValues.size();
     uint32_t Caps = (uint32_t)m_LVA->IdValues.capacity();
     m_ValueRegUses.reserve(Caps);
@@ -353,16 +429,6 @@ bool RegisterEstimator::runOnFunction(Function& F)
     }
 
     m_noGRFPressure = isGRFPressureLow(16, estNumRegs);
-
-    // Note that runOnFunction does not do RPE calculation unless ForceRPE
-    // is enabled (for debugging).  The RPE is calcualted for users to call
-    // calculate() explicitly.
-    if (IGC_IS_FLAG_ENABLED(ForceRPE))
-    {
-        // Calculate register pressure for each BB
-        calculate();
-    }
-    return false;
 }
 
 void RegisterEstimator::print(raw_ostream& OS, BasicBlock* BB, int dumpLevel)
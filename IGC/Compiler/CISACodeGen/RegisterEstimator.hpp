@@ -166,7 +166,8 @@ namespace IGC
             m_DL(nullptr),
             m_LVA(nullptr),
             m_F(nullptr),
-            m_WIA(nullptr)
+            m_WIA(nullptr),
+            m_RPEPerInst(false)
         {
             initializeRegisterEstimatorPass(*llvm::PassRegistry::getPassRegistry());
         }
@@ -192,6 +193,16 @@ namespace IGC
         // is true.
         void calculate(bool doRPEPerInst = false);
 
+        // Incremental update, for passes that move instructions and want to
+        // keep this analysis (and LivenessAnalysis) valid. Only BBs whose
+        // liveness is changed are recomputed. See LivenessAnalysis for the
+        // meaning of the arguments.
+        void instructionMoved(llvm::Instruction* I, llvm::BasicBlock* FromBB);
+        void instructionsReordered(llvm::BasicBlock* BB);
+        // Reset this analysis and LivenessAnalysis to the state right after
+        // runOnFunction(), after instructions have been added or erased.
+        void reset();
+
         // Once MAX register estimate of a function is computed, check
         // if there is GRF pressure.  If the number of estimated registers
         // is larger than a given threshold (threshold is selected based on
@@ -257,9 +268,16 @@ namespace IGC
         // can be skipped completedly.
         ValueToRegUseMap m_ValueRegUses;
 
+        // True if RPE per inst is computed (m_LiveVirtRegs)
+        bool m_RPEPerInst;
+
         // Temporary use.
         llvm::DenseMap<llvm::BasicBlock*, int> m_pBB2ID;
 
+        void initValueRegUses();
+        RegUsage& calculateBB(llvm::BasicBlock* BB, bool doRPEPerInst);
+        void update();
+
         void addRegUsage(RegUsage& RUsage, SBitVector& BV);
 
         uint32_t getNumGRF(RegUsage& rusage, uint16_t simdsize = 16) {
@@ -319,6 +337,7 @@ namespace IGC
 
         void clear()
         {
+            m_RPEPerInst = false;
             m_LiveVirtRegs.clear();
             m_MaxRegs.clear();
             m_BBMaxLiveVirtRegs.clear();
@@ -65,6 +65,7 @@ IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/TimeStatsCounter.h"
 #include "Compiler/CISACodeGen/TypeDemote.h"
 #include "Compiler/CISACodeGen/UniformAssumptions.hpp"
+#include "Compiler/CISACodeGen/VISACompileQueue.hpp"
 #include "Compiler/Optimizer/LinkMultiRateShaders.hpp"
 #include "Compiler/CISACodeGen/MergeURBWrites.hpp"
 #include "Compiler/CISACodeGen/VectorProcess.hpp"
@@ -1026,6 +1027,20 @@ static bool SimdEarlyCheck(CodeGenContext* ctx)
 }
 
 
+// Number of worker threads compiling the SIMD variants of a pixel or compute
+// shader concurrently, or 0 to compile them one after another.
+// Stage 1 of a staged compile is kept sequential: EmitPass decides which SIMD
+// sizes are left for stage 2 right after compiling each variant.
+static unsigned GetParallelSIMDCompileThreads(const CodeGenContext* ctx)
+{
+    unsigned numThreads = IGC_GET_FLAG_VALUE(ParallelSIMDCompileThreads);
+    if (numThreads <= 1 || ctx->m_instrTypes.hasDebugInfo || IsStage1(ctx))
+    {
+        return 0;
+    }
+    return numThreads;
+}
+
 static void PSCodeGen(
     PixelShaderContext* ctx,
     CShaderProgram::KernelShaderMap& shaders,
@@ -1139,8 +1154,26 @@ static void PSCodeGen(
     PassMgr.add(new DebugInfoPass(shaders));
     COMPILER_TIME_END(ctx, TIME_CG_Add_Passes);
 
+    // EmitPass still emits the SIMD variants one after another, but their
+    // vISA back ends run on the compile queue. A variant that depends on the
+    // results of a narrower one still compiling is accepted speculatively and
+    // re-checked when the queue is flushed.
+    unsigned parallelSIMDThreads = useRegKeySimd ? 0 : GetParallelSIMDCompileThreads(ctx);
+    std::unique_ptr<VISACompileQueue> compileQueue;
+    if (parallelSIMDThreads)
+    {
+        compileQueue = std::make_unique<VISACompileQueue>(parallelSIMDThreads);
+        ctx->m_visaCompileQueue = compileQueue.get();
+    }
+
     PassMgr.run(*(ctx->getModule()));
 
+    if (compileQueue)
+    {
+        compileQueue->flush();
+        ctx->m_visaCompileQueue = nullptr;
+    }
+
     DumpLLVMIR(ctx, "codegen");
 
     COMPILER_TIME_END(ctx, TIME_CodeGen);
@@ -1163,6 +1196,7 @@ void CodeGen(ComputeShaderContext* ctx, CShaderProgram::KernelShaderMap& shaders
     SIMDMode simdModeAllowed = ctx->GetLeastSIMDModeAllowed();
     SIMDMode maxSimdMode = ctx->GetMaxSIMDMode();
     unsigned int waveSize = ctx->getModuleMetaData()->csInfo.waveSize;
+    unsigned parallelSIMDThreads = 0;
 
     if (IGC_IS_FLAG_ENABLED(ForceCSSIMD32) || waveSize == 32 || ctx->getModuleMetaData()->csInfo.forcedSIMDSize == 32)
     {
@@ -1182,12 +1216,28 @@ void CodeGen(ComputeShaderContext* ctx, CShaderProgram::KernelShaderMap& shaders
     else
     {
         AddCodeGenPasses(*ctx, shaders, PassMgr, simdModeAllowed, maxSimdMode, setEarlyExit16Stat);
+        parallelSIMDThreads = GetParallelSIMDCompileThreads(ctx);
     }
 
     COMPILER_TIME_END(ctx, TIME_CG_Add_Passes);
 
+    // SIMD32 and SIMD8 wait for the SIMD16 results they are decided from,
+    // then compile concurrently; see CComputeShader::CompileSIMDSize.
+    std::unique_ptr<VISACompileQueue> compileQueue;
+    if (parallelSIMDThreads)
+    {
+        compileQueue = std::make_unique<VISACompileQueue>(parallelSIMDThreads);
+        ctx->m_visaCompileQueue = compileQueue.get();
+    }
+
     PassMgr.run(*(ctx->getModule()));
 
+    if (compileQueue)
+    {
+        compileQueue->flush();
+        ctx->m_visaCompileQueue = nullptr;
+    }
+
     if (setEarlyExit16Stat)
         COMPILER_SHADER_STATS_SET(shaders.begin()->second->m_shaderStats, STATS_ISA_EARLYEXIT16, 1);
 
@@ -1264,6 +1314,9 @@ void CodeGen(OpenCLProgramContext* ctx, CShaderProgram::KernelShaderMap& kernels
         return;
     }
 
+    // SIMD modes to compile and whether each of them can abort on spill,
+    // in the order they are tried.
+    llvm::SmallVector<std::pair<SIMDMode, bool>, 3> simdModes;
     if (ctx->m_DriverInfo.sendMultipleSIMDModes())
     {
         unsigned int leastSIMD = 8;
@@ -1278,20 +1331,20 @@ void CodeGen(OpenCLProgramContext* ctx, CShaderProgram::KernelShaderMap& kernels
         }
         if (leastSIMD <= 8)
         {
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD8, false);
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD16, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 16));
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD32, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 32));
+            simdModes.push_back({ SIMDMode::SIMD8, false });
+            simdModes.push_back({ SIMDMode::SIMD16, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 16) });
+            simdModes.push_back({ SIMDMode::SIMD32, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 32) });
         }
         else if (leastSIMD <= 16)
         {
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD16, false);
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD32, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 32));
+            simdModes.push_back({ SIMDMode::SIMD16, false });
+            simdModes.push_back({ SIMDMode::SIMD32, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 32) });
 
             ctx->SetSIMDInfo(SIMD_SKIP_HW, SIMDMode::SIMD8, ShaderDispatchMode::NOT_APPLICABLE);
         }
         else
         {
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD32, false);
+            simdModes.push_back({ SIMDMode::SIMD32, false });
 
             ctx->SetSIMDInfo(SIMD_SKIP_HW, SIMDMode::SIMD8, ShaderDispatchMode::NOT_APPLICABLE);
             ctx->SetSIMDInfo(SIMD_SKIP_HW, SIMDMode::SIMD16, ShaderDispatchMode::NOT_APPLICABLE);
@@ -1301,12 +1354,60 @@ void CodeGen(OpenCLProgramContext* ctx, CShaderProgram::KernelShaderMap& kernels
     {
         {
             // The order in which we call AddCodeGenPasses matters, please to not change order
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD32, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 32));
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD16, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 16));
-            AddCodeGenPasses(*ctx, kernels, Passes, SIMDMode::SIMD8, false);
+            simdModes.push_back({ SIMDMode::SIMD32, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 32) });
+            simdModes.push_back({ SIMDMode::SIMD16, (ctx->getModuleMetaData()->csInfo.forcedSIMDSize != 16) });
+            simdModes.push_back({ SIMDMode::SIMD8, false });
         }
     }
 
+    unsigned parallelCodeGenThreads = IGC_GET_FLAG_VALUE(ParallelCodeGenThreads);
+    if (parallelCodeGenThreads == 0)
+    {
+        parallelCodeGenThreads = ctx->m_InternalOptions.ParallelCodeGenThreads;
+    }
+
+    if (parallelCodeGenThreads > 1 && !ctx->m_instrTypes.hasDebugInfo)
+    {
+        // Kernels are independent of each other, but each SIMD mode of a kernel
+        // depends on the results of the modes compiled before it. So compile
+        // one SIMD mode for all kernels at a time: EmitPass queues the vISA
+        // back end of every kernel and the queue is flushed, in kernel order,
+        // before the next SIMD mode decides what to compile. As with function pointers above, this needs a
+        // separate pass manager per SIMD mode.
+        VISACompileQueue compileQueue(parallelCodeGenThreads);
+        ctx->m_visaCompileQueue = &compileQueue;
+
+        AddCodeGenPasses(*ctx, kernels, Passes, simdModes.front().first, simdModes.front().second);
+        COMPILER_TIME_END(ctx, TIME_CG_Add_Passes);
+        Passes.run(*(ctx->getModule()));
+        compileQueue.flush();
+
+        for (unsigned i = 1; i < simdModes.size(); ++i)
+        {
+            IGCPassManager SIMDPasses(ctx, "CG");
+            SIMDPasses.add(new MetaDataUtilsWrapper(ctx->getMetaDataUtils(), ctx->getModuleMetaData()));
+            SIMDPasses.add(new CodeGenContextWrapper(ctx));
+            SIMDPasses.add(createGenXFunctionGroupAnalysisPass());
+            AddCodeGenPasses(*ctx, kernels, SIMDPasses, simdModes[i].first, simdModes[i].second);
+            SIMDPasses.run(*(ctx->getModule()));
+            compileQueue.flush();
+        }
+        ctx->m_visaCompileQueue = nullptr;
+
+        IGCPassManager DIPasses(ctx, "DI");
+        DIPasses.add(new DebugInfoPass(kernels));
+        DIPasses.run(*(ctx->getModule()));
+
+        COMPILER_TIME_END(ctx, TIME_CodeGen);
+        DumpLLVMIR(ctx, "codegen");
+        return;
+    }
+
+    for (const auto& simdMode : simdModes)
+    {
+        AddCodeGenPasses(*ctx, kernels, Passes, simdMode.first, simdMode.second);
+    }
+
     Passes.add(new DebugInfoPass(kernels));
     COMPILER_TIME_END(ctx, TIME_CG_Add_Passes);
 
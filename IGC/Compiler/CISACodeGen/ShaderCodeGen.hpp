@@ -107,6 +107,10 @@ public:
     {
         return CompileSIMDSizeInCommon(simdMode);
     }
+    /// Re-checks the rules of CompileSIMDSize that were deferred because the
+    /// narrower variants they depend on were still compiling. Returns true,
+    /// after recording the skip reason, if their results rule this variant out.
+    virtual bool IsSIMDSizeMoot() { return false; }
     CVariable* LazyCreateCCTupleBackingVariable(
         CoalescingEngine::CCTuple* ccTuple,
         VISA_Type baseType = ISA_TYPE_UD);
@@ -307,6 +311,8 @@ public:
     uint m_staticCycle;
     unsigned m_spillSize = 0;
     float m_spillCost = 0;          // num weighted spill inst / total inst
+    /// Set by CompileSIMDSize when it accepted this variant before the results it depends on were known
+    bool m_simdSizeDeferred = false;
 
     std::vector<llvm::Value*> m_argListCache;
 
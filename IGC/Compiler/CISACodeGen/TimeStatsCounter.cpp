@@ -107,9 +107,11 @@ bool TimeStatsCounter::runOnModule(Module& F) {
         if (mode == STATS_COUNTER_START)
         {
             COMPILER_TIME_PASS_START(ctx, igcPass);
+            COMPILE_TRACE_BEGIN(ctx, igcPass, "llvm");
         }
         else
         {
+            COMPILE_TRACE_END(ctx);
             COMPILER_TIME_PASS_END(ctx, igcPass);
         }
     }
@@ -0,0 +1,70 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (c) 2000-2021 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom
+the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+
+============================= end_copyright_notice ===========================*/
+
+
+#include "Compiler/CISACodeGen/VISACompileQueue.hpp"
+#include "Compiler/CISACodeGen/EmitVISAPass.hpp"
+#include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Probe/Assertion.h"
+
+using namespace IGC;
+
+VISACompileQueue::VISACompileQueue(unsigned numThreads)
+    : m_pool(numThreads)
+{
+}
+
+void VISACompileQueue::enqueue(CShader* shader, bool compileWithSymbolTable)
+{
+    IGC_ASSERT(nullptr != shader);
+    shader->GetEncoder().CompileAsync(m_pool);
+    m_pending.push_back({ shader, compileWithSymbolTable });
+}
+
+void VISACompileQueue::flush()
+{
+    // A SIMD variant queued before the narrower ones it depends on finished
+    // is re-checked once they are complete. If their results rule it out, it
+    // is cancelled before the variants after it are looked at, so that the
+    // ones no worker picked up yet are skipped.
+    std::vector<CShader*> cancelled;
+    for (const PendingCompile& pending : m_pending)
+    {
+        CEncoder& encoder = pending.shader->GetEncoder();
+        if (pending.shader->IsSIMDSizeMoot())
+        {
+            encoder.CancelAsyncCompile();
+            cancelled.push_back(pending.shader);
+            continue;
+        }
+        encoder.Compile(pending.compileWithSymbolTable);
+        encoder.DestroyVISABuilder();
+        EmitPass::UpdateMidThreadPreemption(pending.shader);
+    }
+    for (CShader* shader : cancelled)
+    {
+        shader->GetEncoder().DestroyVISABuilder();
+    }
+    m_pending.clear();
+}
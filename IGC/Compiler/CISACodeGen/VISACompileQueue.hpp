@@ -0,0 +1,70 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (c) 2000-2021 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom
+the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+
+============================= end_copyright_notice ===========================*/
+
+
+#pragma once
+
+#include "common/ThreadPool.hpp"
+
+#include <vector>
+
+namespace IGC
+{
+    class CShader;
+
+    // Runs the vISA back end (finalization, RA, scheduling, encoding) of
+    // independent kernels, or of the SIMD variants of one shader, on a
+    // bounded worker pool while EmitPass keeps emitting vISA for the
+    // following ones on the calling thread.
+    //
+    // Everything that reads the compilation results or touches the shared
+    // CodeGenContext is done by flush() on the calling thread, in the order
+    // the kernels were enqueued, not in the order the workers finish them.
+    class VISACompileQueue
+    {
+    public:
+        explicit VISACompileQueue(unsigned numThreads);
+
+        // Starts the vISA compilation of the kernel currently held by the
+        // shader's encoder.
+        void enqueue(CShader* shader, bool compileWithSymbolTable);
+
+        // Waits for every enqueued compilation and completes them. SIMD
+        // variants that the results of the narrower ones make moot are
+        // cancelled and dropped instead.
+        void flush();
+
+        bool empty() const { return m_pending.empty(); }
+
+    private:
+        struct PendingCompile
+        {
+            CShader* shader;
+            bool compileWithSymbolTable;
+        };
+
+        ThreadPool m_pool;
+        std::vector<PendingCompile> m_pending;
+    };
+}
@@ -29,7 +29,9 @@ IN THE SOFTWARE.
 #include "usc_gen7.h"
 #include "usc_gen9.h"
 #include "common/Stats.hpp"
+#include "common/CompileTrace.hpp"
 #include "common/Types.hpp"
+#include "common/ThreadPool.hpp"
 #include "common/allocator.h"
 #include "common/igc_resourceDimTypes.h"
 // hack
@@ -87,6 +89,7 @@ namespace IGC
     class CodeGenContext;
     class PixelShaderContext;
     class ComputeShaderContext;
+    class VISACompileQueue;
 
     struct SProgramOutput
     {
@@ -843,6 +846,8 @@ namespace IGC
         const CDriverInfo& m_DriverInfo;
         /// output: driver instrumentation
         TimeStats* m_compilerTimeStats = nullptr;
+        /// output: hierarchical compile-time trace, only set with DumpCompileTrace
+        CompileTrace* m_compileTrace = nullptr;
         ShaderStats* m_sumShaderStats = nullptr;
         /// output: list of buffer IDs which are promoted to direct AS
         // Map of promoted buffer ids with their respective buffer offsets if needed. Buffer offset will be -1 if no need of buffer offset
@@ -886,6 +891,9 @@ namespace IGC
         // Record previous simd for code patching
         CShader* m_prevShader = nullptr;
 
+        // Set while EmitPass may defer vISA compilation to worker threads
+        VISACompileQueue* m_visaCompileQueue = nullptr;
+
         // For IR dump after pass
         unsigned     m_numPasses = 0;
         bool m_threadCombiningOptDone = false;
@@ -1372,6 +1380,16 @@ namespace IGC
                 {
                     EnableZEBinary = true;
                 }
+                if (const char* O = strstr(options, "-intel-parallel-codegen"))
+                {
+                    // -cl-intel-parallel-codegen[=<number of worker threads>]
+                    const char* optionVal = O + strlen("-intel-parallel-codegen");
+                    ParallelCodeGenThreads = ThreadPool::getHardwareConcurrency();
+                    if (*optionVal == '=' && isdigit(*(optionVal + 1)))
+                    {
+                        ParallelCodeGenThreads = (uint32_t)atoi(optionVal + 1);
+                    }
+                }
                 if (strstr(options, "-intel-no-spill"))
                 {
                     // This is an option to avoid spill/fill instructions in scheduler kernel.
@@ -1413,6 +1431,8 @@ namespace IGC
             bool hasNoLocalToGeneric = false;
             bool EnableZEBinary = false;
             bool NoSpill = false;
+            // 0: kernels are compiled serially
+            uint32_t ParallelCodeGenThreads = 0;
 
             // -1 : initial value that means it is not set from cmdline
             // 0-5: valid values set from the cmdline
@@ -64,14 +64,97 @@ IGC_INITIALIZE_PASS_END(BIImport, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PA
 
 char BIImport::ID = 0;
 
-BIImport::BIImport(std::unique_ptr<Module> pGenericModule, std::unique_ptr<Module> pSizeModule) :
+BIImport::BIImport(std::unique_ptr<Module> pGenericModule, std::unique_ptr<Module> pSizeModule,
+    const BiFSymbolIndex* pSymbolIndex) :
     ModulePass(ID),
     m_GenericModule(std::move(pGenericModule)),
-    m_SizeModule(std::move(pSizeModule))
+    m_SizeModule(std::move(pSizeModule)),
+    m_pSymbolIndex(pSymbolIndex)
 {
     initializeBIImportPass(*PassRegistry::getPassRegistry());
 }
 
+BiFSymbolIndex::BiFSymbolIndex(const Module& genericModule, const Module* pSizeModule)
+{
+    auto addModule = [this](const Module& module)
+    {
+        for (const Function& F : module)
+        {
+            if (F.isDeclaration())
+            {
+                continue;
+            }
+            unsigned id = getOrAddId(F.getName());
+            if (m_defined[id])
+            {
+                // Already defined by the generic module, which wins the lookup.
+                continue;
+            }
+            m_defined[id] = true;
+
+            SmallPtrSet<const Function*, 8> visitedSet;
+            for (const_inst_iterator it = inst_begin(&F), e = inst_end(&F); it != e; ++it)
+            {
+                const CallInst* pInstCall = dyn_cast<CallInst>(&*it);
+                const Function* pCalledFunc = pInstCall ? pInstCall->getCalledFunction() : nullptr;
+                if (pCalledFunc && visitedSet.insert(pCalledFunc).second)
+                {
+                    unsigned calleeId = getOrAddId(pCalledFunc->getName());
+                    m_callees[id].push_back(calleeId);
+                }
+            }
+        }
+    };
+
+    addModule(genericModule);
+    if (pSizeModule)
+    {
+        addModule(*pSizeModule);
+    }
+}
+
+unsigned BiFSymbolIndex::getOrAddId(StringRef name)
+{
+    auto result = m_ids.insert(std::make_pair(name, (unsigned)m_names.size()));
+    if (result.second)
+    {
+        m_names.push_back(result.first->getKey());
+        m_defined.push_back(false);
+        m_callees.emplace_back();
+    }
+    return result.first->getValue();
+}
+
+void BiFSymbolIndex::getClosure(ArrayRef<StringRef> roots, std::vector<StringRef>& closure) const
+{
+    std::vector<bool> visited(m_names.size(), false);
+    std::vector<unsigned> worklist;
+    for (StringRef root : roots)
+    {
+        auto it = m_ids.find(root);
+        if (it != m_ids.end() && m_defined[it->getValue()] && !visited[it->getValue()])
+        {
+            visited[it->getValue()] = true;
+            worklist.push_back(it->getValue());
+        }
+    }
+
+    while (!worklist.empty())
+    {
+        unsigned id = worklist.back();
+        worklist.pop_back();
+        closure.push_back(m_names[id]);
+        for (unsigned calleeId : m_callees[id])
+        {
+            if (m_defined[calleeId] && !visited[calleeId])
+            {
+                visited[calleeId] = true;
+                worklist.push_back(calleeId);
+            }
+        }
+    }
+}
+
 
 /* We have to run this step of updating mangled SPIR function names
 because of SPIR 1.2 specification issue. There are bugs in
@@ -528,6 +611,34 @@ bool BIImport::runOnModule(Module& M)
         }
     }
 
+    // Materializes a builtin, returning true if its body was loaded by this call.
+    auto Materialize = [](Function* pFunc) -> bool
+    {
+        if (!pFunc->isMaterializable())
+        {
+            return false;
+        }
+        if (Error Err = pFunc->materialize()) {
+            std::string Msg;
+            handleAllErrors(std::move(Err), [&](ErrorInfoBase& EIB) {
+                errs() << "===> Materialize Failure: " << EIB.message().c_str() << '\n';
+            });
+            IGC_ASSERT_MESSAGE(0, "Failed to materialize Global Variables");
+            return false;
+        }
+        pFunc->addAttribute(AttributeList::FunctionIndex, llvm::Attribute::Builtin);
+        return true;
+    };
+
+    auto MarkKMPLock = [](Function* pFunc)
+    {
+        if (pFunc->getName().startswith("__builtin_IB_kmp_"))
+        {
+            pFunc->addFnAttr(llvm::Attribute::NoInline);
+            pFunc->addFnAttr("KMPLOCK");
+        }
+    };
+
     std::function<void(Function*)> Explore = [&](Function* pRoot) -> void
     {
         TFunctionsVec calledFuncs;
@@ -548,32 +659,54 @@ bool BIImport::runOnModule(Module& M)
                 pFunc = pCallee;
             }
 
-            if (pFunc->isMaterializable())
+            if (Materialize(pFunc))
             {
-                if (Error Err = pFunc->materialize()) {
-                    std::string Msg;
-                    handleAllErrors(std::move(Err), [&](ErrorInfoBase& EIB) {
-                        errs() << "===> Materialize Failure: " << EIB.message().c_str() << '\n';
-                    });
-                    IGC_ASSERT_MESSAGE(0, "Failed to materialize Global Variables");
+                Explore(pFunc);
+            }
+
+            MarkKMPLock(pFunc);
+        }
+    };
+
+    if (m_pSymbolIndex)
+    {
+        // The index already knows the call graph of the builtins, so only the calls
+        // made by the kernel module need to be visited.
+        std::vector<StringRef> roots;
+        for (auto& func : M)
+        {
+            TFunctionsVec calledFuncs;
+            GetCalledFunctions(&func, calledFuncs);
+            for (auto* pCallee : calledFuncs)
+            {
+                if (pCallee->isDeclaration())
+                {
+                    roots.push_back(pCallee->getName());
                 }
-                else {
-                    pFunc->addAttribute(AttributeList::FunctionIndex, llvm::Attribute::Builtin);
-                    Explore(pFunc);
+                else
+                {
+                    MarkKMPLock(pCallee);
                 }
             }
+        }
 
-            if (pFunc->getName().startswith("__builtin_IB_kmp_"))
+        std::vector<StringRef> closure;
+        m_pSymbolIndex->getClosure(roots, closure);
+        for (StringRef funcName : closure)
+        {
+            if (Function* pFunc = GetBuiltinFunction2(funcName))
             {
-                pFunc->addFnAttr(llvm::Attribute::NoInline);
-                pFunc->addFnAttr("KMPLOCK");
+                Materialize(pFunc);
+                MarkKMPLock(pFunc);
             }
         }
-    };
-
-    for (auto& func : M)
+    }
+    else
     {
-        Explore(&func);
+        for (auto& func : M)
+        {
+            Explore(&func);
+        }
     }
 
     // nuke the unused functions so we can materializeAll() quickly
@@ -991,9 +1124,10 @@ void BIImport::InitializeBIFlags(Module& M)
 
 extern "C" llvm::ModulePass* createBuiltInImportPass(
     std::unique_ptr<Module> pGenericModule,
-    std::unique_ptr<Module> pSizeModule)
+    std::unique_ptr<Module> pSizeModule,
+    const BiFSymbolIndex* pSymbolIndex)
 {
-    return new BIImport(std::move(pGenericModule), std::move(pSizeModule));
+    return new BIImport(std::move(pGenericModule), std::move(pSizeModule), pSymbolIndex);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -29,6 +29,8 @@ IN THE SOFTWARE.
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Pass.h>
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/StringMap.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include "AdaptorOCL/CLElfLib/ElfReader.h"
@@ -39,6 +41,29 @@ IN THE SOFTWARE.
 
 namespace IGC
 {
+    /// Call graph of the builtin modules, keyed by function name.
+    /// It is built once from fully loaded modules and is independent of any LLVMContext,
+    /// so it can be shared by all compilations that use the same builtin bitcode.
+    class BiFSymbolIndex
+    {
+    public:
+        /// Indexes the functions defined in the builtin modules. Definitions in the
+        /// generic module take precedence, as in BIImport::GetBuiltinFunction2.
+        BiFSymbolIndex(const llvm::Module& genericModule, const llvm::Module* pSizeModule);
+
+        /// Returns the names of the builtins defined in the index that are reachable
+        /// through calls from roots, including the defined roots themselves.
+        void getClosure(llvm::ArrayRef<llvm::StringRef> roots, std::vector<llvm::StringRef>& closure) const;
+
+    private:
+        unsigned getOrAddId(llvm::StringRef name);
+
+        llvm::StringMap<unsigned>           m_ids;      // every defined or called name
+        std::vector<llvm::StringRef>        m_names;    // id -> name, backed by m_ids
+        std::vector<bool>                   m_defined;  // id -> has a body in the builtins
+        std::vector<std::vector<unsigned>>  m_callees;  // id -> ids of the called functions
+    };
+
     /// This pass imports built-in functions from source module to destination module.
     class BIImport : public llvm::ModulePass
     {
@@ -52,7 +77,8 @@ namespace IGC
 
         /// @brief Constructor
         BIImport(std::unique_ptr<llvm::Module> pGenericModule = nullptr,
-            std::unique_ptr<llvm::Module> pSizeModule = nullptr);
+            std::unique_ptr<llvm::Module> pSizeModule = nullptr,
+            const BiFSymbolIndex* pSymbolIndex = nullptr);
 
         /// @brief analyses used
         virtual void getAnalysisUsage(llvm::AnalysisUsage& AU) const override
@@ -100,12 +126,17 @@ namespace IGC
         /// Builtin module - contains the source function definition to import
         std::unique_ptr<llvm::Module> m_GenericModule;
         std::unique_ptr<llvm::Module> m_SizeModule;
+
+        /// Optional prebuilt call graph of the builtin modules. When it is present the
+        /// builtins to import are found without walking the bodies of materialized builtins.
+        const BiFSymbolIndex* m_pSymbolIndex;
     };
 
 } // namespace IGC
 
 extern "C" llvm::ModulePass* createBuiltInImportPass(
-    std::unique_ptr<llvm::Module> pGenericModule, std::unique_ptr<llvm::Module> pSizeModule);
+    std::unique_ptr<llvm::Module> pGenericModule, std::unique_ptr<llvm::Module> pSizeModule,
+    const IGC::BiFSymbolIndex* pSymbolIndex = nullptr);
 
 namespace IGC
 {
@@ -0,0 +1,74 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (c) 2014-2021 Intel Corporation
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"),
+; to deal in the Software without restriction, including without limitation
+; the rights to use, copy, modify, merge, publish, distribute, sublicense,
+; and/or sell copies of the Software, and to permit persons to whom
+; the Software is furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included
+; in all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+; FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+; IN THE SOFTWARE.
+;
+;============================ end_copyright_notice =============================
+
+
+; RUN: igc_opt %s -S -o - -basicaa -igc-memopt -instcombine | FileCheck %s
+
+target datalayout = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f16:16:16-f32:32:32-f64:64:64-f80:128:128-v16:16:16-v24:32:32-v32:32:32-v48:64:64-v64:64:64-v96:128:128-v128:128:128-v192:256:256-v256:256:256-v512:512:512-v1024:1024:1024-a:64:64-f80:128:128-n8:16:32:64"
+
+; Loads are merged across a store to a disjoint location from the same base
+; but not across a store to the same location.
+define void @f0(i32* %dst, i32* %src, i32 %v) {
+entry:
+  %0 = load i32, i32* %src, align 4
+  %arrayidx2 = getelementptr inbounds i32, i32* %src, i64 2
+  store i32 %v, i32* %arrayidx2, align 4
+  %arrayidx1 = getelementptr inbounds i32, i32* %src, i64 1
+  %1 = load i32, i32* %arrayidx1, align 4
+  %2 = load i32, i32* %arrayidx2, align 4
+  %add0 = add i32 %0, %1
+  %add1 = add i32 %add0, %2
+  store i32 %add1, i32* %dst, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @f0
+; CHECK: load <2 x i32>
+; CHECK: store i32 %v
+; CHECK: load i32, i32*
+; CHECK: ret void
+
+; Stores are not merged across a load from the location of a store being
+; sunk to the tailing store.
+define void @f1(i32* %dst, i32* %src, i32 %v) {
+entry:
+  store i32 %v, i32* %dst, align 4
+  %0 = load i32, i32* %dst, align 4
+  %arrayidx1 = getelementptr inbounds i32, i32* %dst, i64 1
+  store i32 %v, i32* %arrayidx1, align 4
+  store i32 %0, i32* %src, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @f1
+; CHECK-NOT: store <2 x i32>
+; CHECK: ret void
+
+!igc.functions = !{!0, !3}
+
+!0 = !{void (i32*, i32*, i32)* @f0, !1}
+!3 = !{void (i32*, i32*, i32)* @f1, !1}
+
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
@@ -0,0 +1,59 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (c) 2014-2021 Intel Corporation
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"),
+; to deal in the Software without restriction, including without limitation
+; the rights to use, copy, modify, merge, publish, distribute, sublicense,
+; and/or sell copies of the Software, and to permit persons to whom
+; the Software is furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included
+; in all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+; FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+; IN THE SOFTWARE.
+;
+;============================ end_copyright_notice =============================
+
+; RUN: env IGC_EnableSharedStackCallFuncs=1 igc_opt %s -S -o - -igc-insert-dummy-kernel-for-symbol-table | FileCheck %s
+
+; Stack-call functions called from several kernels that do not require a SIMD
+; size are shared through the default kernel.
+
+define internal spir_func i32 @shared(i32 %x) #0 {
+  %r = add i32 %x, 1
+  ret i32 %r
+}
+
+define spir_kernel void @k0(i32 addrspace(1)* %p) {
+  %v = call spir_func i32 @shared(i32 0)
+  store i32 %v, i32 addrspace(1)* %p
+  ret void
+}
+
+define spir_kernel void @k1(i32 addrspace(1)* %p) {
+  %v = call spir_func i32 @shared(i32 1)
+  store i32 %v, i32 addrspace(1)* %p
+  ret void
+}
+
+attributes #0 = { noinline "visaStackCall" }
+
+!igc.functions = !{!0, !3}
+
+!0 = !{void (i32 addrspace(1)*)* @k0, !1}
+!3 = !{void (i32 addrspace(1)*)* @k1, !1}
+
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+
+; CHECK: define spir_func i32 @shared(i32 %x) [[ATTR:#[0-9]+]]
+; CHECK: define spir_kernel void @Intel_Symbol_Table_Void_Program()
+; CHECK: attributes [[ATTR]] = { {{.*}}"referenced-indirectly"{{.*}} }
@@ -30,7 +30,6 @@ IN THE SOFTWARE.
 #include "common/LLVMWarningsPush.hpp"
 #endif
 
-#include "llvm/MC/StringTableBuilder.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -38,21 +37,27 @@ IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 #endif
 
+#include <cstring>
 #include <iostream>
 #include "Probe/Assertion.h"
 
 namespace zebin {
 
-/// ELFWriter - A helper class to write ELF contents into given raw_pwrite_stream,
+/// ELFWriter - A helper class to write ELF contents into given raw_ostream,
 ///             according to the given ZEELFObjectBuilder. This object should
 ///             only be used by ZEELFObjectBuilder
+///             The layout of the whole file is computed before anything is
+///             written, so the output is produced front to back in one pass
+///             and its exact size is known up front.
 class ELFWriter {
 public:
-    ELFWriter(llvm::raw_pwrite_stream& OS,
-        ZEELFObjectBuilder& objBuilder);
+    ELFWriter(ZEELFObjectBuilder& objBuilder);
+
+    // compute the offset and size of every section, return the file size
+    uint64_t computeLayout();
 
     // write the ELF file into OS, return the number of written bytes
-    uint64_t write();
+    uint64_t write(llvm::raw_ostream& OS);
 
 private:
     typedef ZEELFObjectBuilder::Section Section;
@@ -61,7 +66,7 @@ private:
     typedef ZEELFObjectBuilder::ZEInfoSection ZEInfoSection;
     typedef ZEELFObjectBuilder::RelocationListTy RelocationListTy;
     typedef std::map<ZEELFObjectBuilder::SectionID, uint32_t> SectionIndexMapTy;
-    typedef std::map<std::string, uint64_t> SymNameIndexMapTy;
+    typedef std::map<uint32_t, uint64_t> SymNameIndexMapTy;
 
     struct SectionHdrEntry {
         uint32_t name    = 0;
@@ -77,12 +82,16 @@ private:
     typedef std::vector<SectionHdrEntry> SectionHdrListTy;
 
 private:
-    // set m_SectionHdrEntries and adjust the section index, also creaet
-    // strings for sections' name in StringTableBuilder
+    // set m_SectionHdrEntries and adjust the section index
     void createSectionHdrEntries();
+    // create the symbol name to symbol index mapping used by relocations
+    void createSymbolIndices();
+    // set the offset, size and other attributes in SectionHdrEntry, return the
+    // offset right after the last section
+    uint64_t layoutSections(uint64_t offset);
     // write elf header
     void writeHeader();
-    // write sections and set the attributes in SectionHdrEntry
+    // write sections as laid out by layoutSections
     void writeSections();
     // write a raw section
     uint64_t writeSectionData(const uint8_t* data, uint64_t size, uint32_t padding);
@@ -96,16 +105,14 @@ private:
     uint64_t writeStrTab();
     // write section header
     void writeSectionHeader();
-    // write the section header's offset into ELF header
-    void writeSectionHdrOffset(uint64_t offset);
     // wirite number of zero bytes
     void writePadding(uint32_t size);
 
     void writeWord(uint64_t Word) {
         if (is64Bit())
-            m_W.write<uint64_t>(Word);
+            m_W->write<uint64_t>(Word);
         else
-            m_W.write<uint32_t>(static_cast<uint32_t>(Word));
+            m_W->write<uint32_t>(static_cast<uint32_t>(Word));
     }
 
     bool is64Bit() { return m_ObjBuilder.m_is64Bit; }
@@ -114,11 +121,13 @@ private:
 
     // name is the string table index of the section name
     SectionHdrEntry& createSectionHdrEntry(
-        const std::string& name, unsigned type, const Section* sect = nullptr);
+        uint32_t name, unsigned type, const Section* sect = nullptr);
     SectionHdrEntry& createNullSectionHdrEntry();
 
     uint32_t getSymTabEntSize();
     uint32_t getRelocTabEntSize();
+    uint32_t getHeaderSize();
+    uint32_t getSectionHdrEntSize();
 
     // name is the string table index of the symbol name
     void writeSymbol(uint32_t name, uint64_t value, uint64_t size,
@@ -132,8 +141,8 @@ private:
         uint64_t addralign, uint64_t entsize);
 
 private:
-    llvm::support::endian::Writer m_W;
-    llvm::StringTableBuilder m_StrTabBuilder{llvm::StringTableBuilder::ELF};
+    // valid only while write() is running
+    llvm::support::endian::Writer* m_W = nullptr;
     ZEELFObjectBuilder& m_ObjBuilder;
 
     // Map Section::m_id to ELF section index, used for creating symbol table
@@ -148,6 +157,33 @@ private:
     // section information for constructing section header
     SectionHdrListTy m_SectionHdrEntries;
 
+    // the section header table follows the last section
+    uint64_t m_SectionHdrOffset = 0;
+    uint64_t m_FileSize = 0;
+};
+
+/// BufferOStream - raw_ostream writing into a caller-provided buffer of
+///                 known size
+class BufferOStream : public llvm::raw_ostream {
+public:
+    BufferOStream(uint8_t* buffer, uint64_t size)
+        : llvm::raw_ostream(/*unbuffered=*/true), m_Buffer(buffer), m_Size(size)
+    {}
+
+    ~BufferOStream() override { flush(); }
+
+private:
+    void write_impl(const char* ptr, size_t size) override {
+        IGC_ASSERT(m_Pos + size <= m_Size);
+        memcpy(m_Buffer + m_Pos, ptr, size);
+        m_Pos += size;
+    }
+
+    uint64_t current_pos() const override { return m_Pos; }
+
+    uint8_t* m_Buffer;
+    uint64_t m_Size;
+    uint64_t m_Pos = 0;
 };
 
 } // namespace zebin
@@ -155,6 +191,31 @@ private:
 using namespace zebin;
 using namespace llvm;
 
+uint32_t ZEELFObjectBuilder::StringTable::add(llvm::StringRef str)
+{
+    if (str.empty())
+        return 0;
+    auto result = m_offsets.insert(std::make_pair(str, (uint32_t)m_data.size()));
+    if (result.second) {
+        m_data.append(str.data(), str.size());
+        m_data.push_back('\0');
+    }
+    return result.first->getValue();
+}
+
+const std::string& ZEELFObjectBuilder::ZEInfoSection::getSerialized()
+{
+    if (!m_isSerialized) {
+        // serialize ze_info contents
+        llvm::raw_string_ostream os(m_serialized);
+        llvm::yaml::Output yout(os);
+        yout << m_zeinfo;
+        os.flush();
+        m_isSerialized = true;
+    }
+    return m_serialized;
+}
+
 ZEELFObjectBuilder::Section&
 ZEELFObjectBuilder::addStandardSection(
     std::string sectName, const uint8_t* data, uint64_t size,
@@ -170,7 +231,7 @@ ZEELFObjectBuilder::addStandardSection(
 
     // total required padding is (padding + need_padding_for_align)
     sections.emplace_back(
-        ZEELFObjectBuilder::StandardSection(sectName, data, size, type,
+        ZEELFObjectBuilder::StandardSection(m_strTab.add(sectName), data, size, type,
             (need_padding_for_align + padding), m_sectionId));
     ++m_sectionId;
     return sections.back();
@@ -273,10 +334,10 @@ void ZEELFObjectBuilder::addSymbol(
 {
     if (binding == llvm::ELF::STB_LOCAL)
         m_localSymbols.emplace_back(
-            ZEELFObjectBuilder::Symbol(name, addr, size, binding, type, sectionId));
+            ZEELFObjectBuilder::Symbol(m_strTab.add(name), addr, size, binding, type, sectionId));
     else
         m_globalSymbols.emplace_back(
-            ZEELFObjectBuilder::Symbol(name, addr, size, binding, type, sectionId));
+            ZEELFObjectBuilder::Symbol(m_strTab.add(name), addr, size, binding, type, sectionId));
 }
 
 ZEELFObjectBuilder::RelocSection&
@@ -300,7 +361,7 @@ ZEELFObjectBuilder::getOrCreateRelocSection(SectionID targetSectId)
     else
         sectName = m_RelName;
 
-    m_relocSections.emplace_back(m_sectionId, targetSectId, sectName);
+    m_relocSections.emplace_back(m_sectionId, targetSectId, m_strTab.add(sectName));
     ++m_sectionId;
     return m_relocSections.back();
 }
@@ -311,28 +372,44 @@ void ZEELFObjectBuilder::addRelocation(
     RelocSection& reloc_sect = getOrCreateRelocSection(sectionId);
     // create the relocation
     reloc_sect.m_Relocations.emplace_back(
-        ZEELFObjectBuilder::Relocation(offset, symName, type));
+        ZEELFObjectBuilder::Relocation(offset, m_strTab.add(symName), type));
+}
+
+uint64_t ZEELFObjectBuilder::getBinarySize()
+{
+    ELFWriter w(*this);
+    return w.computeLayout();
 }
 
 uint64_t ZEELFObjectBuilder::finalize(llvm::raw_pwrite_stream& os)
 {
-    ELFWriter w(os, *this);
-    return w.write();
+    ELFWriter w(*this);
+    w.computeLayout();
+    return w.write(os);
+}
+
+uint64_t ZEELFObjectBuilder::finalize(uint8_t* buffer, uint64_t bufferSize)
+{
+    ELFWriter w(*this);
+    if (w.computeLayout() > bufferSize)
+        return 0;
+    BufferOStream os(buffer, bufferSize);
+    return w.write(os);
 }
 
 ZEELFObjectBuilder::SectionID
 ZEELFObjectBuilder::getSectionIDBySectionName(const char* name)
 {
     for (StandardSection& sect : m_textSections) {
-        if (strcmp(name, sect.m_sectName.c_str()) == 0)
+        if (strcmp(name, m_strTab.get(sect.m_sectName)) == 0)
             return sect.id();
     }
     for (StandardSection& sect : m_dataAndbssSections) {
-        if (strcmp(name, sect.m_sectName.c_str()) == 0)
+        if (strcmp(name, m_strTab.get(sect.m_sectName)) == 0)
             return sect.id();
     }
     for (StandardSection& sect : m_otherStdSections) {
-        if (strcmp(name, sect.m_sectName.c_str()) == 0)
+        if (strcmp(name, m_strTab.get(sect.m_sectName)) == 0)
             return sect.id();
     }
 
@@ -345,15 +422,15 @@ std::string ZEELFObjectBuilder::getSectionNameBySectionID(SectionID id)
     // do linear search that we assume there won't be too many sections
     for (StandardSection& sect : m_textSections) {
         if (sect.id() == id)
-            return sect.m_sectName;
+            return m_strTab.get(sect.m_sectName);
     }
     for (StandardSection& sect : m_dataAndbssSections) {
         if (sect.id() == id)
-            return sect.m_sectName;
+            return m_strTab.get(sect.m_sectName);
     }
     for (StandardSection& sect : m_otherStdSections) {
         if (sect.id() == id)
-            return sect.m_sectName;
+            return m_strTab.get(sect.m_sectName);
     }
     IGC_ASSERT_MESSAGE(0, "getSectionNameBySectionID: invalid SectionID");
     return "";
@@ -361,22 +438,21 @@ std::string ZEELFObjectBuilder::getSectionNameBySectionID(SectionID id)
 
 uint64_t ELFWriter::writeSectionData(const uint8_t* data, uint64_t size, uint32_t padding)
 {
-    uint64_t start_off = m_W.OS.tell();
+    uint64_t start_off = m_W->OS.tell();
 
     // it's possible that a section has only pading but no data
     if (data != nullptr)
-        m_W.OS.write((const char*)data, size);
+        m_W->OS.write((const char*)data, size);
 
     writePadding(padding);
 
-    IGC_ASSERT((m_W.OS.tell() - start_off) == (size + padding));
-    return m_W.OS.tell() - start_off;
+    IGC_ASSERT((m_W->OS.tell() - start_off) == (size + padding));
+    return m_W->OS.tell() - start_off;
 }
 
 void ELFWriter::writePadding(uint32_t size)
 {
-    for (uint32_t i = 0; i < size; ++i)
-        m_W.write<uint8_t>(0x0);
+    m_W->OS.write_zeros(size);
 }
 
 uint32_t ELFWriter::getSymTabEntSize()
@@ -395,24 +471,40 @@ uint32_t ELFWriter::getRelocTabEntSize()
         return sizeof(ELF::Elf32_Rel);
 }
 
+uint32_t ELFWriter::getHeaderSize()
+{
+    if (is64Bit())
+        return sizeof(ELF::Elf64_Ehdr);
+    else
+        return sizeof(ELF::Elf32_Ehdr);
+}
+
+uint32_t ELFWriter::getSectionHdrEntSize()
+{
+    if (is64Bit())
+        return sizeof(ELF::Elf64_Shdr);
+    else
+        return sizeof(ELF::Elf32_Shdr);
+}
+
 void ELFWriter::writeSymbol(uint32_t name, uint64_t value, uint64_t size,
     uint8_t binding, uint8_t type, uint8_t other, uint16_t shndx)
 {
     uint8_t info = (binding << 4) | (type & 0xf);
     if (is64Bit()) {
-        m_W.write(name);  // st_name
-        m_W.write(info);  // st_info
-        m_W.write(other); // st_other
-        m_W.write(shndx); // st_shndx
-        writeWord(value); // st_value
-        writeWord(size);  // st_size
+        m_W->write(name);  // st_name
+        m_W->write(info);  // st_info
+        m_W->write(other); // st_other
+        m_W->write(shndx); // st_shndx
+        writeWord(value);  // st_value
+        writeWord(size);   // st_size
     } else {
-        m_W.write(name);  // st_name
-        writeWord(value); // st_value
-        writeWord(size);  // st_size
-        m_W.write(info);  // st_info
-        m_W.write(other); // st_other
-        m_W.write(shndx); // st_shndx
+        m_W->write(name);  // st_name
+        writeWord(value);  // st_value
+        writeWord(size);   // st_size
+        m_W->write(info);  // st_info
+        m_W->write(other); // st_other
+        m_W->write(shndx); // st_shndx
     }
 }
 
@@ -420,18 +512,18 @@ void ELFWriter::writeRelocation(uint64_t offset, uint64_t type, uint64_t symIdx)
 {
     if (is64Bit()) {
         uint64_t info = (symIdx << 32) | (type & 0xffffffffL);
-        m_W.write(offset);
-        m_W.write(info);
+        m_W->write(offset);
+        m_W->write(info);
     } else {
         uint32_t info = ((uint32_t)symIdx << 8) | ((unsigned char)type);
-        m_W.write(uint32_t(offset));
-        m_W.write(info);
+        m_W->write(uint32_t(offset));
+        m_W->write(info);
     }
 }
 
 uint64_t ELFWriter::writeRelocTab(const RelocationListTy& relocs)
 {
-    uint64_t start_off = m_W.OS.tell();
+    uint64_t start_off = m_W->OS.tell();
 
     for (const ZEELFObjectBuilder::Relocation& reloc : relocs) {
         // the target symbol's name must have been added into symbol table
@@ -440,23 +532,35 @@ uint64_t ELFWriter::writeRelocTab(const RelocationListTy& relocs)
             reloc.offset(), reloc.type(), m_SymNameIdxMap[reloc.symName()]);
     }
 
-    return m_W.OS.tell() - start_off;
+    return m_W->OS.tell() - start_off;
 }
 
-uint64_t ELFWriter::writeSymTab()
+void ELFWriter::createSymbolIndices()
 {
-    uint64_t start_off = m_W.OS.tell();
+    // index 0 is the null symbol, then local symbols and global symbols in
+    // the order they are written by writeSymTab
+    uint64_t symidx = 1;
+    auto addOneSym = [&](const ZEELFObjectBuilder::Symbol& sym) {
+        // global symbol name must be unique
+        IGC_ASSERT(sym.binding() != llvm::ELF::STB_GLOBAL || m_SymNameIdxMap.find(sym.name()) == m_SymNameIdxMap.end());
+        m_SymNameIdxMap.insert(std::make_pair(sym.name(), symidx));
+        ++symidx;
+    };
 
-    uint64_t symidx = 0;
+    for (const ZEELFObjectBuilder::Symbol& sym : m_ObjBuilder.m_localSymbols)
+        addOneSym(sym);
+    for (const ZEELFObjectBuilder::Symbol& sym : m_ObjBuilder.m_globalSymbols)
+        addOneSym(sym);
+}
+
+uint64_t ELFWriter::writeSymTab()
+{
+    uint64_t start_off = m_W->OS.tell();
 
     // index 0 is the null symbol
     writeSymbol(0, 0, 0, 0, 0, 0, ELF::SHN_UNDEF);
-    ++symidx;
-
-    auto writeOneSym = [&](ZEELFObjectBuilder::Symbol& sym) {
-        // create symbol name entry in str table
-        uint32_t nameoff = m_StrTabBuilder.add(StringRef(sym.name()));
 
+    auto writeOneSym = [&](const ZEELFObjectBuilder::Symbol& sym) {
         uint16_t sect_idx = 0;
         if (sym.sectionId() >= 0) {
             // the given section's index must have been adjusted in
@@ -468,50 +572,41 @@ uint64_t ELFWriter::writeSymTab()
             sect_idx = ELF::SHN_UNDEF;
         }
 
-        writeSymbol(nameoff, sym.addr(), sym.size(), sym.binding(), sym.type(),
+        writeSymbol(sym.name(), sym.addr(), sym.size(), sym.binding(), sym.type(),
             0, sect_idx);
-        // global symbol name must be unique
-        IGC_ASSERT(sym.binding() != llvm::ELF::STB_GLOBAL || m_SymNameIdxMap.find(sym.name()) == m_SymNameIdxMap.end());
-        m_SymNameIdxMap.insert(std::make_pair(sym.name(), symidx));
-        ++symidx;
     };
 
     // Write the local symbols first
-    for (ZEELFObjectBuilder::Symbol& sym : m_ObjBuilder.m_localSymbols) {
+    for (const ZEELFObjectBuilder::Symbol& sym : m_ObjBuilder.m_localSymbols) {
         writeOneSym(sym);
     }
 
     // And then global symbols
-    for (ZEELFObjectBuilder::Symbol& sym : m_ObjBuilder.m_globalSymbols) {
+    for (const ZEELFObjectBuilder::Symbol& sym : m_ObjBuilder.m_globalSymbols) {
         writeOneSym(sym);
     }
 
-    return m_W.OS.tell() - start_off;
+    return m_W->OS.tell() - start_off;
 }
 
 uint64_t ELFWriter::writeZEInfo()
 {
-    uint64_t start_off = m_W.OS.tell();
-    // serialize ze_info contents
-    llvm::yaml::Output yout(m_W.OS);
+    uint64_t start_off = m_W->OS.tell();
     IGC_ASSERT(nullptr != m_ObjBuilder.m_zeInfoSection);
-    yout << m_ObjBuilder.m_zeInfoSection->getZeInfo();
+    m_W->OS << m_ObjBuilder.m_zeInfoSection->getSerialized();
 
-    return m_W.OS.tell() - start_off;
+    return m_W->OS.tell() - start_off;
 }
 
 uint64_t ELFWriter::writeStrTab()
 {
-    uint64_t start_off = m_W.OS.tell();
+    uint64_t start_off = m_W->OS.tell();
 
-    // at this point, all strings should be added. Finalized the string table
-    // and write it to OS
-    // must finlized it in order, that we take the offset of
-    // section and symbols' name when added
-    m_StrTabBuilder.finalizeInOrder();
-    m_StrTabBuilder.write(m_W.OS);
+    // all section and symbol names were interned into the string table when
+    // they were added
+    m_W->OS << m_ObjBuilder.m_strTab.data();
 
-    return m_W.OS.tell() - start_off;
+    return m_W->OS.tell() - start_off;
 }
 
 void ELFWriter::writeSecHdrEntry(uint32_t name, uint32_t type, uint64_t flags,
@@ -519,14 +614,14 @@ void ELFWriter::writeSecHdrEntry(uint32_t name, uint32_t type, uint64_t flags,
     uint64_t size, uint32_t link, uint32_t info,
     uint64_t addralign, uint64_t entsize)
 {
-    m_W.write(name);      // sh_name
-    m_W.write(type);      // sh_type
+    m_W->write(name);     // sh_name
+    m_W->write(type);     // sh_type
     writeWord(flags);     // sh_flags
     writeWord(address);   // sh_addr
     writeWord(offset);    // sh_offset
     writeWord(size);      // sh_size
-    m_W.write(link);      // sh_link
-    m_W.write(info);      // sh_info
+    m_W->write(link);     // sh_link
+    m_W->write(info);     // sh_info
     writeWord(addralign); // sh_addralign
     writeWord(entsize);   // sh_entsize
 }
@@ -534,7 +629,7 @@ void ELFWriter::writeSecHdrEntry(uint32_t name, uint32_t type, uint64_t flags,
 void ELFWriter::writeSectionHeader()
 {
     // all SectionHdrEntry fields should be fill-up in either
-    // createSectionHdrEntries or writeSections
+    // createSectionHdrEntries or layoutSections
     for (SectionHdrEntry& entry : m_SectionHdrEntries) {
         writeSecHdrEntry(
             entry.name, entry.type, 0, 0, entry.offset, entry.size, entry.link,
@@ -542,25 +637,27 @@ void ELFWriter::writeSectionHeader()
     }
 }
 
-void ELFWriter::writeSections()
+uint64_t ELFWriter::layoutSections(uint64_t offset)
 {
     for (SectionHdrEntry& entry : m_SectionHdrEntries) {
-        entry.offset = m_W.OS.tell();
+        entry.offset = offset;
 
         switch(entry.type) {
         case ELF::SHT_PROGBITS:
-        case SHT_ZEBIN_SPIRV: {
+        case SHT_ZEBIN_SPIRV:
+        case SHT_ZEBIN_GTPIN_INFO: {
             IGC_ASSERT(nullptr != entry.section);
             IGC_ASSERT(entry.section->getKind() == Section::STANDARD);
             const StandardSection* const stdsect =
                 static_cast<const StandardSection*>(entry.section);
             IGC_ASSERT(nullptr != stdsect);
             IGC_ASSERT(stdsect->m_size + stdsect->m_padding);
-            entry.size = writeSectionData(
-                stdsect->m_data, stdsect->m_size, stdsect->m_padding);
+            entry.size = stdsect->m_size + stdsect->m_padding;
+            offset += entry.size;
             break;
         }
         case ELF::SHT_NOBITS: {
+            // occupies no space in the file
             const StandardSection* const stdsect =
                 static_cast<const StandardSection*>(entry.section);
             IGC_ASSERT(nullptr != stdsect);
@@ -568,12 +665,15 @@ void ELFWriter::writeSections()
             break;
         }
         case ELF::SHT_SYMTAB:
-            entry.size = writeSymTab();
             entry.entsize = getSymTabEntSize();
+            // the null symbol, then all local and global symbols
+            entry.size = entry.entsize * (1 + m_ObjBuilder.m_localSymbols.size() +
+                m_ObjBuilder.m_globalSymbols.size());
             entry.link = m_StringTableIndex;
             // one greater than the last local symbol index, including the
             // first null symbol
             entry.info = m_ObjBuilder.m_localSymbols.size() + 1;
+            offset += entry.size;
             break;
 
         case ELF::SHT_REL: {
@@ -582,16 +682,20 @@ void ELFWriter::writeSections()
             const RelocSection* const relocSec =
                 static_cast<const RelocSection*>(entry.section);
             IGC_ASSERT(nullptr != relocSec);
-            entry.size = writeRelocTab(relocSec->m_Relocations);
             entry.entsize = getRelocTabEntSize();
+            entry.size = entry.entsize * relocSec->m_Relocations.size();
+            offset += entry.size;
             break;
         }
         case SHT_ZEBIN_ZEINFO:
-            entry.size = writeZEInfo();
+            IGC_ASSERT(nullptr != m_ObjBuilder.m_zeInfoSection);
+            entry.size = m_ObjBuilder.m_zeInfoSection->getSerialized().size();
+            offset += entry.size;
             break;
 
         case ELF::SHT_STRTAB:
-            entry.size = writeStrTab();
+            entry.size = m_ObjBuilder.m_strTab.data().size();
+            offset += entry.size;
             break;
 
         case ELF::SHT_NULL:
@@ -606,52 +710,80 @@ void ELFWriter::writeSections()
             break;
         }
     }
+    return offset;
 }
 
-void ELFWriter::writeSectionHdrOffset(uint64_t offset)
+void ELFWriter::writeSections()
 {
-    auto &stream = static_cast<raw_pwrite_stream &>(m_W.OS);
+    for (SectionHdrEntry& entry : m_SectionHdrEntries) {
+        IGC_ASSERT(entry.offset == m_W->OS.tell());
+        uint64_t size = 0;
 
-    if (is64Bit()) {
-        uint64_t Val =
-            support::endian::byte_swap<uint64_t>(offset, m_W.Endian);
-        stream.pwrite(reinterpret_cast<char *>(&Val), sizeof(Val),
-            offsetof(ELF::Elf64_Ehdr, e_shoff));
+        switch(entry.type) {
+        case ELF::SHT_PROGBITS:
+        case SHT_ZEBIN_SPIRV:
+        case SHT_ZEBIN_GTPIN_INFO: {
+            const StandardSection* const stdsect =
+                static_cast<const StandardSection*>(entry.section);
+            size = writeSectionData(
+                stdsect->m_data, stdsect->m_size, stdsect->m_padding);
+            break;
+        }
+        case ELF::SHT_SYMTAB:
+            size = writeSymTab();
+            break;
 
-    } else {
-        uint32_t Val =
-            support::endian::byte_swap<uint32_t>(
-                static_cast<uint32_t>(offset), m_W.Endian);
-        stream.pwrite(reinterpret_cast<char *>(&Val), sizeof(Val),
-            offsetof(ELF::Elf32_Ehdr, e_shoff));
+        case ELF::SHT_REL:
+            size = writeRelocTab(
+                static_cast<const RelocSection*>(entry.section)->m_Relocations);
+            break;
+
+        case SHT_ZEBIN_ZEINFO:
+            size = writeZEInfo();
+            break;
+
+        case ELF::SHT_STRTAB:
+            size = writeStrTab();
+            break;
+
+        case ELF::SHT_NOBITS:
+        case ELF::SHT_NULL:
+            // nothing in the file
+            continue;
+
+        default:
+            IGC_ASSERT(0);
+            break;
+        }
+        IGC_ASSERT(size == entry.size);
     }
 }
 
 void ELFWriter::writeHeader()
 {
     // e_ident[EI_MAG0] to e_ident[EI_MAG3]
-    m_W.OS << ELF::ElfMagic;
+    m_W->OS << ELF::ElfMagic;
 
     // e_ident[EI_CLASS]
-    m_W.OS << char(m_ObjBuilder.m_is64Bit ? ELF::ELFCLASS64 : ELF::ELFCLASS32);
+    m_W->OS << char(m_ObjBuilder.m_is64Bit ? ELF::ELFCLASS64 : ELF::ELFCLASS32);
 
     // e_ident[EI_DATA]
-    m_W.OS << char(ELF::ELFDATA2LSB);
+    m_W->OS << char(ELF::ELFDATA2LSB);
 
     // e_ident[EI_VERSION]
-    m_W.OS << char(0);
+    m_W->OS << char(0);
 
     // e_ident padding
-    m_W.OS.write_zeros(ELF::EI_NIDENT - ELF::EI_OSABI);
+    m_W->OS.write_zeros(ELF::EI_NIDENT - ELF::EI_OSABI);
 
     // e_type
-    m_W.write<uint16_t>(m_ObjBuilder.m_fileType);
+    m_W->write<uint16_t>(m_ObjBuilder.m_fileType);
 
     // e_machine
-    m_W.write<uint16_t>(m_ObjBuilder.m_machineType);
+    m_W->write<uint16_t>(m_ObjBuilder.m_machineType);
 
     // e_version
-    m_W.write<uint32_t>(0);
+    m_W->write<uint32_t>(0);
 
     // e_entry, no entry point
     writeWord(0);
@@ -659,28 +791,26 @@ void ELFWriter::writeHeader()
     // e_phoff, no program header
     writeWord(0);
 
-    // e_shoff, will write it later
-    writeWord(0);
+    // e_shoff, known from the layout
+    writeWord(m_SectionHdrOffset);
 
     // e_flags
-    m_W.write<uint32_t>(m_ObjBuilder.m_flags.packed);
+    m_W->write<uint32_t>(m_ObjBuilder.m_flags.packed);
 
     // e_ehsize = ELF header size
-    m_W.write<uint16_t>(is64Bit() ?
-        sizeof(ELF::Elf64_Ehdr) : sizeof(ELF::Elf32_Ehdr));
+    m_W->write<uint16_t>(getHeaderSize());
 
-    m_W.write<uint16_t>(0);          // e_phentsize = prog header entry size
-    m_W.write<uint16_t>(0);          // e_phnum = # prog header entries = 0
+    m_W->write<uint16_t>(0);          // e_phentsize = prog header entry size
+    m_W->write<uint16_t>(0);          // e_phnum = # prog header entries = 0
 
     // e_shentsize
-    m_W.write<uint16_t>(is64Bit() ?
-        sizeof(ELF::Elf64_Shdr) : sizeof(ELF::Elf32_Shdr));
+    m_W->write<uint16_t>(getSectionHdrEntSize());
 
     // e_shnum
-    m_W.write<uint16_t>(numOfSections());
+    m_W->write<uint16_t>(numOfSections());
 
     // e_shstrndx  = .strtab index
-    m_W.write<uint16_t>(m_StringTableIndex);
+    m_W->write<uint16_t>(m_StringTableIndex);
 }
 
 uint16_t ELFWriter::numOfSections()
@@ -689,22 +819,36 @@ uint16_t ELFWriter::numOfSections()
     return m_StringTableIndex + 1;
 }
 
-ELFWriter::ELFWriter(llvm::raw_pwrite_stream& OS,
-                     ZEELFObjectBuilder& objBuilder)
-    : m_W(OS, llvm::support::little), m_ObjBuilder(objBuilder)
+ELFWriter::ELFWriter(ZEELFObjectBuilder& objBuilder)
+    : m_ObjBuilder(objBuilder)
 {
 }
 
-uint64_t ELFWriter::write()
+uint64_t ELFWriter::computeLayout()
 {
-    uint64_t start = m_W.OS.tell();
     createSectionHdrEntries();
+    createSymbolIndices();
+    m_SectionHdrOffset = layoutSections(getHeaderSize());
+    m_FileSize = m_SectionHdrOffset +
+        uint64_t(getSectionHdrEntSize()) * m_SectionHdrEntries.size();
+    return m_FileSize;
+}
+
+uint64_t ELFWriter::write(llvm::raw_ostream& OS)
+{
+    IGC_ASSERT_MESSAGE(m_FileSize != 0, "computeLayout must be called first");
+    llvm::support::endian::Writer W(OS, llvm::support::little);
+    m_W = &W;
+
+    uint64_t start = OS.tell();
     writeHeader();
     writeSections();
-    uint64_t sectHdrOff = m_W.OS.tell();
+    IGC_ASSERT(OS.tell() - start == m_SectionHdrOffset);
     writeSectionHeader();
-    writeSectionHdrOffset(sectHdrOff);
-    return m_W.OS.tell() - start;
+    IGC_ASSERT(OS.tell() - start == m_FileSize);
+
+    m_W = nullptr;
+    return OS.tell() - start;
 }
 
 ELFWriter::SectionHdrEntry& ELFWriter::createNullSectionHdrEntry()
@@ -717,14 +861,13 @@ ELFWriter::SectionHdrEntry& ELFWriter::createNullSectionHdrEntry()
 }
 
 ELFWriter::SectionHdrEntry& ELFWriter::createSectionHdrEntry(
-    const std::string& name, unsigned type, const Section* sect)
+    uint32_t name, unsigned type, const Section* sect)
 {
     m_SectionHdrEntries.emplace_back(SectionHdrEntry());
     SectionHdrEntry& entry = m_SectionHdrEntries.back();
     entry.type = type;
     entry.section = sect;
-    uint32_t nameoff = m_StrTabBuilder.add(StringRef(name));
-    entry.name = nameoff;
+    entry.name = name;
     return entry;
 }
 
@@ -741,6 +884,10 @@ void ELFWriter::createSectionHdrEntries()
     // .ze_info
     // .strtab
 
+    // The names of the sections created here must be in the string table
+    // before its size is taken; adding them again is a no-op
+    ZEELFObjectBuilder::StringTable& strTab = m_ObjBuilder.m_strTab;
+
     // first entry is NULL section
     createNullSectionHdrEntry();
 
@@ -764,7 +911,7 @@ void ELFWriter::createSectionHdrEntries()
         !m_ObjBuilder.m_globalSymbols.empty()) {
         m_SymTabIndex = index;
         ++index;
-        createSectionHdrEntry(m_ObjBuilder.m_SymTabName, ELF::SHT_SYMTAB);
+        createSectionHdrEntry(strTab.add(m_ObjBuilder.m_SymTabName), ELF::SHT_SYMTAB);
     }
 
     // other sections
@@ -793,7 +940,7 @@ void ELFWriter::createSectionHdrEntries()
     // .ze_info
     // every object must have exactly one ze_info section
     if (m_ObjBuilder.m_zeInfoSection != nullptr) {
-        createSectionHdrEntry(m_ObjBuilder.m_ZEInfoName, SHT_ZEBIN_ZEINFO,
+        createSectionHdrEntry(strTab.add(m_ObjBuilder.m_ZEInfoName), SHT_ZEBIN_ZEINFO,
             m_ObjBuilder.m_zeInfoSection);
         ++index;
     }
@@ -802,7 +949,7 @@ void ELFWriter::createSectionHdrEntries()
 
     // .strtab
     m_StringTableIndex = index;
-    createSectionHdrEntry(m_ObjBuilder.m_StrTabName, ELF::SHT_STRTAB);
+    createSectionHdrEntry(strTab.add(m_ObjBuilder.m_StrTabName), ELF::SHT_STRTAB);
 }
 
 // createKernel - create a zeInfoKernel and add it into zeInfoContainer
@@ -39,6 +39,8 @@ IN THE SOFTWARE.
 #include "common/LLVMWarningsPush.hpp"
 #endif
 
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/ELF.h"
 
 #ifndef ZEBinStandAloneBuild
@@ -50,6 +52,7 @@ IN THE SOFTWARE.
 #include <vector>
 
 namespace llvm {
+    class raw_ostream;
     class raw_pwrite_stream;
 }
 
@@ -198,15 +201,44 @@ public:
     void addRelocation(
         uint64_t offset, std::string symName, R_TYPE_ZEBIN type, SectionID sectionId);
 
+    // getBinarySize - compute the layout of the ELF Object and return its
+    // exact size in bytes. All sections, symbols and relocations must have
+    // been added, and the ze_info contents must not change afterwards
+    uint64_t getBinarySize();
+
     // finalize - Finalize the ELF Object, write ELF file into given os
+    // The file is written front to back, os is never seeked
     // return number of written bytes
     uint64_t finalize(llvm::raw_pwrite_stream& os);
 
+    // finalize - Finalize the ELF Object, write ELF file into the given buffer
+    // - buffer     : output buffer, at least getBinarySize() bytes
+    // - bufferSize : size of the output buffer in bytes
+    // return number of written bytes, or 0 if the buffer is too small
+    uint64_t finalize(uint8_t* buffer, uint64_t bufferSize);
+
     // get an ID of a section
     // - name  : section name
     SectionID getSectionIDBySectionName(const char* name);
 
 private:
+    // StringTable - the .strtab contents. Section and symbol names are interned
+    // here when they are added, and are referred to by their offset afterwards
+    class StringTable {
+    public:
+        StringTable() : m_data(1, '\0') {}
+
+        // add a string if it's not already in the table, return its offset
+        uint32_t add(llvm::StringRef str);
+
+        const char* get(uint32_t offset) const { return m_data.data() + offset; }
+        const std::string& data() const { return m_data; }
+
+    private:
+        std::string m_data;
+        llvm::StringMap<uint32_t> m_offsets;
+    };
+
     class Section {
     public:
         enum Kind {STANDARD, RELOC, ZEINFO};
@@ -226,7 +258,7 @@ private:
 
     class StandardSection : public Section {
     public:
-        StandardSection(std::string sectName, const uint8_t* data, uint64_t size,
+        StandardSection(uint32_t sectName, const uint8_t* data, uint64_t size,
             unsigned type, uint32_t padding, uint32_t id)
             : Section(id), m_sectName(sectName), m_data(data), m_size(size), m_type(type),
               m_padding(padding)
@@ -234,9 +266,9 @@ private:
 
         Kind getKind() const { return STANDARD; }
 
-        // m_sectName - the final name presented in ELF section header
-        // This field is required as the place holder for StringTable construction
-        std::string m_sectName;
+        // m_sectName - string table offset of the final name presented in ELF
+        // section header
+        uint32_t m_sectName;
         const uint8_t* m_data;
         uint64_t m_size;
         // section type
@@ -255,19 +287,26 @@ private:
         zeInfoContainer& getZeInfo()
         { return m_zeinfo; }
 
+        // getSerialized - the YAML form of the ze_info contents. It is created
+        // when the layout is first computed and reused for writing
+        const std::string& getSerialized();
+
     private:
         zeInfoContainer& m_zeinfo;
+        std::string m_serialized;
+        bool m_isSerialized = false;
     };
 
     class Symbol {
     public:
-        Symbol(std::string name, uint64_t addr, uint64_t size, uint8_t binding,
+        Symbol(uint32_t name, uint64_t addr, uint64_t size, uint8_t binding,
             uint8_t type, SectionID sectionId)
             : m_name(name), m_addr(addr), m_size(size), m_binding(binding),
             m_type(type), m_sectionId(sectionId)
         {}
 
-        std::string& name()            { return m_name;      }
+        // string table offset of the symbol's name
+        uint32_t     name()      const { return m_name;      }
         uint64_t     addr()      const { return m_addr;      }
         uint64_t     size()      const { return m_size;      }
         uint8_t      binding()   const { return m_binding;   }
@@ -275,7 +314,7 @@ private:
         SectionID    sectionId() const { return m_sectionId; }
 
     private:
-        std::string m_name;
+        uint32_t m_name;
         uint64_t m_addr;
         uint64_t m_size;
         uint8_t m_binding;
@@ -285,17 +324,18 @@ private:
 
     class Relocation {
     public:
-        Relocation(uint64_t offset, std::string symName, R_TYPE_ZEBIN type)
+        Relocation(uint64_t offset, uint32_t symName, R_TYPE_ZEBIN type)
             : m_offset(offset), m_symName(symName), m_type(type)
         {}
 
         uint64_t            offset()  const { return m_offset;  }
-        const std::string&  symName() const { return m_symName; }
+        // string table offset of the target symbol's name
+        uint32_t            symName() const { return m_symName; }
         R_TYPE_ZEBIN        type()    const { return m_type;    }
 
     private:
         uint64_t m_offset;
-        std::string m_symName;
+        uint32_t m_symName;
         R_TYPE_ZEBIN m_type;
     };
 
@@ -305,7 +345,7 @@ private:
 
     class RelocSection : public Section {
     public:
-        RelocSection(SectionID myID, SectionID targetID, std::string sectName)
+        RelocSection(SectionID myID, SectionID targetID, uint32_t sectName)
             : Section(myID), m_TargetID(targetID), m_sectName(sectName)
         {}
 
@@ -313,7 +353,8 @@ private:
 
         // target section's id that this relocation section apply to
         SectionID m_TargetID;
-        std::string m_sectName;
+        // string table offset of the section name
+        uint32_t m_sectName;
         RelocationListTy m_Relocations;
     };
     typedef std::vector<RelocSection> RelocSectionListTy;
@@ -362,6 +403,9 @@ private:
     SymbolListTy m_localSymbols;
     SymbolListTy m_globalSymbols;
 
+    // names of all sections and symbols
+    StringTable m_strTab;
+
 };
 
 /// ZEInfoBuilder - Build a zeInfoContainer for .ze_info section
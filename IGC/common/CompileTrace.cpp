@@ -0,0 +1,196 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (c) 2000-2021 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom
+the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+
+============================= end_copyright_notice ===========================*/
+
+
+#include "common/CompileTrace.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/Path.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <chrono>
+#include <fstream>
+#include "Probe/Assertion.h"
+
+// Provided by vISA (Timer.cpp, Arena.cpp).
+extern "C" const char* getTimerName(unsigned int idx);
+extern "C" void setTimerEventRecording(bool enable);
+extern "C" unsigned int getTimerEventCount();
+extern "C" void getTimerEvent(
+    unsigned int idx, unsigned int* timerIdx, uint64_t* startUS, uint64_t* endUS, uint64_t* arenaPeakBytes);
+extern "C" void clearTimerEvents();
+extern "C" size_t beginArenaPeakWindow();
+extern "C" size_t endArenaPeakWindow(size_t outerPeak);
+
+using namespace llvm;
+using namespace IGC;
+
+CompileTrace::CompileTrace(std::string fileName)
+    : m_fileName(std::move(fileName))
+    , m_originUS(now())
+{
+}
+
+CompileTrace::~CompileTrace()
+{
+    uint64_t endUS = now();
+    for (auto& it : m_openSpans)
+    {
+        while (!it.second.empty())
+        {
+            endSpan(it.second, endUS);
+        }
+    }
+
+    std::string json;
+    raw_string_ostream OS(json);
+    write(OS);
+    OS.flush();
+
+    std::ofstream file(m_fileName, std::ios::out | std::ios::binary);
+    file.write(json.data(), json.size());
+}
+
+uint64_t CompileTrace::now()
+{
+    // vISA timer events use the same monotonic clock.
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+unsigned CompileTrace::getThreadIndex(std::thread::id id)
+{
+    auto it = m_threads.find(id);
+    if (it == m_threads.end())
+    {
+        it = m_threads.emplace(id, (unsigned)m_threads.size()).first;
+    }
+    return it->second;
+}
+
+void CompileTrace::beginSpan(StringRef name, const char* category, json::Object args)
+{
+    // Opening the arena window is thread local and therefore done outside the lock.
+    size_t outerArenaPeak = beginArenaPeakWindow();
+    uint64_t startUS = now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::thread::id id = std::this_thread::get_id();
+    m_spans.push_back(Span{ name.str(), category, std::move(args), getThreadIndex(id), startUS, 0, 0 });
+    m_openSpans[id].push_back(OpenSpan{ m_spans.size() - 1, outerArenaPeak });
+}
+
+void CompileTrace::endSpan(std::vector<OpenSpan>& stack, uint64_t endUS)
+{
+    Span& span = m_spans[stack.back().index];
+    span.endUS = endUS;
+    span.arenaPeakBytes = endArenaPeakWindow(stack.back().outerArenaPeak);
+    stack.pop_back();
+}
+
+void CompileTrace::endSpan()
+{
+    uint64_t endUS = now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<OpenSpan>& stack = m_openSpans[std::this_thread::get_id()];
+    IGC_ASSERT_MESSAGE(!stack.empty(), "unbalanced compile trace span");
+    if (!stack.empty())
+    {
+        endSpan(stack, endUS);
+    }
+}
+
+void CompileTrace::startVISAPhases()
+{
+    clearTimerEvents();
+    setTimerEventRecording(true);
+}
+
+void CompileTrace::recordVISAPhases()
+{
+    setTimerEventRecording(false);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    unsigned tid = getThreadIndex(std::this_thread::get_id());
+    for (unsigned i = 0, e = getTimerEventCount(); i < e; ++i)
+    {
+        unsigned timer = 0;
+        uint64_t startUS = 0, endUS = 0, arenaPeakBytes = 0;
+        getTimerEvent(i, &timer, &startUS, &endUS, &arenaPeakBytes);
+        // The vISA timer names are indented for the flat text report.
+        StringRef name = StringRef(getTimerName(timer)).ltrim();
+        m_spans.push_back(Span{ name.str(), "vISA", json::Object(), tid, startUS, endUS, arenaPeakBytes });
+    }
+    clearTimerEvents();
+}
+
+void CompileTrace::write(raw_ostream& OS)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    json::Array events;
+    for (Span& span : m_spans)
+    {
+        json::Object args = std::move(span.args);
+        args["arena_peak_bytes"] = (int64_t)span.arenaPeakBytes;
+
+        // Events that started before the trace (vISA IR building for a kernel
+        // whose builder predates it) are clamped to the origin.
+        uint64_t startUS = std::max(span.startUS, m_originUS);
+        uint64_t endUS = std::max(span.endUS, startUS);
+        events.push_back(json::Object{
+            { "name", std::move(span.name) },
+            { "cat", span.category },
+            { "ph", "X" },
+            { "pid", 0 },
+            { "tid", (int64_t)span.tid },
+            { "ts", (int64_t)(startUS - m_originUS) },
+            { "dur", (int64_t)(endUS - startUS) },
+            { "args", std::move(args) } });
+    }
+    m_spans.clear();
+
+    OS << json::Value(json::Object{
+        { "traceEvents", std::move(events) },
+        { "displayTimeUnit", "ms" } });
+    OS << "\n";
+}
+
+std::string CompileTrace::getFileName(uint64_t hash)
+{
+    SmallString<256> path(IGC_GET_REGKEYSTRING(CompileTraceDir));
+    if (path.empty())
+    {
+        sys::path::system_temp_directory(/*ErasedOnReboot=*/true, path);
+    }
+
+    std::string name;
+    raw_string_ostream nameOS(name);
+    nameOS << "igc_trace_" << format_hex_no_prefix(hash, 16) << ".json";
+    sys::path::append(path, nameOS.str());
+    return path.str().str();
+}
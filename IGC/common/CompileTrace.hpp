@@ -0,0 +1,150 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (c) 2000-2021 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom
+the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+
+============================= end_copyright_notice ===========================*/
+
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace IGC
+{
+    /// Hierarchical compile-time trace of one program, written as Chrome
+    /// trace-event JSON (viewable in chrome://tracing or Perfetto).
+    ///
+    /// Spans are opened and closed on the calling thread and must be properly
+    /// nested per thread: program > retry > LLVM pass > kernel/SIMD > vISA phase.
+    /// vISA phases are taken from the vISA timers, which record timestamped
+    /// events while a trace is active. Every span carries the vISA arena
+    /// high-water mark reached while it was open.
+    ///
+    /// The trace is written when the object is destroyed; spans that are still
+    /// open at that point (e.g. after an early error return) are closed first.
+    class CompileTrace
+    {
+    public:
+        explicit CompileTrace(std::string fileName);
+        ~CompileTrace();
+
+        CompileTrace(const CompileTrace&) = delete;
+        CompileTrace& operator=(const CompileTrace&) = delete;
+
+        void beginSpan(llvm::StringRef name, const char* category, llvm::json::Object args = llvm::json::Object());
+        void endSpan();
+
+        /// Start recording vISA timer events on the calling thread.
+        static void startVISAPhases();
+        /// Turn the vISA timer events of the calling thread into spans and stop
+        /// recording them.
+        void recordVISAPhases();
+
+        void write(llvm::raw_ostream& OS);
+
+        /// Returns the trace output file for a program with the given hash,
+        /// honoring CompileTraceDir.
+        static std::string getFileName(uint64_t hash);
+
+    private:
+        struct Span
+        {
+            std::string name;
+            const char* category;
+            llvm::json::Object args;
+            unsigned tid;
+            uint64_t startUS;
+            uint64_t endUS;
+            uint64_t arenaPeakBytes;
+        };
+
+        struct OpenSpan
+        {
+            size_t index;
+            size_t outerArenaPeak;
+        };
+
+        static uint64_t now();
+        unsigned getThreadIndex(std::thread::id id);
+        void endSpan(std::vector<OpenSpan>& stack, uint64_t endUS);
+
+        std::string m_fileName;
+        uint64_t m_originUS;
+        std::mutex m_mutex;
+        std::vector<Span> m_spans;
+        std::map<std::thread::id, unsigned> m_threads;
+        std::map<std::thread::id, std::vector<OpenSpan>> m_openSpans;
+    };
+
+    /// Opens a span for the lifetime of the scope; a null trace is a no-op.
+    class CompileTraceScope
+    {
+    public:
+        CompileTraceScope(CompileTrace* trace, llvm::StringRef name, const char* category,
+            llvm::json::Object args = llvm::json::Object())
+            : m_trace(trace)
+        {
+            if (m_trace)
+            {
+                m_trace->beginSpan(name, category, std::move(args));
+            }
+        }
+
+        ~CompileTraceScope()
+        {
+            if (m_trace)
+            {
+                m_trace->endSpan();
+            }
+        }
+
+    private:
+        CompileTrace* m_trace;
+    };
+} // namespace IGC
+
+#define COMPILE_TRACE_BEGIN( pointer, name, category ) \
+    do \
+    { \
+        if( (pointer) && (pointer)->m_compileTrace ) \
+        { \
+            (pointer)->m_compileTrace->beginSpan( name, category ); \
+        } \
+    } while (0)
+#define COMPILE_TRACE_END( pointer ) \
+    do \
+    { \
+        if( (pointer) && (pointer)->m_compileTrace ) \
+        { \
+            (pointer)->m_compileTrace->endSpan(); \
+        } \
+    } while (0)
@@ -26,16 +26,23 @@ IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/PassTimer.hpp"
 #include "Compiler/CISACodeGen/TimeStatsCounter.h"
 #include "common/Stats.hpp"
+#include "common/debug/AsyncDump.hpp"
 #include "common/debug/Dump.hpp"
 #include "common/shaderOverride.hpp"
 #include "common/IntrinsicAnnotator.hpp"
 #include "common/LLVMUtils.h"
 
 #include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/SourceMgr.h>
 #include "common/LLVMWarningsPop.hpp"
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
 using namespace IGC;
 using namespace IGC::Debug;
 using namespace llvm;
@@ -96,14 +103,18 @@ void IGCPassManager::add(Pass *P)
         addPrintPass(P, true);
     }
 
-    if (IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS))
+    // Per-pass timers also provide the LLVM pass spans of the compile trace.
+    const bool timePass =
+        IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS) || m_pContext->m_compileTrace;
+
+    if (timePass)
     {
         PassManager::add(createTimeStatsIGCPass(m_pContext, m_name + '_' + std::string(P->getPassName()), STATS_COUNTER_START));
     }
 
     PassManager::add(P);
 
-    if (IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS))
+    if (timePass)
     {
         PassManager::add(createTimeStatsIGCPass(m_pContext, m_name + '_' + std::string(P->getPassName()), STATS_COUNTER_END));
     }
@@ -173,6 +184,14 @@ void IGCPassManager::addPrintPass(Pass* P, bool isBefore)
         .Pass(passName, m_pContext->m_numPasses++)
         .StagedInfo(m_pContext)
         .Extension("ll");
+    if (IGC::Debug::IsAsyncDumpEnabled() && P->getPassKind() == PT_Module)
+    {
+        // Snapshot the whole module and leave printing to the dump writer.
+        // Function passes keep their printer: a module pass after them would
+        // split their function pass manager and change the pass interleaving.
+        PassManager::add(IGC::Debug::createAsyncDumpPass(name));
+        return;
+    }
     // The dump object needs to be on the Heap because it owns the stream, and the stream
     // is taken by reference into the printer pass. If the Dump object had been on the
     // stack, then that reference would go bad as soon as we exit this scope, and then
@@ -193,14 +212,67 @@ IGCPassManager::~IGCPassManager()
     }
 }
 
+// Points the functions and globals referenced by the module metadata, which
+// belong to the module a dump was taken from, to their counterparts in the copy
+// read back from the dump. The bitcode keeps the order of both lists. Entries
+// whose function or global is not in the snapshot are dropped.
+static void remapModuleMetaData(
+    IGC::ModuleMetaData& moduleMD,
+    const std::vector<const void*>& functions,
+    const std::vector<const void*>& globals,
+    Module& copy)
+{
+    llvm::DenseMap<const void*, Value*> valueMap;
+    auto F = copy.begin();
+    for (const void* pFunc : functions)
+    {
+        valueMap[pFunc] = &*F++;
+    }
+    auto G = copy.global_begin();
+    for (const void* pGlobal : globals)
+    {
+        valueMap[pGlobal] = &*G++;
+    }
+
+    std::map<Function*, IGC::FunctionMetaData> funcMD;
+    for (auto& it : moduleMD.FuncMD)
+    {
+        auto* pFunc = cast_or_null<Function>(valueMap.lookup(it.first));
+        if (!pFunc)
+        {
+            continue;
+        }
+        IGC::FunctionMetaData& MD = funcMD[pFunc] = std::move(it.second);
+        for (auto& offset : MD.localOffsets)
+        {
+            offset.m_Var = cast_or_null<GlobalVariable>(valueMap.lookup(offset.m_Var));
+        }
+        MD.localOffsets.erase(
+            std::remove_if(MD.localOffsets.begin(), MD.localOffsets.end(),
+                [](const IGC::LocalOffsetMD& offset) { return offset.m_Var == nullptr; }),
+            MD.localOffsets.end());
+    }
+    moduleMD.FuncMD = std::move(funcMD);
+
+    std::map<GlobalVariable*, int> inlineProgramScopeOffsets;
+    for (auto& it : moduleMD.inlineProgramScopeOffsets)
+    {
+        if (auto* pGlobal = cast_or_null<GlobalVariable>(valueMap.lookup(it.first)))
+        {
+            inlineProgramScopeOffsets[pGlobal] = it.second;
+        }
+    }
+    moduleMD.inlineProgramScopeOffsets = std::move(inlineProgramScopeOffsets);
+}
+
 void DumpLLVMIR(IGC::CodeGenContext* pContext, const char* dumpName)
 {
     SetCurrentDebugHash(pContext->hash.asmHash);
 
     if (IGC_IS_FLAG_ENABLED(DumpLLVMIR))
     {
+        // Only writes the function info if it changed since the last save.
         pContext->getMetaDataUtils()->save(*pContext->getLLVMContext());
-        serialize(*(pContext->getModuleMetaData()), pContext->getModule());
         using namespace IGC::Debug;
         auto name =
             DumpName(IGC::Debug::GetShaderOutputName())
@@ -209,12 +281,41 @@ void DumpLLVMIR(IGC::CodeGenContext* pContext, const char* dumpName)
             .Pass(dumpName)
             .Retry(pContext->m_retryManager.GetRetryId())
             .Extension("ll");
-        auto new_annotator = IntrinsicAnnotator();
-        auto annotator = (pContext->annotater != nullptr) ? pContext->annotater : &new_annotator;
-        DumpLLVMIRText(
-            pContext->getModule(),
-            Dump(name, DumpType::PASS_IR_TEXT),
-            annotator);
+        // A context annotater may refer to the module being compiled, so it
+        // cannot be used on the writer's copy and the dump stays synchronous.
+        if (IsAsyncDumpEnabled() && pContext->annotater == nullptr)
+        {
+            // The module metadata is serialized by the writer, into its copy of
+            // the module, from a copy taken here.
+            const Module* pModule = pContext->getModule();
+            std::vector<const void*> functions;
+            for (const Function& F : *pModule)
+            {
+                functions.push_back(&F);
+            }
+            std::vector<const void*> globals;
+            for (const GlobalVariable& G : pModule->globals())
+            {
+                globals.push_back(&G);
+            }
+            auto moduleMD = std::make_shared<IGC::ModuleMetaData>(*pContext->getModuleMetaData());
+            DumpLLVMIRAsync(pModule, name,
+                [functions = std::move(functions), globals = std::move(globals), moduleMD](Module& copy)
+                {
+                    remapModuleMetaData(*moduleMD, functions, globals, copy);
+                    serialize(*moduleMD, &copy);
+                });
+        }
+        else
+        {
+            serialize(*(pContext->getModuleMetaData()), pContext->getModule());
+            auto new_annotator = IntrinsicAnnotator();
+            auto annotator = (pContext->annotater != nullptr) ? pContext->annotater : &new_annotator;
+            DumpLLVMIRText(
+                pContext->getModule(),
+                Dump(name, DumpType::PASS_IR_TEXT),
+                annotator);
+        }
     }
     if (IGC_IS_FLAG_ENABLED(ShaderOverride))
     {
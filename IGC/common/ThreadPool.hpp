@@ -0,0 +1,125 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (c) 2000-2021 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom
+the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+
+============================= end_copyright_notice ===========================*/
+
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace IGC
+{
+    // A fixed-size pool of worker threads executing submitted tasks in FIFO
+    // order. Used to run independent back-end compilations concurrently; it
+    // is intentionally minimal and does not support task cancellation or
+    // priorities.
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(unsigned numThreads)
+        {
+            if (numThreads == 0)
+            {
+                numThreads = getHardwareConcurrency();
+            }
+            m_workers.reserve(numThreads);
+            for (unsigned i = 0; i < numThreads; ++i)
+            {
+                m_workers.emplace_back([this]() { workerLoop(); });
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Finishes every task already submitted before joining the workers.
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_cond.notify_all();
+            for (auto& worker : m_workers)
+            {
+                worker.join();
+            }
+        }
+
+        template <typename Func>
+        std::future<typename std::result_of<Func()>::type> submit(Func&& func)
+        {
+            using ResultTy = typename std::result_of<Func()>::type;
+            auto task = std::make_shared<std::packaged_task<ResultTy()>>(std::forward<Func>(func));
+            std::future<ResultTy> result = task->get_future();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_tasks.emplace_back([task]() { (*task)(); });
+            }
+            m_cond.notify_one();
+            return result;
+        }
+
+        unsigned size() const { return static_cast<unsigned>(m_workers.size()); }
+
+        static unsigned getHardwareConcurrency()
+        {
+            unsigned numThreads = std::thread::hardware_concurrency();
+            return numThreads ? numThreads : 1;
+        }
+
+    private:
+        void workerLoop()
+        {
+            for (;;)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cond.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                    if (m_tasks.empty())
+                    {
+                        return;
+                    }
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+        std::vector<std::thread> m_workers;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        bool m_stopping = false;
+    };
+}
@@ -0,0 +1,250 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (c) 2000-2021 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom
+the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+
+============================= end_copyright_notice ===========================*/
+
+#include "common/debug/AsyncDump.hpp"
+#include "common/IntrinsicAnnotator.hpp"
+#include "common/ThreadPool.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/Compression.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+using namespace llvm;
+
+namespace IGC
+{
+namespace Debug
+{
+
+namespace
+{
+    // A single background thread writing dumps in the order they are
+    // queued. Dumps are held as bitcode until written; the memory they take
+    // is bounded by AsyncShaderDumpBudgetMB.
+    class AsyncDumpWriter
+    {
+    public:
+        AsyncDumpWriter()
+            : m_pool(1)
+            , m_budget(size_t(IGC_GET_FLAG_VALUE(AsyncShaderDumpBudgetMB)) << 20)
+        {
+        }
+
+        void enqueue(std::string textPath, std::string bcPath,
+            std::string header, std::string bitcode,
+            std::function<void(Module&)> prepare)
+        {
+            size_t size = bitcode.size();
+            {
+                // Wait for the writer if the budget is exceeded. A dump larger
+                // than the whole budget is let through once nothing is pending.
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cond.wait(lock, [&]() {
+                    return m_pendingBytes == 0 || m_pendingBytes + size <= m_budget;
+                });
+                m_pendingBytes += size;
+            }
+
+            m_pool.submit([this, textPath = std::move(textPath), bcPath = std::move(bcPath),
+                header = std::move(header), bitcode = std::move(bitcode),
+                prepare = std::move(prepare), size]() {
+                write(textPath, bcPath, header, bitcode, prepare);
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_pendingBytes -= size;
+                }
+                m_cond.notify_all();
+            });
+        }
+
+    private:
+        static void write(const std::string& textPath, const std::string& bcPath,
+            const std::string& header, const std::string& bitcode,
+            const std::function<void(Module&)>& prepare)
+        {
+            std::string path = bcPath;
+            StringRef contents = bitcode;
+
+            std::string text;
+            std::string preparedBitcode;
+            const bool toText = IGC_IS_FLAG_ENABLED(AsyncShaderDumpText);
+            if (toText || prepare)
+            {
+                // Each dump is parsed into its own context, which is only
+                // touched by this thread.
+                LLVMContext context;
+                Expected<std::unique_ptr<Module>> M =
+                    parseBitcodeFile(MemoryBufferRef(bitcode, bcPath), context);
+                if (M)
+                {
+                    if (prepare)
+                    {
+                        prepare(**M);
+                    }
+                    if (toText)
+                    {
+                        raw_string_ostream os(text);
+                        os << header;
+                        IntrinsicAnnotator annotator;
+                        (*M)->print(os, &annotator);
+                        os.flush();
+                        path = textPath;
+                        contents = text;
+                    }
+                    else
+                    {
+                        raw_string_ostream os(preparedBitcode);
+                        WriteBitcodeToFile(**M, os);
+                        os.flush();
+                        contents = preparedBitcode;
+                    }
+                }
+                else
+                {
+                    // Keep the bitcode if it cannot be read back.
+                    consumeError(M.takeError());
+                }
+            }
+
+            SmallVector<char, 0> compressed;
+            if (IGC_IS_FLAG_ENABLED(AsyncShaderDumpCompress) && zlib::isAvailable())
+            {
+                if (Error E = zlib::compress(contents, compressed))
+                {
+                    consumeError(std::move(E));
+                }
+                else
+                {
+                    path += ".z";
+                    contents = StringRef(compressed.data(), compressed.size());
+                }
+            }
+
+            std::ofstream file(path, std::ios_base::out | std::ios_base::binary);
+            file.write(contents.data(), contents.size());
+        }
+
+        // Declared first so that it is destroyed last, i.e. after the pool
+        // has finished all queued dumps.
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        size_t m_pendingBytes = 0;
+        ThreadPool m_pool;
+        const size_t m_budget;
+    };
+
+    class AsyncDumpPass : public ModulePass
+    {
+    public:
+        static char ID;
+
+        explicit AsyncDumpPass(DumpName const& dumpName)
+            : ModulePass(ID), m_name(dumpName)
+        {
+        }
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override
+        {
+            AU.setPreservesAll();
+        }
+
+        bool runOnModule(Module& M) override
+        {
+            DumpLLVMIRAsync(&M, m_name);
+            return false;
+        }
+
+        StringRef getPassName() const override
+        {
+            return "AsyncDumpPass";
+        }
+
+    private:
+        DumpName m_name;
+    };
+
+    char AsyncDumpPass::ID = 0;
+
+    // The writer is created on the first dump and destroyed by
+    // ShutdownAsyncDump(), never during static destruction: its thread
+    // cannot be joined there, e.g. under the loader lock on Windows.
+    std::mutex s_writerMutex;
+    AsyncDumpWriter* s_writer = nullptr;
+} // anonymous namespace
+
+bool IsAsyncDumpEnabled()
+{
+    return IGC_IS_FLAG_ENABLED(AsyncShaderDump) && IGC_IS_FLAG_DISABLED(PrintToConsole);
+}
+
+void DumpLLVMIRAsync(const Module* pModule, DumpName const& dumpName,
+    std::function<void(Module&)> prepare)
+{
+    std::string bitcode;
+    {
+        raw_string_ostream os(bitcode);
+        WriteBitcodeToFile(*pModule, os);
+    }
+
+    std::string header;
+    header += "; ------------------------------------------------\n";
+    header += "; " + dumpName.RelativePath() + "\n";
+    header += "; ------------------------------------------------\n";
+
+    std::lock_guard<std::mutex> lock(s_writerMutex);
+    if (!s_writer)
+    {
+        s_writer = new AsyncDumpWriter();
+    }
+    s_writer->enqueue(
+        dumpName.str(), dumpName.Extension("bc").str(),
+        std::move(header), std::move(bitcode), std::move(prepare));
+}
+
+void ShutdownAsyncDump()
+{
+    // Destroying the pool writes all queued dumps and joins its thread.
+    std::lock_guard<std::mutex> lock(s_writerMutex);
+    delete s_writer;
+    s_writer = nullptr;
+}
+
+ModulePass* createAsyncDumpPass(DumpName const& dumpName)
+{
+    return new AsyncDumpPass(dumpName);
+}
+
+} // namespace Debug
+} // namespace IGC
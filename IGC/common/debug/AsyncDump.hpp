@@ -0,0 +1,67 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (c) 2000-2021 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom
+the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/debug/Dump.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/Module.h>
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <functional>
+
+namespace IGC
+{
+namespace Debug
+{
+
+/// Return true if LLVM IR dumps go through the asynchronous dump writer
+/// instead of being printed on the compiling thread.
+bool IsAsyncDumpEnabled();
+
+/// Snapshot the module as bitcode into memory and queue it for the
+/// background writer, which writes it to the file of the given dump name,
+/// optionally converted to text and compressed. The module is not referenced
+/// after this returns. Blocks if pending dumps exceed AsyncShaderDumpBudgetMB.
+///
+/// If given, prepare is called by the writer on the copy of the module read
+/// back from the snapshot, before it is written.
+void DumpLLVMIRAsync(const llvm::Module* pModule, DumpName const& dumpName,
+    std::function<void(llvm::Module&)> prepare = nullptr);
+
+/// Wait until all queued dumps are written and stop the background writer.
+/// It is started again by the next dump. Called once by the adaptor when it
+/// is torn down; must happen before the library is unloaded if any dump was
+/// queued.
+void ShutdownAsyncDump();
+
+/// Create a module pass that does DumpLLVMIRAsync() on the module it runs on.
+/// It must only be scheduled after module passes, as it would split the
+/// function pass manager of a function pass.
+llvm::ModulePass* createAsyncDumpPass(DumpName const& dumpName);
+
+} // namespace Debug
+} // namespace IGC
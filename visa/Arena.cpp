@@ -25,6 +25,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 ======================= end_copyright_notice ==================================*/
 
 #include "Arena.h"
+#include "VISADefines.h"
+
+#include <algorithm>
 
 #ifdef COLLECT_ALLOCATION_STATS
 int numAllocations = 0;
@@ -37,6 +40,74 @@ int currentMallocSize = 0;
 #endif
 using namespace vISA;
 
+static _THREAD ArenaAccounting* currentArenaAccounting = nullptr;
+
+ArenaAccounting* ArenaAccounting::getCurrent()
+{
+    return currentArenaAccounting;
+}
+
+ArenaAccountingScope::ArenaAccountingScope(ArenaAccounting* accounting) : outer(currentArenaAccounting)
+{
+    currentArenaAccounting = accounting;
+}
+
+ArenaAccountingScope::~ArenaAccountingScope()
+{
+    currentArenaAccounting = outer;
+}
+
+size_t ArenaAccounting::beginPeakWindow()
+{
+    size_t outerPeak = total.peakReserved.load(std::memory_order_relaxed);
+    total.peakReserved.store(total.reserved.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return outerPeak;
+}
+
+size_t ArenaAccounting::endPeakWindow(size_t outerPeak)
+{
+    size_t windowPeak = total.peakReserved.load(std::memory_order_relaxed);
+    total.peakReserved.store(std::max(outerPeak, windowPeak), std::memory_order_relaxed);
+    return windowPeak;
+}
+
+ArenaUsage& ArenaAccounting::getArenaUsage(const char* name)
+{
+    // std::map never moves its nodes, so the reference stays valid while other names are added
+    std::lock_guard<std::mutex> lock(arenasMutex);
+    return arenas[name];
+}
+
+static void addReserved(ArenaUsage& usage, size_t size)
+{
+    size_t reserved = usage.reserved.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peak = usage.peakReserved.load(std::memory_order_relaxed);
+    while (peak < reserved &&
+        !usage.peakReserved.compare_exchange_weak(peak, reserved, std::memory_order_relaxed))
+    {
+    }
+}
+
+void ArenaAccounting::reserve(ArenaUsage& arena, size_t size)
+{
+    addReserved(arena, size);
+    addReserved(total, size);
+}
+
+void ArenaAccounting::use(ArenaUsage& arena, size_t size)
+{
+    arena.used.fetch_add(size, std::memory_order_relaxed);
+    total.used.fetch_add(size, std::memory_order_relaxed);
+}
+
+void ArenaAccounting::release(ArenaUsage& arena, size_t reservedSize, size_t usedSize)
+{
+    arena.reserved.fetch_sub(reservedSize, std::memory_order_relaxed);
+    total.reserved.fetch_sub(reservedSize, std::memory_order_relaxed);
+    arena.used.fetch_sub(usedSize, std::memory_order_relaxed);
+    total.used.fetch_sub(usedSize, std::memory_order_relaxed);
+}
+
 void*
 ArenaHeader::AllocSpace(size_t size, size_t al)
 {
@@ -67,6 +138,14 @@ ArenaHeader::AllocSpace(size_t size, size_t al)
 void
 ArenaManager::FreeArenas()
 {
+    if (_accounting)
+    {
+        _accounting->release(*_usage, _reservedSize, _publishedUsedSize);
+        _reservedSize = 0;
+        _usedSize = 0;
+        _publishedUsedSize = 0;
+    }
+
     while (_arenas)
     {
 #ifdef COLLECT_ALLOCATION_STATS
@@ -35,6 +35,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <stdlib.h>
 #include <iostream>
 #include <cstddef>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
 
 #include "Option.h"
 
@@ -53,6 +57,89 @@ extern int currentMallocSize;
 namespace vISA
 {
     class Mem_Manager;
+
+    // Bytes held by the arenas of one name, or of a whole compilation.
+    // reserved is what the arenas got from the system, used is the part handed out by alloc().
+    // used is published whenever a manager opens a new arena, so it may lag behind by up to
+    // one default-sized arena per live manager.
+    struct ArenaUsage
+    {
+        std::atomic<size_t> reserved{0};
+        std::atomic<size_t> used{0};
+        std::atomic<size_t> peakReserved{0};
+    };
+
+    // Memory accounting of one compilation, per arena name and in total, with an optional budget.
+    // Arena managers are charged to the accounting given at construction, by default the one
+    // installed on the constructing thread by ArenaAccountingScope. They keep charging it until
+    // destroyed, possibly from another thread, so the counters are atomic and the accounting
+    // must outlive all of them.
+    class ArenaAccounting
+    {
+        friend class ArenaManager;
+
+    public:
+
+        ArenaAccounting() = default;
+        ArenaAccounting(const ArenaAccounting&) = delete;
+        ArenaAccounting& operator=(const ArenaAccounting&) = delete;
+
+        const ArenaUsage& getTotal() const { return total; }
+
+        // Call f(name, usage) for every arena name charged so far.
+        template <typename F>
+        void forEachArena(F f) const
+        {
+            std::lock_guard<std::mutex> lock(arenasMutex);
+            for (const auto& arena : arenas)
+            {
+                f(arena.first, arena.second);
+            }
+        }
+
+        // Reserved bytes the compilation should stay under, 0 means no budget.
+        // Passes with a cheaper fallback check isOverBudget() before doing expensive work.
+        void setBudget(size_t bytes) { budget = bytes; }
+        size_t getBudget() const { return budget; }
+        bool isOverBudget() const { return budget != 0 && total.reserved.load(std::memory_order_relaxed) > budget; }
+
+        // The accounting installed on the calling thread, nullptr if none.
+        static ArenaAccounting* getCurrent();
+
+        // High-water-mark windows over the total reserved bytes, used to report the memory
+        // peak of each compile-time timer. beginPeakWindow() returns the peak of the enclosing
+        // window, which must be handed back to endPeakWindow(); windows have to be properly
+        // nested, and once all are closed getTotal().peakReserved is the overall peak again.
+        size_t beginPeakWindow();
+        size_t endPeakWindow(size_t outerPeak);
+
+    private:
+
+        ArenaUsage& getArenaUsage(const char* name);
+        void reserve(ArenaUsage& arena, size_t size);
+        void release(ArenaUsage& arena, size_t reservedSize, size_t usedSize);
+        void use(ArenaUsage& arena, size_t size);
+
+        mutable std::mutex arenasMutex;
+        std::map<std::string, ArenaUsage> arenas;
+        ArenaUsage total;
+        std::atomic<size_t> budget{0};
+    };
+
+    // Install an accounting on the current thread for the lifetime of the scope.
+    class ArenaAccountingScope
+    {
+    public:
+        explicit ArenaAccountingScope(ArenaAccounting* accounting);
+        ~ArenaAccountingScope();
+
+        ArenaAccountingScope(const ArenaAccountingScope&) = delete;
+        ArenaAccountingScope& operator=(const ArenaAccountingScope&) = delete;
+
+    private:
+        ArenaAccounting* outer;
+    };
+
     class ArenaHeader
     {
         friend class ArenaManager;
@@ -130,9 +217,11 @@ namespace vISA
 
         // Functions
 
-        ArenaManager(size_t defaultArenaSize) :
+        ArenaManager(size_t defaultArenaSize, const char* name, ArenaAccounting* accounting) :
             _arenas(0),
-            _defaultArenaSize(defaultArenaSize)
+            _defaultArenaSize(defaultArenaSize),
+            _accounting(accounting),
+            _usage(accounting ? &accounting->getArenaUsage(name ? name : "Other") : nullptr)
         {
             CreateArena(_defaultArenaSize);
         }
@@ -162,6 +251,7 @@ namespace vISA
                 }
 
                 assert(space);
+                _usedSize += size;
             }
 
 #ifdef COLLECT_ALLOCATION_STATS
@@ -187,6 +277,14 @@ namespace vISA
             }
 
             _arenas = newArena;
+            if (_accounting)
+            {
+                // Used bytes are published per arena rather than per allocation to keep alloc() cheap
+                _accounting->use(*_usage, _usedSize - _publishedUsedSize);
+                _publishedUsedSize = _usedSize;
+                _accounting->reserve(*_usage, arenaDataSize);
+                _reservedSize += arenaDataSize;
+            }
 
 #ifdef COLLECT_ALLOCATION_STATS
             numMallocCalls++;
@@ -216,6 +314,11 @@ namespace vISA
 
         ArenaHeader * _arenas;
         const size_t  _defaultArenaSize;
+        ArenaAccounting* const _accounting;
+        ArenaUsage* const _usage;
+        size_t _reservedSize = 0;
+        size_t _usedSize = 0;
+        size_t _publishedUsedSize = 0;
     };
 }
 #endif
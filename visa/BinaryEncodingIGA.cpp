@@ -27,11 +27,15 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "BinaryEncodingIGA.h"
 #include "GTGPU_RT_ASM_Interface.h"
 #include "iga/IGALibrary/api/igaEncoderWrapper.hpp"
+#include "iga/IGALibrary/Backend/GED/Encoder.hpp"
 #include "Timer.h"
 #include "BuildIR.h"
 
+#include <iomanip>
 #include <map>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 
 using namespace iga;
@@ -56,6 +60,17 @@ public:
     // translates and encodes (formerly "DoAll")
     void Encode();
 
+    // translates the kernel to IGA IR and encodes it with the IGA encoder
+    void EncodeIGA();
+
+    // Streaming encoder: packs each instruction's GED fields straight from
+    // the G4 operands into the output buffer and patches jump offsets at the
+    // end, without building an IGA kernel. It mirrors the IGA encoder for the
+    // forms vISA generates on Xe and returns false without producing
+    // anything if the kernel contains something it does not model; callers
+    // then fall back to EncodeIGA().
+    bool EncodeDirect();
+
     ///////////////////////////////////////////////////////////////////////////
     // these function translate G4 IR to IGA IR
     iga::Instruction *translateInstruction(G4_INST *g4inst, iga::Block*& bbNew);
@@ -72,6 +87,33 @@ private:
 
     std::map<G4_Label*, iga::Block*> labelToBlockMap;
 
+    // streaming encoder helpers (see EncodeDirect)
+    struct DirectJumpPatch
+    {
+        ged_ins_t  ged;       // fields as encoded, JIP/UIP still unset
+        G4_INST*   inst;      // nullptr if the instruction needs no patching
+        iga::Op    op;
+        uint32_t   pc;
+        uint32_t   nextPC;
+        bool       compacted;
+        bool       hasUIP;    // UIP (src1) needs patching too
+        G4_Label*  jip;       // nullptr: fall through to the next instruction
+        G4_Label*  uip;       // nullptr: UIP is 0
+    };
+    bool canEncodeDirect(G4_INST* inst) const;
+    bool encodeDirect(G4_INST* inst, ged_ins_t& ged, iga::InstOptSet& opts,
+        DirectJumpPatch& jump);
+    bool encodeDirectDst(G4_INST* inst, const iga::OpSpec& os, ged_ins_t& ged);
+    bool encodeDirectSrc(
+        G4_INST* inst, const iga::OpSpec& os, int i, ged_ins_t& ged);
+    bool encodeDirectTernarySrc(
+        G4_INST* inst, const iga::OpSpec& os, int i, ged_ins_t& ged);
+    bool encodeDirectOptions(G4_INST* inst, const iga::OpSpec& os,
+        const iga::InstOptSet& opts, ged_ins_t& ged);
+    void verifyDirectEncoding(
+        const std::vector<uint8_t>& bits, const std::vector<int64_t>& offsets);
+    void reportDirectWarning(G4_INST* inst, const char* msg) const;
+
 public:
     static iga::ExecSize       getIGAExecSize(int execSize);
     static iga::ChannelOffset  getIGAChannelOffset(int offset);
@@ -702,19 +744,6 @@ void BinaryEncodingIGA::getIGAFlagInfo(
 void BinaryEncodingIGA::Encode()
 {
     FixInst();
-    Block* currBB = nullptr;
-
-    auto isFirstInstLabel = [this]()
-    {
-        for (auto bb : kernel.fg)
-        {
-            for (auto inst : *bb)
-            {
-                return inst->isLabel();
-            }
-        }
-        return false;
-    };
 
     // Make the size of the first BB be multiple of 4 instructions, and do not compact
     // any instructions in it, so that the size of the first BB is multiple of 64 bytes
@@ -741,6 +770,82 @@ void BinaryEncodingIGA::Encode()
         }
     }
 
+    bool verifyDirect = kernel.getOption(vISA_VerifyDirectEncoder);
+    bool encoded = false;
+    if (kernel.getOption(vISA_DirectEncoder) || verifyDirect)
+    {
+        encoded = EncodeDirect();
+    }
+    if (encoded && verifyDirect)
+    {
+        // encode again through the IGA kernel and check that both agree;
+        // the IGA result is the one that is kept
+        auto bits = static_cast<const uint8_t*>(m_kernelBuffer);
+        std::vector<uint8_t> directBits(bits, bits + m_kernelBufferSize);
+        std::vector<int64_t> directOffsets;
+        for (auto bb : kernel.fg)
+        {
+            for (auto inst : *bb)
+            {
+                if (!inst->isLabel())
+                {
+                    directOffsets.push_back(inst->getGenOffset());
+                }
+            }
+        }
+        freeBlock(m_kernelBuffer);
+        m_kernelBuffer = nullptr;
+        m_kernelBufferSize = 0;
+        EncodeIGA();
+        verifyDirectEncoding(directBits, directOffsets);
+    }
+    else if (!encoded)
+    {
+        EncodeIGA();
+    }
+
+    if (kernel.fg.builder->getHasPerThreadProlog())
+    {
+        // per thread data load is in the first BB
+        assert(kernel.fg.getNumBB() > 1 && "expect at least one prolog BB");
+        auto secondBB = *(std::next(kernel.fg.begin()));
+        auto iter = std::find_if(secondBB->begin(), secondBB->end(),
+            [](G4_INST* inst) { return !inst->isLabel();});
+        assert(iter != secondBB->end() && "expect at least one non-label inst in second BB");
+        kernel.fg.builder->getJitInfo()->offsetToSkipPerThreadDataLoad =
+            (uint32_t)(*iter)->getGenOffset();
+    }
+    if (kernel.fg.builder->getHasComputeFFIDProlog())
+    {
+        // something weird will happen if both HasPerThreadProlog and HasComputeFFIDProlog
+        assert(!kernel.fg.builder->getHasPerThreadProlog());
+
+        // set offsetToSkipSetFFIDGP to the second entry's offset
+        // the first instruction in the second BB is the start of the sencond entry
+        assert(kernel.fg.getNumBB() > 1 && "expect at least one prolog BB");
+        auto secondBB = *(std::next(kernel.fg.begin()));
+        assert(!secondBB->empty() && !secondBB->front()->isLabel());
+        kernel.fg.builder->getJitInfo()->offsetToSkipSetFFIDGP =
+            (uint32_t)secondBB->front()->getGenOffset();
+    }
+}
+
+void BinaryEncodingIGA::EncodeIGA()
+{
+    Block* currBB = nullptr;
+
+    auto isFirstInstLabel = [this]()
+    {
+        for (auto bb : kernel.fg)
+        {
+            for (auto inst : *bb)
+            {
+                return inst->isLabel();
+            }
+        }
+        return false;
+    };
+
     if (!isFirstInstLabel())
     {
         // create a new BB if kernel does not start with label
@@ -846,30 +951,981 @@ void BinaryEncodingIGA::Encode()
     {
         inst.second->setGenOffset(inst.first->getPC());
     }
-    if (kernel.fg.builder->getHasPerThreadProlog())
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Streaming encoder
+//
+// This packs the same GED fields as iga::Encoder (Backend/GED/Encoder.cpp)
+// does for Xe, in the same order, but reads them straight off the G4_INST.
+// Keep the two in sync; -verifyDirectEncoder encodes every kernel both ways
+// and reports the first instruction where they differ.
+
+// sets a GED field of the instruction being packed; any GED error makes
+// EncodeDirect give up so that the IGA encoder can report it
+#define DIRECT_ENCODE(FIELD, ARG) \
+    do { \
+        if (GED_Set ## FIELD(&ged, ARG) != GED_RETURN_VALUE_SUCCESS) \
+            return false; \
+    } while (0)
+
+// the same for a field every source operand has
+#define DIRECT_ENCODE_SRC(I, FIELD, ARG) \
+    do { \
+        GED_RETURN_VALUE srcStatus = \
+            (I) == 0 ? GED_SetSrc0 ## FIELD(&ged, ARG) : \
+            (I) == 1 ? GED_SetSrc1 ## FIELD(&ged, ARG) : \
+                       GED_SetSrc2 ## FIELD(&ged, ARG); \
+        if (srcStatus != GED_RETURN_VALUE_SUCCESS) \
+            return false; \
+    } while (0)
+
+// the same for a field only src0 and src1 have
+#define DIRECT_ENCODE_SRC01(I, FIELD, ARG) \
+    do { \
+        GED_RETURN_VALUE srcStatus = (I) == 0 ? \
+            GED_SetSrc0 ## FIELD(&ged, ARG) : GED_SetSrc1 ## FIELD(&ged, ARG); \
+        if (srcStatus != GED_RETURN_VALUE_SUCCESS) \
+            return false; \
+    } while (0)
+
+// register number bits of an ARF or GRF as the IGA encoder computes them
+static bool getIGARegNumBits(
+    const iga::Model& model, RegName regName, int regNum, uint32_t& bits)
+{
+    const RegInfo* ri = model.lookupRegInfoByRegName(regName);
+    uint8_t regBits = 0;
+    if (ri == nullptr || !ri->encode(regNum, regBits))
     {
-        // per thread data load is in the first BB
-        assert(kernel.fg.getNumBB() > 1 && "expect at least one prolog BB");
-        auto secondBB = *(std::next(kernel.fg.begin()));
-        auto iter = std::find_if(secondBB->begin(), secondBB->end(),
-            [](G4_INST* inst) { return !inst->isLabel();});
-        assert(iter != secondBB->end() && "expect at least one non-label inst in second BB");
-        kernel.fg.builder->getJitInfo()->offsetToSkipPerThreadDataLoad =
-            (uint32_t)(*iter)->getGenOffset();
+        return false;
     }
-    if (kernel.fg.builder->getHasComputeFFIDProlog())
+    bits = regBits;
+    return true;
+}
+
+// prints a warning the way KernelEncoder::encode prints the IGA encoder's:
+// at the iga::Loc translateInstruction gives the instruction, debug only
+void BinaryEncodingIGA::reportDirectWarning(G4_INST* inst, const char* msg) const
+{
+#ifdef _DEBUG
+    iga::Loc loc(inst->getCISAOff());
+    std::cerr << "line " << loc.line << ", col " << loc.col << ": " << msg << "\n";
+#endif // _DEBUG
+}
+
+bool BinaryEncodingIGA::canEncodeDirect(G4_INST* inst) const
+{
+    auto opinfo = getIgaOpInfo(inst, platformModel, false, *kernel.fg.builder);
+    const OpSpec* opSpec = opinfo.first;
+    if (opSpec == nullptr || !opSpec->isValid())
     {
-        // something weird will happen if both HasPerThreadProlog and HasComputeFFIDProlog
-        assert(!kernel.fg.builder->getHasPerThreadProlog());
+        return false;
+    }
+    Op op = opSpec->op;
+    Subfunction sf = opinfo.second;
+    if (op == Op::NOP || op == Op::ILLEGAL)
+    {
+        return true;
+    }
+    // math macros use the special accumulator operand forms, and brc/brd
+    // have register or immediate JIP/UIP; leave those to IGA
+    if (op == Op::MADM || (op == Op::MATH && iga::IsMacro(sf.math)) ||
+        op == Op::BRC || op == Op::BRD)
+    {
+        return false;
+    }
 
-        // set offsetToSkipSetFFIDGP to the second entry's offset
-        // the first instruction in the second BB is the start of the sencond entry
-        assert(kernel.fg.getNumBB() > 1 && "expect at least one prolog BB");
-        auto secondBB = *(std::next(kernel.fg.begin()));
-        assert(!secondBB->empty() && !secondBB->front()->isLabel());
-        kernel.fg.builder->getJitInfo()->offsetToSkipSetFFIDGP =
-            (uint32_t)secondBB->front()->getGenOffset();
+    G4_DstRegRegion* dst = inst->getDst();
+    if (opSpec->supportsDestination())
+    {
+        if (dst == nullptr)
+        {
+            return false;
+        }
+        if (dst->getRegAccess() != Direct && !opSpec->isSendOrSendsFamily() &&
+            (opSpec->isTernary() || opSpec->isBranching()))
+        {
+            return false;
+        }
+    }
+
+    auto isDirectReg = [](G4_Operand* opnd)
+    {
+        return opnd != nullptr && opnd->isSrcRegRegion() &&
+            opnd->asSrcRegRegion()->getRegAccess() == Direct;
+    };
+
+    if (opSpec->isBranching())
+    {
+        if (op == Op::JMPI || op == Op::RET || op == Op::CALL || op == Op::CALLA)
+        {
+            G4_Operand* src0 = inst->getSrc(0);
+            return opSpec->getSourceCount(sf) <= 1 &&
+                (isDirectReg(src0) || (src0 != nullptr && src0->isLabel()));
+        }
+        return true;
+    }
+    if (opSpec->isSendOrSendsFamily())
+    {
+        return (dst == nullptr || dst->getRegAccess() == Direct) &&
+            isDirectReg(inst->getSrc(0)) &&
+            (!inst->isSplitSend() || isDirectReg(inst->getSrc(1)));
+    }
+    if (op == Op::SYNC)
+    {
+        return true;
+    }
+
+    int numSrc = inst->getNumSrc();
+    if (inst->opcode() == G4_movi && numSrc == 1 && platform >= GENX_ICLLP)
+    {
+        // src1 is added as null during translation
+        numSrc = 2;
+    }
+    int numSrcToEncode = (int)opSpec->getSourceCount(sf);
+    if (numSrc < numSrcToEncode)
+    {
+        return false;
+    }
+    for (int i = 0; i < numSrcToEncode && i < inst->getNumSrc(); i++)
+    {
+        G4_Operand* src = inst->getSrc(i);
+        if (src == nullptr || !(src->isSrcRegRegion() || src->isImm()))
+        {
+            // includes "mov (1) r1 label"
+            return false;
+        }
+        if (opSpec->isTernary() &&
+            ((src->isImm() && i == 1) || (src->isSrcRegRegion() &&
+                src->asSrcRegRegion()->getRegAccess() != Direct)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BinaryEncodingIGA::EncodeDirect()
+{
+    // only the Xe encoding is modeled: no access mode or Align16, unified
+    // sends, simplified branches and SWSB on every instruction
+    if (getPlatformGeneration(platform) < PlatformGen::XE ||
+        platformModel->supportsAccessMode() ||
+        !platformModel->supportsUnifiedSend() ||
+        !platformModel->supportsSimplifiedBranches() ||
+        kernel.getOption(vISA_EnableIGASWSB))
+    {
+        return false;
+    }
+
+    size_t numInsts = 0;
+    for (auto bb : kernel.fg)
+    {
+        for (auto inst : *bb)
+        {
+            if (inst->isLabel())
+            {
+                continue;
+            }
+            if (!canEncodeDirect(inst))
+            {
+                return false;
+            }
+            numInsts++;
+        }
+    }
+
+    TIME_SCOPE(IGA_ENCODER);
+    bool autoCompact = kernel.getOption(vISA_Compaction);
+
+    // every instruction takes at most 16 bytes
+    std::vector<uint8_t> bits(numInsts * 16);
+    std::unordered_map<G4_Label*, uint32_t> labelPCs;
+    std::vector<DirectJumpPatch> jumps;
+    int instCount = 0;
+    uint32_t pc = 0;
+    for (auto bb : kernel.fg)
+    {
+        for (auto inst : *bb)
+        {
+            if (inst->isLabel())
+            {
+                labelPCs[inst->getLabel()] = pc;
+                continue;
+            }
+
+            ged_ins_t ged;
+            InstOptSet opts;
+            DirectJumpPatch jump;
+            jump.inst = nullptr;
+            if (!encodeDirect(inst, ged, opts, jump))
+            {
+                return false;
+            }
+            instCount++;
+            inst->setGenOffset(pc);
+
+            bool mustCompact = opts.contains(InstOpt::COMPACTED);
+            // label operands are only known after the fix-up pass, so
+            // never compact jumps unless asked to
+            bool mustNotCompact =
+                opts.contains(InstOpt::NOCOMPACT) || jump.inst != nullptr;
+            if (jump.inst)
+            {
+                jump.ged = ged;
+            }
+
+            uint32_t iLen = 16;
+            GED_RETURN_VALUE status = GED_RETURN_VALUE_SIZE;
+            if (mustCompact || (!mustNotCompact && autoCompact))
+            {
+                status = GED_EncodeIns(&ged, GED_INS_TYPE_COMPACT, &bits[pc]);
+                if (status == GED_RETURN_VALUE_SUCCESS)
+                {
+                    iLen = 8;
+                }
+                else if (status == GED_RETURN_VALUE_NO_COMPACT_FORM &&
+                    mustCompact)
+                {
+                    // same diagnostic as the IGA encoder, which treats an
+                    // explicit compaction miss as a warning for vISA
+                    reportDirectWarning(inst, "GED unable to compact instruction");
+                }
+            }
+            if (status != GED_RETURN_VALUE_SUCCESS &&
+                GED_EncodeIns(&ged, GED_INS_TYPE_NATIVE, &bits[pc]) !=
+                    GED_RETURN_VALUE_SUCCESS)
+            {
+                return false;
+            }
+
+            if (jump.inst)
+            {
+                jump.pc = pc;
+                jump.nextPC = pc + iLen;
+                jump.compacted = iLen == 8;
+                jumps.push_back(jump);
+            }
+            pc += iLen;
+        }
+    }
+
+    // fix-up pass: all label offsets are known now
+    for (auto& jump : jumps)
+    {
+        // calla takes an absolute offset
+        uint32_t encodePC = jump.op == Op::CALLA ? 0 : jump.pc;
+        uint32_t jumpPC = 0;
+        if (jump.jip == nullptr)
+        {
+            jumpPC = jump.nextPC;
+        }
+        else
+        {
+            auto iter = labelPCs.find(jump.jip);
+            if (iter == labelPCs.end())
+            {
+                // labels outside the kernel (e.g. calls to functions that
+                // are only resolved when linking) are left to EncodeIGA
+                return false;
+            }
+            jumpPC = iter->second;
+        }
+        if (GED_SetJIP(&jump.ged, (int32_t)(jumpPC - encodePC)) !=
+            GED_RETURN_VALUE_SUCCESS)
+        {
+            return false;
+        }
+
+        if (jump.hasUIP)
+        {
+            jumpPC = encodePC;
+            if (jump.uip != nullptr)
+            {
+                auto iter = labelPCs.find(jump.uip);
+                if (iter == labelPCs.end())
+                {
+                    return false;
+                }
+                jumpPC = iter->second;
+            }
+            if (GED_SetUIP(&jump.ged, (int32_t)(jumpPC - jump.pc)) !=
+                GED_RETURN_VALUE_SUCCESS)
+            {
+                return false;
+            }
+        }
+
+        if (GED_EncodeIns(&jump.ged,
+                jump.compacted ? GED_INS_TYPE_COMPACT : GED_INS_TYPE_NATIVE,
+                &bits[jump.pc]) != GED_RETURN_VALUE_SUCCESS)
+        {
+            return false;
+        }
+    }
+
+    kernel.setAsmCount(instCount);
+
+    freeBlock(m_kernelBuffer);
+    m_kernelBufferSize = pc;
+    m_kernelBuffer = allocCodeBlock(m_kernelBufferSize);
+    memcpy_s(m_kernelBuffer, m_kernelBufferSize, bits.data(), m_kernelBufferSize);
+
+    return true;
+}
+
+bool BinaryEncodingIGA::encodeDirect(
+    G4_INST* inst, ged_ins_t& ged, InstOptSet& opts, DirectJumpPatch& jump)
+{
+    auto opinfo = getIgaOpInfo(inst, platformModel, false, *kernel.fg.builder);
+    const OpSpec& os = *opinfo.first;
+    Op op = os.op;
+    Subfunction sf = opinfo.second;
+
+    if (GED_InitEmptyIns(lowerPlatform(platformModel->platform), &ged,
+            lowerOpcode(op)) != GED_RETURN_VALUE_SUCCESS)
+    {
+        return false;
+    }
+    opts = getIGAInstOptSet(inst);
+    if (op == Op::ILLEGAL)
+    {
+        return true;
+    }
+    else if (op == Op::NOP)
+    {
+        return encodeDirectOptions(inst, os, opts, ged);
+    }
+
+    Predication pred;
+    RegRef flagReg {0, 0};
+    FlagModifier condModifier = FlagModifier::NONE;
+    getIGAFlagInfo(inst, &os, sf, pred, condModifier, flagReg);
+    if (os.isBranching() || os.isSendOrSendsFamily())
+    {
+        // IGA's branch and send instructions carry no flag modifier
+        condModifier = FlagModifier::NONE;
+    }
+    if (os.isBranching())
+    {
+        sf = os.supportsSubfunction() ?
+            Subfunction(getIGABranchCntrl(inst->asCFInst()->isBackward())) :
+            Subfunction();
+    }
+
+    DIRECT_ENCODE(ExecSize, lowerExecSize(getIGAExecSize(inst->getExecSize())));
+    if (os.is(Op::MATH))
+    {
+        DIRECT_ENCODE(MathFC, lowerMathFC(sf.math));
+    }
+    else if (os.isSendOrSendsFamily())
+    {
+        DIRECT_ENCODE(SFID, lowerSFID(sf.send));
+    }
+    else if (os.is(Op::SYNC))
+    {
+        DIRECT_ENCODE(SyncFC, lowerSyncFC(sf.sync));
+    }
+    else if (os.supportsBranchCtrl())
+    {
+        DIRECT_ENCODE(BranchCtrl, lowerBranchCntrl(sf.branch));
+    }
+    if (os.supportsQtrCtrl())
+    {
+        DIRECT_ENCODE(ChannelOffset,
+            lowerQtrCtrl(getIGAChannelOffset(inst->getMaskOffset())));
+    }
+    DIRECT_ENCODE(MaskCtrl, lowerEmask(getIGAMaskCtrl(
+        inst->opcode() == G4_jmpi || inst->isWriteEnableInst())));
+    DIRECT_ENCODE(PredCtrl, os.supportsPredication() ?
+        lowerPredCtrl(pred.function) : GED_PRED_CTRL_Normal);
+
+    // a 64-bit immediate src0 overlaps the flag modifier field
+    G4_Operand* src0 = inst->getNumSrc() > 0 ? inst->getSrc(0) : nullptr;
+    bool isImm64Src0Overlap =
+        !os.isBranching() && !os.isSendOrSendsFamily() &&
+        src0 != nullptr && src0->isImm() &&
+        TypeIs64b(getIGAType(src0->getType(), platform));
+    if (!isImm64Src0Overlap && os.supportsFlagModifier())
+    {
+        DIRECT_ENCODE(CondModifier, lowerCondModifier(condModifier));
+    }
+    if (os.supportsPredication())
+    {
+        DIRECT_ENCODE(PredInv,
+            pred.inverse ? GED_PRED_INV_Invert : GED_PRED_INV_Normal);
+    }
+    if (flagReg != REGREF_INVALID)
+    {
+        DIRECT_ENCODE(FlagRegNum, static_cast<uint32_t>(flagReg.regNum));
+        DIRECT_ENCODE(FlagSubRegNum, flagReg.subRegNum);
+    }
+    if (opts.contains(InstOpt::ACCWREN))
+    {
+        DIRECT_ENCODE(AccWrCtrl, GED_ACC_WR_CTRL_AccWrEn);
+    }
+
+    if (os.isBranching())
+    {
+        if (os.supportsBranchCtrl())
+        {
+            DIRECT_ENCODE(BranchCtrl, lowerBranchCntrl(sf.branch));
+        }
+
+        RegName dstName = RegName::ARF_NULL;
+        RegRef dstReg {0, 0};
+        Type dstType = Type::UD;
+        if (os.supportsDestination())
+        {
+            dstName = getIGARegName(inst->getDst());
+            dstReg = getIGARegRef(inst->getDst());
+            dstType = getIGAType(inst, Opnd_dst, platform);
+        }
+        uint32_t regBits = 0;
+        if (!getIGARegNumBits(*platformModel, dstName, dstReg.regNum, regBits))
+        {
+            return false;
+        }
+        DIRECT_ENCODE(DstRegFile, lowerRegFile(dstName));
+        DIRECT_ENCODE(DstRegNum, regBits);
+        DIRECT_ENCODE(DstSubRegNum,
+            SubRegToBytesOffset(dstReg.subRegNum, dstName, dstType));
+
+        jump.op = op;
+        jump.hasUIP = os.getSourceCount(sf) == 2;
+        jump.jip = nullptr;
+        jump.uip = nullptr;
+        if (op == Op::JMPI || op == Op::RET || op == Op::CALL || op == Op::CALLA)
+        {
+            if (src0->isLabel())
+            {
+                jump.inst = inst;
+                jump.jip = src0->asLabel();
+                DIRECT_ENCODE(Src0RegFile, GED_REG_FILE_IMM);
+            }
+            else
+            {
+                RegName srcName = getIGARegName(src0);
+                RegRef srcReg = getIGARegRef(src0);
+                regBits = srcReg.regNum;
+                if (srcName != RegName::GRF_R &&
+                    !getIGARegNumBits(*platformModel, srcName, srcReg.regNum, regBits))
+                {
+                    return false;
+                }
+                DIRECT_ENCODE(Src0RegFile, lowerRegFile(srcName));
+                DIRECT_ENCODE(Src0RegNum, regBits);
+                DIRECT_ENCODE(Src0SubRegNum,
+                    SubRegToBytesOffset(srcReg.subRegNum, srcName, Type::D));
+            }
+        }
+        else
+        {
+            // JIP/UIP are labels; without a JIP the branch falls through
+            jump.inst = inst;
+            G4_InstCF* cfInst = inst->asCFInst();
+            if (cfInst->getJip())
+            {
+                jump.jip = cfInst->getJip()->asLabel();
+                jump.uip = cfInst->getUip() ? cfInst->getUip()->asLabel() : nullptr;
+            }
+            DIRECT_ENCODE(Src0RegFile, GED_REG_FILE_IMM);
+        }
+        if (jump.hasUIP)
+        {
+            DIRECT_ENCODE(Src1RegFile, GED_REG_FILE_IMM);
+        }
+    }
+    else if (os.isTernary())
+    {
+        Type src0Type = src0->isImm() ?
+            getIGAType(src0->getType(), platform) :
+            getIGAType(inst, inst->getSrcOperandNum(0), platform);
+        switch (src0Type)
+        {
+        case Type::HF: case Type::F: case Type::DF:
+            DIRECT_ENCODE(ExecutionDataType, GED_EXECUTION_DATA_TYPE_Float);
+            break;
+        case Type::UQ: case Type::Q: case Type::UD: case Type::D:
+        case Type::UW: case Type::W: case Type::UB: case Type::B:
+            DIRECT_ENCODE(ExecutionDataType, GED_EXECUTION_DATA_TYPE_Integer);
+            break;
+        default:
+            return false;
+        }
+        if (os.supportsDestination() && !encodeDirectDst(inst, os, ged))
+        {
+            return false;
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            if (!encodeDirectTernarySrc(inst, os, i, ged))
+            {
+                return false;
+            }
+        }
+    }
+    else if (os.isSendOrSendsFamily())
+    {
+        G4_DstRegRegion* dst = inst->getDst();
+        if (platformModel->supportsUnarySend())
+        {
+            DIRECT_ENCODE(DstAddrMode, GED_ADDR_MODE_Direct);
+        }
+        DIRECT_ENCODE(DstRegFile, lowerRegFile(getIGARegName(dst)));
+        DIRECT_ENCODE(DstRegNum, getIGARegRef(dst).regNum);
+
+        if (platformModel->supportsUnarySend())
+        {
+            DIRECT_ENCODE(Src0AddrMode, GED_ADDR_MODE_Direct);
+        }
+        DIRECT_ENCODE(Src0RegFile, lowerRegFile(getIGARegName(src0)));
+        DIRECT_ENCODE(Src0RegNum, getIGARegRef(src0).regNum);
+        if (inst->isSplitSend())
+        {
+            G4_Operand* src1 = inst->getSrc(1);
+            DIRECT_ENCODE(Src1RegFile, lowerRegFile(getIGARegName(src1)));
+            DIRECT_ENCODE(Src1RegNum, getIGARegRef(src1).regNum);
+        }
+        else
+        {
+            DIRECT_ENCODE(Src1RegFile, lowerRegFile(RegName::ARF_NULL));
+            DIRECT_ENCODE(Src1RegNum, 0);
+        }
+
+        InstOptSet extraOpts;
+        int xlen = -1;
+        SendDesc exDesc = getIGASendExDesc(inst, xlen, extraOpts);
+        opts.add(extraOpts);
+        if (exDesc.isImm())
+        {
+            DIRECT_ENCODE(ExDescRegFile, GED_REG_FILE_IMM);
+            // EOT is a separate field on platforms with unified sends
+            DIRECT_ENCODE(ExMsgDesc, exDesc.imm & ~(1 << 5));
+        }
+        else
+        {
+            DIRECT_ENCODE(ExDescRegFile, GED_REG_FILE_ARF);
+            // encoded as [3:1]
+            DIRECT_ENCODE(ExDescAddrSubRegNum, 2 * exDesc.reg.subRegNum);
+        }
+
+        SendDesc desc = getIGASendDesc(inst);
+        if (desc.isImm())
+        {
+            DIRECT_ENCODE(DescRegFile, GED_REG_FILE_IMM);
+            DIRECT_ENCODE(MsgDesc, desc.imm);
+        }
+        else
+        {
+            DIRECT_ENCODE(DescRegFile, GED_REG_FILE_ARF);
+            if (platformModel->supportsUnarySend())
+            {
+                uint32_t regBits = 0;
+                if (!getIGARegNumBits(*platformModel, RegName::ARF_A,
+                        desc.reg.regNum, regBits))
+                {
+                    return false;
+                }
+                DIRECT_ENCODE(DescRegNum, regBits);
+            }
+        }
+
+        DIRECT_ENCODE(FusionCtrl, opts.contains(InstOpt::SERIALIZE) ?
+            GED_FUSION_CTRL_Serialized : GED_FUSION_CTRL_Normal);
+    }
+    else if (os.is(Op::SYNC))
+    {
+        // as in IGA, lets "sync.bar null" compact
+        DIRECT_ENCODE(DstHorzStride, 1);
+        if (src0 != nullptr && src0->isImm())
+        {
+            Type type = getIGAType(src0->getType(), platform);
+            ImmVal val;
+            val = src0->asImm()->getImm();
+            val.kind = getIGAImmType(src0->getType());
+            DIRECT_ENCODE(Src0RegFile, GED_REG_FILE_IMM);
+            DIRECT_ENCODE(Src0DataType, lowerDataType(type));
+            DIRECT_ENCODE(Imm, iga::Encoder::typeConvesionHelper(val, type));
+        }
+        else
+        {
+            DIRECT_ENCODE(Src0RegFile, GED_REG_FILE_ARF);
+        }
+    }
+    else
+    {
+        if (os.supportsDestination() && !encodeDirectDst(inst, os, ged))
+        {
+            return false;
+        }
+        switch (os.getSourceCount(sf))
+        {
+        case 2:
+            if (!encodeDirectSrc(inst, os, 1, ged))
+            {
+                return false;
+            }
+            // fall through
+        case 1:
+            if (!encodeDirectSrc(inst, os, 0, ged))
+            {
+                return false;
+            }
+        }
+    }
+
+    return encodeDirectOptions(inst, os, opts, ged);
+}
+
+bool BinaryEncodingIGA::encodeDirectDst(
+    G4_INST* inst, const OpSpec& os, ged_ins_t& ged)
+{
+    G4_DstRegRegion* dst = inst->getDst();
+    Type type = getIGAType(inst, Opnd_dst, platform);
+    GED_SATURATE sat = lowerSaturate(getIGADstModifier(inst->getSaturate()));
+    Region::Horz hstride = getIGAHorz(dst->getHorzStride());
+
+    if (os.isTernary())
+    {
+        RegName regName = getIGARegName(dst);
+        RegRef regRef = getIGARegRef(dst);
+        uint32_t regBits = 0;
+        if (!getIGARegNumBits(*platformModel, regName, regRef.regNum, regBits))
+        {
+            return false;
+        }
+        if (os.supportsSaturation())
+        {
+            DIRECT_ENCODE(Saturate, sat);
+        }
+        DIRECT_ENCODE(DstDataType, lowerDataType(type));
+        DIRECT_ENCODE(DstRegFile, lowerRegFile(regName));
+        DIRECT_ENCODE(DstRegNum, regBits);
+        DIRECT_ENCODE(DstSubRegNum,
+            SubRegToBytesOffset(regRef.subRegNum, regName, type));
+        DIRECT_ENCODE(DstHorzStride, lowerRegionHorz(hstride));
+        return true;
+    }
+
+    if (dst->getRegAccess() == Direct)
+    {
+        RegName regName = getIGARegName(dst);
+        RegRef regRef = getIGARegRef(dst);
+        uint32_t regBits = 0;
+        if (!getIGARegNumBits(*platformModel, regName, regRef.regNum, regBits))
+        {
+            return false;
+        }
+        DIRECT_ENCODE(DstRegFile, lowerRegFile(regName));
+        DIRECT_ENCODE(DstAddrMode, GED_ADDR_MODE_Direct);
+        DIRECT_ENCODE(DstDataType, lowerDataType(type));
+        if (os.supportsSaturation())
+        {
+            DIRECT_ENCODE(Saturate, sat);
+        }
+        DIRECT_ENCODE(DstRegNum, regBits);
+        DIRECT_ENCODE(DstSubRegNum,
+            SubRegToBytesOffset(regRef.subRegNum, regName, type));
+    }
+    else
+    {
+        bool valid;
+        DIRECT_ENCODE(DstRegFile, lowerRegFile(RegName::GRF_R));
+        DIRECT_ENCODE(DstAddrMode, GED_ADDR_MODE_Indirect);
+        DIRECT_ENCODE(DstDataType, lowerDataType(type));
+        if (os.supportsSaturation())
+        {
+            DIRECT_ENCODE(Saturate, sat);
+        }
+        DIRECT_ENCODE(DstAddrImm, dst->getAddrImm());
+        DIRECT_ENCODE(DstAddrSubRegNum, (uint8_t)dst->ExIndSubRegNum(valid));
+    }
+    DIRECT_ENCODE(DstHorzStride, lowerRegionHorz(hstride));
+    return true;
+}
+
+bool BinaryEncodingIGA::encodeDirectSrc(
+    G4_INST* inst, const OpSpec& os, int i, ged_ins_t& ged)
+{
+    if (i == 1 && inst->opcode() == G4_movi && inst->getNumSrc() == 1)
+    {
+        // the null src1 translateInstructionSrcs adds to movi
+        DIRECT_ENCODE_SRC01(i, RegFile, lowerRegFile(RegName::ARF_NULL));
+        if (os.supportsSourceModifiers())
+        {
+            DIRECT_ENCODE_SRC01(i, SrcMod, lowerSrcMod(SrcModifier::NONE));
+        }
+        DIRECT_ENCODE_SRC01(i, DataType, lowerDataType(Type::UB));
+        uint32_t regBits = 0;
+        if (!getIGARegNumBits(*platformModel, RegName::ARF_NULL, 0, regBits))
+        {
+            return false;
+        }
+        DIRECT_ENCODE_SRC01(i, AddrMode, GED_ADDR_MODE_Direct);
+        DIRECT_ENCODE_SRC01(i, RegNum, regBits);
+        DIRECT_ENCODE_SRC01(i, SubRegNum, 0);
+        DIRECT_ENCODE_SRC01(i, VertStride, 1);
+        DIRECT_ENCODE_SRC01(i, Width, 1);
+        DIRECT_ENCODE_SRC01(i, HorzStride, 0);
+        return true;
+    }
+
+    G4_Operand* src = inst->getSrc(i);
+    if (src->isImm())
+    {
+        Type type = getIGAType(src->getType(), platform);
+        ImmVal val;
+        val = src->asImm()->getImm();
+        val.kind = getIGAImmType(src->getType());
+        DIRECT_ENCODE_SRC01(i, RegFile, GED_REG_FILE_IMM);
+        DIRECT_ENCODE_SRC01(i, DataType, lowerDataType(type));
+        DIRECT_ENCODE(Imm, iga::Encoder::typeConvesionHelper(val, type));
+        return true;
+    }
+
+    G4_SrcRegRegion* srcRegion = src->asSrcRegRegion();
+    SrcModifier srcMod = getIGASrcModifier(srcRegion->getModifier());
+    Type type = getIGAType(inst, inst->getSrcOperandNum(i), platform);
+    bool isDirect = srcRegion->getRegAccess() == Direct;
+    RegName regName = isDirect ? getIGARegName(srcRegion) : RegName::GRF_R;
+
+    DIRECT_ENCODE_SRC01(i, RegFile, lowerRegFile(regName));
+    if (os.supportsSourceModifiers())
+    {
+        DIRECT_ENCODE_SRC01(i, SrcMod, lowerSrcMod(srcMod));
+    }
+    else if (srcMod != SrcModifier::NONE)
+    {
+        return false;
+    }
+    DIRECT_ENCODE_SRC01(i, DataType, lowerDataType(type));
+
+    if (isDirect)
+    {
+        RegRef regRef = getIGARegRef(srcRegion);
+        uint32_t regBits = regRef.regNum;
+        if (regName != RegName::GRF_R &&
+            !getIGARegNumBits(*platformModel, regName, regRef.regNum, regBits))
+        {
+            return false;
+        }
+        DIRECT_ENCODE_SRC01(i, AddrMode, GED_ADDR_MODE_Direct);
+        DIRECT_ENCODE_SRC01(i, RegNum, regBits);
+        DIRECT_ENCODE_SRC01(i, SubRegNum,
+            SubRegToBytesOffset(regRef.subRegNum, regName, type));
+    }
+    else
+    {
+        bool valid;
+        DIRECT_ENCODE_SRC01(i, AddrMode, GED_ADDR_MODE_Indirect);
+        DIRECT_ENCODE_SRC01(i, AddrImm, srcRegion->getAddrImm());
+        DIRECT_ENCODE_SRC01(i, AddrSubRegNum,
+            (uint8_t)srcRegion->ExIndSubRegNum(valid));
+    }
+
+    Region region = getIGARegion(srcRegion, i);
+    if (region.getVt() == Region::Vert::VT_INVALID ||
+        region.getWi() == Region::Width::WI_INVALID ||
+        region.getHz() == Region::Horz::HZ_INVALID)
+    {
+        return false;
+    }
+    DIRECT_ENCODE_SRC01(i, VertStride, lowerRegionVert(region.getVt()));
+    DIRECT_ENCODE_SRC01(i, Width, lowerRegionWidth(region.getWi()));
+    DIRECT_ENCODE_SRC01(i, HorzStride, lowerRegionHorz(region.getHz()));
+    return true;
+}
+
+bool BinaryEncodingIGA::encodeDirectTernarySrc(
+    G4_INST* inst, const OpSpec& os, int i, ged_ins_t& ged)
+{
+    G4_Operand* src = inst->getSrc(i);
+    if (src->isImm())
+    {
+        Type type = getIGAType(src->getType(), platform);
+        ImmVal val;
+        val = src->asImm()->getImm();
+        val.kind = getIGAImmType(src->getType());
+        DIRECT_ENCODE_SRC(i, DataType, lowerDataType(type));
+        DIRECT_ENCODE_SRC(i, RegFile, GED_REG_FILE_IMM);
+        if (i == 0)
+        {
+            DIRECT_ENCODE(Src0TernaryImm,
+                iga::Encoder::typeConvesionHelper(val, type));
+        }
+        else
+        {
+            DIRECT_ENCODE(Src2TernaryImm,
+                iga::Encoder::typeConvesionHelper(val, type));
+        }
+        return true;
+    }
+
+    G4_SrcRegRegion* srcRegion = src->asSrcRegRegion();
+    Type type = getIGAType(inst, inst->getSrcOperandNum(i), platform);
+    RegName regName = getIGARegName(srcRegion);
+    RegRef regRef = getIGARegRef(srcRegion);
+    Region region = getIGARegion(srcRegion, i);
+    uint32_t regBits = regRef.regNum;
+    if (regName != RegName::GRF_R &&
+        !getIGARegNumBits(*platformModel, regName, regRef.regNum, regBits))
+    {
+        return false;
+    }
+
+    DIRECT_ENCODE_SRC(i, DataType, lowerDataType(type));
+    DIRECT_ENCODE_SRC(i, RegFile, lowerRegFile(regName));
+    if (os.supportsSourceModifiers())
+    {
+        DIRECT_ENCODE_SRC(i, SrcMod,
+            lowerSrcMod(getIGASrcModifier(srcRegion->getModifier())));
+    }
+    DIRECT_ENCODE_SRC(i, HorzStride, lowerRegionHorz(region.getHz()));
+    if (i < 2)
+    {
+        // src2 has no vertical stride
+        DIRECT_ENCODE_SRC01(i, VertStride, lowerRegionVert(region.getVt()));
+    }
+    DIRECT_ENCODE_SRC(i, RegNum, regBits);
+    DIRECT_ENCODE_SRC(i, SubRegNum,
+        SubRegToBytesOffset(regRef.subRegNum, regName, type));
+    return true;
+}
+
+bool BinaryEncodingIGA::encodeDirectOptions(
+    G4_INST* inst, const OpSpec& os, const InstOptSet& opts, ged_ins_t& ged)
+{
+    DIRECT_ENCODE(DebugCtrl, opts.contains(InstOpt::BREAKPOINT) ?
+        GED_DEBUG_CTRL_Breakpoint : GED_DEBUG_CTRL_Normal);
+    if (opts.contains(InstOpt::EOT))
+    {
+        DIRECT_ENCODE(EOT, GED_EOT_EOT);
+    }
+
+    if (os.supportsDepCtrl())
+    {
+        bool noDDChk = opts.contains(InstOpt::NODDCHK);
+        bool noDDClr = opts.contains(InstOpt::NODDCLR);
+        if (noDDChk && noDDClr)
+        {
+            DIRECT_ENCODE(DepCtrl, GED_DEP_CTRL_NoDDClr_NoDDChk);
+        }
+        else if (noDDChk)
+        {
+            DIRECT_ENCODE(DepCtrl, GED_DEP_CTRL_NoDDChk);
+        }
+        else if (noDDClr)
+        {
+            DIRECT_ENCODE(DepCtrl, GED_DEP_CTRL_NoDDClr);
+        }
+        else if (!os.isSendOrSendsFamily() && !os.is(Op::NOP))
+        {
+            DIRECT_ENCODE(DepCtrl, GED_DEP_CTRL_Normal);
+        }
+    }
+
+    bool atomic = opts.contains(InstOpt::ATOMIC);
+    bool yield = opts.contains(InstOpt::SWITCH);
+    bool noPreempt = opts.contains(InstOpt::NOPREEMPT);
+    if (atomic)
+    {
+        DIRECT_ENCODE(ThreadCtrl, GED_THREAD_CTRL_Atomic);
+    }
+    if (yield && platformModel->supportsHwDeps() && !os.is(Op::NOP))
+    {
+        DIRECT_ENCODE(ThreadCtrl, GED_THREAD_CTRL_Switch);
+    }
+    if (noPreempt && platformModel->supportsNoPreempt())
+    {
+        DIRECT_ENCODE(ThreadCtrl, GED_THREAD_CTRL_NoPreempt);
+    }
+    if (!atomic && !yield && !noPreempt &&
+        !os.isSendOrSendsFamily() && !os.is(Op::NOP))
+    {
+        DIRECT_ENCODE(ThreadCtrl, GED_THREAD_CTRL_Normal);
+    }
+
+    if (opts.contains(InstOpt::NOSRCDEPSET))
+    {
+        DIRECT_ENCODE(NoSrcDepSet, GED_NO_SRC_DEP_SET_NoSrcDepSet);
+    }
+    else if (os.isSendOrSendsFamily() && platformModel->supportNoSrcDepSet())
+    {
+        DIRECT_ENCODE(NoSrcDepSet, GED_NO_SRC_DEP_SET_Normal);
+    }
+
+    iga::SWSB sw;
+    SetSWSB(inst, sw);
+    SWSB_ENCODE_MODE mode = GetIGASWSBEncodeMode(*kernel.fg.builder);
+    SWSB::InstType instTy = SWSB::InstType::OTHERS;
+    if (os.isSendOrSendsFamily())
+        instTy = SWSB::InstType::SEND;
+    else if (os.is(Op::MATH))
+        instTy = SWSB::InstType::MATH;
+    if (!sw.verify(mode, instTy))
+    {
+        return false;
+    }
+    DIRECT_ENCODE(SWSB, sw.encode(mode, instTy));
+    return true;
+}
+
+#undef DIRECT_ENCODE
+#undef DIRECT_ENCODE_SRC
+#undef DIRECT_ENCODE_SRC01
+
+void BinaryEncodingIGA::verifyDirectEncoding(
+    const std::vector<uint8_t>& directBits,
+    const std::vector<int64_t>& directOffsets)
+{
+    std::vector<G4_INST*> insts;
+    for (auto bb : kernel.fg)
+    {
+        for (auto inst : *bb)
+        {
+            if (!inst->isLabel())
+            {
+                insts.push_back(inst);
+            }
+        }
+    }
+
+    auto bits = static_cast<const uint8_t*>(m_kernelBuffer);
+    for (size_t i = 0, e = insts.size(); i != e; ++i)
+    {
+        size_t start = (size_t)insts[i]->getGenOffset();
+        size_t end = i + 1 != e ?
+            (size_t)insts[i + 1]->getGenOffset() : m_kernelBufferSize;
+        if (i < directOffsets.size() && (size_t)directOffsets[i] == start &&
+            end <= directBits.size() &&
+            std::equal(bits + start, bits + end, directBits.begin() + start))
+        {
+            continue;
+        }
+
+        std::ios::fmtflags flags(std::cerr.flags());
+        std::cerr << kernel.getName() << ": direct encoder mismatch at offset "
+            << start << " (direct " << (i < directOffsets.size() ? directOffsets[i] : -1)
+            << ")\n  ";
+        insts[i]->emit(std::cerr);
+        std::cerr << "\n  iga:   " << std::hex;
+        for (size_t b = start; b < end; b++)
+        {
+            std::cerr << std::setw(2) << std::setfill('0') << (unsigned)bits[b];
+        }
+        std::cerr << "\n  direct:";
+        for (size_t b = start; b < end && b < directBits.size(); b++)
+        {
+            std::cerr << std::setw(2) << std::setfill('0') << (unsigned)directBits[b];
+        }
+        std::cerr << "\n";
+        std::cerr.flags(flags);
+        assert(false && "direct encoder output differs from the IGA encoder");
+        return;
     }
+    assert(directBits.size() == m_kernelBufferSize &&
+        "direct encoder output differs from the IGA encoder");
 }
 
 iga::Instruction *BinaryEncodingIGA::translateInstruction(
@@ -26,15 +26,24 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "BitSet.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BITSET_USE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BITSET_USE_SSE2
+#endif
+
 void BitSet::create(unsigned size)
 {
-    const unsigned newArraySize = (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
-    const unsigned oldArraySize = (m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
-    const unsigned numBitsLeft = size % NUM_BITS_PER_ELT;
+    const unsigned newArraySize = numWords(size);
+    const unsigned oldArraySize = numWords(m_Size);
+    const unsigned numBitsLeft = size % NUM_BITS_PER_WORD;
 
     if (size == 0)
     {
         free(m_BitSetArray);
+        m_BitSetArray = nullptr;
         m_Size = 0;
         return;
     }
@@ -45,12 +54,12 @@ void BitSet::create(unsigned size)
         m_Size = size;
         if (newArraySize && numBitsLeft != 0)
         {
-            m_BitSetArray[ newArraySize - 1 ] &= BIT(numBitsLeft) - 1;
+            m_BitSetArray[ newArraySize - 1 ] &= lowMask(numBitsLeft);
         }
     }
     else
     {
-        BITSET_ARRAY_TYPE*  ptr = (BITSET_ARRAY_TYPE*) malloc(newArraySize * sizeof(BITSET_ARRAY_TYPE));
+        BITSET_WORD_TYPE*  ptr = (BITSET_WORD_TYPE*) malloc(newArraySize * sizeof(BITSET_WORD_TYPE));
 
         if (ptr)
         {
@@ -59,23 +68,23 @@ void BitSet::create(unsigned size)
                 if (newArraySize > oldArraySize)
                 {
                     // copy entire old array over, set uninitialized bits to zero
-                    memcpy_s(ptr, newArraySize * sizeof(BITSET_ARRAY_TYPE), m_BitSetArray, oldArraySize * sizeof(BITSET_ARRAY_TYPE));
+                    memcpy_s(ptr, newArraySize * sizeof(BITSET_WORD_TYPE), m_BitSetArray, oldArraySize * sizeof(BITSET_WORD_TYPE));
                     memset(ptr + oldArraySize, 0,
-                        (newArraySize - oldArraySize) * sizeof(BITSET_ARRAY_TYPE));
+                        (newArraySize - oldArraySize) * sizeof(BITSET_WORD_TYPE));
                 }
                 else
                 {
                     // copy old array up to the size of new array, zero out the unused bits
-                    memcpy_s(ptr, newArraySize * sizeof(BITSET_ARRAY_TYPE), m_BitSetArray, newArraySize * sizeof(BITSET_ARRAY_TYPE));
+                    memcpy_s(ptr, newArraySize * sizeof(BITSET_WORD_TYPE), m_BitSetArray, newArraySize * sizeof(BITSET_WORD_TYPE));
                     if (numBitsLeft != 0)
                     {
-                        ptr[ newArraySize - 1 ] &= BIT(numBitsLeft) - 1;
+                        ptr[ newArraySize - 1 ] &= lowMask(numBitsLeft);
                     }
                 }
             }
             else
             {
-                memset(ptr, 0, newArraySize * sizeof(BITSET_ARRAY_TYPE));
+                memset(ptr, 0, newArraySize * sizeof(BITSET_WORD_TYPE));
             }
 
             free(m_BitSetArray);
@@ -95,17 +104,17 @@ void BitSet::setAll(void)
     if (m_BitSetArray)
     {
         unsigned index;
-        for (index = 0; index < m_Size / NUM_BITS_PER_ELT; index++)
+        for (index = 0; index < m_Size / NUM_BITS_PER_WORD; index++)
         {
-            m_BitSetArray[index] = ~((BITSET_ARRAY_TYPE)0);
+            m_BitSetArray[index] = ~((BITSET_WORD_TYPE)0);
         }
 
         // do the leftover bits, make sure we don't change the values of the unused bits,
         // so isEmpty() can be implemented faster
-        int numBitsLeft = m_Size % NUM_BITS_PER_ELT;
+        int numBitsLeft = m_Size % NUM_BITS_PER_WORD;
         if (numBitsLeft)
         {
-            m_BitSetArray[index] = BIT(numBitsLeft) - 1;
+            m_BitSetArray[index] = lowMask(numBitsLeft);
         }
     }
 }
@@ -115,24 +124,67 @@ void BitSet::invert(void)
     if (m_BitSetArray)
     {
         unsigned index;
-        for (index = 0; index < m_Size / NUM_BITS_PER_ELT; index++)
+        for (index = 0; index < m_Size / NUM_BITS_PER_WORD; index++)
         {
             m_BitSetArray[index] = ~m_BitSetArray[index];
         }
 
         // do the leftover bits
-        int numBitsLeft = m_Size % NUM_BITS_PER_ELT;
+        int numBitsLeft = m_Size % NUM_BITS_PER_WORD;
         if (numBitsLeft)
         {
-            m_BitSetArray[index] = ~m_BitSetArray[index] & (BIT(numBitsLeft) - 1);
+            m_BitSetArray[index] = ~m_BitSetArray[index] & lowMask(numBitsLeft);
         }
     }
 }
 
+//
+// Bulk word operations. Each one processes as many words as possible with
+// the widest SIMD registers available at compile time and finishes the tail
+// with scalar 64-bit operations. All loads/stores are unaligned since the
+// word array comes from malloc.
+//
+#if defined(BITSET_USE_AVX2)
+typedef __m256i simd_t;
+#define SIMD_LOAD(p)        _mm256_loadu_si256((const __m256i *)(p))
+#define SIMD_STORE(p, v)    _mm256_storeu_si256((__m256i *)(p), v)
+#define SIMD_AND(a, b)      _mm256_and_si256(a, b)
+#define SIMD_OR(a, b)       _mm256_or_si256(a, b)
+#define SIMD_XOR(a, b)      _mm256_xor_si256(a, b)
+#define SIMD_ANDNOT(b, a)   _mm256_andnot_si256(b, a)   // a & ~b
+#define SIMD_ZERO()         _mm256_setzero_si256()
+#define SIMD_IS_ZERO(v)     _mm256_testz_si256(v, v)
+#elif defined(BITSET_USE_SSE2)
+typedef __m128i simd_t;
+#define SIMD_LOAD(p)        _mm_loadu_si128((const __m128i *)(p))
+#define SIMD_STORE(p, v)    _mm_storeu_si128((__m128i *)(p), v)
+#define SIMD_AND(a, b)      _mm_and_si128(a, b)
+#define SIMD_OR(a, b)       _mm_or_si128(a, b)
+#define SIMD_XOR(a, b)      _mm_xor_si128(a, b)
+#define SIMD_ANDNOT(b, a)   _mm_andnot_si128(b, a)      // a & ~b
+#define SIMD_ZERO()         _mm_setzero_si128()
+#define SIMD_IS_ZERO(v)     (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xFFFF)
+#endif
+
+#if defined(BITSET_USE_AVX2) || defined(BITSET_USE_SSE2)
+#define SIMD_WORDS (sizeof(simd_t) / sizeof(BITSET_WORD_TYPE))
+#define HAS_SIMD 1
+#else
+#define SIMD_WORDS 1
+#define HAS_SIMD 0
+#endif
+
 template <typename T>
 void vector_and(T *__restrict__ p1, const T *const p2, unsigned n)
 {
-    for (unsigned i = 0; i < n; ++i)
+    unsigned i = 0;
+#if HAS_SIMD
+    for (; i + SIMD_WORDS <= n; i += SIMD_WORDS)
+    {
+        SIMD_STORE(p1 + i, SIMD_AND(SIMD_LOAD(p1 + i), SIMD_LOAD(p2 + i)));
+    }
+#endif
+    for (; i < n; ++i)
     {
         p1[i] &= p2[i];
     }
@@ -141,7 +193,14 @@ void vector_and(T *__restrict__ p1, const T *const p2, unsigned n)
 template <typename T>
 void vector_or(T *__restrict__ p1, const T *const p2, unsigned n)
 {
-    for (unsigned i = 0; i < n; ++i)
+    unsigned i = 0;
+#if HAS_SIMD
+    for (; i + SIMD_WORDS <= n; i += SIMD_WORDS)
+    {
+        SIMD_STORE(p1 + i, SIMD_OR(SIMD_LOAD(p1 + i), SIMD_LOAD(p2 + i)));
+    }
+#endif
+    for (; i < n; ++i)
     {
         p1[i] |= p2[i];
     }
@@ -150,12 +209,117 @@ void vector_or(T *__restrict__ p1, const T *const p2, unsigned n)
 template <typename T>
 void vector_minus(T *__restrict__ p1, const T *const p2, unsigned n)
 {
-    for (unsigned i = 0; i < n; ++i)
+    unsigned i = 0;
+#if HAS_SIMD
+    for (; i + SIMD_WORDS <= n; i += SIMD_WORDS)
+    {
+        SIMD_STORE(p1 + i, SIMD_ANDNOT(SIMD_LOAD(p2 + i), SIMD_LOAD(p1 + i)));
+    }
+#endif
+    for (; i < n; ++i)
     {
         p1[i] &= ~p2[i];
     }
 }
 
+template <typename T>
+void vector_xor(T *__restrict__ p1, const T *const p2, unsigned n)
+{
+    unsigned i = 0;
+#if HAS_SIMD
+    for (; i + SIMD_WORDS <= n; i += SIMD_WORDS)
+    {
+        SIMD_STORE(p1 + i, SIMD_XOR(SIMD_LOAD(p1 + i), SIMD_LOAD(p2 + i)));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        p1[i] ^= p2[i];
+    }
+}
+
+template <typename T>
+bool vector_is_zero(const T *const p, unsigned n)
+{
+    unsigned i = 0;
+#if HAS_SIMD
+    for (; i + SIMD_WORDS <= n; i += SIMD_WORDS)
+    {
+        if (!SIMD_IS_ZERO(SIMD_LOAD(p + i)))
+        {
+            return false;
+        }
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (p[i] != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// p1 |= p2 & ~p3, returns true if p1 changed
+template <typename T>
+bool vector_or_andnot(T *__restrict__ p1, const T *const p2, const T *const p3, unsigned n)
+{
+    unsigned i = 0;
+    bool changed = false;
+#if HAS_SIMD
+    simd_t diff = SIMD_ZERO();
+    for (; i + SIMD_WORDS <= n; i += SIMD_WORDS)
+    {
+        simd_t oldVal = SIMD_LOAD(p1 + i);
+        simd_t newVal = SIMD_OR(oldVal, SIMD_ANDNOT(SIMD_LOAD(p3 + i), SIMD_LOAD(p2 + i)));
+        diff = SIMD_OR(diff, SIMD_XOR(oldVal, newVal));
+        SIMD_STORE(p1 + i, newVal);
+    }
+    changed = !SIMD_IS_ZERO(diff);
+#endif
+    T scalarDiff = 0;
+    for (; i < n; ++i)
+    {
+        T newVal = p1[i] | (p2[i] & ~p3[i]);
+        scalarDiff |= p1[i] ^ newVal;
+        p1[i] = newVal;
+    }
+    return changed || scalarDiff != 0;
+}
+
+// p1 = p0 | (p2 & ~p3), returns true if p1 changed
+template <typename T>
+bool vector_assign_or_andnot(
+    T *__restrict__ p1, const T *const p0, const T *const p2, const T *const p3, unsigned n)
+{
+    unsigned i = 0;
+    bool changed = false;
+#if HAS_SIMD
+    simd_t diff = SIMD_ZERO();
+    for (; i + SIMD_WORDS <= n; i += SIMD_WORDS)
+    {
+        simd_t newVal = SIMD_OR(SIMD_LOAD(p0 + i), SIMD_ANDNOT(SIMD_LOAD(p3 + i), SIMD_LOAD(p2 + i)));
+        diff = SIMD_OR(diff, SIMD_XOR(SIMD_LOAD(p1 + i), newVal));
+        SIMD_STORE(p1 + i, newVal);
+    }
+    changed = !SIMD_IS_ZERO(diff);
+#endif
+    T scalarDiff = 0;
+    for (; i < n; ++i)
+    {
+        T newVal = p0[i] | (p2[i] & ~p3[i]);
+        scalarDiff |= p1[i] ^ newVal;
+        p1[i] = newVal;
+    }
+    return changed || scalarDiff != 0;
+}
+
+bool BitSet::isEmpty() const
+{
+    return vector_is_zero(m_BitSetArray, numWords(m_Size));
+}
+
 BitSet& BitSet::operator|=(const BitSet& other)
 {
     unsigned size = other.m_Size;
@@ -167,8 +331,7 @@ BitSet& BitSet::operator|=(const BitSet& other)
         size = m_Size;
     }
 
-    unsigned arraySize = (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
-    vector_or(m_BitSetArray, other.m_BitSetArray, arraySize);
+    vector_or(m_BitSetArray, other.m_BitSetArray, numWords(size));
 
     return *this;
 }
@@ -177,8 +340,7 @@ BitSet& BitSet::operator-= (const BitSet &other)
 {
     // do not grow the set for subtract
     unsigned size = m_Size < other.m_Size ? m_Size : other.m_Size;
-    unsigned arraySize = (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
-    vector_minus(m_BitSetArray, other.m_BitSetArray, arraySize);
+    vector_minus(m_BitSetArray, other.m_BitSetArray, numWords(size));
     return *this;
 }
 
@@ -186,11 +348,11 @@ BitSet& BitSet::operator&= (const BitSet &other)
 {
     // do not grow the set for and
     unsigned size =  m_Size < other.m_Size ? m_Size : other.m_Size;
-    unsigned arraySize = (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+    unsigned arraySize = numWords(size);
     vector_and(m_BitSetArray, other.m_BitSetArray, arraySize);
 
     //zero out the leftover bits if there are any
-    unsigned myArraySize = (m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+    unsigned myArraySize = numWords(m_Size);
     for (unsigned i = arraySize; i < myArraySize; i++)
     {
         m_BitSetArray[ i ] = 0;
@@ -198,3 +360,85 @@ BitSet& BitSet::operator&= (const BitSet &other)
 
     return *this;
 }
+
+BitSet& BitSet::operator^=(const BitSet& other)
+{
+    unsigned size = other.m_Size;
+
+    //grow the set to the size of the other set if necessary
+    if (m_Size < other.m_Size)
+    {
+        create(other.m_Size);
+        size = m_Size;
+    }
+
+    vector_xor(m_BitSetArray, other.m_BitSetArray, numWords(size));
+
+    return *this;
+}
+
+bool BitSet::orAndNot(const BitSet &a, const BitSet &b)
+{
+    if (a.m_Size == m_Size && b.m_Size == m_Size)
+    {
+        return vector_or_andnot(m_BitSetArray, a.m_BitSetArray, b.m_BitSetArray, numWords(m_Size));
+    }
+
+    // sizes differ, fall back to the unfused operators
+    BitSet tmp(a);
+    tmp -= b;
+    BitSet old(*this);
+    *this |= tmp;
+    return old != *this;
+}
+
+bool BitSet::assignOrAndNot(const BitSet &g, const BitSet &a, const BitSet &b)
+{
+    if (g.m_Size == m_Size && a.m_Size == m_Size && b.m_Size == m_Size)
+    {
+        return vector_assign_or_andnot(
+            m_BitSetArray, g.m_BitSetArray, a.m_BitSetArray, b.m_BitSetArray, numWords(m_Size));
+    }
+
+    // sizes differ, fall back to the unfused operators
+    BitSet tmp(a);
+    tmp -= b;
+    tmp |= g;
+    bool changed = tmp != *this;
+    swap(tmp);
+    return changed;
+}
+
+void BitSet::copyBits(unsigned dstIndex, const BitSet &src, unsigned srcIndex, unsigned count)
+{
+    MUST_BE_TRUE(srcIndex + count <= src.m_Size, "Invalid bitSet Index");
+    if (dstIndex + count > m_Size)
+    {
+        create(dstIndex + count);
+    }
+
+    while (count > 0)
+    {
+        // read up to one word worth of bits from src
+        unsigned srcWord = srcIndex / NUM_BITS_PER_WORD;
+        unsigned srcShift = srcIndex % NUM_BITS_PER_WORD;
+        unsigned dstShift = dstIndex % NUM_BITS_PER_WORD;
+        unsigned n = NUM_BITS_PER_WORD - dstShift;
+        n = n < count ? n : count;
+
+        BITSET_WORD_TYPE bits = src.m_BitSetArray[srcWord] >> srcShift;
+        if (srcShift + n > NUM_BITS_PER_WORD)
+        {
+            bits |= src.m_BitSetArray[srcWord + 1] << (NUM_BITS_PER_WORD - srcShift);
+        }
+        bits &= lowMask(n);
+
+        // write them into the (single) destination word
+        BITSET_WORD_TYPE& dst = m_BitSetArray[dstIndex / NUM_BITS_PER_WORD];
+        dst = (dst & ~(lowMask(n) << dstShift)) | (bits << dstShift);
+
+        srcIndex += n;
+        dstIndex += n;
+        count -= n;
+    }
+}
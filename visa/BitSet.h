@@ -28,18 +28,29 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define _BITSET_H_
 
 #include "Mem_Manager.h"
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 // Array-based bitset implementation where each element occupies a single bit.
-// Inside each array element, bits are stored and indexed from lsb to msb.
+// Bits are stored in 64-bit words and indexed from lsb to msb inside each word.
+// For compatibility with existing clients that work on 32-bit chunks
+// (e.g., footprints and the interference matrix), getElt/setElt/resetElt
+// still address the bitset as an array of 32-bit elements; element i is
+// the low (even i) or high (odd i) half of word i / 2.
 typedef unsigned int BITSET_ARRAY_TYPE;
+typedef uint64_t BITSET_WORD_TYPE;
 
 class BitSet
 {
 #define BITS_PER_BYTE  8
 #define BIT(x)  (((BITSET_ARRAY_TYPE)1 ) << x)
 #define NUM_BITS_PER_ELT ( sizeof(BITSET_ARRAY_TYPE) * BITS_PER_BYTE )
+#define NUM_BITS_PER_WORD ( sizeof(BITSET_WORD_TYPE) * BITS_PER_BYTE )
+#define NUM_ELTS_PER_WORD ( NUM_BITS_PER_WORD / NUM_BITS_PER_ELT )
 
 public:
     BitSet() : m_BitSetArray(nullptr), m_Size(0) {}
@@ -73,30 +84,21 @@ public:
     void resize(unsigned size) { create(size); }
     void clear()
     {
-        unsigned sizeInBytes = (m_Size + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
-        std::memset(m_BitSetArray, 0, sizeInBytes);
+        if (m_BitSetArray)
+        {
+            std::memset(m_BitSetArray, 0, numWords(m_Size) * sizeof(BITSET_WORD_TYPE));
+        }
     }
 
     void setAll(void);
     void invert(void);
 
-    bool isEmpty() const
-    {
-        unsigned arraySize = (m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
-        for (unsigned i = 0; i < arraySize; i++)
-        {
-            if (m_BitSetArray[i] != 0)
-            {
-                return false;
-            }
-        }
-        return true;
-    }
+    bool isEmpty() const;
 
     bool isAllset() const
     {
         unsigned index;
-        unsigned bound = m_Size / NUM_BITS_PER_ELT;
+        unsigned bound = m_Size / NUM_BITS_PER_WORD;
 
         for (index = 0; index < bound; index++)
         {
@@ -106,13 +108,10 @@ public:
             }
         }
 
-        unsigned numBitsLeft = m_Size % NUM_BITS_PER_ELT;
-        for (unsigned bitIndex = 0; bitIndex < numBitsLeft; bitIndex++)
+        unsigned numBitsLeft = m_Size % NUM_BITS_PER_WORD;
+        if (numBitsLeft)
         {
-            if ((m_BitSetArray[index] & BIT(bitIndex)) == 0)
-            {
-                return false;
-            }
+            return m_BitSetArray[index] == lowMask(numBitsLeft);
         }
 
         return true;
@@ -123,9 +122,9 @@ public:
     {
         if (index < m_Size)
         {
-            unsigned arrayIndex = index / NUM_BITS_PER_ELT;
-            unsigned bitIndex = index % NUM_BITS_PER_ELT;
-            return (m_BitSetArray[arrayIndex] & BIT(bitIndex)) != 0;
+            unsigned arrayIndex = index / NUM_BITS_PER_WORD;
+            unsigned bitIndex = index % NUM_BITS_PER_WORD;
+            return (m_BitSetArray[arrayIndex] & wordBit(bitIndex)) != 0;
         }
         return false;
     }
@@ -136,36 +135,23 @@ public:
         MUST_BE_TRUE(startIndex < m_Size, "Invalid bitSet Index");
         MUST_BE_TRUE(endIndex < m_Size, "Invalid bitSet Index");
 
-        unsigned start = startIndex / NUM_BITS_PER_ELT;
-        unsigned end = endIndex / NUM_BITS_PER_ELT;
+        unsigned start = startIndex / NUM_BITS_PER_WORD;
+        unsigned end = endIndex / NUM_BITS_PER_WORD;
+        BITSET_WORD_TYPE firstMask = ~lowMask(startIndex % NUM_BITS_PER_WORD);
+        BITSET_WORD_TYPE lastMask = lowMask(endIndex % NUM_BITS_PER_WORD + 1);
 
         if (start == end)
         {
-            for (unsigned i = startIndex; i <= endIndex; i++)
-            {
-                if (!isSet(i))
-                {
-                    return false;
-                }
-            }
-            return true;
+            BITSET_WORD_TYPE mask = firstMask & lastMask;
+            return (m_BitSetArray[start] & mask) == mask;
         }
 
-        unsigned index;
-        unsigned numBitsBefore = startIndex % NUM_BITS_PER_ELT;
-        if (numBitsBefore)
+        if ((m_BitSetArray[start] & firstMask) != firstMask)
         {
-            for (unsigned bitIndex = numBitsBefore; bitIndex < NUM_BITS_PER_ELT; bitIndex++)
-            {
-                if ((m_BitSetArray[start] & BIT(bitIndex)) == 0)
-                {
-                    return false;
-                }
-            }
-            start++;
+            return false;
         }
 
-        for (index = start; index < end; index++)
+        for (unsigned index = start + 1; index < end; index++)
         {
             if (~m_BitSetArray[index] != 0)
             {
@@ -173,16 +159,7 @@ public:
             }
         }
 
-        unsigned numBitsLeft = endIndex % NUM_BITS_PER_ELT;
-        for (unsigned bitIndex = 0; bitIndex <= numBitsLeft; bitIndex++)
-        {
-            if ((m_BitSetArray[index] & BIT(bitIndex)) == 0)
-            {
-                return false;
-            }
-        }
-
-        return true;
+        return (m_BitSetArray[end] & lastMask) == lastMask;
     }
 
     bool isEmpty(unsigned startIndex, unsigned endIndex) const
@@ -191,36 +168,22 @@ public:
         MUST_BE_TRUE(startIndex < m_Size, "Invalid bitSet Index");
         MUST_BE_TRUE(endIndex < m_Size, "Invalid bitSet Index");
 
-        unsigned start = startIndex / NUM_BITS_PER_ELT;
-        unsigned end = endIndex / NUM_BITS_PER_ELT;
+        unsigned start = startIndex / NUM_BITS_PER_WORD;
+        unsigned end = endIndex / NUM_BITS_PER_WORD;
+        BITSET_WORD_TYPE firstMask = ~lowMask(startIndex % NUM_BITS_PER_WORD);
+        BITSET_WORD_TYPE lastMask = lowMask(endIndex % NUM_BITS_PER_WORD + 1);
 
         if (start == end)
         {
-            for (unsigned i = startIndex; i <= endIndex; i++)
-            {
-                if (isSet(i))
-                {
-                    return false;
-                }
-            }
-            return true;
+            return (m_BitSetArray[start] & firstMask & lastMask) == 0;
         }
 
-        unsigned index;
-        unsigned numBitsBefore = startIndex % NUM_BITS_PER_ELT;
-        if (numBitsBefore)
+        if ((m_BitSetArray[start] & firstMask) != 0)
         {
-            for (unsigned bitIndex = numBitsBefore; bitIndex < NUM_BITS_PER_ELT; bitIndex++)
-            {
-                if ((m_BitSetArray[start] & BIT(bitIndex)) != 0)
-                {
-                    return false;
-                }
-            }
-            start++;
+            return false;
         }
 
-        for (index = start; index < end; index++)
+        for (unsigned index = start + 1; index < end; index++)
         {
             if (m_BitSetArray[index] != 0)
             {
@@ -228,22 +191,13 @@ public:
             }
         }
 
-        unsigned numBitsLeft = endIndex % NUM_BITS_PER_ELT;
-        for (unsigned bitIndex = 0; bitIndex <= numBitsLeft; bitIndex++)
-        {
-            if ((m_BitSetArray[index] & BIT(bitIndex)) != 0)
-            {
-                return false;
-            }
-        }
-
-        return true;
+        return (m_BitSetArray[end] & lastMask) == 0;
     }
 
     BITSET_ARRAY_TYPE getElt(unsigned eltIndex) const
     {
-        MUST_BE_TRUE(eltIndex < m_Size, "Invalid bitSet Index");
-        return m_BitSetArray[eltIndex];
+        MUST_BE_TRUE(eltIndex / NUM_ELTS_PER_WORD < numWords(m_Size), "Invalid bitSet Index");
+        return (BITSET_ARRAY_TYPE)(m_BitSetArray[eltIndex / NUM_ELTS_PER_WORD] >> eltShift(eltIndex));
     }
 
     void setElt(unsigned eltIndex, BITSET_ARRAY_TYPE value)
@@ -253,7 +207,7 @@ public:
         {
             create(bound);
         }
-        m_BitSetArray[eltIndex] |= value;
+        m_BitSetArray[eltIndex / NUM_ELTS_PER_WORD] |= (BITSET_WORD_TYPE)value << eltShift(eltIndex);
     }
 
     void resetElt(unsigned eltIndex, BITSET_ARRAY_TYPE value)
@@ -263,7 +217,7 @@ public:
         {
             create(bound);
         }
-        m_BitSetArray[eltIndex] &= ~value;
+        m_BitSetArray[eltIndex / NUM_ELTS_PER_WORD] &= ~((BITSET_WORD_TYPE)value << eltShift(eltIndex));
     }
 
     void set(unsigned index, bool value)
@@ -274,47 +228,112 @@ public:
             create(index + 1);
         }
 
-        unsigned arrayIndex = index / NUM_BITS_PER_ELT;
-        unsigned bitIndex = index % NUM_BITS_PER_ELT;
+        unsigned arrayIndex = index / NUM_BITS_PER_WORD;
+        unsigned bitIndex = index % NUM_BITS_PER_WORD;
 
         if (value)
         {
-            m_BitSetArray[arrayIndex] |= BIT(bitIndex);
+            m_BitSetArray[arrayIndex] |= wordBit(bitIndex);
         }
         else
         {
-            m_BitSetArray[arrayIndex] &= ~BIT(bitIndex);
+            m_BitSetArray[arrayIndex] &= ~wordBit(bitIndex);
         }
     }
 
     void set(unsigned startIndex, unsigned endIndex)
     {
-        for (unsigned i = startIndex; i <= endIndex; i++)
+        if (startIndex > endIndex)
+        {
+            return;
+        }
+        if (endIndex >= m_Size)
+        {
+            create(endIndex + 1);
+        }
+
+        unsigned start = startIndex / NUM_BITS_PER_WORD;
+        unsigned end = endIndex / NUM_BITS_PER_WORD;
+        BITSET_WORD_TYPE firstMask = ~lowMask(startIndex % NUM_BITS_PER_WORD);
+        BITSET_WORD_TYPE lastMask = lowMask(endIndex % NUM_BITS_PER_WORD + 1);
+
+        if (start == end)
+        {
+            m_BitSetArray[start] |= firstMask & lastMask;
+            return;
+        }
+
+        m_BitSetArray[start] |= firstMask;
+        for (unsigned index = start + 1; index < end; index++)
         {
-            set(i, true);
+            m_BitSetArray[index] = ~(BITSET_WORD_TYPE)0;
         }
+        m_BitSetArray[end] |= lastMask;
     }
 
     unsigned getSize() const { return m_Size; }
 
+    // Returns the index of the first set bit at or after startIndex,
+    // or getSize() if there is none. Typical usage:
+    //   for (unsigned i = bs.findFirstSet(); i < bs.getSize(); i = bs.findNextSet(i + 1))
+    unsigned findNextSet(unsigned startIndex) const
+    {
+        if (startIndex >= m_Size)
+        {
+            return m_Size;
+        }
+
+        unsigned index = startIndex / NUM_BITS_PER_WORD;
+        BITSET_WORD_TYPE word = m_BitSetArray[index] & ~lowMask(startIndex % NUM_BITS_PER_WORD);
+        unsigned arraySize = numWords(m_Size);
+        while (word == 0)
+        {
+            if (++index == arraySize)
+            {
+                return m_Size;
+            }
+            word = m_BitSetArray[index];
+        }
+
+        // unused bits in the last word are always zero, so the result is < m_Size
+        return index * NUM_BITS_PER_WORD + countTrailingZeros(word);
+    }
+
+    unsigned findFirstSet() const { return findNextSet(0); }
+
+    // Number of trailing zero bits of a non-zero word.
+    static unsigned countTrailingZeros(BITSET_WORD_TYPE word)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+#if defined(_WIN64)
+        _BitScanForward64(&index, word);
+#else
+        if (!_BitScanForward(&index, (unsigned long)word))
+        {
+            _BitScanForward(&index, (unsigned long)(word >> 32));
+            index += 32;
+        }
+#endif
+        return (unsigned)index;
+#else
+        return (unsigned)__builtin_ctzll(word);
+#endif
+    }
+
     bool operator==(const BitSet &other) const
     {
         if (m_Size == other.m_Size)
         {
-            unsigned sizeInBytes = (m_Size + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
-            return 0 == std::memcmp(m_BitSetArray, other.m_BitSetArray, sizeInBytes);
+            // unused bits in the last word are always zero
+            return 0 == std::memcmp(m_BitSetArray, other.m_BitSetArray, numWords(m_Size) * sizeof(BITSET_WORD_TYPE));
         }
         return false;
     }
 
     bool operator!=(const BitSet &other) const
     {
-        if (m_Size == other.m_Size)
-        {
-            unsigned sizeInBytes = (m_Size + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
-            return 0 != std::memcmp(m_BitSetArray, other.m_BitSetArray, sizeInBytes);
-        }
-        return true;
+        return !(*this == other);
     }
 
     BitSet& operator= (const BitSet &other)
@@ -349,27 +368,56 @@ public:
     BitSet &operator|=(const BitSet &other);
     BitSet &operator&=(const BitSet &other);
     BitSet &operator-=(const BitSet &other);
+    BitSet &operator^=(const BitSet &other);
+
+    // Fused dataflow operators.
+    // orAndNot:       this |= a & ~b
+    // assignOrAndNot: this  = g | (a & ~b)
+    // Both return true if any bit of this set changed.
+    bool orAndNot(const BitSet &a, const BitSet &b);
+    bool assignOrAndNot(const BitSet &g, const BitSet &a, const BitSet &b);
+
+    // Copy count bits of src starting at srcIndex into this set starting at dstIndex.
+    void copyBits(unsigned dstIndex, const BitSet &src, unsigned srcIndex, unsigned count);
 
     void *operator new(size_t sz, vISA::
         Mem_Manager &m) { return m.alloc(sz); }
 
 protected:
-    BITSET_ARRAY_TYPE* m_BitSetArray;
+    BITSET_WORD_TYPE* m_BitSetArray;
     unsigned m_Size;
 
+    static unsigned numWords(unsigned size)
+    {
+        return (size + NUM_BITS_PER_WORD - 1) / NUM_BITS_PER_WORD;
+    }
+    static BITSET_WORD_TYPE wordBit(unsigned bitIndex)
+    {
+        return (BITSET_WORD_TYPE)1 << bitIndex;
+    }
+    // mask of the lowest numBits bits, numBits must be in [0, 64]
+    static BITSET_WORD_TYPE lowMask(unsigned numBits)
+    {
+        return numBits >= NUM_BITS_PER_WORD ? ~(BITSET_WORD_TYPE)0 : wordBit(numBits) - 1;
+    }
+    static unsigned eltShift(unsigned eltIndex)
+    {
+        return (eltIndex % NUM_ELTS_PER_WORD) * NUM_BITS_PER_ELT;
+    }
+
     void create(unsigned size);
     void copy(const BitSet &other)
     {
-        unsigned sizeInBytes = (other.m_Size + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
+        unsigned sizeInBytes = numWords(other.m_Size) * sizeof(BITSET_WORD_TYPE);
         if (this != &other)
         {
-            if (m_Size == other.m_Size)
+            if (numWords(m_Size) != numWords(other.m_Size))
             {
-                memcpy_s(m_BitSetArray, sizeInBytes, other.m_BitSetArray, sizeInBytes);
+                create(other.m_Size);
             }
-            else
+            m_Size = other.m_Size;
+            if (sizeInBytes)
             {
-                create(other.m_Size);
                 memcpy_s(m_BitSetArray, sizeInBytes, other.m_BitSetArray, sizeInBytes);
             }
         }
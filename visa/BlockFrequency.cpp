@@ -0,0 +1,314 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "BlockFrequency.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vISA;
+
+bool BlockFrequency::inLoop(unsigned header, const G4_BB* bb) const
+{
+    for (auto& loop : loops)
+    {
+        if (loop.first == header)
+        {
+            return loop.second[bb->getId()];
+        }
+    }
+    return false;
+}
+
+float BlockFrequency::edgeProb(G4_BB* from, G4_BB* to) const
+{
+    // a subroutine call always reaches the callee
+    if (from->getBBType() & G4_BB_CALL_TYPE)
+    {
+        return 1.0f;
+    }
+
+    unsigned numSuccs = (unsigned)from->Succs.size();
+    int header = innerLoop[from->getId()];
+    if (header < 0 || numSuccs < 2)
+    {
+        return 1.0f / numSuccs;
+    }
+
+    // Leaving the innermost loop is taken once every tripCount iterations.
+    unsigned numExits = 0;
+    for (auto succ : from->Succs)
+    {
+        if (!inLoop(header, succ))
+        {
+            numExits++;
+        }
+    }
+    if (numExits == 0 || numExits == numSuccs)
+    {
+        return 1.0f / numSuccs;
+    }
+    float exitProb = 1.0f / tripCount;
+    if (!inLoop(header, to))
+    {
+        return exitProb / numExits;
+    }
+    return (1.0f - exitProb) / (numSuccs - numExits);
+}
+
+// Collect the natural loop of every back edge, merging loops that share a
+// header. Subroutine bodies are skipped the same way findNaturalLoops() does.
+// Returns false if the CFG is irreducible.
+bool BlockFrequency::findLoops()
+{
+    unsigned numBB = (unsigned)rpoIndex.size();
+    G4_BB* entryBB = fg.getEntryBB();
+    for (auto bb : rpo)
+    {
+        for (auto succ : bb->Succs)
+        {
+            if (!isBackEdge(bb, succ))
+            {
+                continue;
+            }
+
+            G4_BB* header = succ;
+            auto loopIt = std::find_if(loops.begin(), loops.end(),
+                [header](const std::pair<unsigned, std::vector<bool>>& loop)
+                { return loop.first == header->getId(); });
+            if (loopIt == loops.end())
+            {
+                loops.emplace_back(header->getId(), std::vector<bool>(numBB, false));
+                loopIt = loops.end() - 1;
+            }
+            auto& body = loopIt->second;
+            body[header->getId()] = true;
+
+            std::vector<G4_BB*> worklist;
+            if (!body[bb->getId()])
+            {
+                body[bb->getId()] = true;
+                worklist.push_back(bb);
+            }
+            while (!worklist.empty())
+            {
+                G4_BB* loopBB = worklist.back();
+                worklist.pop_back();
+                if (loopBB->getBBType() & G4_BB_INIT_TYPE)
+                {
+                    continue;
+                }
+                if (loopBB == entryBB)
+                {
+                    return false;
+                }
+                auto visit = [&](G4_BB* pred)
+                {
+                    if (rpoIndex[pred->getId()] >= 0 && !body[pred->getId()])
+                    {
+                        body[pred->getId()] = true;
+                        worklist.push_back(pred);
+                    }
+                };
+                if (loopBB->getBBType() & G4_BB_RETURN_TYPE)
+                {
+                    visit(loopBB->BBBeforeCall());
+                }
+                else
+                {
+                    for (auto pred : loopBB->Preds)
+                    {
+                        visit(pred);
+                    }
+                }
+            }
+        }
+    }
+
+    // a nested loop's body is a strict subset of its parent's
+    std::vector<size_t> sizes;
+    for (auto& loop : loops)
+    {
+        sizes.push_back(std::count(loop.second.begin(), loop.second.end(), true));
+    }
+    std::vector<size_t> order(loops.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [&sizes](size_t a, size_t b) { return sizes[a] < sizes[b]; });
+    decltype(loops) sorted;
+    for (auto i : order)
+    {
+        sorted.push_back(std::move(loops[i]));
+    }
+    loops.swap(sorted);
+
+    for (auto& loop : loops)
+    {
+        for (unsigned id = 0; id < numBB; ++id)
+        {
+            if (loop.second[id] && innerLoop[id] < 0)
+            {
+                innerLoop[id] = loop.first;
+            }
+        }
+    }
+    return true;
+}
+
+// Propagate frequencies forward along non-back edges, either through a loop
+// body starting from its header or through the whole CFG from the entry.
+void BlockFrequency::propagate(const std::vector<bool>* body, std::vector<float>& bbFreq) const
+{
+    G4_BB* seed = body ? nullptr : fg.getEntryBB();
+    for (auto bb : rpo)
+    {
+        if (body && !(*body)[bb->getId()])
+        {
+            continue;
+        }
+        if (!seed)
+        {
+            seed = bb;
+        }
+
+        float f = 0.0f;
+        if (bb == seed)
+        {
+            f = 1.0f;
+        }
+        else if (bb->getBBType() & G4_BB_RETURN_TYPE)
+        {
+            f = bbFreq[bb->BBBeforeCall()->getId()];
+        }
+        else
+        {
+            for (auto pred : bb->Preds)
+            {
+                if (rpoIndex[pred->getId()] < 0 || isBackEdge(pred, bb) ||
+                    (body && !(*body)[pred->getId()]))
+                {
+                    continue;
+                }
+                f += bbFreq[pred->getId()] * edgeProb(pred, bb);
+            }
+            f *= loopScale[bb->getId()];
+        }
+        bbFreq[bb->getId()] = f;
+    }
+}
+
+void BlockFrequency::run()
+{
+    unsigned numBB = 0;
+    for (auto bb : fg)
+    {
+        numBB = std::max(numBB, bb->getId() + 1);
+    }
+    rpoIndex.assign(numBB, -1);
+    innerLoop.assign(numBB, -1);
+    loopScale.assign(numBB, 1.0f);
+    freq.assign(numBB, 1.0f);
+
+    std::vector<G4_BB*> postOrder;
+    std::vector<std::pair<G4_BB*, BB_LIST_ITER>> stack;
+    std::vector<bool> visited(numBB, false);
+    G4_BB* entryBB = fg.getEntryBB();
+    visited[entryBB->getId()] = true;
+    stack.push_back({ entryBB, entryBB->Succs.begin() });
+    while (!stack.empty())
+    {
+        auto& top = stack.back();
+        if (top.second == top.first->Succs.end())
+        {
+            postOrder.push_back(top.first);
+            stack.pop_back();
+            continue;
+        }
+        G4_BB* succ = *top.second++;
+        if (!visited[succ->getId()])
+        {
+            visited[succ->getId()] = true;
+            stack.push_back({ succ, succ->Succs.begin() });
+        }
+    }
+    rpo.assign(postOrder.rbegin(), postOrder.rend());
+    for (int i = 0, e = (int)rpo.size(); i < e; ++i)
+    {
+        rpoIndex[rpo[i]->getId()] = i;
+    }
+
+    if (!findLoops())
+    {
+        loops.clear();
+        innerLoop.assign(numBB, -1);
+    }
+
+    // Innermost loops first, so that a nested header already carries its
+    // scale when the enclosing loop is propagated.
+    std::vector<float> localFreq(numBB, 0.0f);
+    for (auto& loop : loops)
+    {
+        G4_BB* header = rpo[rpoIndex[loop.first]];
+        propagate(&loop.second, localFreq);
+
+        float cyclicProb = 0.0f;
+        for (auto pred : header->Preds)
+        {
+            if (rpoIndex[pred->getId()] >= 0 && loop.second[pred->getId()] &&
+                isBackEdge(pred, header))
+            {
+                cyclicProb += localFreq[pred->getId()] * edgeProb(pred, header);
+            }
+        }
+        cyclicProb = std::min(cyclicProb, 1.0f - 1.0f / tripCount);
+        loopScale[loop.first] = 1.0f / (1.0f - cyclicProb);
+    }
+
+    propagate(nullptr, freq);
+
+    // Like GlobalRA::getRefCount(), stop scaling past 8 nested loops.
+    float maxFreq = (float)std::pow(tripCount, 8);
+    for (unsigned id = 0; id < numBB; ++id)
+    {
+        freq[id] = visited[id] ? std::min(freq[id], maxFreq) : 1.0f;
+    }
+}
+
+void BlockFrequency::dump(std::ostream& os) const
+{
+    for (auto bb : fg)
+    {
+        os << "BB" << bb->getId() << ": freq = " << getFreq(bb);
+        if (bb->getId() < innerLoop.size() && innerLoop[bb->getId()] >= 0)
+        {
+            os << ", loop header = BB" << innerLoop[bb->getId()];
+        }
+        os << "\n";
+    }
+}
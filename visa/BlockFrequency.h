@@ -0,0 +1,83 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#ifndef __BLOCKFREQUENCY_H__
+#define __BLOCKFREQUENCY_H__
+
+#include "FlowGraph.h"
+
+#include <ostream>
+#include <vector>
+
+namespace vISA
+{
+    // Static estimate of how often each BB executes relative to the kernel
+    // entry, in the spirit of Wu & Larus: loop back edges are assumed taken
+    // so that a natural loop runs loopTripCount times, other branches are
+    // split evenly, and a loop header's frequency is its inflow scaled by
+    // the loop's cyclic probability.
+    class BlockFrequency
+    {
+    public:
+        BlockFrequency(FlowGraph& fg, unsigned loopTripCount) :
+            fg(fg), tripCount(loopTripCount) {}
+
+        void run();
+
+        float getFreq(const G4_BB* bb) const
+        {
+            return bb->getId() < freq.size() ? freq[bb->getId()] : 1.0f;
+        }
+
+        void dump(std::ostream& os) const;
+
+    private:
+        FlowGraph& fg;
+        const unsigned tripCount;
+
+        std::vector<G4_BB*> rpo;
+        std::vector<int> rpoIndex;
+        // innermost loop containing a BB, as the header's BB id; -1 if none
+        std::vector<int> innerLoop;
+        // loop header id -> BB ids in its body, innermost loops first
+        std::vector<std::pair<unsigned, std::vector<bool>>> loops;
+        // loop header id -> 1 / (1 - cyclic probability)
+        std::vector<float> loopScale;
+        std::vector<float> freq;
+
+        bool isBackEdge(const G4_BB* from, const G4_BB* to) const
+        {
+            return rpoIndex[to->getId()] >= 0 &&
+                rpoIndex[to->getId()] <= rpoIndex[from->getId()];
+        }
+        bool inLoop(unsigned header, const G4_BB* bb) const;
+        float edgeProb(G4_BB* from, G4_BB* to) const;
+        bool findLoops();
+        void propagate(const std::vector<bool>* body, std::vector<float>& bbFreq) const;
+    };
+}
+
+#endif // __BLOCKFREQUENCY_H__
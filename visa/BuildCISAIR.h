@@ -855,9 +855,16 @@ private:
 
     void emitFCPatchFile();
 
+    bool canCompileConcurrently() const;
+    int compileKernelsConcurrently(unsigned numThreads);
+
     const WA_TABLE *m_pWaTable;
     bool needsToFreeWATable = false;
 
+    // The platform is thread-local; Compile() may run on another thread than
+    // the one that created the builder (e.g. IGC's vISA compile pool).
+    TARGET_PLATFORM m_platform = GENX_NONE;
+
     void* gtpin_init = nullptr;
 
     // important messages that we should relay to the user
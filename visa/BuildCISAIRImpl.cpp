@@ -45,11 +45,15 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "IsaVerification.h"
 #include "IGC/common/StringMacros.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <list>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace vISA;
 extern "C" int64_t getTimerTicks(unsigned int idx);
@@ -254,6 +258,7 @@ int CISA_IR_Builder::CreateBuilder(
     SetVisaPlatform(platform);
 
     builder = new CISA_IR_Builder(buildOption, mode, COMMON_ISA_MAJOR_VER, COMMON_ISA_MINOR_VER, pWaTable);
+    builder->m_platform = platform;
 
     if (!builder->m_options.parseOptions(numArgs, flags))
     {
@@ -678,6 +683,8 @@ int CISA_IR_Builder::ParseVISAText(const std::string& visaFile)
 int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_visa_only)
 {
     stopTimer(TimerID::BUILDER);   // TIMER_BUILDER is started when builder is created
+    // the platform is per thread
+    SetVisaPlatform(m_platform);
     int status = VISA_SUCCESS;
 
     std::string name = std::string(nameInput);
@@ -749,7 +756,16 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
     }
 
     VISAKernelImpl* oldMainKernel = nullptr;
-    if (IS_GEN_BOTH_PATH)
+    if (IS_GEN_BOTH_PATH && canCompileConcurrently())
+    {
+        status = compileKernelsConcurrently(m_options.getuInt32Option(vISA_NumCompileThreads));
+        if (status != VISA_SUCCESS)
+        {
+            stopTimer(TimerID::TOTAL);
+            return status;
+        }
+    }
+    else if (IS_GEN_BOTH_PATH)
     {
         Mem_Manager mem(4096);
         common_isa_header pseudoHeader;
@@ -1027,6 +1043,91 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
     return status;
 }
 
+// The concurrent path is only taken for builders holding independent
+// kernels: functions would have to be stitched into their callers and
+// code patching relies on the kernels being compiled in order.
+bool CISA_IR_Builder::canCompileConcurrently() const
+{
+    return m_options.getuInt32Option(vISA_NumCompileThreads) > 1 &&
+        m_kernel_count > 1 && m_function_count == 0 &&
+        !m_options.getuInt32Option(vISA_CodePatch);
+}
+
+// Run the whole Gen back end (flow graph, optimizer, RA, scheduling and
+// encoding) for each kernel on up to numThreads threads, the calling
+// thread included. Every kernel has its own memory managers and a private
+// copy of the options; results, status and critical messages are collected
+// per kernel and reported in kernel order, so the output does not depend
+// on how the kernels were scheduled.
+int CISA_IR_Builder::compileKernelsConcurrently(unsigned numThreads)
+{
+    std::vector<VISAKernelImpl*> kernels(
+        m_kernelsAndFunctions.begin(), m_kernelsAndFunctions.end());
+    for (auto kernel : kernels)
+    {
+        kernel->finalizeAttributes();
+        kernel->getIRBuilder()->setType(kernel->getType());
+        kernel->prepareForConcurrentCompile();
+    }
+
+    std::vector<int> kernelStatus(kernels.size(), VISA_SUCCESS);
+    std::atomic<size_t> nextKernel(0);
+    TARGET_PLATFORM platform = getGenxPlatform();
+    auto compileKernels = [&]()
+    {
+        // the platform is per thread
+        SetVisaPlatform(platform);
+        for (size_t i = nextKernel++; i < kernels.size(); i = nextKernel++)
+        {
+            VISAKernelImpl* kernel = kernels[i];
+            kernelStatus[i] = kernel->compileFastPath();
+            if (kernelStatus[i] != VISA_SUCCESS)
+            {
+                continue;
+            }
+
+            // no functions to append, but indirect fcalls still become calls
+            std::map<std::string, G4_Kernel*> noSubFunctions;
+            std::map<G4_BB*, G4_INST*> origFCallFRet;
+            Stitch_Compiled_Units(kernel->getKernel(), noSubFunctions, origFCallFRet);
+
+            kernel->compilePostOptimize();
+            unsigned int genxBufferSize = 0;
+            void* genxBuffer = kernel->encodeAndEmit(genxBufferSize);
+            kernel->setGenxBinaryBuffer(genxBuffer, genxBufferSize);
+            if (m_options.getOption(vISA_GenerateDebugInfo))
+            {
+                VISAKernelImpl::VISAKernelImplListTy noFunctions;
+                kernel->computeAndEmitDebugInfo(noFunctions);
+            }
+            restoreFCallState(kernel->getKernel(), origFCallFRet);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    numThreads = (unsigned)std::min<size_t>(numThreads, kernels.size());
+    for (unsigned i = 1; i < numThreads; i++)
+    {
+        workers.emplace_back(compileKernels);
+    }
+    compileKernels();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    int status = VISA_SUCCESS;
+    for (size_t i = 0; i < kernels.size(); i++)
+    {
+        criticalMsg << kernels[i]->getCriticalMsg();
+        if (status == VISA_SUCCESS)
+        {
+            status = kernelStatus[i];
+        }
+    }
+    return status;
+}
+
 int CISA_IR_Builder::verifyVISAIR()
 {
 
@@ -3294,6 +3395,10 @@ void CISA_IR_Builder::CISA_post_file_parse()
 // place it here so that internal Gen_IR files don't have to include VISAKernel.h
 std::stringstream& IR_Builder::criticalMsgStream()
 {
+    if (localCriticalMsg)
+    {
+        return *localCriticalMsg;
+    }
     return const_cast<CISA_IR_Builder*>(parentBuilder)->criticalMsgStream();
 }
 
@@ -390,6 +390,10 @@ private:
     const WA_TABLE *m_pWaTable;
     Options *m_options = nullptr;
 
+    // Set when the kernel is compiled on a worker thread; critical messages
+    // are then kept here until the parent builder collects them.
+    std::stringstream *localCriticalMsg = nullptr;
+
     std::map<const G4_INST*, G4_FCALL*> m_fcallInfo;
 
     // Basic region descriptors.
@@ -477,6 +481,7 @@ public:
     std::vector<input_info_t*> m_inputVect;
 
     const Options* getOptions() const { return m_options; }
+    void           setOptions(Options *options) { m_options = options; }
     bool           getOption(vISAOptions opt) const {return m_options->getOption(opt); }
     uint32_t       getuint32Option(vISAOptions opt) const { return m_options->getuInt32Option(opt); }
     void           getOption(vISAOptions opt, const char *&str) const {return m_options->getOption(opt, str); }
@@ -490,6 +495,7 @@ public:
     void dump(std::ostream &os); // not const because G4_INST::emit isn't :(
 
     std::stringstream& criticalMsgStream();
+    void setLocalCriticalMsgStream(std::stringstream *ss) { localCriticalMsg = ss; }
 
     const USE_DEF_ALLOCATOR& getAllocator() const { return useDefAllocator; }
 
@@ -755,7 +755,7 @@ IR_Builder::IR_Builder(
     builtinSamplerHeaderInitialized(false), m_pWaTable(pWaTable), m_options(options), CanonicalRegionStride0(0, 1, 0),
     CanonicalRegionStride1(1, 1, 0), CanonicalRegionStride2(2, 1, 0), CanonicalRegionStride4(4, 1, 0),
     mem(m), phyregpool(m, k.getNumRegTotal()), hashtable(m), rgnpool(m), dclpool(m),
-    instList(alloc), kernel(k), metadataMem(4096)
+    instList(alloc), kernel(k), metadataMem(4096, "Metadata")
 {
     num_temp_dcl = 0;
     kernel.setBuilder(this); // kernel needs pointer to the builder
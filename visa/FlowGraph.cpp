@@ -38,6 +38,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "iga/IGALibrary/api/iga.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdlib>
 #include <fstream>
@@ -339,6 +340,16 @@ G4_BB* FlowGraph::createNewBB(bool insertInFG)
     return bb;
 }
 
+void FlowGraph::destroyTempBB(G4_BB* bb)
+{
+    // Temporary BBs are normally the most recent ones.
+    auto it = std::find(BBAllocList.rbegin(), BBAllocList.rend(), bb);
+    MUST_BE_TRUE(it != BBAllocList.rend(), "BB not created by this flow graph");
+    BBAllocList.erase(std::next(it).base());
+    // the memory itself stays in the pool until the flow graph goes away
+    bb->~G4_BB();
+}
+
 G4_BB* FlowGraph::createNewBBWithLabel(const char* LabelPrefix, int Lineno, int CISAoff)
 {
     G4_BB* newBB = createNewBB(true);
@@ -349,7 +360,8 @@ G4_BB* FlowGraph::createNewBBWithLabel(const char* LabelPrefix, int Lineno, int
     return newBB;
 }
 
-static int globalCount = 1;
+// Kernels may be compiled on several threads at once.
+static std::atomic<int> globalCount(1);
 
 int64_t FlowGraph::insertDummyUUIDMov()
 {
@@ -368,8 +380,7 @@ int64_t FlowGraph::insertDummyUUIDMov()
         for (auto bb : BBs)
         {
             uint32_t seed = (uint32_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
-            std::mt19937 mt_rand(seed * globalCount);
-            globalCount++;
+            std::mt19937 mt_rand(seed * globalCount++);
 
             G4_DstRegRegion* nullDst = builder->createNullDst(Type_UD);
             int64_t uuID = (int64_t)mt_rand();
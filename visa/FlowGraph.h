@@ -490,6 +490,8 @@ public:
     G4_INST* createNewLabelInst(G4_Label* label, int lineNo = 0, int CISAOff = -1);
 
     G4_BB* createNewBB(bool insertInFG = true);
+    // Destroys a BB from createNewBB(false) that was never added to the CFG.
+    void destroyTempBB(G4_BB* bb);
     G4_BB* createNewBBWithLabel(const char* LabelPrefix, int Lineno = 0, int CISAoff = -1);
     int64_t insertDummyUUIDMov();
     //
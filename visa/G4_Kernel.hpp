@@ -223,6 +223,7 @@ public:
     uint64_t getKernelID() const { return kernelID; }
 
     Options *getOptions() { return m_options; }
+    void setOptions(Options *options) { m_options = options; }
     const Attributes* getKernelAttrs() const { return m_kernelAttrs; }
     bool getBoolKernelAttr(Attributes::ID aID) const {
         return getKernelAttrs()->getBoolKernelAttr(aID);
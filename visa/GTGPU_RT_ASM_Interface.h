@@ -31,3 +31,4 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // in GTGPU runtime
 //
 extern "C" void* allocCodeBlock(size_t sz);
+extern "C" void freeBlock(void* ptr);
@@ -0,0 +1,612 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "GVN.h"
+#include "GraphColor.h"
+#include "RPE.h"
+
+#include <algorithm>
+
+using namespace vISA;
+
+// Opcodes whose result is a pure function of their sources, modifiers and
+// predicate.
+static bool isGVNOpcode(G4_INST* inst)
+{
+    switch (inst->opcode())
+    {
+    case G4_mov:
+    case G4_add:
+    case G4_mul:
+    case G4_mad:
+    case G4_shl:
+    case G4_shr:
+    case G4_asr:
+    case G4_and:
+    case G4_or:
+    case G4_xor:
+    case G4_not:
+    case G4_bfrev:
+    case G4_cbit:
+    case G4_fbl:
+    case G4_fbh:
+    case G4_lzd:
+    case G4_frc:
+    case G4_rndu:
+    case G4_rndd:
+    case G4_rnde:
+    case G4_rndz:
+    case G4_avg:
+    case G4_ror:
+    case G4_rol:
+        return true;
+    case G4_sel:
+        // sel without a predicate is min/max and needs a cond mod
+        return inst->getPredicate() != nullptr;
+    case G4_math:
+        return !inst->asMathInst()->isIEEEMath() &&
+            !inst->asMathInst()->isMathIntDiv();
+    default:
+        return false;
+    }
+}
+
+static bool isSIMDCFOpcode(G4_opcode op)
+{
+    switch (op)
+    {
+    case G4_goto:
+    case G4_join:
+    case G4_if:
+    case G4_else:
+    case G4_endif:
+    case G4_while:
+    case G4_break:
+    case G4_cont:
+    case G4_halt:
+        return true;
+    default:
+        return false;
+    }
+}
+
+unsigned GVN::computeMaxRP(G4_Kernel& kernel)
+{
+    PointsToAnalysis p2a(kernel.Declares, kernel.fg.getNumBB());
+    p2a.doPointsToAnalysis(kernel.fg);
+    GlobalRA gra(kernel, kernel.fg.builder->phyregpool, p2a);
+    gra.markGraphBlockLocalVars();
+    LivenessAnalysis liveness(gra, G4_GRF | G4_ADDRESS | G4_INPUT | G4_FLAG);
+    liveness.computeLiveness();
+    RPE rpe(gra, &liveness);
+    rpe.run();
+    return rpe.getMaxRP();
+}
+
+void GVN::collectDclInfo()
+{
+    for (auto dcl : kernel.Declares)
+    {
+        auto& info = dclInfo[dcl->getRootDeclare()];
+        if (dcl->getAliasDeclare())
+        {
+            info.aliased = true;
+        }
+        if (dcl->getAddressed())
+        {
+            info.addrTaken = true;
+        }
+    }
+
+    struct Kill
+    {
+        const G4_Declare* dcl;
+        G4_BB* bb;
+        int localId;
+    };
+    std::vector<Kill> kills;
+
+    for (auto bb : fg)
+    {
+        bb->resetLocalId();
+        for (auto inst : *bb)
+        {
+            if (isSIMDCFOpcode(inst->opcode()))
+            {
+                divergenceUnknown = !kernel.getOption(vISA_divergentBB);
+            }
+
+            if (inst->isPseudoKill())
+            {
+                if (auto dcl = inst->getDst()->getTopDcl())
+                {
+                    kills.push_back({ dcl, bb, inst->getLocalId() });
+                }
+                continue;
+            }
+
+            if (inst->isLifeTimeEnd())
+            {
+                auto src = inst->getSrc(0);
+                if (src && src->getTopDcl())
+                {
+                    dclInfo[src->getTopDcl()].hasLifetimeEnd = true;
+                }
+                continue;
+            }
+
+            auto addDef = [&](G4_Operand* opnd)
+            {
+                if (!opnd || !opnd->getTopDcl())
+                {
+                    return;
+                }
+                auto& info = dclInfo[opnd->getTopDcl()];
+                info.numDefs++;
+                info.defInst = inst;
+                info.defBB = bb;
+            };
+            if (inst->getDst() && !inst->getDst()->isNullReg())
+            {
+                addDef(inst->getDst());
+            }
+            addDef(inst->getCondMod());
+
+            for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; ++i)
+            {
+                auto src = inst->getSrc(i);
+                if (src && src->isAddrExp())
+                {
+                    auto dcl = src->asAddrExp()->getRegVar()->getDeclare();
+                    dclInfo[dcl->getRootDeclare()].addrTaken = true;
+                }
+            }
+        }
+    }
+
+    for (auto& kill : kills)
+    {
+        auto& info = dclInfo[kill.dcl];
+        if (info.defBB != kill.bb ||
+            kill.localId > info.defInst->getLocalId())
+        {
+            info.badKill = true;
+        }
+    }
+}
+
+// Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm".
+void GVN::computeDominators()
+{
+    rpoIndex.assign(fg.getNumBB(), -1);
+
+    // iterative post-order DFS from the entry
+    std::vector<G4_BB*> postOrder;
+    std::vector<std::pair<G4_BB*, BB_LIST_ITER>> stack;
+    std::vector<bool> visited(fg.getNumBB(), false);
+    auto entry = fg.getEntryBB();
+    visited[entry->getId()] = true;
+    stack.push_back({ entry, entry->Succs.begin() });
+    while (!stack.empty())
+    {
+        auto& top = stack.back();
+        if (top.second == top.first->Succs.end())
+        {
+            postOrder.push_back(top.first);
+            stack.pop_back();
+            continue;
+        }
+        G4_BB* succ = *top.second++;
+        if (!visited[succ->getId()])
+        {
+            visited[succ->getId()] = true;
+            stack.push_back({ succ, succ->Succs.begin() });
+        }
+    }
+
+    rpo.assign(postOrder.rbegin(), postOrder.rend());
+    for (int i = 0, e = (int)rpo.size(); i < e; ++i)
+    {
+        rpoIndex[rpo[i]->getId()] = i;
+    }
+
+    idom.assign(rpo.size(), -1);
+    idom[0] = 0;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int i = 1, e = (int)rpo.size(); i < e; ++i)
+        {
+            int newIdom = -1;
+            for (auto pred : rpo[i]->Preds)
+            {
+                int p = rpoIndex[pred->getId()];
+                if (p < 0 || idom[p] < 0)
+                {
+                    continue;
+                }
+                if (newIdom < 0)
+                {
+                    newIdom = p;
+                    continue;
+                }
+                int a = p, b = newIdom;
+                while (a != b)
+                {
+                    while (a > b) a = idom[a];
+                    while (b > a) b = idom[b];
+                }
+                newIdom = a;
+            }
+            if (newIdom != idom[i])
+            {
+                idom[i] = newIdom;
+                changed = true;
+            }
+        }
+    }
+
+    domChildren.assign(rpo.size(), {});
+    for (int i = 1, e = (int)rpo.size(); i < e; ++i)
+    {
+        domChildren[idom[i]].push_back(i);
+    }
+
+    // pre/post numbering of the dominator tree for O(1) dominance queries
+    domPre.assign(rpo.size(), 0);
+    domPost.assign(rpo.size(), 0);
+    unsigned counter = 0;
+    std::vector<std::pair<int, size_t>> work;
+    work.push_back({ 0, 0 });
+    domPre[0] = counter++;
+    while (!work.empty())
+    {
+        auto& top = work.back();
+        if (top.second == domChildren[top.first].size())
+        {
+            domPost[top.first] = counter++;
+            work.pop_back();
+            continue;
+        }
+        int child = domChildren[top.first][top.second++];
+        domPre[child] = counter++;
+        work.push_back({ child, 0 });
+    }
+}
+
+bool GVN::dominates(G4_BB* a, G4_BB* b) const
+{
+    int ia = rpoIndex[a->getId()], ib = rpoIndex[b->getId()];
+    if (ia < 0 || ib < 0)
+    {
+        return false;
+    }
+    return domPre[ia] <= domPre[ib] && domPost[ib] <= domPost[ia];
+}
+
+// A variable read by inst holds the same value at every dominated point if it
+// is never written, or written exactly once at a point dominating inst.
+bool GVN::isStable(const G4_Declare* dcl, G4_INST* inst, G4_BB* bb) const
+{
+    auto it = dclInfo.find(dcl);
+    if (it == dclInfo.end())
+    {
+        return true;
+    }
+    auto& info = it->second;
+    if (info.addrTaken || info.numDefs > 1)
+    {
+        return false;
+    }
+    if (info.numDefs == 0)
+    {
+        return true;
+    }
+    if (info.defBB == bb)
+    {
+        return info.defInst->getLocalId() < inst->getLocalId();
+    }
+    return dominates(info.defBB, bb);
+}
+
+G4_Declare* GVN::canonical(G4_Declare* dcl) const
+{
+    auto it = replacement.find(dcl);
+    return it == replacement.end() ? dcl : it->second;
+}
+
+bool GVN::isCandidate(G4_INST* inst, G4_BB* bb) const
+{
+    // Other than for sel, a predicate makes the dst a partial definition.
+    if (!isGVNOpcode(inst) || inst->getCondMod() ||
+        (inst->getPredicate() && inst->opcode() != G4_sel) ||
+        inst->getImplAccSrc() || inst->getImplAccDst() ||
+        inst->isAtomicInst() || inst->isNoDDChkInst() || inst->isNoDDClrInst())
+    {
+        return false;
+    }
+
+    auto dst = inst->getDst();
+    if (!dst || dst->isNullReg() || dst->getRegAccess() != Direct ||
+        !dst->getBase()->isRegVar() || dst->isAccRegValid())
+    {
+        return false;
+    }
+    auto regVar = dst->getBase()->asRegVar();
+    auto dcl = regVar->getDeclare();
+    if (regVar->isPhyRegAssigned() || dcl->getAliasDeclare() ||
+        dcl->getRegFile() != G4_GRF || dcl->isInput() || dcl->isOutput() ||
+        dcl->getIsSplittedDcl() || dcl->getIsPartialDcl())
+    {
+        return false;
+    }
+
+    // dst must be the full and only definition of its variable
+    unsigned execSize = inst->getExecSize();
+    if (dst->getRegOff() != 0 || dst->getSubRegOff() != 0 ||
+        (execSize > 1 && dst->getHorzStride() != 1) ||
+        execSize * TypeSize(dst->getType()) != dcl->getByteSize())
+    {
+        return false;
+    }
+    auto it = dclInfo.find(dcl);
+    if (it == dclInfo.end() || it->second.numDefs != 1 ||
+        it->second.addrTaken || it->second.aliased)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool GVN::buildKey(G4_INST* inst, G4_BB* bb, ExprKey& key) const
+{
+    key.fill(0);
+
+    uint64_t mathCtrl = inst->isMath() ? inst->asMathInst()->getMathCtrl() : 0;
+    key[0] = (uint64_t)inst->opcode() |
+        ((uint64_t)inst->getExecSize() << 16) |
+        ((uint64_t)inst->getDst()->getType() << 24) |
+        ((uint64_t)inst->getSaturate() << 32) |
+        (mathCtrl << 40);
+    key[1] = inst->getOption();
+
+    if (auto pred = inst->getPredicate())
+    {
+        auto flag = pred->getTopDcl();
+        if (!flag || !isStable(flag, inst, bb))
+        {
+            return false;
+        }
+        key[2] = ((uint64_t)canonical(flag)->getDeclId() + 1) |
+            ((uint64_t)pred->getControl() << 32) |
+            ((uint64_t)pred->getState() << 40) |
+            ((uint64_t)pred->getSubRegOff() << 48);
+    }
+
+    int numSrc = inst->getNumSrc();
+    if (numSrc > 3)
+    {
+        return false;
+    }
+    for (int i = 0; i < numSrc; ++i)
+    {
+        auto src = inst->getSrc(i);
+        uint64_t* slot = &key[3 + 3 * i];
+        if (!src)
+        {
+            continue;
+        }
+        if (src->isImm())
+        {
+            slot[0] = 1 | ((uint64_t)src->getType() << 8);
+            slot[1] = (uint64_t)src->asImm()->getImm();
+            continue;
+        }
+        if (!src->isSrcRegRegion())
+        {
+            return false;
+        }
+        auto rgn = src->asSrcRegRegion();
+        auto dcl = rgn->getTopDcl();
+        if (rgn->getRegAccess() != Direct || !dcl || rgn->isAccRegValid() ||
+            !(dcl->getRegFile() & (G4_GRF | G4_INPUT)) ||
+            !isStable(dcl, inst, bb))
+        {
+            return false;
+        }
+        auto region = rgn->getRegion();
+        slot[0] = 2 | ((uint64_t)rgn->getModifier() << 8) |
+            ((uint64_t)rgn->getType() << 16) |
+            ((uint64_t)region->vertStride << 32) |
+            ((uint64_t)region->width << 40) |
+            ((uint64_t)region->horzStride << 48);
+        slot[1] = canonical(const_cast<G4_Declare*>(dcl))->getDeclId();
+        slot[2] = rgn->getLeftBound();
+    }
+
+    if (numSrc == 2 && INST_COMMUTATIVE(inst->opcode()) &&
+        std::lexicographical_compare(key.begin() + 6, key.begin() + 9,
+            key.begin() + 3, key.begin() + 6))
+    {
+        std::swap_ranges(key.begin() + 3, key.begin() + 6, key.begin() + 6);
+    }
+    return true;
+}
+
+bool GVN::canLead(G4_INST* inst, G4_BB* leaderBB, G4_BB* useBB) const
+{
+    auto& info = dclInfo.at(inst->getDst()->getTopDcl());
+    if (info.hasLifetimeEnd || info.badKill)
+    {
+        return false;
+    }
+    if (leaderBB == useBB || inst->isWriteEnableInst())
+    {
+        return true;
+    }
+    // Under SIMD control flow a dominating block may have run with fewer
+    // channels enabled than the block reusing its result.
+    return !divergenceUnknown && !leaderBB->isDivergent();
+}
+
+void GVN::walk(int root)
+{
+    struct Scope
+    {
+        int node;
+        size_t nextChild;
+        size_t logStart;
+    };
+    std::vector<ExprKey> log;
+    std::vector<Scope> scopes;
+
+    auto enter = [&](int node)
+    {
+        scopes.push_back({ node, 0, log.size() });
+        G4_BB* bb = rpo[node];
+        for (auto inst : *bb)
+        {
+            ExprKey key;
+            if (!isCandidate(inst, bb) || !buildKey(inst, bb, key))
+            {
+                continue;
+            }
+            auto it = table.find(key);
+            if (it == table.end())
+            {
+                table.emplace(key, Leader{ inst, bb });
+                log.push_back(key);
+            }
+            else if (canLead(it->second.inst, it->second.bb, bb))
+            {
+                auto leaderDcl = it->second.inst->getDst()->getTopDcl();
+                replacement[inst->getDst()->getTopDcl()] = leaderDcl;
+                redundant[inst] = it->second.inst;
+            }
+        }
+    };
+
+    enter(root);
+    while (!scopes.empty())
+    {
+        auto& top = scopes.back();
+        if (top.nextChild == domChildren[top.node].size())
+        {
+            for (size_t i = top.logStart, e = log.size(); i < e; ++i)
+            {
+                table.erase(log[i]);
+            }
+            log.resize(top.logStart);
+            scopes.pop_back();
+            continue;
+        }
+        enter(domChildren[top.node][top.nextChild++]);
+    }
+}
+
+void GVN::applyReplacements()
+{
+    auto builder = fg.builder;
+    for (auto& entry : replacement)
+    {
+        auto from = entry.first, to = entry.second;
+        if (!to->isEvenAlign() && from->isEvenAlign())
+        {
+            to->setEvenAlign();
+        }
+        to->setSubRegAlign(std::max(to->getSubRegAlign(), from->getSubRegAlign()));
+        if (from->isDoNotSpill())
+        {
+            to->setDoNotSpill();
+        }
+        to->setIsRefInSendDcl(from->getIsRefInSendDcl());
+    }
+
+    auto isReplaced = [&](G4_Operand* opnd)
+    {
+        return opnd && opnd->getTopDcl() &&
+            replacement.count(const_cast<G4_Declare*>(opnd->getTopDcl()));
+    };
+
+    for (auto bb : fg)
+    {
+        for (auto it = bb->begin(); it != bb->end();)
+        {
+            G4_INST* inst = *it;
+
+            auto redundantIt = redundant.find(inst);
+            if (redundantIt != redundant.end())
+            {
+                inst->transferUse(redundantIt->second, true);
+                inst->removeAllDefs();
+                it = bb->erase(it);
+                numInstsRemoved++;
+                continue;
+            }
+
+            if ((inst->isPseudoKill() && isReplaced(inst->getDst())) ||
+                ((inst->isLifeTimeEnd() || inst->isPseudoUse()) &&
+                    isReplaced(inst->getSrc(0))))
+            {
+                inst->removeAllDefs();
+                it = bb->erase(it);
+                continue;
+            }
+
+            for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; ++i)
+            {
+                auto src = inst->getSrc(i);
+                if (!src || !src->isSrcRegRegion() || !isReplaced(src))
+                {
+                    continue;
+                }
+                auto rgn = src->asSrcRegRegion();
+                auto to = replacement[const_cast<G4_Declare*>(rgn->getTopDcl())];
+                auto newSrc = builder->createSrcRegRegion(rgn->getModifier(),
+                    Direct, to->getRegVar(), rgn->getRegOff(), rgn->getSubRegOff(),
+                    rgn->getRegion(), rgn->getType(), rgn->getAccRegSel());
+                inst->setSrc(newSrc, i);
+            }
+            ++it;
+        }
+    }
+}
+
+void GVN::doGVN()
+{
+    // Subroutines and stack calls would need interprocedural def info.
+    if (fg.getNumFuncs() > 0 || fg.getHasStackCalls() || fg.getIsStackCallFunc())
+    {
+        return;
+    }
+
+    collectDclInfo();
+    computeDominators();
+    walk(0);
+    applyReplacements();
+}
@@ -0,0 +1,130 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#ifndef _G4_GVN_H_
+#define _G4_GVN_H_
+
+#include "Gen4_IR.hpp"
+#include "FlowGraph.h"
+#include "G4_Kernel.hpp"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+// Dominator-scoped global value numbering over G4 IR.
+//
+// G4 IR is not in SSA form, so the pass only numbers instructions whose dst
+// is the sole, full definition of a virtual variable, and whose sources are
+// either immediates or variables that are not redefined on any path between
+// their own (dominating) definition and the use. Such an instruction computes
+// the same value wherever it is dominated by an identical instruction, so its
+// dst can be renamed to the dominating one and the instruction removed.
+//
+// Expressions are hash-consed: operands are keyed on the canonical
+// (post-replacement) declare, so a chain of redundant computations collapses
+// in a single walk of the dominator tree.
+namespace vISA
+{
+    class GVN
+    {
+    public:
+        GVN(G4_Kernel& k) : kernel(k), fg(k.fg) {}
+
+        void doGVN();
+        unsigned getNumInstsRemoved() const { return numInstsRemoved; }
+
+        // Max GRF pressure of the kernel as estimated by RPE.
+        static unsigned computeMaxRP(G4_Kernel& kernel);
+
+    private:
+        // opcode/modifiers/predicate + up to three sources
+        typedef std::array<uint64_t, 12> ExprKey;
+
+        struct ExprKeyHash
+        {
+            size_t operator()(const ExprKey& key) const
+            {
+                uint64_t h = 0xcbf29ce484222325ULL;
+                for (auto v : key)
+                {
+                    h ^= v;
+                    h *= 0x100000001b3ULL;
+                }
+                return (size_t)h;
+            }
+        };
+
+        struct DclInfo
+        {
+            unsigned numDefs = 0;
+            G4_INST* defInst = nullptr;
+            G4_BB* defBB = nullptr;
+            // pseudo_kill outside the def BB or after the def in it
+            bool badKill = false;
+            bool hasLifetimeEnd = false;
+            bool addrTaken = false;
+            bool aliased = false;
+        };
+
+        struct Leader
+        {
+            G4_INST* inst;
+            G4_BB* bb;
+        };
+
+        G4_Kernel& kernel;
+        FlowGraph& fg;
+        unsigned numInstsRemoved = 0;
+        // kernel has SIMD control flow whose divergence was not marked
+        bool divergenceUnknown = false;
+
+        std::unordered_map<const G4_Declare*, DclInfo> dclInfo;
+        // redundant root declare -> root declare of its leader
+        std::unordered_map<G4_Declare*, G4_Declare*> replacement;
+        // redundant instruction -> its leader
+        std::unordered_map<G4_INST*, G4_INST*> redundant;
+        std::unordered_map<ExprKey, Leader, ExprKeyHash> table;
+
+        // dominator tree
+        std::vector<G4_BB*> rpo;
+        std::vector<int> rpoIndex;
+        std::vector<int> idom;
+        std::vector<std::vector<int>> domChildren;
+        std::vector<unsigned> domPre, domPost;
+
+        void collectDclInfo();
+        void computeDominators();
+        bool dominates(G4_BB* a, G4_BB* b) const;
+        bool isStable(const G4_Declare* dcl, G4_INST* inst, G4_BB* bb) const;
+        G4_Declare* canonical(G4_Declare* dcl) const;
+        bool isCandidate(G4_INST* inst, G4_BB* bb) const;
+        bool buildKey(G4_INST* inst, G4_BB* bb, ExprKey& key) const;
+        bool canLead(G4_INST* inst, G4_BB* leaderBB, G4_BB* useBB) const;
+        void walk(int root);
+        void applyReplacements();
+    };
+}
+#endif // _G4_GVN_H_
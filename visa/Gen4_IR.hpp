@@ -43,6 +43,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <stack>
 #include <optional>
 #include <array>
+#include <iterator>
 
 #include "Mem_Manager.h"
 #include "G4_Opcode.h"
@@ -241,9 +242,318 @@ inline const char* const MathOpNames[16] =
 
 typedef vISA::std_arena_based_allocator<vISA::G4_INST*> INST_LIST_NODE_ALLOCATOR;
 
-typedef std::list<vISA::G4_INST*, INST_LIST_NODE_ALLOCATOR>           INST_LIST;
-typedef std::list<vISA::G4_INST*, INST_LIST_NODE_ALLOCATOR>::iterator INST_LIST_ITER;
-typedef std::list<vISA::G4_INST*, INST_LIST_NODE_ALLOCATOR>::reverse_iterator INST_LIST_RITER;
+namespace vISA
+{
+    // A link of an InstList. Every G4_INST embeds one node, which is used the
+    // first time the instruction is put into a list. Walking a BB therefore
+    // goes from instruction to instruction without a separate node allocation
+    // in between. An instruction that is already linked somewhere else (e.g.
+    // it is also kept in a side list) gets a node from the list's arena
+    // instead, so INST_LIST keeps the value semantics of the std::list it
+    // replaced: the same instruction may be in several lists at once, and
+    // *it may be assigned.
+    struct InstListNode
+    {
+        InstListNode* prev = nullptr;
+        InstListNode* next = nullptr;
+        G4_INST* inst = nullptr;
+
+        InstListNode() {}
+        // A copied instruction starts out unlinked.
+        InstListNode(const InstListNode&) {}
+        InstListNode& operator=(const InstListNode&) { return *this; }
+
+        bool isLinked() const { return prev != nullptr; }
+    };
+
+    // Defined after G4_INST.
+    inline InstListNode* getEmbeddedListNode(G4_INST* inst);
+
+    template <class NodeT, class RefT, class PtrT>
+    class InstListIterator
+    {
+        NodeT* node;
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef G4_INST*                        value_type;
+        typedef std::ptrdiff_t                  difference_type;
+        typedef PtrT                            pointer;
+        typedef RefT                            reference;
+
+        InstListIterator() : node(nullptr) {}
+        explicit InstListIterator(NodeT* n) : node(n) {}
+        // iterator -> const_iterator
+        template <class N, class R, class P>
+        InstListIterator(const InstListIterator<N, R, P>& other) : node(other.getNode()) {}
+
+        NodeT* getNode() const { return node; }
+
+        reference operator*() const { return node->inst; }
+        pointer operator->() const { return &node->inst; }
+
+        InstListIterator& operator++() { node = node->next; return *this; }
+        InstListIterator& operator--() { node = node->prev; return *this; }
+        InstListIterator operator++(int) { InstListIterator tmp(*this); node = node->next; return tmp; }
+        InstListIterator operator--(int) { InstListIterator tmp(*this); node = node->prev; return tmp; }
+    };
+
+    template <class N1, class R1, class P1, class N2, class R2, class P2>
+    bool operator==(const InstListIterator<N1, R1, P1>& a, const InstListIterator<N2, R2, P2>& b)
+    {
+        return a.getNode() == b.getNode();
+    }
+    template <class N1, class R1, class P1, class N2, class R2, class P2>
+    bool operator!=(const InstListIterator<N1, R1, P1>& a, const InstListIterator<N2, R2, P2>& b)
+    {
+        return a.getNode() != b.getNode();
+    }
+
+    // Doubly-linked instruction list with the interface of
+    // std::list<G4_INST*>. See InstListNode for how nodes are provided.
+    class InstList
+    {
+    public:
+        typedef G4_INST*                value_type;
+        typedef G4_INST*&               reference;
+        typedef G4_INST* const&         const_reference;
+        typedef std::size_t             size_type;
+        typedef std::ptrdiff_t          difference_type;
+        typedef INST_LIST_NODE_ALLOCATOR allocator_type;
+
+        typedef InstListIterator<InstListNode, G4_INST*&, G4_INST**> iterator;
+        typedef InstListIterator<const InstListNode, G4_INST* const&, G4_INST* const*> const_iterator;
+        typedef std::reverse_iterator<iterator>       reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    private:
+        InstListNode head;      // sentinel; head.next is the first node
+        size_type count = 0;
+        std_arena_based_allocator<InstListNode> nodeAlloc;
+
+        void initHead() { head.prev = head.next = &head; }
+
+        static InstListNode* getNode(const_iterator it) { return const_cast<InstListNode*>(it.getNode()); }
+
+        InstListNode* createNode(G4_INST* inst)
+        {
+            InstListNode* node = getEmbeddedListNode(inst);
+            if (node->isLinked())
+            {
+                node = new (nodeAlloc.allocate(1)) InstListNode();
+            }
+            node->inst = inst;
+            return node;
+        }
+
+        // link the chain [first, last] before pos
+        static void linkBefore(InstListNode* pos, InstListNode* first, InstListNode* last)
+        {
+            first->prev = pos->prev;
+            last->next = pos;
+            pos->prev->next = first;
+            pos->prev = last;
+        }
+
+        // unlink the chain [first, last] without touching its nodes
+        static void unlinkChain(InstListNode* first, InstListNode* last)
+        {
+            first->prev->next = last->next;
+            last->next->prev = first->prev;
+        }
+
+    public:
+        InstList() { initHead(); }
+        explicit InstList(const allocator_type& alloc) : nodeAlloc(alloc) { initHead(); }
+        InstList(const InstList& other) : nodeAlloc(other.nodeAlloc)
+        {
+            initHead();
+            insert(end(), other.begin(), other.end());
+        }
+        InstList(InstList&& other) : nodeAlloc(other.nodeAlloc)
+        {
+            initHead();
+            splice(end(), other);
+        }
+        ~InstList() { clear(); }
+
+        InstList& operator=(const InstList& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                insert(end(), other.begin(), other.end());
+            }
+            return *this;
+        }
+        InstList& operator=(InstList&& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                splice(end(), other);
+            }
+            return *this;
+        }
+
+        allocator_type get_allocator() const { return allocator_type(nodeAlloc); }
+
+        iterator begin() { return iterator(head.next); }
+        iterator end() { return iterator(&head); }
+        const_iterator begin() const { return const_iterator(head.next); }
+        const_iterator end() const { return const_iterator(&head); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crbegin() const { return rbegin(); }
+        const_reverse_iterator crend() const { return rend(); }
+
+        bool empty() const { return count == 0; }
+        size_type size() const { return count; }
+
+        reference front() { return head.next->inst; }
+        const_reference front() const { return head.next->inst; }
+        reference back() { return head.prev->inst; }
+        const_reference back() const { return head.prev->inst; }
+
+        iterator insert(const_iterator pos, G4_INST* inst)
+        {
+            InstListNode* node = createNode(inst);
+            linkBefore(getNode(pos), node, node);
+            ++count;
+            return iterator(node);
+        }
+
+        template <class InputIt>
+        iterator insert(const_iterator pos, InputIt first, InputIt last)
+        {
+            iterator result(getNode(pos));
+            if (first != last)
+            {
+                result = insert(pos, *first);
+                for (++first; first != last; ++first)
+                {
+                    insert(pos, *first);
+                }
+            }
+            return result;
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            InstListNode* node = getNode(pos);
+            InstListNode* next = node->next;
+            unlinkChain(node, node);
+            node->prev = node->next = nullptr;
+            --count;
+            return iterator(next);
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            while (first != last)
+            {
+                first = erase(first);
+            }
+            return iterator(getNode(last));
+        }
+
+        void push_back(G4_INST* inst) { insert(end(), inst); }
+        void push_front(G4_INST* inst) { insert(begin(), inst); }
+        void pop_back() { erase(iterator(head.prev)); }
+        void pop_front() { erase(begin()); }
+
+        void clear()
+        {
+            for (InstListNode* node = head.next; node != &head;)
+            {
+                InstListNode* next = node->next;
+                node->prev = node->next = nullptr;
+                node = next;
+            }
+            initHead();
+            count = 0;
+        }
+
+        template <class Pred>
+        void remove_if(Pred pred)
+        {
+            for (iterator it = begin(); it != end();)
+            {
+                it = pred(*it) ? erase(it) : std::next(it);
+            }
+        }
+        void remove(G4_INST* inst) { remove_if([inst](G4_INST* i) { return i == inst; }); }
+
+        // splice only relinks nodes, so an instruction keeps its embedded node
+        // when it moves between lists.
+        void splice(const_iterator pos, InstList& other)
+        {
+            if (other.empty() || &other == this)
+            {
+                return;
+            }
+            InstListNode* first = other.head.next;
+            InstListNode* last = other.head.prev;
+            other.initHead();
+            linkBefore(getNode(pos), first, last);
+            count += other.count;
+            other.count = 0;
+        }
+        void splice(const_iterator pos, InstList&& other) { splice(pos, other); }
+
+        void splice(const_iterator pos, InstList& other, const_iterator it)
+        {
+            InstListNode* node = getNode(it);
+            InstListNode* p = getNode(pos);
+            if (node == p || node->next == p)
+            {
+                return;
+            }
+            unlinkChain(node, node);
+            linkBefore(p, node, node);
+            --other.count;
+            ++count;
+        }
+        void splice(const_iterator pos, InstList&& other, const_iterator it) { splice(pos, other, it); }
+
+        void splice(const_iterator pos, InstList& other, const_iterator first, const_iterator last)
+        {
+            if (first == last)
+            {
+                return;
+            }
+            if (&other != this)
+            {
+                size_type n = (size_type)std::distance(first, last);
+                other.count -= n;
+                count += n;
+            }
+            InstListNode* f = getNode(first);
+            InstListNode* l = getNode(last)->prev;
+            unlinkChain(f, l);
+            linkBefore(getNode(pos), f, l);
+        }
+        void splice(const_iterator pos, InstList&& other, const_iterator first, const_iterator last)
+        {
+            splice(pos, other, first, last);
+        }
+
+        void swap(InstList& other)
+        {
+            InstList tmp(std::move(other));
+            other.splice(other.end(), *this);
+            splice(end(), tmp);
+        }
+    };
+} // namespace vISA
+
+typedef vISA::InstList                   INST_LIST;
+typedef INST_LIST::iterator              INST_LIST_ITER;
+typedef INST_LIST::reverse_iterator      INST_LIST_RITER;
 
 typedef std::pair<vISA::G4_INST*, Gen4_Operand_Number> USE_DEF_NODE;
 typedef vISA::std_arena_based_allocator<USE_DEF_NODE> USE_DEF_ALLOCATOR;
@@ -577,6 +887,9 @@ protected:
 
     const IR_Builder& builder;  // link to builder to access the various compilation options
 
+    InstListNode listNode;  // see InstListNode
+    friend InstListNode* getEmbeddedListNode(G4_INST* inst);
+
 public:
     enum SWSBTokenType {
         TOKEN_NONE,
@@ -1263,6 +1576,11 @@ private:
     bool isLegalType(G4_Type type, Gen4_Operand_Number opndNum) const;
     bool isFloatOnly() const;
 };
+
+inline InstListNode* getEmbeddedListNode(G4_INST* inst)
+{
+    return &inst->listNode;
+}
 } // namespace vISA
 
 std::ostream& operator<<(std::ostream& os, vISA::G4_INST& inst);
@@ -30,6 +30,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "GraphColor.h"
 #include "LocalRA.h"
 #include "LinearScanRA.h"
+#include "LocalScheduler/LatencyTable.h"
 #include "Optimizer.h"
 #include "SCCAnalysis.h"
 #include "SpillCleanup.h"
@@ -1366,7 +1367,7 @@ LiveRange::LiveRange(G4_RegVar* v, GlobalRA& g) : var(v), dcl(v->getDeclare()),
     }
 }
 
-void LiveRange::checkForInfiniteSpillCost(G4_BB* bb, std::list<G4_INST*>::reverse_iterator& it)
+void LiveRange::checkForInfiniteSpillCost(G4_BB* bb, INST_LIST_RITER& it)
 {
     // G4_INST at *it defines liverange object (this ptr)
     // If next instruction of iterator uses same liverange then
@@ -1419,7 +1420,7 @@ void LiveRange::checkForInfiniteSpillCost(G4_BB* bb, std::list<G4_INST*>::revers
 
     // isCandidate is set to true only for first definition ever seen.
     // If more than 1 def if found this gets set to false.
-    const std::list<G4_INST*>::reverse_iterator rbegin = bb->rbegin();
+    const INST_LIST_RITER rbegin = bb->rbegin();
     if (this->isCandidate == true && it != rbegin)
     {
         G4_INST* nextInst = NULL;
@@ -1437,7 +1438,7 @@ void LiveRange::checkForInfiniteSpillCost(G4_BB* bb, std::list<G4_INST*>::revers
         }
 
         // Skip all pseudo kills
-        std::list<G4_INST*>::reverse_iterator next = it;
+        INST_LIST_RITER next = it;
         while (true)
         {
             if (next == rbegin)
@@ -1563,8 +1564,7 @@ bool Interference::interfereBetween(unsigned v1, unsigned v2) const
     }
     else
     {
-        auto&& set = sparseMatrix[v1];
-        return set.find(v2) != set.end();
+        return sparseMatrix->isSet(v1, v2);
     }
 }
 
@@ -1655,50 +1655,48 @@ void Interference::buildInterferenceWithLive(const BitSet& live, unsigned i)
 
     unsigned colEnd = i / BITS_DWORD;
 
+    // Skip over runs of dead variables with findNextSet and walk the set bits
+    // of each live dword with ctz instead of testing all 32 bits one by one.
+    auto nextLiveDword = [&live](unsigned bitIdx)
+    {
+        unsigned next = live.findNextSet(bitIdx);
+        return next < live.getSize() ? next / BITS_DWORD : UINT_MAX;
+    };
+
     // Set column bits in intf graph
-    for (unsigned k = 0; k < colEnd; k++)
+    for (unsigned k = nextLiveDword(0); k < colEnd; k = nextLiveDword((k + 1) * BITS_DWORD))
     {
         unsigned elt = live.getElt(k);
 
-        if (elt != 0)
+        if (is_partial || is_splitted)
         {
-            if (is_partial || is_splitted)
-            {
-                filterSplitDclares(start_idx, end_idx, n, k, elt, is_partial);
-            }
+            filterSplitDclares(start_idx, end_idx, n, k, elt, is_partial);
+        }
 
-            for (unsigned j = 0; j < BITS_DWORD; j++)
-            {
-                if (elt & (1 << j))
-                {
-                    unsigned curPos = j + (k * BITS_DWORD);
-                    safeSetInterference(curPos, i);
-                }
-            }
+        while (elt != 0)
+        {
+            unsigned curPos = BitSet::countTrailingZeros(elt) + (k * BITS_DWORD);
+            elt &= elt - 1;
+            safeSetInterference(curPos, i);
         }
     }
 
     // Set dword at transition point from column to row
     unsigned elt = live.getElt(colEnd);
     //checkAndSetIntf guarantee partial and splitted cases
-    if (elt != 0)
+    while (elt != 0)
     {
-        for (unsigned j = 0; j < BITS_DWORD; j++)
+        unsigned curPos = BitSet::countTrailingZeros(elt) + (colEnd * BITS_DWORD);
+        elt &= elt - 1;
+        if (!varSplitCheckBeforeIntf(i, curPos))
         {
-            if (elt & (1 << j))
-            {
-                unsigned curPos = j + (colEnd * BITS_DWORD);
-                if (!varSplitCheckBeforeIntf(i, curPos))
-                {
-                    checkAndSetIntf(i, curPos);
-                }
-            }
+            checkAndSetIntf(i, curPos);
         }
     }
 
     colEnd++;
     // Set row intf graph
-    for (unsigned k = colEnd; k < numDwords; k++)
+    for (unsigned k = nextLiveDword(colEnd * BITS_DWORD); k < numDwords; k = nextLiveDword((k + 1) * BITS_DWORD))
     {
         unsigned elt = live.getElt(k);
 
@@ -2145,8 +2143,34 @@ uint32_t GlobalRA::getRefCount(int loopNestLevel)
     return (uint32_t)std::pow(IN_LOOP_REFERENCE_COUNT_FACTOR, std::min(loopNestLevel, 8));
 }
 
+const BlockFrequency& GlobalRA::getBlockFreq()
+{
+    if (!blockFreq)
+    {
+        blockFreq = std::make_unique<BlockFrequency>(kernel.fg, IN_LOOP_REFERENCE_COUNT_FACTOR);
+        blockFreq->run();
+        LatencyTable LT(&builder);
+        scratchReadLatency = LT.getScratchLatency(false);
+        scratchWriteLatency = LT.getScratchLatency(true);
+    }
+    return *blockFreq;
+}
+
+// Cost of a reference in bb should its variable be spilled: a def becomes a
+// scratch write and a use a scratch read, each executed as often as bb.
+// Block frequencies are only computed with -freqspillcost.
+float GlobalRA::getSpillRefWeight(const G4_BB* bb, bool isDef)
+{
+    if (!useFreqSpillCost)
+    {
+        return 0.0f;
+    }
+    float freq = getBlockFreq().getFreq(bb);
+    return freq * (isDef ? scratchWriteLatency : scratchReadLatency);
+}
+
 // handle return value interference for fcall
-void Interference::buildInterferenceForFcall(G4_BB* bb, BitSet& live, G4_INST* inst, std::list<G4_INST*>::reverse_iterator i, const G4_VarBase* regVar)
+void Interference::buildInterferenceForFcall(G4_BB* bb, BitSet& live, G4_INST* inst, INST_LIST_RITER i, const G4_VarBase* regVar)
 {
     assert(inst->opcode() == G4_pseudo_fcall && "expect fcall inst");
     unsigned refCount = GlobalRA::getRefCount(kernel.getOption(vISA_ConsiderLoopInfoInRA) ?
@@ -2156,6 +2180,7 @@ void Interference::buildInterferenceForFcall(G4_BB* bb, BitSet& live, G4_INST* i
     {
         unsigned id = static_cast<const G4_RegVar*>(regVar)->getId();
         lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount);
+        lrs[id]->addWeightedRefCount(gra.getSpillRefWeight(bb, true));
 
         buildInterferenceWithLive(live, id);
         updateLiveness(live, id, false);
@@ -2169,7 +2194,7 @@ bool GlobalRA::isReRAPass()
     return reRAPass;
 }
 
-void Interference::buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* inst, std::list<G4_INST*>::reverse_iterator i, G4_DstRegRegion* dst)
+void Interference::buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* inst, INST_LIST_RITER i, G4_DstRegRegion* dst)
 {
     unsigned refCount = GlobalRA::getRefCount(kernel.getOption(vISA_ConsiderLoopInfoInRA) ?
         bb->getNestLevel() : 0);
@@ -2192,6 +2217,7 @@ void Interference::buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* ins
             !inst->isLifeTimeEnd())
         {
             lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount);  // update reference count
+            lrs[id]->addWeightedRefCount(gra.getSpillRefWeight(bb, true));
 
             buildInterferenceWithLive(live, id);
             if (lrs[id]->getIsSplittedDcl())
@@ -2245,6 +2271,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
     DebugInfoState state;
     unsigned refCount = GlobalRA::getRefCount(kernel.getOption(vISA_ConsiderLoopInfoInRA) ?
         bb->getNestLevel() : 0);
+    float useWeight = gra.getSpillRefWeight(bb, false);
 
     for (auto i = bb->rbegin(); i != bb->rend(); i++)
     {
@@ -2351,6 +2378,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                 {
                     unsigned id = ((G4_RegVar*)(srcRegion)->getBase())->getId();
                     lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount); // update reference count
+                    lrs[id]->addWeightedRefCount(useWeight);
 
                     if (!inst->isLifeTimeEnd())
                     {
@@ -2413,6 +2441,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                 if (flagReg->asRegVar()->isRegAllocPartaker())
                 {
                     lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount); // update reference count
+                    lrs[id]->addWeightedRefCount(gra.getSpillRefWeight(bb, true));
                     buildInterferenceWithLive(live, id);
 
                     if (liveAnalysis->writeWholeRegion(bb, inst, flagReg))
@@ -2442,6 +2471,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
             if (flagReg->asRegVar()->isRegAllocPartaker())
             {
                 lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount); // update reference count
+                lrs[id]->addWeightedRefCount(useWeight);
                 live.set(id, true);
             }
         }
@@ -2591,12 +2621,11 @@ void Interference::generateSparseIntfGraph()
     {
         for (uint32_t v1 = 0; v1 < maxId; ++v1)
         {
-            auto&& intfSet = sparseMatrix[v1];
-            for (uint32_t v2 : intfSet)
+            sparseMatrix->forEachInRow(v1, [this, v1](uint32_t v2)
             {
                 sparseIntf[v1].emplace_back(v2);
                 sparseIntf[v2].emplace_back(v1);
-            }
+            });
         }
     }
 
@@ -2621,6 +2650,10 @@ void Interference::generateSparseIntfGraph()
         float avgNeighbor = ((float)numNeighbor) / sparseIntf.size();
         std::cout << "\t--avg # neighbors: " << std::setprecision(6) << avgNeighbor << "\n";
         std::cout << "\t--max # neighbors: " << maxNeighbor << " (" << lrs[maxIndex]->getDcl()->getName() << ")\n";
+        if (!useDenseMatrix())
+        {
+            std::cout << "\t--sparse intf matrix size: " << sparseMatrix->getBytesAllocated() << " bytes\n";
+        }
     }
 
     stopTimer(TimerID::INTERFERENCE);
@@ -3768,7 +3801,7 @@ static int calculateBankConflictsInBB(G4_BB* bb, int &even_odd_num, int &low_hig
 {
     int conflict_num = 0;
 
-    for (std::list<G4_INST*>::reverse_iterator i = bb->rbegin();
+    for (INST_LIST_RITER i = bb->rbegin();
         i != bb->rend();
         i++)
     {
@@ -5420,7 +5453,7 @@ GraphColor::GraphColor(LivenessAnalysis& live, unsigned totalGRF, bool hybrid, b
     gra(live.gra), totalGRFRegCount(totalGRF), numVar(live.getNumSelectedVar()), numSplitStartID(live.getNumSplitStartID()), numSplitVar(live.getNumSplitVar()),
     intf(&live, lrs, live.getNumSelectedVar(), live.getNumSplitStartID(), live.getNumSplitVar(), gra), regPool(gra.regPool),
     builder(gra.builder), isHybrid(hybrid),
-    forceSpill(forceSpill_), mem(GRAPH_COLOR_MEM_SIZE),
+    forceSpill(forceSpill_), mem(GRAPH_COLOR_MEM_SIZE, "GraphColor"),
     kernel(gra.kernel), liveAnalysis(live)
 {
     spAddrRegSig = (unsigned*)mem.alloc(getNumAddrRegisters() * sizeof(unsigned));
@@ -5558,6 +5591,10 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic)
 {
     std::vector <LiveRange *> addressSensitiveVars;
     float maxNormalCost = 0.0f;
+    // Weigh GRF references by how often they run and what a scratch access
+    // would cost there, rather than by loop depth alone.
+    bool useFreqCost = liveAnalysis.livenessClass(G4_GRF) &&
+        builder.getOption(vISA_FreqBasedSpillCost);
 
     for (unsigned i = 0; i < numVar; i++)
     {
@@ -5624,19 +5661,25 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic)
             // NOTE: Add 1 to degree to avoid divide-by-0, as a live range may have no neighbors
             if (builder.kernel.getInt32KernelAttr(Attributes::ATTR_Target) == VISA_3D)
             {
+                float refCount = useFreqCost ?
+                    lrs[i]->getWeightedRefCount() : (float)lrs[i]->getRefCount();
                 if (useSplitLLRHeuristic)
                 {
-                    spillCost = 1.0f*lrs[i]->getRefCount() / (lrs[i]->getDegree() + 1);
+                    spillCost = 1.0f * refCount / (lrs[i]->getDegree() + 1);
                 }
                 else
                 {
                     assert(lrs[i]->getDcl()->getTotalElems() > 0);
                     unsigned short numRows = lrs[i]->getDcl()->getNumRows();
-                    spillCost = 1.0f * lrs[i]->getRefCount() * lrs[i]->getRefCount() * lrs[i]->getDcl()->getByteSize() *
+                    spillCost = 1.0f * refCount * refCount * lrs[i]->getDcl()->getByteSize() *
                         (float)sqrt(lrs[i]->getDcl()->getByteSize())
                         / ((float)sqrt(lrs[i]->getDegree() + 1) * (float)(sqrt(sqrt(numRows))));
                 }
             }
+            else if (useFreqCost)
+            {
+                spillCost = lrs[i]->getWeightedRefCount() / (lrs[i]->getDegree() + 1);
+            }
             else
             {
                 spillCost =
@@ -6739,7 +6782,7 @@ bool GraphColor::regAlloc(
     {
         bool hasStackCall = kernel.fg.getHasStackCalls() || kernel.fg.getIsStackCallFunc();
 
-        bool willSpill = ((builder.getOption(vISA_FastCompileRA) || builder.getOption(vISA_HybridRAWithSpill)) && !hasStackCall) ||
+        bool willSpill = ((builder.getOption(vISA_FastCompileRA) || builder.getOption(vISA_HybridRAWithSpill) || gra.overMemBudget) && !hasStackCall) ||
             (kernel.getInt32KernelAttr(Attributes::ATTR_Target) == VISA_3D &&
             rpe->getMaxRP() >= kernel.getNumRegTotal() + 24);
         if (willSpill)
@@ -6845,7 +6888,7 @@ void GraphColor::cleanupRedundantARFFillCode()
     {
         clearSpillAddrLocSignature();
 
-        for (std::list<G4_INST*>::iterator i = bb->begin(); i != bb->end();)
+        for (INST_LIST_ITER i = bb->begin(); i != bb->end();)
         {
             G4_INST* inst = (*i);
 
@@ -6883,7 +6926,7 @@ void GraphColor::cleanupRedundantARFFillCode()
                         G4_SrcRegRegion* srcRgn = inst->getSrc(0)->asSrcRegRegion();
 
                         if (redundantAddrFill(dst, srcRgn, inst->getExecSize())) {
-                            std::list<G4_INST*>::iterator j = i++;
+                            INST_LIST_ITER j = i++;
                             bb->erase(j);
                             continue;
                         }
@@ -8711,7 +8754,7 @@ void VarSplit::globalSplit(IR_Builder& builder, G4_Kernel &kernel)
                 {
                     //The tuple<G4_BB*, G4_Operand*, int pos, unsigned instIndex, INST_LIST_ITER>,
                     //these info are tuning and split operand/instruction generation
-                    splitDcls[topdcl->getRegVar()].push_front(make_tuple(bb, dst, 0, instIndex, it));
+                    splitDcls[topdcl->getRegVar()].push_front(std::make_tuple(bb, dst, 0, instIndex, it));
                 }
             }
         }
@@ -8753,7 +8796,7 @@ void VarSplit::globalSplit(IR_Builder& builder, G4_Kernel &kernel)
                         ((src->asSrcRegRegion()->getRightBound() - src->asSrcRegRegion()->getLeftBound() + 1) < topdcl->getByteSize()) &&
                         src->asSrcRegRegion()->getRegAccess() == Direct)  //We don't split the indirect access
                     {
-                        splitDcls[topdcl->getRegVar()].push_back(make_tuple(bb, src, j, instIndex, it));
+                        splitDcls[topdcl->getRegVar()].push_back(std::make_tuple(bb, src, j, instIndex, it));
                     }
                 }
             }
@@ -9523,7 +9566,7 @@ int GlobalRA::coloringRegAlloc()
                     LivenessAnalysis live(*this, G4_GRF | G4_INPUT, false, true);
                     live.computeLiveness();
                     GraphColor coloring(live, kernel.getNumRegTotal(), false, false);
-                    vISA::Mem_Manager mem(GRAPH_COLOR_MEM_SIZE);
+                    vISA::Mem_Manager mem(GRAPH_COLOR_MEM_SIZE, "GraphColor");
                     coloring.createLiveRanges(0);
                     LiveRange** lrs = coloring.getLRs();
                     Interference intf(&live, lrs, live.getNumSelectedVar(), live.getNumSplitStartID(), live.getNumSplitVar(), *this);
@@ -9610,6 +9653,10 @@ int GlobalRA::coloringRegAlloc()
 
     bool rematDone = false;
     VarSplit splitPass(*this);
+    // liveness of the previous iteration, to only recompute what spill code
+    // changed (-incrementalRA); interference is still rebuilt in full
+    LivenessSnapshot prevLiveness;
+    bool incrementalLiveness = builder.getOption(vISA_IncrementalRA);
     if (kernel.getOption(vISA_SplitGRFAlignedScalar))
     {
         SplitAlignedScalars split(*this);
@@ -9624,6 +9671,20 @@ int GlobalRA::coloringRegAlloc()
         }
         setIterNo(iterationNo);
 
+        // Every iteration reserves new liveness, interference and spill arenas, so once the kernel
+        // exceeds its memory budget finish with the fast compile path, fail safe from this iteration
+        if (!fastCompile && !hasStackCall && ArenaAccounting::getCurrent() &&
+            ArenaAccounting::getCurrent()->isOverBudget())
+        {
+            if (builder.getOption(vISA_RATrace))
+            {
+                std::cout << "\t--over memory budget, switch to fast compile RA\n";
+            }
+            overMemBudget = true;
+            fastCompile = true;
+            failSafeRAIteration = iterationNo;
+        }
+
         if (!builder.getOption(vISA_HybridRAWithSpill))
         {
             resetGlobalRAStates();
@@ -9689,6 +9750,10 @@ int GlobalRA::coloringRegAlloc()
         }
 
         LivenessAnalysis liveAnalysis(*this, G4_GRF | G4_INPUT);
+        if (incrementalLiveness)
+        {
+            liveAnalysis.setSnapshot(&prevLiveness);
+        }
         liveAnalysis.computeLiveness();
         if (builder.getOption(vISA_dumpLiveness))
         {
@@ -9722,6 +9787,10 @@ int GlobalRA::coloringRegAlloc()
             unsigned indrSpillRegSize = 0;
             bool isColoringGood =
                 coloring.regAlloc(doBankConflictReduction, highInternalConflict, reserveSpillReg, spillRegSize, indrSpillRegSize, &rpe);
+            if (builder.getOption(vISA_DumpSpillCosts))
+            {
+                coloring.dumpSpillCosts(std::cout, iterationNo);
+            }
             if (!isColoringGood)
             {
                 if (isReRAPass())
@@ -11394,6 +11463,49 @@ void GraphColor::dumpRegisterPressure()
     }
 }
 
+void GraphColor::dumpSpillCosts(std::ostream& os, unsigned iterationNo)
+{
+    bool useFreqCost = builder.getOption(vISA_FreqBasedSpillCost);
+    os << "===== spill costs: " << builder.kernel.getName() << ", RA iteration " <<
+        iterationNo << (useFreqCost ? " (frequency based)" : " (loop based)") << " =====\n";
+    if (iterationNo == 0)
+    {
+        gra.getBlockFreq().dump(os);
+    }
+
+    std::unordered_set<LiveRange*> spilled(spilledLRs.begin(), spilledLRs.end());
+    std::vector<LiveRange*> sorted;
+    for (unsigned i = 0; i < numVar; i++)
+    {
+        if (!lrs[i]->getIsPartialDcl() && !lrs[i]->getIsPseudoNode())
+        {
+            sorted.push_back(lrs[i]);
+        }
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](LiveRange* a, LiveRange* b) { return a->getSpillCost() > b->getSpillCost(); });
+
+    for (auto lr : sorted)
+    {
+        os << (spilled.count(lr) ? "S " : "  ") << lr->getDcl()->getName() <<
+            " (size = " << lr->getDcl()->getByteSize() <<
+            ", refs = " << lr->getRefCount() <<
+            ", weighted refs = " << lr->getWeightedRefCount() <<
+            ", degree = " << lr->getDegree() <<
+            ", spill cost = ";
+        if (lr->getSpillCost() == MAXSPILLCOST)
+        {
+            os << "inf";
+        }
+        else
+        {
+            os << lr->getSpillCost();
+        }
+        os << ")\n";
+    }
+    os << spilledLRs.size() << " live range(s) spilled\n\n";
+}
+
 void GlobalRA::fixAlignment()
 {
     // Copy over alignment from G4_RegVar to GlobalRA instance
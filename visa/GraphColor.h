@@ -28,9 +28,11 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define __GRAPHCOLOR_H__
 
 #include "BitSet.h"
+#include "BlockFrequency.h"
 #include "Gen4_IR.hpp"
 #include "RegAlloc.h"
 #include "RPE.h"
+#include "SparseBitMatrix.h"
 #include "SpillManagerGMRF.h"
 #include "VarSplit.h"
 
@@ -92,6 +94,8 @@ class LiveRange final
     unsigned numRegNeeded;
     unsigned degree = 0;
     unsigned refCount = 0;
+    // references weighted by block frequency and scratch message latency
+    float weightedRefCount = 0.0f;
     unsigned parentLRID;
     AssignedReg reg;
     float spillCost;
@@ -153,11 +157,14 @@ public:
     unsigned getRefCount() const {return refCount;}
     void setRefCount(unsigned count) {refCount = count;}
 
+    float getWeightedRefCount() const {return weightedRefCount;}
+    void addWeightedRefCount(float weight) {weightedRefCount += weight;}
+
     float getSpillCost() const {return spillCost;}
     void setSpillCost(float cost) {spillCost = cost;}
 
     bool getIsInfiniteSpillCost() const { return isInfiniteCost; }
-    void checkForInfiniteSpillCost(G4_BB* bb, std::list<G4_INST*>::reverse_iterator& it);
+    void checkForInfiniteSpillCost(G4_BB* bb, INST_LIST_RITER& it);
 
     G4_VarBase* getPhyReg() const { return reg.phyReg; }
 
@@ -369,7 +376,7 @@ namespace vISA
         // we don't directly update sparseIntf to ensure uniqueness
         // like dense matrix, interference is not symmetric (that is, if v1 and v2 interfere and v1 < v2,
         // we insert (v1, v2) but not (v2, v1)) for better cache behavior
-        std::vector<std::unordered_set<uint32_t> > sparseMatrix;
+        SparseBitMatrix* sparseMatrix = nullptr;
         static const uint32_t denseMatrixLimit = 0x80000;
 
         static void updateLiveness(BitSet& live, uint32_t id, bool val)
@@ -395,7 +402,7 @@ namespace vISA
             }
             else
             {
-                sparseMatrix[v1].emplace(v2);
+                sparseMatrix->set(v1, v2);
             }
         }
 
@@ -411,15 +418,7 @@ namespace vISA
             }
             else
             {
-                auto&& intfSet = sparseMatrix[v1];
-                for (int i = 0; i < BITS_DWORD; ++i)
-                {
-                    if (block & (1 << i))
-                    {
-                        uint32_t v2 = col * BITS_DWORD + i;
-                        intfSet.emplace(v2);
-                    }
-                }
+                sparseMatrix->setBlock(v1, col * BITS_DWORD, block);
             }
         }
 
@@ -433,8 +432,8 @@ namespace vISA
 
         void buildInterferenceAtBBExit(const G4_BB* bb, BitSet& live);
         void buildInterferenceWithinBB(G4_BB* bb, BitSet& live);
-        void buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* inst, std::list<G4_INST*>::reverse_iterator i, G4_DstRegRegion* dst);
-        void buildInterferenceForFcall(G4_BB* bb, BitSet& live, G4_INST* inst, std::list<G4_INST*>::reverse_iterator i, const G4_VarBase* regVar);
+        void buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* inst, INST_LIST_RITER i, G4_DstRegRegion* dst);
+        void buildInterferenceForFcall(G4_BB* bb, BitSet& live, G4_INST* inst, INST_LIST_RITER i, const G4_VarBase* regVar);
 
         inline void filterSplitDclares(unsigned startIdx, unsigned endIdx, unsigned n, unsigned col, unsigned &elt, bool is_split);
 
@@ -488,7 +487,7 @@ namespace vISA
             }
             else
             {
-                sparseMatrix.resize(maxId);
+                sparseMatrix = new (m) SparseBitMatrix(m, maxId);
             }
         }
 
@@ -612,6 +611,7 @@ namespace vISA
         void getSaveRestoreRegister();
         void getCallerSaveRegisters();
         void dumpRegisterPressure();
+        void dumpSpillCosts(std::ostream& os, unsigned iterationNo);
         GlobalRA & getGRA() { return gra; }
         G4_SrcRegRegion* getScratchSurface() const;
         LiveRange** getLRs() const { return lrs; }
@@ -727,6 +727,7 @@ namespace vISA
         void expandSpillIntrinsic(G4_BB*);
         void expandFillIntrinsic(G4_BB*);
         void expandSpillFillIntrinsics(unsigned);
+        unsigned int coalesceSpillFillIntrinsics(G4_BB*);
 
         static const RAVarInfo defaultValues;
         std::vector<RAVarInfo> vars;
@@ -779,6 +780,13 @@ namespace vISA
         uint32_t numGRFSpill = 0;
         uint32_t numGRFFill = 0;
 
+        // -freqspillcost
+        bool useFreqSpillCost = false;
+        // built on first use; RA does not change the CFG
+        std::unique_ptr<BlockFrequency> blockFreq;
+        float scratchReadLatency = 0.0f;
+        float scratchWriteLatency = 0.0f;
+
         void expandFillNonStackcall(uint32_t numRows, uint32_t offset, short rowOffset, G4_SrcRegRegion* header, G4_DstRegRegion* resultRgn, G4_BB* bb, INST_LIST_ITER& instIt);
         void expandSpillNonStackcall(uint32_t numRows, uint32_t offset, short rowOffset, G4_SrcRegRegion* header, G4_SrcRegRegion* payload, G4_BB* bb, INST_LIST_ITER& instIt);
         void expandFillStackcall(uint32_t numRows, uint32_t offset, short rowOffset, G4_SrcRegRegion* header, G4_DstRegRegion* resultRgn, G4_BB* bb, INST_LIST_ITER& instIt);
@@ -804,6 +812,8 @@ namespace vISA
         PhyRegPool& regPool;
         PointsToAnalysis& pointsToAnalysis;
         FCALL_RET_MAP fcallRetMap;
+        // Set once the kernel runs past its arena memory budget, RA then behaves as with -fastCompileRA
+        bool overMemBudget = false;
 
 
         VarSplitPass* getVarSplitPass() const { return kernel.getVarSplitPass(); }
@@ -1157,6 +1167,7 @@ namespace vISA
         {
             vars.resize(k.Declares.size());
             varMasks.resize(k.Declares.size());
+            useFreqSpillCost = kernel.getOptions()->getOption(vISA_FreqBasedSpillCost);
 
             if (kernel.getOptions()->getOption(vISA_VerifyAugmentation))
             {
@@ -1167,6 +1178,8 @@ namespace vISA
         void emitFGWithLiveness(const LivenessAnalysis& liveAnalysis) const;
         void reportSpillInfo(const LivenessAnalysis& liveness, const GraphColor& coloring) const;
         static uint32_t getRefCount(int loopNestLevel);
+        float getSpillRefWeight(const G4_BB* bb, bool isDef);
+        const BlockFrequency& getBlockFreq();
         bool isReRAPass();
         void updateSubRegAlignment(G4_SubReg_Align subAlign);
         bool isChannelSliced();
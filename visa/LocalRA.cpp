@@ -1204,12 +1204,12 @@ void LocalRA::markReferencesInOpnd(G4_Operand* opnd, bool isEOT, INST_LIST_ITER
                 if (useMapIter == LLRUseMap.end())
                 {
                     std::vector<std::pair<INST_LIST_ITER, unsigned int>> useList;
-                    useList.push_back(make_pair(inst_it, pos));
+                    useList.push_back(std::make_pair(inst_it, pos));
                     LLRUseMap.insert(make_pair(lr, useList));
                 }
                 else
                 {
-                    (*useMapIter).second.push_back(make_pair(inst_it, pos));
+                    (*useMapIter).second.push_back(std::make_pair(inst_it, pos));
                 }
             }
 
@@ -13,6 +13,17 @@ uint16_t LatencyTable::getLatency(G4_INST* Inst) const
     return getLatencyLegacy(Inst);
 }
 
+// Scratch messages go through the data cache. A fill stalls its first use
+// for the full read latency, while a spill only has to be issued.
+uint16_t LatencyTable::getScratchLatency(bool isWrite) const
+{
+    auto GEN = getPlatformGeneration(m_builder->getPlatform());
+    if (GEN >= PlatformGen::XE)
+        return isWrite ? LatenciesXe::SEND_OTHERS : LatenciesXe::DP_L3;
+
+    return LegacyFFLatency[SFIDtoInt(isWrite ? SFID::DP_WRITE : SFID::DP_DC)];
+}
+
 // This calculates the node's pipeline occupancy (node delay)
 uint16_t LatencyTable::getOccupancy(G4_INST* Inst) const
 {
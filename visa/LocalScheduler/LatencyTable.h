@@ -82,6 +82,8 @@ namespace vISA
         // Functions to get latencies/occupancy based on platforms
         uint16_t getOccupancy(G4_INST* Inst) const;
         uint16_t getLatency(G4_INST* Inst) const;
+        // Latency of a scratch block read (fill) or write (spill) message.
+        uint16_t getScratchLatency(bool isWrite) const;
     private:
         uint16_t getLatencyLegacy(G4_INST* Inst) const;
         uint16_t getOccupancyLegacy(G4_INST* Inst) const;
@@ -52,6 +52,7 @@ void LocalScheduler::localScheduling()
     LatencyTable LT(fg.builder);
 
     uint32_t totalCycles = 0;
+    std::unordered_map<G4_BB*, uint32_t> localCycles;
     uint32_t scheduleStartBBId = m_options->getuInt32Option(vISA_LocalSchedulingStartBB);
     uint32_t shceduleEndBBId = m_options->getuInt32Option(vISA_LocalSchedulingEndBB);
     for (; ib != bend; ++ib)
@@ -68,7 +69,7 @@ void LocalScheduler::localScheduling()
             continue;
         }
 
-        Mem_Manager bbMem(4096);
+        Mem_Manager bbMem(4096, "Scheduler");
         unsigned schedulerWindowSize = m_options->getuInt32Option(vISA_SchedulerWindowSize);
         if (schedulerWindowSize > 0 && instCountBefore > schedulerWindowSize)
         {
@@ -114,10 +115,19 @@ void LocalScheduler::localScheduling()
             bbInfo[i].sendStallCycle = schedule.sendStallCycle;
             bbInfo[i].loopNestLevel = (*ib)->getNestLevel();
             totalCycles += schedule.sequentialCycle;
+            localCycles[*ib] = schedule.sequentialCycle;
         }
 
         i++;
     }
+
+    if (m_options->getOption(vISA_GlobalScheduling))
+    {
+        uint32_t savedCycles = globalScheduling(LT, localCycles);
+        totalCycles -= savedCycles;
+        fg.builder->getcompilerStats().SetI64(CompilerStats::numGlobalSchedCyclesSavedStr(),
+            savedCycles, fg.getKernel()->getSimdSize());
+    }
     FINALIZER_INFO* jitInfo = fg.builder->getJitInfo();
     jitInfo->BBInfo = bbInfo;
     jitInfo->BBNum = i;
@@ -125,6 +135,196 @@ void LocalScheduler::localScheduling()
     fg.builder->getcompilerStats().SetI64(CompilerStats::numCyclesStr(), totalCycles, fg.getKernel()->getSimdSize());
 }
 
+//
+// Superblock scheduling:
+// A superblock is a chain of blocks laid out back to back where each block
+// other than the first is entered only by falling through from the previous
+// one, which ends with a uniform conditional jmpi to a side exit. The whole
+// chain is scheduled as one DAG, in which nothing may be hoisted above a
+// side exit but instructions may sink below it; every instruction that does
+// is copied to the head of the exit target, so the off-trace path still
+// executes it exactly once. To keep that legal without splitting edges, a
+// side exit target must have the exit block as its only predecessor.
+//
+bool LocalScheduler::canExtendSuperblock(G4_BB* bb, G4_BB* next) const
+{
+    if (bb->empty() || next->empty() ||
+        bb->fallThroughBB() != next ||
+        next->Preds.size() != 1 ||
+        next->getBBType() != G4_BB_NONE_TYPE ||
+        next->isDivergent() != bb->isDivergent() ||
+        // stay on the hot path; don't grow the trace out of (or into) a loop
+        next->getNestLevel() != bb->getNestLevel())
+    {
+        return false;
+    }
+
+    G4_INST* lastInst = bb->back();
+    if (lastInst->opcode() != G4_jmpi || !lastInst->getPredicate() ||
+        lastInst->asCFInst()->isIndirectJmp() || bb->Succs.size() != 2)
+    {
+        return false;
+    }
+
+    G4_BB* exitBB = bb->Succs.back();
+    return exitBB != next &&
+        exitBB->Preds.size() == 1 &&
+        exitBB->getBBType() == G4_BB_NONE_TYPE &&
+        exitBB->getLabel() != nullptr &&
+        exitBB->getNestLevel() <= next->getNestLevel();
+}
+
+uint32_t LocalScheduler::globalScheduling(const LatencyTable& LT,
+    const std::unordered_map<G4_BB*, uint32_t>& localCycles)
+{
+    const Options *m_options = fg.builder->getOptions();
+    unsigned schedulerWindowSize = m_options->getuInt32Option(vISA_SchedulerWindowSize);
+    uint32_t savedCycles = 0;
+
+    // Regions only contain blocks that were scheduled by the local scheduler,
+    // which also keeps them within the scheduling window and BB id range.
+    auto wasScheduled = [&](G4_BB* bb) { return localCycles.count(bb) != 0; };
+
+    // Every region is scheduled in the same temporary block.
+    G4_BB* regionBB = fg.createNewBB(false);
+
+    std::vector<G4_BB*> layout(fg.begin(), fg.end());
+    for (size_t i = 0, e = layout.size(); i < e; ++i)
+    {
+        if (!wasScheduled(layout[i]))
+        {
+            continue;
+        }
+
+        std::vector<G4_BB*> blocks(1, layout[i]);
+        size_t numInsts = layout[i]->size();
+        while (i + 1 < e && wasScheduled(layout[i + 1]) &&
+            (schedulerWindowSize == 0 || numInsts + layout[i + 1]->size() <= schedulerWindowSize) &&
+            canExtendSuperblock(layout[i], layout[i + 1]))
+        {
+            ++i;
+            blocks.push_back(layout[i]);
+            numInsts += layout[i]->size();
+        }
+
+        if (blocks.size() > 1)
+        {
+            savedCycles += scheduleSuperblock(blocks, regionBB, LT, localCycles);
+        }
+    }
+
+    fg.destroyTempBB(regionBB);
+    return savedCycles;
+}
+
+uint32_t LocalScheduler::scheduleSuperblock(const std::vector<G4_BB*>& blocks,
+    G4_BB* regionBB, const LatencyTable& LT,
+    const std::unordered_map<G4_BB*, uint32_t>& localCycles)
+{
+    // Keep the local schedules around in case the superblock one is no better.
+    std::vector<std::vector<G4_INST*>> localOrder;
+    uint32_t localCost = 0;
+    for (G4_BB* bb : blocks)
+    {
+        localOrder.emplace_back(bb->begin(), bb->end());
+        localCost += localCycles.at(bb);
+    }
+
+    // Move the whole region into a temporary block. Labels of the inner
+    // blocks stay behind since nothing but the fall-through reaches them.
+    std::unordered_set<G4_INST*> sideExits;
+    std::unordered_map<G4_INST*, unsigned> homeBlock;
+    for (unsigned b = 0, e = (unsigned)blocks.size(); b < e; ++b)
+    {
+        G4_BB* bb = blocks[b];
+        for (G4_INST* inst : *bb)
+        {
+            homeBlock[inst] = b;
+        }
+        if (b + 1 < e)
+        {
+            sideExits.insert(bb->back());
+        }
+        INST_LIST_ITER first = bb->begin();
+        if (b != 0 && (*first)->isLabel())
+        {
+            ++first;
+        }
+        regionBB->splice(regionBB->end(), bb, first, bb->end());
+    }
+
+    Mem_Manager regionMem(4096, "Scheduler");
+    G4_BB_Schedule schedule(fg.getKernel(), regionMem, regionBB, LT, &sideExits);
+
+    // Each instruction that sinks below side exits is copied to their targets
+    // (see below). Charge those copies as if the exit paths were as hot as the
+    // trace, since there is no profile to tell.
+    uint32_t compensationCost = 0;
+    unsigned newB = 0;
+    for (G4_INST* inst : *regionBB)
+    {
+        compensationCost += (newB - homeBlock[inst]) * LT.getOccupancy(inst);
+        if (sideExits.count(inst))
+        {
+            ++newB;
+        }
+    }
+    const uint32_t regionCost = schedule.sequentialCycle + compensationCost;
+
+    if (regionCost >= localCost)
+    {
+        regionBB->clear();
+        for (unsigned b = 0, e = (unsigned)blocks.size(); b < e; ++b)
+        {
+            blocks[b]->clear();
+            for (G4_INST* inst : localOrder[b])
+            {
+                blocks[b]->push_back(inst);
+            }
+        }
+        return 0;
+    }
+
+    // Redistribute the schedule: everything up to and including a side exit
+    // stays in that exit's block. An instruction that now lives below the
+    // side exits of blocks [home, b) is copied to each of their targets.
+    std::vector<std::vector<G4_INST*>> compensation(blocks.size());
+    unsigned b = 0;
+    for (INST_LIST_ITER it = regionBB->begin(); it != regionBB->end();)
+    {
+        G4_INST* inst = *it;
+        INST_LIST_ITER next = std::next(it);
+        blocks[b]->splice(blocks[b]->end(), regionBB, it);
+        for (unsigned exitB = homeBlock[inst]; exitB < b; ++exitB)
+        {
+            compensation[exitB].push_back(inst);
+        }
+        if (sideExits.count(inst))
+        {
+            ++b;
+        }
+        it = next;
+    }
+
+    for (unsigned exitB = 0, e = (unsigned)blocks.size(); exitB < e; ++exitB)
+    {
+        if (compensation[exitB].empty())
+        {
+            continue;
+        }
+        G4_BB* exitBB = blocks[exitB]->Succs.back();
+        INST_LIST_ITER insertPos = std::next(exitBB->begin());
+        for (G4_INST* inst : compensation[exitB])
+        {
+            G4_INST* copy = inst->cloneInst();
+            copy->inheritDIFrom(inst);
+            exitBB->insertBefore(insertPos, copy);
+        }
+    }
+
+    return localCost - regionCost;
+}
+
 void G4_BB_Schedule::dumpSchedule(G4_BB *bb)
 {
     const char *asmName = nullptr;
@@ -210,7 +410,7 @@ void G4_BB_Schedule::dumpSchedule(G4_BB *bb)
 //      - creates a new instruction listing within a BBB
 //
 G4_BB_Schedule::G4_BB_Schedule(G4_Kernel* k, Mem_Manager& m, G4_BB* block,
-    const LatencyTable& LT)
+    const LatencyTable& LT, const std::unordered_set<G4_INST*>* sideExits)
     : mem(m)
     , bb(block)
     , kernel(k)
@@ -219,11 +419,13 @@ G4_BB_Schedule::G4_BB_Schedule(G4_Kernel* k, Mem_Manager& m, G4_BB* block,
     // we use local id in the scheduler for determining two instructions' original ordering
     bb->resetLocalId();
 
-    DDD ddd(mem, bb, LT, k);
+    DDD ddd(mem, bb, LT, k, sideExits);
     // Generate pairs of TypedWrites
+    // (not across side exits, as the pair would straddle two blocks)
     bool doMessageFuse =
-        (k->fg.builder->fuseTypedWrites() && k->getSimdSize() >= g4::SIMD16) ||
-        k->fg.builder->fuseURBMessage();
+        !sideExits &&
+        ((k->fg.builder->fuseTypedWrites() && k->getSimdSize() >= g4::SIMD16) ||
+         k->fg.builder->fuseURBMessage());
 
     if (doMessageFuse)
     {
@@ -1219,12 +1421,37 @@ bool DDD::hasReadSuppression(G4_INST* prevInst, G4_INST* nextInst, bool multiSup
 // dependencies with all insts in live set. After analyzing
 // dependencies and creating necessary edges, current inst
 // is inserted in all buckets it touches.
-DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
+// Can this node be moved below a superblock side exit (and be copied to its
+// target)? Sends are kept in place: sinking them only delays the message
+// and would duplicate memory traffic code on the exit path.
+static bool canSinkPastSideExit(const Node* node)
+{
+    if (node->isBarrier() != NODEP)
+    {
+        return false;
+    }
+    for (G4_INST* inst : *node->getInstructions())
+    {
+        if (inst->isSend() || inst->isIntrinsic() || inst->isFlowControl() ||
+            inst->isLabel())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k,
+    const std::unordered_set<G4_INST*>* sideExits)
     : mem(m)
     , LT(lt)
     , kernel(k)
 {
     Node* lastBarrier = nullptr;
+    Node* lastSideExit = nullptr;
+    auto isSideExit = [sideExits](G4_INST* inst) {
+        return sideExits && sideExits->count(inst) != 0;
+    };
     HWthreadsPerEU = k->getNumThreads();
     useMTLatencies = getBuilder()->useMultiThreadLatency();
     totalGRFNum = kernel->getNumRegTotal();
@@ -1245,7 +1472,7 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
 
     // Building the graph in reverse relative to the original instruction
     // order, to naturally take care of the liveness of operands.
-    std::list<G4_INST*>::reverse_iterator iInst(bb->rbegin()), iInstEnd(bb->rend());
+    INST_LIST_RITER iInst(bb->rbegin()), iInstEnd(bb->rend());
     std::vector<BucketDescr> BDvec;
 
     int threeSrcInstNUm = 0;
@@ -1269,7 +1496,7 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
             //FIXME: we can extended to all 3 sources
             if (curInst->opcode() == G4_mad || curInst->opcode() == G4_dp4a)
             {
-                 std::list<G4_INST*>::reverse_iterator iNextInst = iInst;
+                 INST_LIST_RITER iNextInst = iInst;
                  iNextInst ++;
                  if (iNextInst != iInstEnd)
                  {
@@ -1278,7 +1505,8 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
                      BitSet liveDst(totalGRFNum, false);
                      liveSrc.clear();
                      liveDst.clear();
-                     while (hasReadSuppression(nextInst, curInst, liveDst, liveSrc))
+                     while (!isSideExit(nextInst) &&
+                            hasReadSuppression(nextInst, curInst, liveDst, liveSrc))
                      {
                          //Pushed to the same node
                          node->instVec.push_front(nextInst);
@@ -1305,7 +1533,27 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
         }
 
         DepType  depType;
-        if ((depType = node->isLabel()) || (depType = node->isBarrier()))
+        if (isSideExit(curInst))
+        {
+            // Nothing after a side exit may be hoisted above it. The live
+            // buckets are kept, so earlier instructions only depend on it
+            // (and on what follows it) through real dependences.
+            for (Node* laterNode : allNodes)
+            {
+                if (laterNode != node && laterNode->preds.empty())
+                {
+                    createAddEdge(node, laterNode, CONTROL_FLOW_BARRIER);
+                }
+            }
+            if (lastBarrier)
+            {
+                createAddEdge(node, lastBarrier, lastBarrier->isBarrier());
+                node->hasTransitiveEdgeToBarrier = true;
+            }
+
+            lastSideExit = node;
+        }
+        else if ((depType = node->isLabel()) || (depType = node->isBarrier()))
         {
             // Insert edge from current instruction
             // to all instructions live in every bucket
@@ -1322,6 +1570,10 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
             {
                 createAddEdge(node, lastBarrier, lastBarrier->isBarrier());
             }
+            if (lastSideExit)
+            {
+                createAddEdge(node, lastSideExit, depType);
+            }
 
             lastBarrier = node;
         } else {
@@ -1406,6 +1658,14 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
                 }
             }
 
+            if (lastSideExit && !canSinkPastSideExit(node))
+            {
+                // Pin it above the next side exit. This is not a real
+                // terminator, so don't charge send latency on the edge.
+                createAddEdge(node, lastSideExit, OPT_BARRIER);
+                transitiveEdgeToBarrier |= lastSideExit->hasTransitiveEdgeToBarrier;
+            }
+
             if (transitiveEdgeToBarrier == false && lastBarrier != nullptr)
             {
                 // Insert edge to barrier and set flag
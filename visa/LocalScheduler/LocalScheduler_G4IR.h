@@ -39,6 +39,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <list>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 
@@ -271,7 +273,11 @@ public:
     bool hasReadSuppression(G4_INST *curInst, G4_INST *nextInst, BitSet &liveDst, BitSet &liveSrc);
     bool hasReadSuppression(G4_INST* prevInst, G4_INST* nextInst, bool multipSuppression);
 
-    DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k);
+    // sideExits is non-null when bb is a superblock: the listed branches
+    // are side exits that later instructions may not be hoisted above,
+    // but which earlier instructions may sink below.
+    DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k,
+        const std::unordered_set<G4_INST*>* sideExits = nullptr);
     ~DDD()
     {
         if (Nodes.size())
@@ -323,7 +329,8 @@ public:
 
     // Constructor
     G4_BB_Schedule(G4_Kernel* kernel, Mem_Manager& m, G4_BB* bb,
-        const LatencyTable& LT);
+        const LatencyTable& LT,
+        const std::unordered_set<G4_INST*>* sideExits = nullptr);
     void *operator new(size_t sz, Mem_Manager &m){ return m.alloc(sz); }
     // Dumps the schedule
     void emit(std::ostream &);
@@ -341,6 +348,15 @@ class LocalScheduler {
     // send latencies are now defined in FFLatency in LIR.cpp
     void EmitNode(Node *);
 
+    // Superblock (global) scheduling. Returns the estimated number of
+    // cycles saved over the local schedules in localCycles.
+    uint32_t globalScheduling(const LatencyTable& LT,
+        const std::unordered_map<G4_BB*, uint32_t>& localCycles);
+    bool canExtendSuperblock(G4_BB* bb, G4_BB* next) const;
+    uint32_t scheduleSuperblock(const std::vector<G4_BB*>& blocks,
+        G4_BB* regionBB, const LatencyTable& LT,
+        const std::unordered_map<G4_BB*, uint32_t>& localCycles);
+
 public:
     LocalScheduler(FlowGraph &flowgraph, Mem_Manager &m)
         : fg(flowgraph), mem(m) {}
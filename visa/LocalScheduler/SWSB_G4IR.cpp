@@ -34,6 +34,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <functional>
 #include <sstream>
 #include <queue>
+#include <deque>
 
 using namespace vISA;
 
@@ -704,6 +705,12 @@ void SWSB::SWSBGlobalTokenGenerator(PointsToAnalysis& p, LiveGRFBuckets& LB, Liv
         allTokenNodesMap[i] = BitSet(unsigned(SBSendNodes.size()), false);
     }
 
+    globalSendOpndPositions.resize(globalSendNum);
+    for (unsigned k = 0; k < globalSendOpndList.size(); k++)
+    {
+        globalSendOpndPositions[globalSendOpndList[k]->node->globalID].push_back(k);
+    }
+
     // Get the live out, may kill bit sets
     for (G4_BB_SB *bb : BBVector)
     {
@@ -1333,6 +1340,57 @@ void SWSB::examineNodeForTokenReuse(/* out */ int &reuseDelay, /* out */ int &cu
     }
 }
 
+//Fold all nodes which have been assigned the token into reuseDelay (max) and sameTokenDistance (min).
+//Only the nodes within maxTokenReuseDelay can get a positive reuse delay. Beyond that window, the distance
+//is either linear in the node ID distance or, for the back edge of the same loop, min(d, loopSize - d),
+//so the minimum is always taken by the nearest or the farthest node on each side.
+//That keeps the examined nodes per token bounded instead of growing with the kernel.
+void SWSB::examineSameTokenNodes(/* out */ int &reuseDelay, /* out */ int &sameTokenDistance, unsigned short token, unsigned nodeID, unsigned nodeDelay, unsigned char nestLoopLevel, unsigned curLoopStartBB, unsigned curLoopEndBB) const
+{
+    auto examineNode = [&](const SBNode* snode)
+    {
+        int sReuseDelay;
+        int sDistance;
+        examineNodeForTokenReuse(sReuseDelay, sDistance, nodeID, nodeDelay, snode, nestLoopLevel, curLoopStartBB, curLoopEndBB);
+
+        reuseDelay = std::max(reuseDelay, sReuseDelay);
+        sameTokenDistance = std::min(sameTokenDistance, sDistance);
+    };
+
+    for (const auto& levelNodes : sameTokenNodes[token])
+    {
+        const std::map<unsigned, const SBNode*>& nodes = levelNodes.second;
+
+        //The back edge distance comes from the loop of each node, no shortcut
+        if (nestLoopLevel && levelNodes.first == nestLoopLevel &&
+            (curLoopStartBB == -1 || curLoopEndBB == -1))
+        {
+            for (const auto& node : nodes)
+            {
+                examineNode(node.second);
+            }
+            continue;
+        }
+
+        auto windowStart = nodes.lower_bound(nodeID > maxTokenReuseDelay ? nodeID - maxTokenReuseDelay : 0);
+        auto windowEnd = nodes.upper_bound(nodeID + maxTokenReuseDelay);
+        if (windowStart != nodes.begin())
+        {
+            examineNode(std::prev(windowStart)->second);
+            examineNode(nodes.begin()->second);
+        }
+        for (auto it = windowStart; it != windowEnd; ++it)
+        {
+            examineNode(it->second);
+        }
+        if (windowEnd != nodes.end())
+        {
+            examineNode(windowEnd->second);
+            examineNode(nodes.rbegin()->second);
+        }
+    }
+}
+
 //The algorithm for reuse selection: The live range which causes the least stall delay of current live range.
 //Fixme: for global variable, it's not accurate. Because the AFTER_SOURCE and AFTER_WRITE may in different branches.
 //Try not reuse the tokens set in adjacent instructions.
@@ -1357,15 +1415,7 @@ SBNode * SWSB::reuseTokenSelection(const SBNode * node) const
 
         const unsigned short token = curNode->getLastInstruction()->getSetToken();
         int sameTokenDistance = 0x7FFFFFFF;
-        for (const SBNode* snode : sameTokenNodes[token])
-        {
-            int sReuseDelay;
-            int sDistance;
-            examineNodeForTokenReuse(sReuseDelay, sDistance, nodeID, nodeDelay, snode, nestLoopLevel, loopStartBB, loopEndBB);
-
-            reuseDelay = std::max(reuseDelay, sReuseDelay);
-            sameTokenDistance = std::min(sameTokenDistance, sDistance);
-        }
+        examineSameTokenNodes(reuseDelay, sameTokenDistance, token, nodeID, nodeDelay, nestLoopLevel, loopStartBB, loopEndBB);
 
         //Smallest one is the best one
         //if Distance is not 0, count the distance, otherwise, use the delay.
@@ -1777,7 +1827,7 @@ void SWSB::assignToken(SBNode* node,
         printf("Reuse token: %d,  QUEUE SIZE: %d\n", token, linearScanLiveNodes.size());
 #endif
     }
-    sameTokenNodes[token].push_back(node);
+    sameTokenNodes[token][BBVector[node->getBBID()]->getBB()->getNestLevel()].emplace(node->getNodeID(), node);
 #ifdef DEBUG_VERBOSE_ON
     printf("Assigned token: %d,  node: %d, send: %d,  QUEUE SIZE: %d\n", token, node->getNodeID(), node->getSendID(), linearScanLiveNodes.size());
 #endif
@@ -1933,70 +1983,81 @@ bool SWSB::globalTokenReachAnalysis(G4_BB* bb)
     }
 
     //Caculate the live out according to the live in and killed tokens in current BB
-    for (uint32_t token = 0; token < totalTokenNum; token++)
-    {
-        if (BBVector[bbID]->killedTokens.isSet(token))
-        {
-            temp_live_in -= allTokenNodesMap[token];
-        }
-    }
-
     //Get the new live out,
     //FIXME: is it right? the live out is always assigned in increasing.
     //Original, we only have local live out.
     //should we seperate the local ive out vs total live out?
     //Not necessary, can live out, will always be live out.
-    BBVector[bbID]->liveOutTokenNodes |= temp_live_in;
+    BBVector[bbID]->liveOutTokenNodes.orAndNot(temp_live_in, BBVector[bbID]->killedTokenNodes);
 
     return changed;
 }
 
-void SWSB::SWSBGlobalTokenAnalysis()
+//Forward union dataflow over both the scalar and the SIMD CFG, seeded in layout order.
+//A BB is revisited only when the live in of it may grow, i.e. a predecessor got new live out.
+//The live out of a BB only grows with its live in, except for the first visit.
+void SWSB::solveGlobalDataflow(bool (SWSB::*transfer)(G4_BB*))
 {
-    bool change = true;
-    while (change)
+    std::deque<G4_BB*> worklist(fg.begin(), fg.end());
+    std::vector<bool> inWorklist(BBVector.size(), true);
+    std::vector<bool> visited(BBVector.size(), false);
+
+    auto addToWorklist = [&](G4_BB* succ)
     {
-        change = false;
-        for (G4_BB* bb : fg)
+        if (!inWorklist[succ->getId()])
         {
-            if (globalTokenReachAnalysis(bb))
-            {
-                change = true;
-            }
+            inWorklist[succ->getId()] = true;
+            worklist.push_back(succ);
         }
-    }
-}
+    };
 
-void SWSB::SWSBGlobalScalarCFGReachAnalysis()
-{
-    bool change = true;
-    while (change)
+    while (!worklist.empty())
     {
-        change = false;
-        for (G4_BB* bb : fg)
+        G4_BB* bb = worklist.front();
+        worklist.pop_front();
+        unsigned bbID = bb->getId();
+        inWorklist[bbID] = false;
+
+        if ((this->*transfer)(bb) || !visited[bbID])
         {
-            if (globalDependenceDefReachAnalysis(bb))
+            visited[bbID] = true;
+            for (G4_BB* succ : bb->Succs)
             {
-                change = true;
+                addToWorklist(succ);
+            }
+            for (G4_BB_SB* succ : BBVector[bbID]->Succs)
+            {
+                addToWorklist(succ->getBB());
             }
         }
     }
 }
 
-void SWSB::SWSBGlobalSIMDCFGReachAnalysis()
+void SWSB::SWSBGlobalTokenAnalysis()
 {
-    bool change = true;
-    while (change)
+    for (G4_BB_SB* sb_bb : BBVector)
     {
-        change = false;
-        for (G4_BB* bb : fg)
+        sb_bb->killedTokenNodes = BitSet(unsigned(SBSendNodes.size()), false);
+        for (uint32_t token = 0; token < totalTokenNum; token++)
         {
-            if (globalDependenceUseReachAnalysis(bb))
+            if (sb_bb->killedTokens.isSet(token))
             {
-                change = true;
+                sb_bb->killedTokenNodes |= allTokenNodesMap[token];
             }
         }
     }
+
+    solveGlobalDataflow(&SWSB::globalTokenReachAnalysis);
+}
+
+void SWSB::SWSBGlobalScalarCFGReachAnalysis()
+{
+    solveGlobalDataflow(&SWSB::globalDependenceDefReachAnalysis);
+}
+
+void SWSB::SWSBGlobalSIMDCFGReachAnalysis()
+{
+    solveGlobalDataflow(&SWSB::globalDependenceUseReachAnalysis);
 }
 
 void SWSB::setTopTokenIndex()
@@ -3286,7 +3347,7 @@ void SWSB::insertTest()
         BitSet dstTokens(totalTokenNum, false);
         BitSet srcTokens(totalTokenNum, false);
 
-        std::list<G4_INST*>::iterator inst_it(bb->begin()), iInstNext(bb->begin());
+        INST_LIST_ITER inst_it(bb->begin()), iInstNext(bb->begin());
         while (iInstNext != bb->end())
         {
             inst_it = iInstNext;
@@ -3496,6 +3557,7 @@ void SWSB::buildLiveIntervals()
     //For global send nodes
     //According to layout, extend the live range of each send operand to
     //the start of the first live in BB and end of last live out BB
+    std::vector<unsigned> sendOpnds;
     BB_LIST_ITER ib(fg.begin()), bend(fg.end());
     for (; ib != bend; ++ib)
     {
@@ -3510,7 +3572,13 @@ void SWSB::buildLiveIntervals()
             continue;
         }
 
-        for (size_t i = 0; i < globalSendOpndList.size(); i++)
+        SBBitSets liveSends(globalSendNum);
+        liveSends = *send_live_in;
+        liveSends |= *send_live_out;
+        liveSends.dst |= send_live_in_scalar->dst;
+        liveSends.dst |= send_live_out_scalar->dst;
+        getGlobalSendOpnds(liveSends, sendOpnds);
+        for (unsigned i : sendOpnds)
         {
             SBNode* node = globalSendOpndList[i]->node;
             int globalID = node->globalID;
@@ -3925,11 +3993,32 @@ void G4_BB_SB::setSendOpndMayKilled(LiveGRFBuckets* globalSendsLB,
                 SBNode* curLiveNode = liveBN->node;
                 Gen4_Operand_Number liveOpnd = liveBN->opndNum;
                 G4_INST* liveInst = liveBN->inst;
-                const SBFootprint* liveFootprint = curLiveNode->getFootprint(liveBN->opndNum,liveInst);
+
+                //Find DEP type
+                DepType dep = DEPTYPE_MAX;
+                dep = getDepForOpnd(liveOpnd, curOpnd);
+
+                //The global send buckets hold every send of the kernel, only check the overlap
+                //when it may add a kill which is not recorded for the BB yet.
+                bool newKill = false;
+                if (dep == RAW || dep == WAW)
+                {
+                    newKill = !send_may_kill.isDstSet(curLiveNode->globalID) ||
+                        (dep == WAW && !send_WAW_may_kill.isSet(curLiveNode->globalID));
+                }
+                else if (dep == WAR)
+                {
+                    newKill = !send_may_kill.isSrcSet(curLiveNode->globalID);
+                }
+                if (!newKill)
+                {
+                    ++bn_it;
+                    continue;
+                }
 
                 //Send operands are all GRF aligned, there is no overlap checking required.
                 //Fix me, this is not right, for math intruction, less than 1 GRF may happen.
-                //Find DEP type
+                const SBFootprint* liveFootprint = curLiveNode->getFootprint(liveBN->opndNum,liveInst);
                 unsigned short internalOffset = 0;
                 bool hasOverlap = curFootprint->hasOverlap(liveFootprint, internalOffset);
                 if (!hasOverlap)
@@ -3938,9 +4027,6 @@ void G4_BB_SB::setSendOpndMayKilled(LiveGRFBuckets* globalSendsLB,
                     continue;
                 }
 
-                DepType dep = DEPTYPE_MAX;
-                dep = getDepForOpnd(liveOpnd, curOpnd);
-
                 //For SBID global liveness analysis, both explict and implicit kill counted.
                 if (dep == RAW || dep == WAW)
                 {
@@ -4332,7 +4418,7 @@ void G4_BB_SB::SBDDD(G4_BB* bb,
     SBNODE_LIST tmpSBSendNodes;
     bool hasFollowDistOneAReg = false;
 
-    std::list<G4_INST*>::iterator iInst(bb->begin()), iInstEnd(bb->end()), iInstNext(bb->begin());
+    INST_LIST_ITER iInst(bb->begin()), iInstEnd(bb->end()), iInstNext(bb->begin());
     for (; iInst != iInstEnd; ++iInst)
     {
         SBNode* node = nullptr;
@@ -5097,11 +5183,35 @@ void G4_BB_SB::getLiveBucketsFromFootprint(const SBFootprint* firstFootprint, SB
     return;
 }
 
+//Get the indexes into globalSendOpndList of the operands of the global sends set in either dst or src, in list order.
+//The BB scans below only need those operands, walking the whole list per BB is quadratic in the number of sends.
+void SWSB::getGlobalSendOpnds(const SBBitSets& sends, std::vector<unsigned>& opndIndexes) const
+{
+    opndIndexes.clear();
+
+    BitSet globalIDs = sends.dst;
+    globalIDs |= sends.src;
+    for (unsigned id = globalIDs.findFirstSet(); id < globalIDs.getSize(); id = globalIDs.findNextSet(id + 1))
+    {
+        opndIndexes.insert(opndIndexes.end(), globalSendOpndPositions[id].begin(), globalSendOpndPositions[id].end());
+    }
+    std::sort(opndIndexes.begin(), opndIndexes.end());
+}
+
 /*
 * Note that the fall through dependencies are captured in the SBDDD linear scan already
 */
 void SWSB::addGlobalDependence(unsigned globalSendNum, SBBUCKET_VECTOR* globalSendOpndList, SBNODE_VECT* SBNodes, PointsToAnalysis& p, bool afterWrite)
 {
+    //The kill flags are only set on the operands of send_use_kills while scanning a BB,
+    //so clear all of them once, and then only the ones used by the previous BB
+    for (SBBucketNode* sBucketNode : *globalSendOpndList)
+    {
+        sBucketNode->node->setInstKilled(false);
+        sBucketNode->node->setSourceKilled(false);
+    }
+
+    std::vector<unsigned> sendOpnds;
     for (size_t i = 0; i < BBVector.size(); i++)
     {
         //Get global send operands killed by current BB
@@ -5118,8 +5228,15 @@ void SWSB::addGlobalDependence(unsigned globalSendNum, SBBUCKET_VECTOR* globalSe
         //   the order of the operands are scanned is not an issue anymore.
         //   i.e explicit RAW and WAW can cover all other dependences.
         LiveGRFBuckets send_use_kills(mem, kernel.getNumRegTotal(), BBVector[i]->getBB()->getKernel());
-        for (SBBucketNode* sBucketNode : *globalSendOpndList)
+        for (unsigned k : sendOpnds)
         {
+            (*globalSendOpndList)[k]->node->setInstKilled(false);
+            (*globalSendOpndList)[k]->node->setSourceKilled(false);
+        }
+        getGlobalSendOpnds(send_kill, sendOpnds);
+        for (unsigned k : sendOpnds)
+        {
+            SBBucketNode* sBucketNode = (*globalSendOpndList)[k];
             SBNode* sNode = sBucketNode->node;
             if (send_kill.isSrcSet(sNode->globalID) && (sBucketNode->opndNum == Opnd_src0 ||
                 sBucketNode->opndNum == Opnd_src1 ||
@@ -5132,8 +5249,6 @@ void SWSB::addGlobalDependence(unsigned globalSendNum, SBBUCKET_VECTOR* globalSe
             {
                 BBVector[i]->getLiveBucketsFromFootprint(sNode->getFirstFootprint(sBucketNode->opndNum), sBucketNode, &send_use_kills);
             }
-            sNode->setInstKilled(false);
-            sNode->setSourceKilled(false);
         }
 
         if (BBVector[i]->first_node == -1)
@@ -5331,6 +5446,14 @@ void SWSB::addReachingUseSet(SBNode* node, SBNode* use)
 
 void SWSB::addGlobalDependenceWithReachingDef(unsigned globalSendNum, SBBUCKET_VECTOR* globalSendOpndList, SBNODE_VECT* SBNodes, PointsToAnalysis& p, bool afterWrite)
 {
+    //Same as addGlobalDependence, clear the kill flags of all operands once
+    for (SBBucketNode* sBucketNode : *globalSendOpndList)
+    {
+        sBucketNode->node->setInstKilled(false);
+        sBucketNode->node->setSourceKilled(false);
+    }
+
+    std::vector<unsigned> sendOpnds;
     for (size_t i = 0; i < BBVector.size(); i++)
     {
         //Get global send operands killed by current BB
@@ -5356,9 +5479,16 @@ void SWSB::addGlobalDependenceWithReachingDef(unsigned globalSendNum, SBBUCKET_V
         //   the order of the operands are scanned is not an issue anymore.
         //   i.e explicit RAW and WAW can cover all other dependences.
         LiveGRFBuckets send_use_kills(mem, kernel.getNumRegTotal(), BBVector[i]->getBB()->getKernel());
-        for (size_t j = 0; j < globalSendOpndList->size(); j++)
+        for (unsigned k : sendOpnds)
+        {
+            (*globalSendOpndList)[k]->node->setInstKilled(false);
+            (*globalSendOpndList)[k]->node->setSourceKilled(false);
+        }
+        //send_kill and send_live_through split send_live_in
+        getGlobalSendOpnds(BBVector[i]->send_live_in, sendOpnds);
+        for (unsigned k : sendOpnds)
         {
-            SBBucketNode* sBucketNode = (*globalSendOpndList)[j];
+            SBBucketNode* sBucketNode = (*globalSendOpndList)[k];
             SBNode* sNode = sBucketNode->node;
             if (send_kill.isSrcSet(sNode->globalID) && (sBucketNode->opndNum == Opnd_src0 ||
                 sBucketNode->opndNum == Opnd_src1 ||
@@ -5385,8 +5515,6 @@ void SWSB::addGlobalDependenceWithReachingDef(unsigned globalSendNum, SBBUCKET_V
             {
                 send_reach_all.setDst(sNode->getSendID(), true);
             }
-            sNode->setInstKilled(false);
-            sNode->setSourceKilled(false);
         }
 
         if (BBVector[i]->first_node == -1)
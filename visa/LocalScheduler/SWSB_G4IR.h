@@ -225,6 +225,7 @@ namespace vISA
     // Since dependencies may come from dst and src and there may be dependence kill between dst and src depencencies,
     // we use internal bit set to track the live of dst and src seperately.
     // Each bit map to one global SBID node according to the node's global ID.
+    // The sets are dense, so each BB's sets are sized by the number of global sends in the kernel.
     struct SBBitSets {
         BitSet dst;
         BitSet src;
@@ -941,6 +942,7 @@ namespace vISA
         BitSet   liveInTokenNodes;
         BitSet   liveOutTokenNodes;
         BitSet   killedTokens;
+        BitSet   killedTokenNodes;  //Nodes of all killedTokens, refreshed for each token reach analysis
         std::vector<BitSet> tokeNodesMap;
         unsigned    *tokenLiveInDist;
         unsigned    *tokenLiveOutDist;
@@ -1174,12 +1176,15 @@ namespace vISA
         SWSB_INDEXES indexes;         // To pass ALU ID  from previous BB to current.
         uint32_t  globalSendNum = 0;  // The number of out-of-order instructions which generate global dependencies.
         SBBUCKET_VECTOR globalSendOpndList;  //All send operands which live out their instructions' BBs. No redundant.
+        std::vector<std::vector<unsigned>> globalSendOpndPositions;  //Indexes into globalSendOpndList of each global send's operands
         const uint32_t totalTokenNum;
         static constexpr unsigned TOKEN_AFTER_READ_CYCLE = 4;
         const unsigned tokenAfterWriteMathCycle;
         const unsigned tokenAfterWriteSendSlmCycle;
         const unsigned tokenAfterWriteSendMemoryCycle;
         const unsigned tokenAfterWriteSendSamplerCycle;
+        // Upper bound of getDepDelay(), nodes farther apart than this can never stall each other
+        const unsigned maxTokenReuseDelay;
 
         //For profiling
         uint32_t syncInstCount = 0;
@@ -1200,7 +1205,9 @@ namespace vISA
         std::vector<SBNODE_VECT *> reachUseArray;
         SBNODE_VECT localTokenUsage;
 
-        std::vector<const SBNode*> sameTokenNodes[32];
+        //All nodes ever assigned to a token, keyed by BB nest level and then node ID, so that
+        //reuse selection only examines the nodes which can change the decision
+        std::map<unsigned char, std::map<unsigned, const SBNode*>> sameTokenNodes[32];
         int topIndex = -1;
 
         std::map<G4_Label*, G4_BB_SB*> labelToBlockMap;
@@ -1211,6 +1218,7 @@ namespace vISA
         bool globalDependenceDefReachAnalysis(G4_BB* bb);
         bool globalDependenceUseReachAnalysis(G4_BB* bb);
         void addGlobalDependence(unsigned globalSendNum, SBBUCKET_VECTOR *globalSendOpndList, SBNODE_VECT *SBNodes, PointsToAnalysis &p, bool afterWrite);
+        void getGlobalSendOpnds(const SBBitSets& sends, std::vector<unsigned>& opndIndexes) const;
         void tokenEdgePrune(unsigned& prunedEdgeNum, unsigned& prunedGlobalEdgeNum, unsigned& prunedDiffBBEdgeNum, unsigned& prunedDiffBBSameTokenEdgeNum);
         void dumpTokenLiveInfo();
 
@@ -1229,6 +1237,7 @@ namespace vISA
         void addToLiveList(SBNode *node);
 
         void examineNodeForTokenReuse(/* out */ int &reuseDelay, /* out */ int &curDistance, unsigned nodeID, unsigned nodeDelay, const SBNode *curNode, unsigned char nestLoopLevel, unsigned curLoopStartBB, unsigned curLoopEndBB) const;
+        void examineSameTokenNodes(/* out */ int &reuseDelay, /* out */ int &sameTokenDistance, unsigned short token, unsigned nodeID, unsigned nodeDelay, unsigned char nestLoopLevel, unsigned curLoopStartBB, unsigned curLoopEndBB) const;
         SBNode * reuseTokenSelection(const SBNode * node) const;
         unsigned getDepDelay(const SBNode *node) const;
         unsigned short reuseTokenSelectionGlobal(SBNode* node, G4_BB* bb, SBNode*& candidateNode, bool& fromUse);
@@ -1272,6 +1281,7 @@ namespace vISA
         void addSIMDEdge(G4_BB_SB *pred, G4_BB_SB* succ);
         void SWSBGlobalScalarCFGReachAnalysis();
         void SWSBGlobalSIMDCFGReachAnalysis();
+        void solveGlobalDataflow(bool (SWSB::*transfer)(G4_BB*));
 
         void setTopTokenIndex();
 
@@ -1308,7 +1318,9 @@ namespace vISA
                 : (k.fg.builder->isXeLP() ? 65u : 50u)), // TOKEN_AFTER_WRITE_SEND_L1_MEMORY_CYCLE
             tokenAfterWriteSendSamplerCycle(k.fg.builder->getOptions()->getOption(vISA_USEL3HIT)
                 ? (k.fg.builder->isXeLP() ? 175u : 210u) // TOKEN_AFTER_WRITE_SEND_L3_SAMPLER_CYCLE
-                : 60u)                                   // TOKEN_AFTER_WRITE_SEND_L1_SAMPLER_CYCLE
+                : 60u),                                  // TOKEN_AFTER_WRITE_SEND_L1_SAMPLER_CYCLE
+            maxTokenReuseDelay(std::max({TOKEN_AFTER_READ_CYCLE, tokenAfterWriteMathCycle, tokenAfterWriteSendSlmCycle,
+                tokenAfterWriteSendMemoryCycle, tokenAfterWriteSendSamplerCycle}))
         {
             indexes.instIndex = 0;
             indexes.ALUIndex = 0;
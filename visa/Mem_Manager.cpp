@@ -30,8 +30,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Mem_Manager.h"
 using namespace vISA;
-Mem_Manager::Mem_Manager(size_t defaultArenaSize)
-    : _arenaManager (defaultArenaSize)
+Mem_Manager::Mem_Manager(size_t defaultArenaSize, const char* name, ArenaAccounting* accounting)
+    : _arenaManager (defaultArenaSize, name, accounting)
 {
 }
 
@@ -37,7 +37,9 @@ namespace vISA
     class Mem_Manager {
     public:
 
-        Mem_Manager(size_t defaultArenaSize);
+        // name groups the arenas of this manager in the accounting, see ArenaAccounting.
+        Mem_Manager(size_t defaultArenaSize, const char* name = nullptr,
+            ArenaAccounting* accounting = ArenaAccounting::getCurrent());
         ~Mem_Manager();
 
         void* alloc(size_t size)
@@ -29,6 +29,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Timer.h"
 #include "G4_Verifier.hpp"
 #include "LVN.h"
+#include "GVN.h"
 #include "ifcvt.h"
 #include "FlowGraph.h"
 #include "SendFusion.h"
@@ -59,7 +60,7 @@ void Optimizer::LVN()
     // redundancies that got introduced mainly by HW
     // conformity or due to VISA lowering.
     int numInstsRemoved = 0;
-    Mem_Manager mem(1024);
+    Mem_Manager mem(1024, "Optimizer");
     PointsToAnalysis p(kernel.Declares, kernel.fg.getNumBB());
     p.doPointsToAnalysis(kernel.fg);
     for (auto bb : kernel.fg)
@@ -82,6 +83,30 @@ void Optimizer::LVN()
     }
 }
 
+void Optimizer::GVN()
+{
+    // Unlike LVN, reuse values across blocks: an instruction is replaced by an
+    // identical one in a dominating block. Catches redundancies the FE left
+    // behind in different branches of the CFG as well as those exposed by
+    // HW conformity.
+    bool optReport = kernel.getOption(vISA_OptReport);
+    unsigned maxRPBefore = optReport ? ::GVN::computeMaxRP(kernel) : 0;
+
+    ::GVN gvn(kernel);
+    gvn.doGVN();
+
+    if (optReport)
+    {
+        unsigned maxRPAfter = ::GVN::computeMaxRP(kernel);
+        std::ofstream optreport;
+        getOptReportStream(optreport, kernel.getOptions());
+        optreport << "===== GVN =====" << std::endl;
+        optreport << "Number of instructions removed: " << gvn.getNumInstsRemoved() << std::endl;
+        optreport << "Max GRF pressure: " << maxRPBefore << " -> " << maxRPAfter << std::endl << std::endl;
+        closeOptReportStream(optreport);
+    }
+}
+
 // helper functions
 
 static int getDstSubReg(G4_DstRegRegion *dst)
@@ -153,7 +178,7 @@ void Optimizer::insertFallThroughJump()
                 {
                     if ((*next)->front()->getSrc(0) == bb->back()->getSrc(0))
                     {
-                        std::list<G4_INST*>::iterator it = bb->end();
+                        INST_LIST_ITER it = bb->end();
                         it--;
                         bb->erase(it);
                     }
@@ -982,6 +1007,7 @@ void Optimizer::initOptimizations()
     INITIALIZE_PASS(mergeScalarInst,         vISA_MergeScalar,             TimerID::OPTIMIZER);
     INITIALIZE_PASS(lowerMadSequence,        vISA_EnableMACOpt,            TimerID::OPTIMIZER);
     INITIALIZE_PASS(LVN,                     vISA_LVN,                     TimerID::OPTIMIZER);
+    INITIALIZE_PASS(GVN,                     vISA_GVN,                     TimerID::OPTIMIZER);
     INITIALIZE_PASS(ifCvt,                   vISA_ifCvt,                   TimerID::OPTIMIZER);
     INITIALIZE_PASS(dumpPayload,             vISA_dumpPayload,             TimerID::MISC_OPTS);
     INITIALIZE_PASS(normalizeRegion,         vISA_EnableAlways,            TimerID::MISC_OPTS);
@@ -1006,7 +1032,7 @@ void Optimizer::initOptimizations()
     INITIALIZE_PASS(analyzeMove,             vISA_analyzeMove,             TimerID::MISC_OPTS);
     INITIALIZE_PASS(removeInstrinsics,       vISA_removeInstrinsics,       TimerID::MISC_OPTS);
     INITIALIZE_PASS(expandMulPostSchedule,   vISA_expandMulPostSchedule,   TimerID::MISC_OPTS);
-    INITIALIZE_PASS(addSWSBInfo,             vISA_addSWSBInfo,             TimerID::MISC_OPTS);
+    INITIALIZE_PASS(addSWSBInfo,             vISA_addSWSBInfo,             TimerID::SWSB);
 
     // Verify all passes are initialized.
 #ifdef _DEBUG
@@ -1416,6 +1442,9 @@ int Optimizer::optimization()
     // Local Value Numbering
     runPass(PI_LVN);
 
+    // Global Value Numbering
+    runPass(PI_GVN);
+
     // this must be run after copy prop cleans up the moves
     runPass(PI_cleanupBindless);
 
@@ -8582,7 +8611,7 @@ void Optimizer::mergeScalarInst()
         bundleSizeLimit = 8;
     }
 
-    Mem_Manager mergeManager(1024);
+    Mem_Manager mergeManager(1024, "Optimizer");
     // set of declares that have been changed to alias to another declare
     std::unordered_set<G4_Declare*> modifiedDcl;
     std::vector<G4_Declare*> newInputs;
@@ -186,6 +186,8 @@ class Optimizer
 
     void LVN();
 
+    void GVN();
+
     void ifCvt();
 
     void ifCvtFCCall();
@@ -335,6 +337,7 @@ public:
         PI_mergeScalarInst,
         PI_lowerMadSequence,
         PI_LVN,
+        PI_GVN,
         PI_ifCvt,
         PI_normalizeRegion,            // always
         PI_dumpPayload,
@@ -588,6 +588,13 @@ Options::Options() {
     initialize_m_vISAOptions();
 }
 
+Options::Options(const Options& other) : Options() {
+    m_vISAOptions.copyValues(other.m_vISAOptions);
+    target = other.target;
+    argString << other.argString.str();
+    stepping = other.stepping;
+}
+
 Options::~Options() {
     ;
 }
@@ -130,6 +130,9 @@ class Options {
 
 public:
     Options();
+    // Deep copy, used to give a kernel its own option values when several
+    // kernels of one builder are compiled concurrently.
+    Options(const Options& other);
     ~Options();
 
 public:
@@ -425,6 +428,26 @@ private:
             assert(Cstr && "Uninitialized?");
             return Cstr->getVal();
         }
+        // Copy the values of OTHER (but not the defaults) into this DB.
+        void copyValues(const VISAOptionsDB &other) {
+            for (auto &pair : other.optionsMap) {
+                vISAOptions key = pair.first;
+                const VISAOptionsEntry *value = pair.second.value;
+                if (! value) {
+                    setCstr(key, nullptr);
+                } else {
+                    switch (value->getType()) {
+                    case ET_BOOL:  setBool(key, value->val.boolean); break;
+                    case ET_INT32: setUint32(key, value->val.int32); break;
+                    case ET_INT64: setUint64(key, value->val.int64); break;
+                    case ET_CSTR:  setCstr(key, value->val.cstr); break;
+                    default:
+                        assert(0 && "Bad TYPE");
+                    }
+                }
+                optionsMap[key].argIsSet = pair.second.argIsSet;
+            }
+        }
         VISAOptionsDB() {}
         VISAOptionsDB(Options *opt) {
             options = opt;
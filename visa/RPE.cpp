@@ -32,7 +32,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace vISA
 {
-    RPE::RPE(const GlobalRA& g, const LivenessAnalysis* l) : m(1024), gra(g), liveAnalysis(l), live(l->getNumSelectedVar(), false),
+    RPE::RPE(const GlobalRA& g, const LivenessAnalysis* l) : m(1024, "RPE"), gra(g), liveAnalysis(l), live(l->getNumSelectedVar(), false),
         vars(l->vars)
     {
         options = g.kernel.getOptions();
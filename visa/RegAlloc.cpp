@@ -605,7 +605,7 @@ LivenessAnalysis::LivenessAnalysis(
         bool verifyRA,
         bool forceRun) :
         selectedRF(kind),
-        pointsToAnalysis(g.pointsToAnalysis), m(4096), gra(g), fg(g.kernel.fg)
+        pointsToAnalysis(g.pointsToAnalysis), m(4096, "Liveness"), gra(g), fg(g.kernel.fg)
 {
     //
     // NOTE:
@@ -1084,55 +1084,33 @@ void LivenessAnalysis::computeLiveness()
 #endif
     }
 
-    //
-    // backward flow analysis to propagate uses (locate last uses)
-    //
-
-    bool change = true;
-
-    while (change)
+    if (!snapshot)
     {
-        change = false;
-        BB_LIST::iterator rit = fg.end();
-        do
-        {
-            //
-            // use_out = use_in(s1) + use_in(s2) + ...
-            // where s1 s2 ... are the successors of bb
-            // use_in  = use_gen + (use_out - use_kill)
-            //
-            --rit;
-            if (contextFreeUseAnalyze((*rit), change))
-            {
-                change = true;
-            }
-
-        } while (rit != fg.begin());
+        contextFreeAnalyze(inputDefs);
     }
+    else
+    {
+        // def_out holds the defs of each BB at this point
+        std::vector<BitSet> def_gen = def_out;
+        bool verify = fg.builder->getOption(vISA_VerifyIncrementalRA);
+        std::vector<BitSet> initUseIn, initUseOut, initDefIn, initDefOut;
+        if (verify)
+        {
+            initUseIn = use_in;
+            initUseOut = use_out;
+            initDefIn = def_in;
+            initDefOut = def_out;
+        }
 
-    //
-    // forward flow analysis to propagate defs (locate first defs)
-    //
+        bool seeded = seedFromSnapshot(def_gen, inputDefs, outputUses);
+        contextFreeAnalyze(inputDefs);
 
-    //
-    // initialize entry block with payload input
-    //
-    def_in[fg.getEntryBB()->getId()] = inputDefs;
-    change = true;
-    while (change)
-    {
-        change = false;
-        for (auto bb : fg)
+        if (seeded && verify)
         {
-            //
-            // def_in   = def_out(p1) + def_out(p2) + ... where p1 p2 ... are the predecessors of bb
-            // def_out |= def_in
-            //
-            if (contextFreeDefAnalyze(bb, change))
-            {
-                change = true;
-            }
+            verifySeededLiveness(inputDefs, std::move(initUseIn), std::move(initUseOut),
+                std::move(initDefIn), std::move(initDefOut));
         }
+        saveSnapshot(std::move(def_gen), inputDefs, outputUses);
     }
 
 #if 0
@@ -1223,6 +1201,220 @@ void LivenessAnalysis::computeLiveness()
     stopTimer(TimerID::LIVENESS);
 }
 
+//
+// backward flow analysis to propagate uses (locate last uses), followed by
+// forward flow analysis to propagate defs (locate first defs)
+//
+void LivenessAnalysis::contextFreeAnalyze(const BitSet& inputDefs)
+{
+    bool change = true;
+
+    while (change)
+    {
+        change = false;
+        BB_LIST::iterator rit = fg.end();
+        do
+        {
+            //
+            // use_out = use_in(s1) + use_in(s2) + ...
+            // where s1 s2 ... are the successors of bb
+            // use_in  = use_gen + (use_out - use_kill)
+            //
+            --rit;
+            if (contextFreeUseAnalyze((*rit), change))
+            {
+                change = true;
+            }
+
+        } while (rit != fg.begin());
+    }
+
+    //
+    // initialize entry block with payload input
+    //
+    def_in[fg.getEntryBB()->getId()] |= inputDefs;
+    change = true;
+    while (change)
+    {
+        change = false;
+        for (auto bb : fg)
+        {
+            //
+            // def_in   = def_out(p1) + def_out(p2) + ... where p1 p2 ... are the predecessors of bb
+            // def_out |= def_in
+            //
+            if (contextFreeDefAnalyze(bb, change))
+            {
+                change = true;
+            }
+        }
+    }
+}
+
+//
+// Seed use_in/use_out/def_in/def_out with the solution of the previous run.
+//
+// Liveness is a bit-vector problem, so the solution for a variable depends
+// only on its own gen/kill bits. A variable whose gen/kill bits are the same
+// in every BB as in the previous run (e.g., anything not touched by the spill
+// code inserted since then) has the same solution, and seeding the fixpoint
+// with it is exact. Spilled variables and new temporaries start from scratch.
+// Returns false if the snapshot can't be used (e.g., the CFG changed).
+//
+bool LivenessAnalysis::seedFromSnapshot(const std::vector<BitSet>& def_gen,
+    const BitSet& inputDefs, const BitSet& outputUses)
+{
+    if (snapshot->empty() || snapshot->bbs.size() != numBBId)
+    {
+        return false;
+    }
+    for (auto bb : fg)
+    {
+        if (bb->getId() >= numBBId || snapshot->bbs[bb->getId()] != bb)
+        {
+            return false;
+        }
+    }
+
+    // Map the ids of the previous run onto ours. Ids are handed out in
+    // declare order, so the mapping consists of a few runs of consecutive ids.
+    struct IdRun
+    {
+        unsigned newId;
+        unsigned oldId;
+        unsigned count;
+    };
+    std::unordered_map<const G4_RegVar*, unsigned> oldIds;
+    for (unsigned i = 0, e = (unsigned)snapshot->vars.size(); i < e; ++i)
+    {
+        oldIds[snapshot->vars[i]] = i;
+    }
+    std::vector<IdRun> runs;
+    for (unsigned i = 0; i < numVarId; ++i)
+    {
+        auto it = oldIds.find(vars[i]);
+        if (it == oldIds.end())
+        {
+            continue;
+        }
+        if (!runs.empty() &&
+            runs.back().newId + runs.back().count == i &&
+            runs.back().oldId + runs.back().count == it->second)
+        {
+            runs.back().count++;
+        }
+        else
+        {
+            runs.push_back({ i, it->second, 1 });
+        }
+    }
+    if (runs.empty())
+    {
+        return false;
+    }
+
+    auto remap = [this, &runs](const BitSet& old)
+    {
+        BitSet bs(numVarId, false);
+        for (auto&& run : runs)
+        {
+            bs.copyBits(run.newId, old, run.oldId, run.count);
+        }
+        return bs;
+    };
+
+    // A variable is clean if it existed in the previous run and none of its
+    // gen/kill/boundary bits changed.
+    BitSet dirty(numVarId, false);
+    for (auto&& run : runs)
+    {
+        dirty.set(run.newId, run.newId + run.count - 1);
+    }
+    dirty.invert();
+    auto markChanged = [&remap, &dirty](const BitSet& old, const BitSet& cur)
+    {
+        BitSet diff = remap(old);
+        diff ^= cur;
+        dirty |= diff;
+    };
+    markChanged(snapshot->inputDefs, inputDefs);
+    markChanged(snapshot->outputUses, outputUses);
+    for (unsigned i = 0; i < numBBId; ++i)
+    {
+        markChanged(snapshot->use_gen[i], use_gen[i]);
+        markChanged(snapshot->use_kill[i], use_kill[i]);
+        markChanged(snapshot->def_gen[i], def_gen[i]);
+    }
+
+    auto seed = [&remap, &dirty](BitSet& cur, const BitSet& old)
+    {
+        BitSet bs = remap(old);
+        bs -= dirty;
+        cur |= bs;
+    };
+    for (unsigned i = 0; i < numBBId; ++i)
+    {
+        seed(use_in[i], snapshot->use_in[i]);
+        seed(use_out[i], snapshot->use_out[i]);
+        seed(def_in[i], snapshot->def_in[i]);
+        seed(def_out[i], snapshot->def_out[i]);
+    }
+
+    if (fg.builder->getOption(vISA_RATrace))
+    {
+        unsigned numDirty = 0;
+        for (unsigned i = dirty.findFirstSet(); i < numVarId; i = dirty.findNextSet(i + 1))
+        {
+            numDirty++;
+        }
+        std::cout << "\t--incremental liveness: " << numDirty << " of " << numVarId << " variables recomputed\n";
+    }
+
+    return true;
+}
+
+void LivenessAnalysis::saveSnapshot(std::vector<BitSet>&& def_gen, const BitSet& inputDefs, const BitSet& outputUses)
+{
+    snapshot->vars = vars;
+    snapshot->bbs.assign(numBBId, nullptr);
+    for (auto bb : fg)
+    {
+        if (bb->getId() < numBBId)
+        {
+            snapshot->bbs[bb->getId()] = bb;
+        }
+    }
+    snapshot->inputDefs = inputDefs;
+    snapshot->outputUses = outputUses;
+    snapshot->use_gen = use_gen;
+    snapshot->use_kill = use_kill;
+    snapshot->def_gen = std::move(def_gen);
+    snapshot->use_in = use_in;
+    snapshot->use_out = use_out;
+    snapshot->def_in = def_in;
+    snapshot->def_out = def_out;
+}
+
+//
+// -verifyIncrementalRA: recompute the fixpoint from scratch and check that it
+// matches the seeded one.
+//
+void LivenessAnalysis::verifySeededLiveness(const BitSet& inputDefs, std::vector<BitSet>&& initUseIn,
+    std::vector<BitSet>&& initUseOut, std::vector<BitSet>&& initDefIn, std::vector<BitSet>&& initDefOut)
+{
+    // restart from the initial state, the init* vectors get the seeded solution
+    use_in.swap(initUseIn);
+    use_out.swap(initUseOut);
+    def_in.swap(initDefIn);
+    def_out.swap(initDefOut);
+
+    contextFreeAnalyze(inputDefs);
+
+    MUST_BE_TRUE(use_in == initUseIn && use_out == initUseOut &&
+        def_in == initDefIn && def_out == initDefOut,
+        "incremental liveness does not match full recomputation");
+}
+
 //
 // compute the maydef set for every subroutine
 // This includes recursively all the variables that are defined by the
@@ -1291,25 +1483,10 @@ void LivenessAnalysis::useAnalysis(FuncInfo* subroutine)
                 }
             }
 
-            if (changed)
+            bool useInChanged = use_in[bbid].assignOrAndNot(use_gen[bbid], use_out[bbid], use_kill[bbid]);
+            if (!(bb->getBBType() & G4_BB_INIT_TYPE) && useInChanged)
             {
-                // no need to update changed, save a copy
-                use_in[bbid] = use_out[bbid];
-                use_in[bbid] -= use_kill[bbid];
-                use_in[bbid] |= use_gen[bbid];
-            }
-            else
-            {
-                BitSet oldUseIn = use_in[bbid];
-
-                use_in[bbid] = use_out[bbid];
-                use_in[bbid] -= use_kill[bbid];
-                use_in[bbid] |= use_gen[bbid];
-
-                if (!(bb->getBBType() & G4_BB_INIT_TYPE) && oldUseIn != use_in[bbid])
-                {
-                    changed = true;
-                }
+                changed = true;
             }
         }
     } while (changed);
@@ -1358,25 +1535,10 @@ void LivenessAnalysis::useAnalysisWithArgRetVal(FuncInfo* subroutine,
                 }
             }
 
-            if (changed)
-            {
-                // no need to update changed, save a copy
-                use_in[bbid] = use_out[bbid];
-                use_in[bbid] -= use_kill[bbid];
-                use_in[bbid] |= use_gen[bbid];
-            }
-            else
+            bool useInChanged = use_in[bbid].assignOrAndNot(use_gen[bbid], use_out[bbid], use_kill[bbid]);
+            if (!(bb->getBBType() & G4_BB_INIT_TYPE) && useInChanged)
             {
-                BitSet oldUseIn = use_in[bbid];
-
-                use_in[bbid] = use_out[bbid];
-                use_in[bbid] -= use_kill[bbid];
-                use_in[bbid] |= use_gen[bbid];
-
-                if (!(bb->getBBType() & G4_BB_INIT_TYPE) && oldUseIn != use_in[bbid])
-                {
-                    changed = true;
-                }
+                changed = true;
             }
         }
     } while (changed);
@@ -2267,9 +2429,7 @@ bool LivenessAnalysis::contextFreeUseAnalyze(G4_BB* bb, bool isChanged)
     //
     // in = gen + (out - kill)
     //
-    use_in[bbid] = use_out[bbid];
-    use_in[bbid] -= use_kill[bbid];
-    use_in[bbid] |= use_gen[bbid];
+    use_in[bbid].assignOrAndNot(use_gen[bbid], use_out[bbid], use_kill[bbid]);
 
     return changed;
 }
@@ -2478,7 +2638,7 @@ void GlobalRA::markBlockLocalVars()
 {
     for (auto bb : kernel.fg)
     {
-        for (std::list<G4_INST*>::iterator it = bb->begin(); it != bb->end(); it++)
+        for (INST_LIST_ITER it = bb->begin(); it != bb->end(); it++)
         {
             G4_INST* inst = *it;
 
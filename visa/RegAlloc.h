@@ -349,6 +349,30 @@ struct VarRangeListPackage
     VAR_RANGE_LIST list;
 };
 
+//
+// Dataflow solution of a previous LivenessAnalysis run.
+// Every LivenessAnalysis renumbers the variables it tracks, so the snapshot
+// keeps the reg var of each id and its bit vectors are remapped onto the ids
+// of the next run (see LivenessAnalysis::seedFromSnapshot).
+//
+struct LivenessSnapshot
+{
+    std::vector<G4_RegVar*> vars;
+    std::vector<G4_BB*> bbs;
+    BitSet inputDefs;
+    BitSet outputUses;
+    std::vector<BitSet> use_gen;
+    std::vector<BitSet> use_kill;
+    std::vector<BitSet> def_gen;
+    std::vector<BitSet> use_in;
+    std::vector<BitSet> use_out;
+    std::vector<BitSet> def_in;
+    std::vector<BitSet> def_out;
+
+    bool empty() const { return vars.empty(); }
+    void clear() { *this = LivenessSnapshot(); }
+};
+
 class LivenessAnalysis
 {
     unsigned numVarId = 0;         // the var count
@@ -373,6 +397,14 @@ class LivenessAnalysis
 
     bool contextFreeUseAnalyze(G4_BB* bb, bool isChanged);
     bool contextFreeDefAnalyze(G4_BB* bb, bool isChanged);
+    void contextFreeAnalyze(const BitSet& inputDefs);
+
+    // Previous solution used to seed the fixpoint, and updated with the new one.
+    LivenessSnapshot* snapshot = nullptr;
+    bool seedFromSnapshot(const std::vector<BitSet>& def_gen, const BitSet& inputDefs, const BitSet& outputUses);
+    void saveSnapshot(std::vector<BitSet>&& def_gen, const BitSet& inputDefs, const BitSet& outputUses);
+    void verifySeededLiveness(const BitSet& inputDefs, std::vector<BitSet>&& initUseIn,
+        std::vector<BitSet>&& initUseOut, std::vector<BitSet>&& initDefIn, std::vector<BitSet>&& initDefOut);
 
     bool livenessCandidate(const G4_Declare* decl, bool verifyRA) const;
 
@@ -409,6 +441,10 @@ public:
     bool setVarIDs(bool verifyRA, bool areAllPhyRegAssigned);
     LivenessAnalysis(GlobalRA& gra, unsigned char kind, bool verifyRA = false, bool forceRun = false);
     ~LivenessAnalysis();
+    // Incremental mode: seed the context-free fixpoint with the solution in s
+    // for variables whose gen/kill sets did not change, then store the new
+    // solution back into s.
+    void setSnapshot(LivenessSnapshot* s) { snapshot = s; }
     void computeLiveness();
     bool isLiveAtEntry(const G4_BB* bb, unsigned var_id) const;
     bool isLiveAtExit(const G4_BB* bb, unsigned var_id) const;
@@ -0,0 +1,183 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#ifndef _SPARSEBITMATRIX_H_
+#define _SPARSEBITMATRIX_H_
+
+#include "Mem_Manager.h"
+#include "BitSet.h"
+#include <cstdint>
+#include <cstring>
+
+namespace vISA
+{
+// Compact bit matrix for graphs that are too large for a dense n * n matrix
+// (e.g., the interference graph of very large kernels).
+//
+// Each row is a sorted array of chunks, where a chunk is a 64-bit bitmap
+// covering one aligned window of 64 columns. Only windows with at least one
+// bit set are materialized, so a row costs 16 bytes per live window instead
+// of one hash node per bit. Row storage comes from the given Mem_Manager and
+// grows geometrically; abandoned arrays are reclaimed with the arena.
+class SparseBitMatrix
+{
+    struct Chunk
+    {
+        uint32_t index;
+        BITSET_WORD_TYPE bits;
+    };
+
+    struct Row
+    {
+        Chunk* chunks;
+        uint32_t size;
+        uint32_t capacity;
+    };
+
+    static const unsigned BITS_PER_CHUNK = sizeof(BITSET_WORD_TYPE) * 8;
+    static const uint32_t INITIAL_ROW_CAPACITY = 4;
+
+    Mem_Manager& mem;
+    Row* rows;
+    const unsigned numRows;
+    size_t bytesAllocated = 0;
+
+    // Returns the chunk covering the given window in row, inserting an empty
+    // one in sorted position if it does not exist yet.
+    BITSET_WORD_TYPE& getOrInsertChunk(Row& row, uint32_t index)
+    {
+        // Common case: columns are mostly added in increasing order.
+        if (row.size > 0 && row.chunks[row.size - 1].index == index)
+        {
+            return row.chunks[row.size - 1].bits;
+        }
+
+        uint32_t pos = lowerBound(row, index);
+        if (pos < row.size && row.chunks[pos].index == index)
+        {
+            return row.chunks[pos].bits;
+        }
+
+        if (row.size == row.capacity)
+        {
+            uint32_t newCapacity = row.capacity ? row.capacity * 2 : INITIAL_ROW_CAPACITY;
+            size_t newBytes = newCapacity * sizeof(Chunk);
+            Chunk* newChunks = (Chunk*)mem.alloc(newBytes);
+            if (row.size)
+            {
+                memcpy_s(newChunks, newBytes, row.chunks, row.size * sizeof(Chunk));
+            }
+            bytesAllocated += newBytes;
+            row.chunks = newChunks;
+            row.capacity = newCapacity;
+        }
+
+        if (pos < row.size)
+        {
+            std::memmove(&row.chunks[pos + 1], &row.chunks[pos], (row.size - pos) * sizeof(Chunk));
+        }
+        row.chunks[pos].index = index;
+        row.chunks[pos].bits = 0;
+        row.size++;
+        return row.chunks[pos].bits;
+    }
+
+    static uint32_t lowerBound(const Row& row, uint32_t index)
+    {
+        uint32_t lo = 0, hi = row.size;
+        while (lo < hi)
+        {
+            uint32_t mid = (lo + hi) / 2;
+            if (row.chunks[mid].index < index)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+public:
+    SparseBitMatrix(Mem_Manager& m, unsigned n) : mem(m), numRows(n)
+    {
+        size_t rowBytes = (size_t)numRows * sizeof(Row);
+        rows = (Row*)mem.alloc(rowBytes);
+        std::memset(rows, 0, rowBytes);
+        bytesAllocated += rowBytes;
+    }
+
+    void set(unsigned row, unsigned col)
+    {
+        getOrInsertChunk(rows[row], col / BITS_PER_CHUNK) |= (BITSET_WORD_TYPE)1 << (col % BITS_PER_CHUNK);
+    }
+
+    // Set a 32-bit block of columns starting at col, which must be 32-bit aligned.
+    void setBlock(unsigned row, unsigned col, uint32_t block)
+    {
+        if (block != 0)
+        {
+            getOrInsertChunk(rows[row], col / BITS_PER_CHUNK) |= (BITSET_WORD_TYPE)block << (col % BITS_PER_CHUNK);
+        }
+    }
+
+    bool isSet(unsigned row, unsigned col) const
+    {
+        const Row& r = rows[row];
+        uint32_t index = col / BITS_PER_CHUNK;
+        uint32_t pos = lowerBound(r, index);
+        return pos < r.size && r.chunks[pos].index == index &&
+            (r.chunks[pos].bits & ((BITSET_WORD_TYPE)1 << (col % BITS_PER_CHUNK))) != 0;
+    }
+
+    // Invoke f(col) for each set column of row in increasing order.
+    template <typename F>
+    void forEachInRow(unsigned row, F f) const
+    {
+        const Row& r = rows[row];
+        for (uint32_t i = 0; i < r.size; i++)
+        {
+            BITSET_WORD_TYPE bits = r.chunks[i].bits;
+            unsigned base = r.chunks[i].index * BITS_PER_CHUNK;
+            while (bits != 0)
+            {
+                f(base + BitSet::countTrailingZeros(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    unsigned getNumRows() const { return numRows; }
+
+    void *operator new(size_t sz, Mem_Manager &m) { return m.alloc(sz); }
+
+    // Total bytes taken from the Mem_Manager, including abandoned row arrays.
+    size_t getBytesAllocated() const { return bytesAllocated; }
+};
+}
+#endif
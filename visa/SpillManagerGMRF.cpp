@@ -36,6 +36,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <sstream>
 #include <fstream>
 #include <unordered_set>
+#include <unordered_map>
 
 using namespace vISA;
 
@@ -157,7 +158,7 @@ SpillManagerGRF::SpillManagerGRF(
     , doSpillSpaceCompression(enableSpillSpaceCompression)
     , failSafeSpill_(failSafeSpill)
     , spillIntf_(intf)
-    , mem_(1024)
+    , mem_(1024, "Spill")
     , useScratchMsg_(useScratchMsg)
     , avoidDstSrcOverlap_(avoidDstSrcOverlap)
 {
@@ -207,7 +208,7 @@ SpillManagerGRF::SpillManagerGRF(
     , nextSpillOffset_(spillAreaOffset)
     , doSpillSpaceCompression(enableSpillSpaceCompression)
     , failSafeSpill_(false)
-    , mem_(1024)
+    , mem_(1024, "Spill")
     , useScratchMsg_(useScratchMsg)
     , avoidDstSrcOverlap_(avoidDstSrcOverlap)
 {
@@ -4430,9 +4431,10 @@ void GlobalRA::expandSpillNonStackcall(
 
             instIt = bb->insertBefore(instIt, sendInst);
 
-            numRows -= getPayloadSizeGRF(numRows);
-            offset += getPayloadSizeGRF(numRows);
-            rowOffset += getPayloadSizeGRF(numRows);
+            auto payloadSize = getPayloadSizeGRF(numRows);
+            numRows -= payloadSize;
+            offset += payloadSize;
+            rowOffset += payloadSize;
         }
     }
 }
@@ -4559,7 +4561,6 @@ void GlobalRA::expandSpillIntrinsic(G4_BB* bb)
                     expandSpillStackcall(numRows, offset, rowOffset, payload, bb, instIt);
                 }
             }
-            numGRFSpill++;
             instIt = bb->erase(spillIt);
             continue;
         }
@@ -4619,9 +4620,10 @@ void GlobalRA::expandSpillIntrinsic(G4_BB* bb)
 
              instIt = bb->insertBefore(instIt, sendInst);
 
-             numRows -= getPayloadSizeGRF(numRows);
-             offset += getPayloadSizeGRF(numRows);
-             rowOffset += getPayloadSizeGRF(numRows);
+             auto respSize = getPayloadSizeGRF(numRows);
+             numRows -= respSize;
+             offset += respSize;
+             rowOffset += respSize;
          }
      }
  }
@@ -4738,7 +4740,6 @@ void GlobalRA::expandFillIntrinsic(G4_BB* bb)
                     expandFillStackcall(numRows, offset, rowOffset, header, resultRgn, bb, instIt);
                 }
             }
-            numGRFFill++;
             instIt = bb->erase(fillIt);
             continue;
         }
@@ -4747,16 +4748,434 @@ void GlobalRA::expandFillIntrinsic(G4_BB* bb)
 }
 
 
+// Number of sends an expanded spill/fill intrinsic of numRows turns into.
+static unsigned int getNumScratchMsgs(unsigned int numRows, bool isOffBP)
+{
+    unsigned int numMsgs = 0;
+    if (!isOffBP)
+    {
+        while (numRows >= 1)
+        {
+            numRows -= getPayloadSizeGRF(numRows);
+            numMsgs++;
+        }
+    }
+    else
+    {
+        auto numRowsOword = numRows * 2;
+        while (numRowsOword >= 1)
+        {
+            numRowsOword -= getPayloadSizeOword(numRowsOword);
+            numMsgs++;
+        }
+    }
+    return numMsgs;
+}
+
+// Returns the range of GRFs referenced by a direct GRF operand after RA.
+// Operands of alias declares are resolved through their root declare since
+// expansion runs before assignRegForAliasDcl().
+static bool getAssignedGRFRange(G4_Operand* opnd, unsigned& first, unsigned& last,
+    bool* rowAligned = nullptr)
+{
+    if (!opnd || !opnd->isRegRegion() || !opnd->getBase()->isRegVar())
+    {
+        return false;
+    }
+
+    G4_Declare* rootDcl = opnd->getBase()->asRegVar()->getDeclare()->getRootDeclare();
+    G4_RegVar* rootVar = rootDcl->getRegVar();
+    if (!rootVar->isPhyRegAssigned() || !rootVar->getPhyReg()->isGreg())
+    {
+        return false;
+    }
+
+    unsigned start = rootVar->getPhyReg()->asGreg()->getRegNum() * numEltPerGRF<Type_UB>() +
+        rootVar->getPhyRegOff() * rootDcl->getElemSize();
+    first = (start + opnd->getLeftBound()) / numEltPerGRF<Type_UB>();
+    last = (start + opnd->getRightBound()) / numEltPerGRF<Type_UB>();
+    if (rowAligned)
+    {
+        *rowAligned = (start + opnd->getLeftBound()) % numEltPerGRF<Type_UB>() == 0;
+    }
+    return true;
+}
+
+// Post-RA coalescing of spill/fill intrinsics within a BB.
+//
+// Fills reading adjacent scratch rows into adjacent GRFs are hoisted to the
+// earliest of them and spills writing adjacent rows from adjacent GRFs are
+// sunk to the latest, so that a group is lowered as one intrinsic using the
+// widest block messages available and a single header set-up instead of one
+// send (plus header) per original access. Legality is checked against the
+// last read/write position of every GRF and the last spill/fill position of
+// every scratch row, so a fill is never hoisted above a write of its slot or
+// a use of its destination, and a spill is never sunk below a redefinition of
+// its payload or an access to its slot.
+//
+// Returns number of sends eliminated.
+unsigned int GlobalRA::coalesceSpillFillIntrinsics(G4_BB* bb)
+{
+    struct ScratchGroup
+    {
+        INST_LIST_ITER anchor;
+        int pos = 0;
+        bool isSpill = false;
+        G4_Declare* fp = nullptr;
+        unsigned int option = 0;
+        uint32_t storedOffset = 0;
+        uint32_t offStart = 0, offEnd = 0;
+        unsigned regStart = 0, regEnd = 0;
+        unsigned int numMsgs = 0;
+        // instructions folded into anchor
+        std::vector<INST_LIST_ITER> members;
+        // GRFs the expanded access reads besides its payload (header, FP)
+        std::vector<std::pair<unsigned, unsigned>> extraReads;
+    };
+
+    const unsigned numRegs = kernel.getNumRegTotal();
+    std::vector<int> lastRead(numRegs, -1), lastWrite(numRegs, -1);
+    std::unordered_map<uint32_t, int> lastSpill, lastFill;
+    // position of last instruction whose GRF footprint is unknown
+    int barrier = -1;
+
+    std::vector<ScratchGroup> groups;
+    // open groups keyed by first and one-past-last scratch row
+    std::unordered_map<uint32_t, size_t> fillByStart, fillByEnd, spillByStart, spillByEnd;
+
+    auto maxGRFWrite = [&](unsigned first, unsigned last)
+    {
+        int pos = -1;
+        for (unsigned r = first; r <= last && r < numRegs; r++)
+            pos = std::max(pos, lastWrite[r]);
+        return pos;
+    };
+    auto maxGRFAccess = [&](unsigned first, unsigned last)
+    {
+        int pos = maxGRFWrite(first, last);
+        for (unsigned r = first; r <= last && r < numRegs; r++)
+            pos = std::max(pos, lastRead[r]);
+        return pos;
+    };
+    auto maxSlotAccess = [](std::unordered_map<uint32_t, int>& slots, uint32_t start, uint32_t end)
+    {
+        int pos = -1;
+        for (uint32_t off = start; off < end; off++)
+        {
+            auto it = slots.find(off);
+            if (it != slots.end())
+                pos = std::max(pos, it->second);
+        }
+        return pos;
+    };
+    auto extraReadsWritten = [&](const ScratchGroup& g)
+    {
+        int pos = -1;
+        for (auto& range : g.extraReads)
+            pos = std::max(pos, maxGRFWrite(range.first, range.second));
+        return pos;
+    };
+    auto recordRead = [&](unsigned first, unsigned last, int pos)
+    {
+        for (unsigned r = first; r <= last && r < numRegs; r++)
+            lastRead[r] = pos;
+    };
+    auto recordWrite = [&](unsigned first, unsigned last, int pos)
+    {
+        for (unsigned r = first; r <= last && r < numRegs; r++)
+            lastWrite[r] = pos;
+    };
+    auto canMerge = [&](const ScratchGroup& g, const ScratchGroup& next)
+    {
+        if (g.isSpill != next.isSpill || g.fp != next.fp || g.option != next.option || g.pos <= barrier)
+            return false;
+        unsigned int numRows = (g.offEnd - g.offStart) + (next.offEnd - next.offStart);
+        if (numRows > (next.fp ? 4u : 8u))
+            return false;
+        // merging must not need more messages than the two accesses separately
+        return getNumScratchMsgs(numRows, next.fp != nullptr) <= g.numMsgs + next.numMsgs;
+    };
+
+    int pos = 0;
+    for (auto instIt = bb->begin(); instIt != bb->end(); ++instIt, ++pos)
+    {
+        G4_INST* inst = *instIt;
+
+        if (inst->isSpillIntrinsic() || inst->isFillIntrinsic())
+        {
+            bool isSpill = inst->isSpillIntrinsic();
+            G4_Operand* data = isSpill ? inst->getSrc(1) : static_cast<G4_Operand*>(inst->getDst());
+            uint32_t numRows = isSpill ? inst->asSpillIntrinsic()->getNumRows() : inst->asFillIntrinsic()->getNumRows();
+            bool offsetValid = isSpill ? inst->asSpillIntrinsic()->isOffsetValid() : inst->asFillIntrinsic()->isOffsetValid();
+
+            ScratchGroup cur;
+            cur.anchor = instIt;
+            cur.pos = pos;
+            cur.isSpill = isSpill;
+            cur.fp = isSpill ? inst->asSpillIntrinsic()->getFP() : inst->asFillIntrinsic()->getFP();
+            cur.option = inst->getOption();
+            cur.storedOffset = isSpill ? inst->asSpillIntrinsic()->getOffset() : inst->asFillIntrinsic()->getOffset();
+            cur.offStart = cur.storedOffset * (numEltPerGRF<Type_UB>() / HWORD_BYTE_SIZE);
+            cur.offEnd = cur.offStart + numRows;
+            cur.numMsgs = getNumScratchMsgs(numRows, cur.fp != nullptr);
+
+            // Right bound of the payload/destination may be clamped to its
+            // declare size, so the rows accessed are derived from its start.
+            unsigned first = 0, last = 0;
+            bool rowAligned = false;
+            bool candidate = offsetValid && !inst->getPredicate() &&
+                getAssignedGRFRange(data, first, last, &rowAligned) &&
+                rowAligned && first + numRows <= numRegs;
+            cur.regStart = first;
+            cur.regEnd = first + numRows;
+
+            unsigned hdrFirst = 0, hdrLast = 0;
+            if (getAssignedGRFRange(inst->getSrc(0), hdrFirst, hdrLast))
+                cur.extraReads.push_back({ hdrFirst, hdrLast });
+            if (cur.fp)
+            {
+                auto fpVar = cur.fp->getRootDeclare()->getRegVar();
+                if (fpVar->isPhyRegAssigned() && fpVar->getPhyReg()->isGreg())
+                {
+                    unsigned fpReg = fpVar->getPhyReg()->asGreg()->getRegNum();
+                    cur.extraReads.push_back({ fpReg, fpReg });
+                }
+                else
+                {
+                    candidate = false;
+                }
+            }
+            size_t groupId = groups.size();
+            if (candidate && !isSpill)
+            {
+                // hoist this fill to an earlier fill of the neighbouring rows
+                auto tryFill = [&](std::unordered_map<uint32_t, size_t>& map, uint32_t key, bool append)
+                {
+                    auto it = map.find(key);
+                    if (it == map.end())
+                        return false;
+                    ScratchGroup& g = groups[it->second];
+                    if ((append ? g.regEnd != cur.regStart : cur.regEnd != g.regStart) || !canMerge(g, cur))
+                        return false;
+                    if (maxGRFAccess(cur.regStart, cur.regEnd - 1) >= g.pos ||
+                        extraReadsWritten(cur) >= g.pos ||
+                        maxSlotAccess(lastSpill, cur.offStart, cur.offEnd) >= g.pos)
+                        return false;
+                    groupId = it->second;
+                    return true;
+                };
+                if (tryFill(fillByEnd, cur.offStart, true) || tryFill(fillByStart, cur.offEnd, false))
+                {
+                    ScratchGroup& g = groups[groupId];
+                    fillByStart.erase(g.offStart);
+                    fillByEnd.erase(g.offEnd);
+                    if (cur.offStart < g.offStart)
+                    {
+                        g.offStart = cur.offStart;
+                        g.regStart = cur.regStart;
+                        g.storedOffset = cur.storedOffset;
+                    }
+                    else
+                    {
+                        g.offEnd = cur.offEnd;
+                        g.regEnd = cur.regEnd;
+                    }
+                    g.numMsgs += cur.numMsgs;
+                    g.members.push_back(instIt);
+                }
+                else
+                {
+                    groups.push_back(cur);
+                }
+                fillByStart[groups[groupId].offStart] = groupId;
+                fillByEnd[groups[groupId].offEnd] = groupId;
+            }
+            else if (candidate && isSpill)
+            {
+                // sink an earlier spill of the neighbouring rows to this one
+                auto trySpill = [&](std::unordered_map<uint32_t, size_t>& map, uint32_t key, bool append)
+                {
+                    auto it = map.find(key);
+                    if (it == map.end())
+                        return false;
+                    ScratchGroup& g = groups[it->second];
+                    if ((append ? g.regEnd != cur.regStart : cur.regEnd != g.regStart) || !canMerge(g, cur))
+                        return false;
+                    if (maxGRFWrite(g.regStart, g.regEnd - 1) >= g.pos ||
+                        extraReadsWritten(g) >= g.pos ||
+                        maxSlotAccess(lastFill, g.offStart, g.offEnd) >= g.pos ||
+                        maxSlotAccess(lastSpill, g.offStart, g.offEnd) > g.pos)
+                        return false;
+                    groupId = it->second;
+                    return true;
+                };
+                if (trySpill(spillByEnd, cur.offStart, true) || trySpill(spillByStart, cur.offEnd, false))
+                {
+                    ScratchGroup& g = groups[groupId];
+                    spillByStart.erase(g.offStart);
+                    spillByEnd.erase(g.offEnd);
+                    g.members.push_back(g.anchor);
+                    g.anchor = instIt;
+                    g.pos = pos;
+                    if (cur.offStart < g.offStart)
+                    {
+                        g.offStart = cur.offStart;
+                        g.regStart = cur.regStart;
+                        g.storedOffset = cur.storedOffset;
+                    }
+                    else
+                    {
+                        g.offEnd = cur.offEnd;
+                        g.regEnd = cur.regEnd;
+                    }
+                    g.numMsgs += cur.numMsgs;
+                    g.extraReads.insert(g.extraReads.end(), cur.extraReads.begin(), cur.extraReads.end());
+                }
+                else
+                {
+                    groups.push_back(cur);
+                }
+                spillByStart[groups[groupId].offStart] = groupId;
+                spillByEnd[groups[groupId].offEnd] = groupId;
+            }
+
+            if (!candidate)
+            {
+                if (!getAssignedGRFRange(data, first, last))
+                {
+                    barrier = pos;
+                }
+                else if (isSpill)
+                {
+                    recordRead(first, std::max(last, first + numRows - 1), pos);
+                }
+                else
+                {
+                    recordWrite(first, std::max(last, first + numRows - 1), pos);
+                }
+            }
+            else if (isSpill)
+            {
+                // the whole group now reads its payload here
+                const ScratchGroup& g = groups[groupId];
+                recordRead(g.regStart, g.regEnd - 1, pos);
+                for (uint32_t off = g.offStart; off < g.offEnd; off++)
+                    lastSpill[off] = pos;
+            }
+            else
+            {
+                recordWrite(cur.regStart, cur.regEnd - 1, pos);
+            }
+
+            for (auto& range : cur.extraReads)
+                recordRead(range.first, range.second, pos);
+            for (uint32_t off = cur.offStart; off < cur.offEnd; off++)
+                (isSpill ? lastSpill : lastFill)[off] = pos;
+            continue;
+        }
+
+        if (inst->isPseudoKill() || inst->isLifeTimeEnd())
+        {
+            // no code is generated for these
+            continue;
+        }
+
+        if (G4_DstRegRegion* dst = inst->getDst())
+        {
+            unsigned first = 0, last = 0;
+            if (dst->isIndirect())
+                barrier = pos;
+            else if (getAssignedGRFRange(dst, first, last))
+                recordWrite(first, last, pos);
+            else if (dst->isGreg())
+                barrier = pos;
+        }
+        for (unsigned i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+        {
+            G4_Operand* src = inst->getSrc(i);
+            unsigned first = 0, last = 0;
+            if (!src || !src->isSrcRegRegion())
+                continue;
+            if (src->asSrcRegRegion()->isIndirect())
+                barrier = pos;
+            else if (getAssignedGRFRange(src, first, last))
+                recordRead(first, last, pos);
+            else if (src->isGreg())
+                barrier = pos;
+        }
+    }
+
+    unsigned int numSendsRemoved = 0;
+    for (auto& g : groups)
+    {
+        if (g.members.empty())
+        {
+            continue;
+        }
+
+        G4_INST* inst = *g.anchor;
+        uint32_t numRows = g.offEnd - g.offStart;
+        G4_Declare* dataDcl = builder.createHardwiredDeclare(
+            numEltPerGRF<Type_UD>() * numRows, Type_UD, g.regStart, 0);
+        if (g.isSpill)
+        {
+            inst->asSpillIntrinsic()->setNumRows(numRows);
+            inst->asSpillIntrinsic()->setOffset(g.storedOffset);
+            inst->setSrc(builder.createSrc(dataDcl->getRegVar(), 0, 0,
+                builder.getRegionStride1(), Type_UD), 1);
+        }
+        else
+        {
+            inst->asFillIntrinsic()->setNumRows(numRows);
+            inst->asFillIntrinsic()->setOffset(g.storedOffset);
+            inst->setDest(builder.createDst(dataDcl->getRegVar(), 0, 0, 1, Type_UD));
+        }
+
+        for (auto memberIt : g.members)
+        {
+            bb->erase(memberIt);
+        }
+        numSendsRemoved += g.numMsgs - getNumScratchMsgs(numRows, g.fp != nullptr);
+    }
+
+    return numSendsRemoved;
+}
+
 void GlobalRA::expandSpillFillIntrinsics(unsigned int spillSizeInBytes)
 {
     auto globalScratchOffset = kernel.getInt32KernelAttr(Attributes::ATTR_SpillMemOffset);
 
+    // Spill/fill coalescing works on physical registers, so it is skipped
+    // when debug info needs a 1:1 mapping of intrinsics to sends.
+    unsigned int numScratchSendsRemoved = 0;
+    bool coalesceScratchMsgs = kernel.getOption(vISA_ScratchMsgCoalescing) &&
+        !kernel.getOption(vISA_GenerateDebugInfo);
+
     for (auto bb : kernel.fg)
     {
+        // NumGRFSpill/NumGRFFill count the intrinsics RA inserted, so that
+        // they do not change with coalescing; the sends it saves are
+        // reported separately as NumScratchSendsCoalesced
+        for (auto inst : *bb)
+        {
+            if (inst->isSpillIntrinsic())
+            {
+                numGRFSpill++;
+            }
+            else if (inst->isFillIntrinsic())
+            {
+                numGRFFill++;
+            }
+        }
+        if (coalesceScratchMsgs)
+        {
+            numScratchSendsRemoved += coalesceSpillFillIntrinsics(bb);
+        }
         expandSpillIntrinsic(bb);
         expandFillIntrinsic(bb);
     }
     kernel.fg.builder->getcompilerStats().SetI64(CompilerStats::numGRFSpillStr(), numGRFSpill, kernel.getSimdSize());
     kernel.fg.builder->getcompilerStats().SetI64(CompilerStats::numGRFFillStr(), numGRFFill, kernel.getSimdSize());
+    kernel.fg.builder->getcompilerStats().SetI64(CompilerStats::numScratchSendsCoalescedStr(), numScratchSendsRemoved, kernel.getSimdSize());
 
 }
@@ -66,7 +66,7 @@ public:
     using DECLARE_LIST = std::list<G4_Declare *> ;
     using LR_LIST = std::list<LiveRange *>;
     using LSLR_LIST = std::list<LSLiveRange *>;
-    using INST_LIST = std::list<G4_INST *,INST_LIST_NODE_ALLOCATOR>;
+    using INST_LIST = ::INST_LIST;
     typedef struct Edge
     {
         unsigned first;
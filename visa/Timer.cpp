@@ -24,6 +24,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 ======================= end_copyright_notice ==================================*/
 
+#include "Arena.h"
 #include "Option.h"
 #include "Timer.h"
 
@@ -34,6 +35,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Windows.h"
 #endif
 #include <cassert>
+#include <vector>
 
 #undef DEF_TIMER
 #define DEF_TIMER(ENUM, DESCR) DESCR,
@@ -42,8 +44,6 @@ static const char* timerNames[static_cast<int>(TimerID::NUM_TIMERS)] =
     #include "Timer.def"
 };
 
-#ifdef MEASURE_COMPILATION_TIME
-
 #define CLOCK_TYPE CLOCK_MONOTONIC
 
 #if   !defined(_WIN32)
@@ -92,7 +92,6 @@ static const char* timerNames[static_cast<int>(TimerID::NUM_TIMERS)] =
     }
 
 #endif
-#endif // MEASURE_COMPILATION_TIME
 
 
 struct Timer {
@@ -102,15 +101,52 @@ struct Timer {
     LONGLONG ticks;
     bool started;
     unsigned int hits;
+    vISA::ArenaAccounting* arenaAccounting;
+    size_t outerArenaPeak;
 };
 
 static _THREAD Timer timers[static_cast<int>(TimerID::NUM_TIMERS)];
 static _THREAD LARGE_INTEGER proc_freq;
 static _THREAD int numTimers = static_cast<int>(TimerID::NUM_TIMERS);
 
-void initTimer() {
+// Timer events: while enabled on a thread, every completed start/stop
+// interval is also appended to a per-thread log together with the arena
+// high-water mark reached inside it. Unlike the accumulated counters this is
+// available in release builds, so that a client (e.g. IGC's compile trace)
+// can place the vISA phases on its own timeline.
+struct TimerEvent {
+    unsigned int timer;
+    LONGLONG start;
+    LONGLONG stop;
+    size_t arenaPeak;
+};
+
+static _THREAD bool recordTimerEvents = false;
+static thread_local std::vector<TimerEvent> timerEvents;
 
+// Timers that are hit once per instruction would flood the event log; they
+// are still accumulated when MEASURE_COMPILATION_TIME is on.
+static bool isPerInstructionTimer(TimerID ti)
+{
+    return ti == TimerID::VISA_BUILDER_APPEND_INST ||
+        ti == TimerID::VISA_BUILDER_CREATE_VAR ||
+        ti == TimerID::VISA_BUILDER_CREATE_OPND ||
+        ti == TimerID::VISA_BUILDER_IR_CONSTRUCTION ||
+        ti == TimerID::ENCODE_COMPACTION;
+}
+
+// Returns whether start/stop of the given timer has to be tracked at all.
+static bool isTimerActive(TimerID ti)
+{
 #ifdef MEASURE_COMPILATION_TIME
+    return true;
+#else
+    return recordTimerEvents && !isPerInstructionTimer(ti);
+#endif
+}
+
+void initTimer() {
+
     numTimers = 0;
     for (int i = 0; i < static_cast<int>(TimerID::NUM_TIMERS); i++)
     {
@@ -120,10 +156,11 @@ void initTimer() {
         timers[i].ticks = 0;
         timers[i].started = false;
         timers[i].hits = 0;
+        timers[i].arenaAccounting = nullptr;
+        timers[i].outerArenaPeak = 0;
         createNewTimer(timerNames[i]);
     }
     QueryPerformanceFrequency(&proc_freq);
-#endif
 }
 
 void resetPerKernel()
@@ -157,7 +194,10 @@ int createNewTimer(const char* name)
 void startTimer(TimerID timerId)
 {
     int timer = static_cast<int>(timerId);
-#ifdef MEASURE_COMPILATION_TIME
+    if (!isTimerActive(timerId))
+    {
+        return;
+    }
     if (timer < static_cast<int>(TimerID::NUM_TIMERS))
     {
 #if defined(_DEBUG) && defined(CHECK_TIMER)
@@ -175,6 +215,16 @@ void startTimer(TimerID timerId)
 #if defined(_DEBUG) && defined(CHECK_TIMER)
         timers[timer].started = true;
 #endif
+        // windows have to nest, so only open one for timers stopTimer()
+        // closes again
+        if (recordTimerEvents && !isPerInstructionTimer(timerId))
+        {
+            // the window is on the accounting of the compilation running on
+            // this thread; outside of one there is no arena peak to report
+            auto accounting = vISA::ArenaAccounting::getCurrent();
+            timers[timer].arenaAccounting = accounting;
+            timers[timer].outerArenaPeak = accounting ? accounting->beginPeakWindow() : 0;
+        }
     }
     else
     {
@@ -183,17 +233,30 @@ void startTimer(TimerID timerId)
         std::cerr << "Invalid index used when invoking startTimer\n";
 #endif
     }
-#endif
 }
 
 void stopTimer(TimerID timerId)
 {
     int timer = static_cast<int>(timerId);
-#ifdef MEASURE_COMPILATION_TIME
+    if (!isTimerActive(timerId))
+    {
+        return;
+    }
     if (timer < static_cast<int>(TimerID::NUM_TIMERS))
     {
         LARGE_INTEGER stop;
         QueryPerformanceCounter(&stop);
+        if (recordTimerEvents && timers[timer].currentStart != 0 && !isPerInstructionTimer(timerId))
+        {
+            TimerEvent event;
+            event.timer = timer;
+            event.start = timers[timer].currentStart;
+            event.stop = stop.QuadPart;
+            auto accounting = timers[timer].arenaAccounting;
+            event.arenaPeak = accounting ? accounting->endPeakWindow(timers[timer].outerArenaPeak) : 0;
+            timers[timer].arenaAccounting = nullptr;
+            timerEvents.push_back(event);
+        }
         timers[timer].time += (stop.QuadPart - timers[timer].currentStart) / (double)proc_freq.QuadPart;
         timers[timer].ticks += (stop.QuadPart - timers[timer].currentStart);
         timers[timer].currentStart = 0;
@@ -208,7 +271,6 @@ void stopTimer(TimerID timerId)
         std::cerr << "Invalid index used when invoking stopTimer\n";
 #endif
     }
-#endif
 }
 
 extern "C" unsigned int getTotalTimers()
@@ -231,6 +293,42 @@ extern "C" unsigned int getTimerHits(unsigned int idx)
     return timers[idx].hits;
 }
 
+extern "C" const char* getTimerName(unsigned int idx)
+{
+    return timerNames[idx];
+}
+
+// Enable or disable timer event recording on the calling thread.
+extern "C" void setTimerEventRecording(bool enable)
+{
+    recordTimerEvents = enable;
+}
+
+extern "C" unsigned int getTimerEventCount()
+{
+    return (unsigned int)timerEvents.size();
+}
+
+// Return the idx-th recorded event of the calling thread. Times are in
+// microseconds of the monotonic clock (QueryPerformanceCounter on Windows,
+// CLOCK_MONOTONIC elsewhere), i.e. the same clock as std::chrono::steady_clock.
+extern "C" void getTimerEvent(
+    unsigned int idx, unsigned int* timerIdx, uint64_t* startUS, uint64_t* endUS, uint64_t* arenaPeakBytes)
+{
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    const TimerEvent& event = timerEvents[idx];
+    *timerIdx = event.timer;
+    *startUS = (uint64_t)(event.start * 1000000.0 / freq.QuadPart);
+    *endUS = (uint64_t)(event.stop * 1000000.0 / freq.QuadPart);
+    *arenaPeakBytes = event.arenaPeak;
+}
+
+extern "C" void clearTimerEvents()
+{
+    timerEvents.clear();
+}
+
 // static double getTimerUS(unsigned int idx)
 // {
 //     return (timers[idx].ticks * 1000000) / (double)proc_freq.QuadPart;
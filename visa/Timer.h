@@ -71,11 +71,7 @@ struct TimerScope {
     ~TimerScope() {stopTimer(timerId);}
 };
 
-#if defined(MEASURE_COMPILATION_TIME)
 #define  TIME_SCOPE(TIMER_ID) TimerScope __timerScope(TimerID::TIMER_ID);
-#else
-#define  TIME_SCOPE(TIMER_ID)
-#endif
 
 #undef DEF_TIMER
 
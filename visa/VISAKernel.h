@@ -63,7 +63,7 @@ class VISAKernelImpl : public VISAFunction
 
 public:
     VISAKernelImpl(enum VISA_BUILD_TYPE type, CISA_IR_Builder* cisaBuilder, const char* name)
-        : m_mem(4096), m_CISABuilder(cisaBuilder), m_options(cisaBuilder->getOptions())
+        : m_mem(4096, "VISAKernel", &m_arenaAccounting), m_CISABuilder(cisaBuilder), m_options(cisaBuilder->getOptions())
     {
         mBuildOption = m_CISABuilder->getBuilderOption();
         m_magic_number = COMMON_ISA_MAGIC_NUM;
@@ -119,6 +119,7 @@ public:
         mIsFCCallableKernel = false;
         mIsFCCallerKernel = false;
         mIsFCComposableKernel = false;
+        m_privateOptions = nullptr;
 
         // Initialize first level scope of the map
         m_GenNamedVarMap.emplace_back();
@@ -765,6 +766,12 @@ public:
 
     int compileFastPath();
 
+    // Give this kernel its own copy of the builder's options and its own
+    // critical message stream, so that it can be compiled concurrently
+    // with the other kernels of the builder.
+    void prepareForConcurrentCompile();
+    std::string getCriticalMsg() const { return m_criticalMsg.str(); }
+
     unsigned int m_magic_number;
     unsigned char m_major_version;
     unsigned char m_minor_version;
@@ -886,6 +893,7 @@ private:
     int calculateTotalInputSize();
     int compileTillOptimize();
     void recordFinalizerInfo();
+    void recordArenaStats();
 
     // Re-adjust indirect call target after swsb
     void adjustIndirectCallOffset();
@@ -945,6 +953,8 @@ private:
     enum VISA_BUILD_TYPE m_type;
     unsigned int m_resolvedIndex;
 
+    // All memory of this kernel is charged here, so it must outlive every Mem_Manager below
+    vISA::ArenaAccounting m_arenaAccounting;
     vISA::Mem_Manager m_mem;
     std::string m_name;
     std::string m_asmName;
@@ -1034,6 +1044,9 @@ private:
     void computeFCInfo();
     //memory managed by the entity that creates vISA Kernel object
     Options *m_options;
+    // owned copy of the builder's options, see prepareForConcurrentCompile()
+    Options *m_privateOptions;
+    std::stringstream m_criticalMsg;
 
     void createKernelAttributes() {
         void* pmem = m_mem.alloc(sizeof(vISA::Attributes));
@@ -169,6 +169,7 @@ int VISAKernelImpl::compileFastPath()
         return status;
     }
 
+    ArenaAccountingScope arenaScope(&m_arenaAccounting);
     IR_Builder& builder = *m_builder;
     builder.predefinedVarRegAssignment((uint8_t)m_inputSize);
     builder.expandPredefinedVars();
@@ -374,6 +375,7 @@ void VISAKernelImpl::compilePostOptimize()
 
 void* VISAKernelImpl::encodeAndEmit(unsigned int& binarySize)
 {
+    ArenaAccountingScope arenaScope(&m_arenaAccounting);
     void* binary = NULL;
 
     //
@@ -522,10 +524,36 @@ void* VISAKernelImpl::encodeAndEmit(unsigned int& binarySize)
     }
 
     recordFinalizerInfo();
+    recordArenaStats();
 
     return binary;
 }
 
+// Report the memory held by this kernel's arenas: the high-water mark and what is
+// still held after emission, in total and for each named arena.
+void VISAKernelImpl::recordArenaStats()
+{
+    int simd = m_kernel->getSimdSize();
+    const ArenaUsage& total = m_arenaAccounting.getTotal();
+    m_compilerStats.SetI64(CompilerStats::arenaPeakBytesStr(), total.peakReserved, simd);
+    m_compilerStats.SetI64(CompilerStats::arenaReservedBytesStr(), total.reserved, simd);
+    m_compilerStats.SetI64(CompilerStats::arenaUsedBytesStr(), total.used, simd);
+    if (m_arenaAccounting.isOverBudget())
+    {
+        m_compilerStats.SetFlag(CompilerStats::arenaOverBudgetStr(), simd);
+    }
+
+    m_arenaAccounting.forEachArena([&](const std::string& name, const ArenaUsage& usage)
+    {
+        std::string peakStr = std::string(CompilerStats::arenaPeakBytesStr()) + "." + name;
+        std::string usedStr = std::string(CompilerStats::arenaUsedBytesStr()) + "." + name;
+        m_compilerStats.Init(peakStr, CompilerStats::type_int64, simd);
+        m_compilerStats.Init(usedStr, CompilerStats::type_int64, simd);
+        m_compilerStats.SetI64(peakStr, usage.peakReserved, simd);
+        m_compilerStats.SetI64(usedStr, usage.used, simd);
+    });
+}
+
 void VISAKernelImpl::recordFinalizerInfo()
 {
     if (m_builder->getJitInfo())
@@ -537,7 +565,9 @@ void VISAKernelImpl::recordFinalizerInfo()
 
 int VISAKernelImpl::InitializeFastPath()
 {
-    m_kernelMem = new vISA::Mem_Manager(4096);
+    ArenaAccountingScope arenaScope(&m_arenaAccounting);
+    m_arenaAccounting.setBudget(size_t(m_options->getuInt32Option(vISA_ArenaBudgetMB)) << 20);
+    m_kernelMem = new vISA::Mem_Manager(4096, "Kernel");
 
     m_kernel = new (m_mem) G4_Kernel(
         m_instListNodeAllocator,
@@ -575,6 +605,22 @@ int VISAKernelImpl::InitializeFastPath()
     return VISA_SUCCESS;
 }
 
+void VISAKernelImpl::prepareForConcurrentCompile()
+{
+    // Passes may update options while compiling (and kernel attributes like
+    // OutputAsmPath are recorded there), so the builder-wide copy cannot be
+    // shared between threads.
+    m_privateOptions = new Options(*m_options);
+    m_options = m_privateOptions;
+    if (m_kernelAttrs->isKernelAttrSet(Attributes::ATTR_OutputAsmPath))
+    {
+        m_options->setOptionInternally(VISA_AsmFileName, m_asmName.c_str());
+    }
+    m_kernel->setOptions(m_options);
+    m_builder->setOptions(m_options);
+    m_builder->setLocalCriticalMsgStream(&m_criticalMsg);
+}
+
 void VISAKernelImpl::CopyVars(VISAKernelImpl* from)
 {
     m_builder->dclpool.getDeclareList() = from->m_builder->dclpool.getDeclareList();
@@ -603,8 +649,14 @@ void VISAKernelImpl::initCompilerStats()
 {
     m_compilerStats.Init(CompilerStats::numGRFSpillStr(), CompilerStats::type_int64);
     m_compilerStats.Init(CompilerStats::numGRFFillStr(), CompilerStats::type_int64);
+    m_compilerStats.Init(CompilerStats::numScratchSendsCoalescedStr(), CompilerStats::type_int64);
     m_compilerStats.Init(CompilerStats::numSendStr(), CompilerStats::type_int64);
     m_compilerStats.Init(CompilerStats::numCyclesStr(), CompilerStats::type_int64);
+    m_compilerStats.Init(CompilerStats::numGlobalSchedCyclesSavedStr(), CompilerStats::type_int64);
+    m_compilerStats.Init(CompilerStats::arenaPeakBytesStr(), CompilerStats::type_int64);
+    m_compilerStats.Init(CompilerStats::arenaReservedBytesStr(), CompilerStats::type_int64);
+    m_compilerStats.Init(CompilerStats::arenaUsedBytesStr(), CompilerStats::type_int64);
+    m_compilerStats.Init(CompilerStats::arenaOverBudgetStr(), CompilerStats::type_bool);
 #if COMPILER_STATS_ENABLE
     m_compilerStats.Init("PreRASchedulerForPressure", CompilerStats::type_bool);
     m_compilerStats.Init("PreRASchedulerForLatency", CompilerStats::type_bool);
@@ -7847,6 +7899,7 @@ VISAKernelImpl::~VISAKernelImpl()
         delete m_kernelMem;
     }
 
+    delete m_privateOptions;
     destroyKernelAttributes();
 }
 
@@ -40,6 +40,7 @@ bool disassemble(
     setOptBit(dopts.decoder_opts,
         IGA_DECODING_OPT_NATIVE,
         opts.useNativeEncoder);
+    dopts.decoder_threads = opts.decodeThreads;
     try {
         auto r = ctx.disassembleToString(inp.data(), inp.size(), dopts);
         for (auto &w : r.warnings) {
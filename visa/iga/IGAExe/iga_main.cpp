@@ -26,7 +26,10 @@ IN THE SOFTWARE.
 #include "opts.hpp"
 
 #include <iomanip>
+#include <map>
+#include <memory>
 #include <sstream>
+#include <thread>
 #include <tuple>
 
 
@@ -133,6 +136,27 @@ extern "C" int iga_main(int argc, const char **argv)
             }
         });
 
+    cmdline.defineOpt(
+        "j",
+        "jobs",
+        "INT",
+        "decodes large kernels on this many threads",
+        "Disassembly splits each kernel into runs of instructions and "
+        "decodes the runs in parallel.  The threads are kept across all "
+        "input files.  If given as a flag -j, then one thread per hardware "
+        "thread is used.  This has no effect with -Xnative.",
+        opts::OptAttrs::ALLOW_UNSET|opts::OptAttrs::OPT_FLAG_VAL,
+        [] (const char *cinp, const opts::ErrorHandler &eh, Opts &baseOpts) {
+            if (cinp == nullptr) {
+                baseOpts.decodeThreads = std::thread::hardware_concurrency();
+            } else {
+                int threads = eh.parseInt(cinp);
+                if (threads < 0)
+                    eh("thread count must be non-negative");
+                baseOpts.decodeThreads = (uint32_t)std::max(threads, 0);
+            }
+        });
+
     ///////////////////////////////////////////// abt. the 80 col limit in desc
     std::vector<igax::PlatformInfo> platforms;
     std::string platformExtendedDescription;
@@ -581,6 +605,10 @@ extern "C" int iga_main(int argc, const char **argv)
             fatalExitWithMessage("at least one file required");
         }
 
+        // contexts are kept per platform so that what they cache across
+        // calls (e.g. the -j decoder threads) is reused between files
+        std::map<iga_gen_t,std::unique_ptr<igax::Context>> contexts;
+
         // iterate each file and process it
         for (auto &inpFile : baseOpts.inputFiles) {
             if (inpFile != IGA_STDIN_FILENAME &&
@@ -591,11 +619,14 @@ extern "C" int iga_main(int argc, const char **argv)
 
             struct Opts opts = optsForFile(inpFile);
             try {
-                igax::Context ctx(opts.platform);
+                auto &ctx = contexts[opts.platform];
+                if (!ctx) {
+                    ctx.reset(new igax::Context(opts.platform));
+                }
                 if (opts.mode == Opts::Mode::DIS) {
-                    hasError |= !disassemble(opts, ctx, inpFile);
+                    hasError |= !disassemble(opts, *ctx, inpFile);
                 } else if (opts.mode == Opts::Mode::ASM) {
-                    hasError |= !assemble(opts, ctx, inpFile);
+                    hasError |= !assemble(opts, *ctx, inpFile);
                 } else {
                     fatalExitWithMessage(
                         inpFile,
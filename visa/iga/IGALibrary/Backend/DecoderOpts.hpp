@@ -26,12 +26,18 @@ IN THE SOFTWARE.
 #define IGA_BACKEND_DECODER_OPTS
 namespace iga
 {
+class DecoderPool;
+
 struct DecoderOpts
 {
     bool useNumericLabels;
+    // if set, the GED decoder splits large kernels into runs of
+    // instructions and decodes those on the pool's threads
+    DecoderPool *pool;
 
-    DecoderOpts(bool _useNumericLabels = false)
+    DecoderOpts(bool _useNumericLabels = false, DecoderPool *_pool = nullptr)
         : useNumericLabels(_useNumericLabels)
+        , pool(_pool)
     {
     }
 };
@@ -34,14 +34,22 @@ IN THE SOFTWARE.
 #include "../../IR/SWSBSetter.hpp"
 #include "../../MemManager/MemManager.hpp"
 
-#include <sstream>
+#include "DecoderPool.hpp"
+
+#include <algorithm>
 #include <cstring>
+#include <memory>
+#include <sstream>
 
 
 
 // Used to label expressions that need to be removed once GED is fixed
 #define GED_WORKAROUND(X) (X)
 
+// instructions per job when decoding on a DecoderPool; kernels no larger
+// than one run are decoded serially
+static const size_t PARALLEL_DECODE_RUN = 256;
+
 using namespace ::iga;
 
 DEFINE_GED_SOURCE_ACCESSORS_01(GED_ADDR_MODE, AddrMode)
@@ -190,11 +198,21 @@ Kernel *Decoder::decodeKernel(
     // insts.reserve(binarySize / 8 + 1);
 
     // Pass 1. decode them all into Instruction objects
-    decodeInstructions(
-        *kernel,
-        binary,
-        binarySize,
-        insts);
+    if (m_pool && m_pool->threads() > 1 &&
+        binarySize > PARALLEL_DECODE_RUN * UNCOMPACTED_SIZE)
+    {
+        decodeInstructionsParallel(
+            *kernel,
+            binary,
+            binarySize,
+            insts);
+    } else {
+        decodeInstructions(
+            *kernel,
+            binary,
+            binarySize,
+            insts);
+    }
 
     if (numericLabels) {
         Block *block = kernel->createBlock();
@@ -204,14 +222,14 @@ Kernel *Decoder::decodeKernel(
         }
         kernel->appendBlock(block);
     } else {
-        auto blockStarts = Block::inferBlocks(
+        auto blocks = Block::inferBlocks(
             errorHandler(),
             kernel->getMemManager(),
             insts);
         int id = 1;
-        for (auto bitr : blockStarts) {
-            bitr.second->setID(id++);
-            kernel->appendBlock(bitr.second);
+        for (Block *block : blocks) {
+            block->setID(id++);
+            kernel->appendBlock(block);
         }
     }
     return kernel;
@@ -300,57 +318,7 @@ void Decoder::decodeInstructions(
             warningT("unexpected padding at end of kernel");
             break;
         }
-        memset(&m_currGedInst, 0, sizeof(m_currGedInst));
-        GED_RETURN_VALUE status =
-            GED_DecodeIns(m_gedModel, binary, (uint32_t)binarySize, &m_currGedInst);
-        Instruction *inst = nullptr;
-        if (status == GED_RETURN_VALUE_NO_COMPACT_FORM) {
-            errorT("error decoding instruction (no compacted form)");
-            inst = createErrorInstruction(
-                kernel,
-                "unable to decompact",
-                binary,
-                iLen);
-            // fall through: GED can sort of decode some things here
-        } else if (status != GED_RETURN_VALUE_SUCCESS) {
-            errorT("error decoding instruction");
-            inst = createErrorInstruction(
-                kernel,
-                "GED error decoding instruction",
-                binary,
-                iLen);
-        } else {
-            const auto gedOp = GED_GetOpcode(&m_currGedInst);
-            const Op op = translate(gedOp);
-            m_opSpec = decodeOpSpec(op);
-            if (!m_opSpec->isValid()) {
-                // figure out if we failed to resolve the primary op
-                // or if it's an unmapped subfunction (e.g. math function)
-                auto os = m_model.lookupOpSpec(op);
-                std::stringstream ss;
-                ss << "0x" << std::hex << (unsigned)op <<
-                    ": unsupported opcode on this platform";
-                std::string str = ss.str();
-                errorT(str);
-                inst = createErrorInstruction(
-                    kernel,
-                    str.c_str(),
-                    binary,
-                    iLen);
-            } else {
-                m_subfunc = decodeSubfunction();
-                try {
-                    inst = decodeNextInstruction(kernel);
-                } catch (const FatalError &fe) {
-                    // error is already logged
-                    inst = createErrorInstruction(
-                        kernel,
-                        fe.what(),
-                        binary,
-                        iLen);
-                }
-            }
-        }
+        Instruction *inst = decodeInstruction(kernel, binary, binarySize, iLen);
         inst->setPC(currentPc());
         inst->setID(nextId++);
         inst->setLoc(currentPc());
@@ -367,6 +335,205 @@ void Decoder::decodeInstructions(
     }
 }
 
+// Pass 1 on the decoder pool.
+//
+// An instruction's length only depends on its compaction control bit, so
+// one cheap serial scan finds every instruction boundary.  The instructions
+// are then decoded in fixed-size runs, each run by its own Decoder with its
+// own diagnostics, into a flat array.  Worker threads allocate from
+// scratch kernels whose arenas the result kernel adopts afterwards.
+void Decoder::decodeInstructionsParallel(
+    Kernel &kernel,
+    const void *binaryStart,
+    size_t binarySize,
+    InstList &insts)
+{
+    restart();
+
+    std::vector<int32_t> instPcs;
+    instPcs.reserve(binarySize / UNCOMPACTED_SIZE + 1);
+    bool trailingPadding = false;
+    int32_t bytesLeft = (int32_t)binarySize;
+    while (bytesLeft > 0)
+    {
+        if (bytesLeft < 4) {
+            trailingPadding = true;
+            break;
+        }
+        int32_t iLen = getBitField(COMPACTION_CONTROL,1) != 0 ?
+            COMPACTED_SIZE :
+            UNCOMPACTED_SIZE;
+        if (bytesLeft < iLen) {
+            trailingPadding = true;
+            break;
+        }
+        instPcs.push_back(currentPc());
+        advancePc(iLen);
+        bytesLeft -= iLen;
+    }
+    const int32_t endPc = currentPc();
+    // the end PC bounds the last instruction
+    instPcs.push_back(endPc);
+
+    const size_t numInsts = instPcs.size() - 1;
+    const size_t numRuns =
+        (numInsts + PARALLEL_DECODE_RUN - 1) / PARALLEL_DECODE_RUN;
+    std::vector<Instruction *> decoded(numInsts, nullptr);
+    std::vector<ErrorHandler> runDiagnostics(numRuns);
+    std::vector<std::unique_ptr<Kernel>> scratch(m_pool->threads());
+    for (auto &k : scratch) {
+        k.reset(new Kernel(m_model));
+    }
+
+    m_pool->run(numRuns, [&](size_t run, unsigned thread) {
+        size_t first = run * PARALLEL_DECODE_RUN;
+        size_t last = std::min(first + PARALLEL_DECODE_RUN, numInsts);
+        Decoder runDecoder(m_model, runDiagnostics[run]);
+        runDecoder.setSWSBEncodingMode(m_SWSBEncodeMode);
+        try {
+            runDecoder.decodeInstructionRange(
+                *scratch[thread],
+                binaryStart,
+                binarySize,
+                instPcs,
+                first,
+                last,
+                decoded.data());
+        } catch (const FatalError &) {
+            // error is already logged; the instructions not decoded
+            // become error instructions below
+        }
+    });
+
+    // the scratch kernels own no blocks, so handing over their arenas
+    // is all it takes to keep the instructions alive
+    for (auto &k : scratch) {
+        kernel.getMemManager().adopt(k->getMemManager());
+    }
+
+    // report diagnostics in the order a serial decode would have
+    for (const ErrorHandler &eh : runDiagnostics) {
+        for (const Diagnostic &d : eh.getWarnings()) {
+            errorHandler().reportWarning(d.at, d.message);
+        }
+        for (const Diagnostic &d : eh.getErrors()) {
+            errorHandler().reportError(d.at, d.message);
+        }
+    }
+
+    const unsigned char *binary = (const unsigned char *)binaryStart;
+    for (size_t i = 0; i < numInsts; i++) {
+        Instruction *inst = decoded[i];
+        if (inst == nullptr) {
+            int32_t pc = instPcs[i];
+            inst = createErrorInstruction(
+                kernel,
+                "instruction not decoded",
+                binary + pc,
+                instPcs[i + 1] - pc);
+            inst->setPC(pc);
+            inst->setID((int)i + 1);
+            inst->setLoc(pc);
+        }
+        insts.emplace_back(inst);
+    }
+
+    setPc(endPc);
+    if (trailingPadding) {
+        warningT("unexpected padding at end of kernel");
+    }
+}
+
+void Decoder::decodeInstructionRange(
+    Kernel &kernel,
+    const void *binaryStart,
+    size_t binarySize,
+    const std::vector<int32_t> &instPcs,
+    size_t first,
+    size_t last,
+    Instruction **insts)
+{
+    m_binary = binaryStart;
+    const unsigned char *binary = (const unsigned char *)binaryStart;
+    for (size_t i = first; i < last; i++) {
+        int32_t pc = instPcs[i];
+        int32_t iLen = instPcs[i + 1] - pc;
+        setPc(pc);
+        Instruction *inst =
+            decodeInstruction(kernel, binary + pc, binarySize, iLen);
+        inst->setPC(pc);
+        inst->setID((int)i + 1);
+        inst->setLoc(pc);
+        insts[i] = inst;
+#if _DEBUG
+        if (!errorHandler().hasErrors()) {
+            // only validate if there weren't errors
+            inst->validate();
+        }
+#endif
+    }
+}
+
+Instruction *Decoder::decodeInstruction(
+    Kernel &kernel,
+    const unsigned char *binary,
+    size_t binarySize,
+    int32_t iLen)
+{
+    memset(&m_currGedInst, 0, sizeof(m_currGedInst));
+    GED_RETURN_VALUE status =
+        GED_DecodeIns(m_gedModel, binary, (uint32_t)binarySize, &m_currGedInst);
+    Instruction *inst = nullptr;
+    if (status == GED_RETURN_VALUE_NO_COMPACT_FORM) {
+        errorT("error decoding instruction (no compacted form)");
+        inst = createErrorInstruction(
+            kernel,
+            "unable to decompact",
+            binary,
+            iLen);
+        // fall through: GED can sort of decode some things here
+    } else if (status != GED_RETURN_VALUE_SUCCESS) {
+        errorT("error decoding instruction");
+        inst = createErrorInstruction(
+            kernel,
+            "GED error decoding instruction",
+            binary,
+            iLen);
+    } else {
+        const auto gedOp = GED_GetOpcode(&m_currGedInst);
+        const Op op = translate(gedOp);
+        m_opSpec = decodeOpSpec(op);
+        if (!m_opSpec->isValid()) {
+            // figure out if we failed to resolve the primary op
+            // or if it's an unmapped subfunction (e.g. math function)
+            auto os = m_model.lookupOpSpec(op);
+            std::stringstream ss;
+            ss << "0x" << std::hex << (unsigned)op <<
+                ": unsupported opcode on this platform";
+            std::string str = ss.str();
+            errorT(str);
+            inst = createErrorInstruction(
+                kernel,
+                str.c_str(),
+                binary,
+                iLen);
+        } else {
+            m_subfunc = decodeSubfunction();
+            try {
+                inst = decodeNextInstruction(kernel);
+            } catch (const FatalError &fe) {
+                // error is already logged
+                inst = createErrorInstruction(
+                    kernel,
+                    fe.what(),
+                    binary,
+                    iLen);
+            }
+        }
+    }
+    return inst;
+}
+
 void Decoder::decodeNextInstructionEpilog(Instruction *inst)
 {
     decodeSWSB(inst);
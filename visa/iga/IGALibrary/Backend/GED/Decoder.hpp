@@ -29,6 +29,8 @@ IN THE SOFTWARE.
 #include "GEDToIGATranslation.hpp"
 #include "ged.h"
 
+#include <vector>
+
 
 #define GED_DECODE_TO(FIELD, TRANS, DST) \
     do { \
@@ -115,6 +117,8 @@ namespace iga
         Type      type = Type::INVALID;
     };
 
+    class DecoderPool;
+
     class Decoder : public GEDBitProcessor
     {
     public:
@@ -138,6 +142,10 @@ namespace iga
             }
         }
 
+        // Decode large kernels in parallel on this pool (nullptr decodes
+        // serially); the pool must outlive the decode calls
+        void setDecoderPool(DecoderPool *pool) {m_pool = pool;}
+
         bool isMacro() const;
 
     private:
@@ -152,6 +160,29 @@ namespace iga
             const void *binary,
             size_t binarySize,
             InstList &insts);
+        // pass 1 on m_pool: finds instruction boundaries from the
+        // compaction bits and decodes fixed-size runs on worker threads
+        void decodeInstructionsParallel(
+            Kernel &kernel,
+            const void *binary,
+            size_t binarySize,
+            InstList &insts);
+        // decodes instructions [first, last) of a boundary list
+        // into insts[first, last)
+        void decodeInstructionRange(
+            Kernel &kernel,
+            const void *binary,
+            size_t binarySize,
+            const std::vector<int32_t> &instPcs,
+            size_t first,
+            size_t last,
+            Instruction **insts);
+        // decodes the instruction at the current PC
+        Instruction *decodeInstruction(
+            Kernel &kernel,
+            const unsigned char *bits,
+            size_t binarySize,
+            int32_t iLen);
         const OpSpec *decodeOpSpec(Op op);
 
         Instruction *decodeNextInstruction(Kernel &kernel);
@@ -415,6 +446,9 @@ namespace iga
         // SWSB encoding mode
         SWSB_ENCODE_MODE m_SWSBEncodeMode = SWSB_ENCODE_MODE::SWSBInvalidMode;
 
+        // worker threads for decodeInstructionsParallel (optional)
+        DecoderPool                  *m_pool = nullptr;
+
         // for GED workarounds: grab specific bits from the current instruction
         uint32_t getBitField(int ix, int len) const;
 
@@ -0,0 +1,113 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (c) 2017-2021 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom
+the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+
+============================= end_copyright_notice ===========================*/
+
+
+#include "DecoderPool.hpp"
+
+using namespace iga;
+
+
+DecoderPool::DecoderPool(unsigned threads)
+    : m_nextJob(0)
+{
+    for (unsigned t = 1; t < threads; t++) {
+        m_workers.emplace_back(&DecoderPool::workerLoop, this, t);
+    }
+}
+
+DecoderPool::~DecoderPool()
+{
+    {
+        std::lock_guard<std::mutex> lk(m_lock);
+        m_exit = true;
+    }
+    m_wake.notify_all();
+    for (auto &w : m_workers) {
+        w.join();
+    }
+}
+
+void DecoderPool::drain(const Job &job, size_t jobs, unsigned thread)
+{
+    for (size_t ix = m_nextJob++; ix < jobs; ix = m_nextJob++) {
+        job(ix, thread);
+    }
+}
+
+void DecoderPool::workerLoop(unsigned thread)
+{
+    uint64_t lastBatch = 0;
+    std::unique_lock<std::mutex> lk(m_lock);
+    for (;;) {
+        m_wake.wait(lk, [&] {return m_exit || m_batch != lastBatch;});
+        if (m_exit) {
+            return;
+        }
+        // copy the batch while holding the lock; run() cannot replace it
+        // until we are no longer busy
+        lastBatch = m_batch;
+        const Job *job = m_job;
+        size_t jobs = m_jobs;
+        if (job == nullptr) {
+            // woke up after run() already returned
+            continue;
+        }
+        m_busy++;
+
+        lk.unlock();
+        drain(*job, jobs, thread);
+        lk.lock();
+
+        if (--m_busy == 0) {
+            m_done.notify_all();
+        }
+    }
+}
+
+void DecoderPool::run(size_t jobs, const Job &job)
+{
+    if (m_workers.empty() || jobs <= 1) {
+        for (size_t ix = 0; ix < jobs; ix++) {
+            job(ix, 0);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lk(m_lock);
+        m_job = &job;
+        m_jobs = jobs;
+        m_nextJob = 0;
+        m_batch++;
+    }
+    m_wake.notify_all();
+
+    drain(job, jobs, 0);
+
+    // workers that wake up late find the batch exhausted and go back to
+    // sleep; we only need to wait for the ones still inside a job
+    std::unique_lock<std::mutex> lk(m_lock);
+    m_done.wait(lk, [&] {return m_busy == 0;});
+    m_job = nullptr;
+    m_jobs = 0;
+}
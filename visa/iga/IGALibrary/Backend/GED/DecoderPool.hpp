@@ -0,0 +1,84 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (c) 2017-2021 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom
+the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+IN THE SOFTWARE.
+
+============================= end_copyright_notice ===========================*/
+
+
+#ifndef _IGA_BACKEND_GED_DECODERPOOL_HPP_
+#define _IGA_BACKEND_GED_DECODERPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iga
+{
+    // A fixed set of worker threads the GED decoder hands runs of
+    // instructions to.  The pool is meant to outlive a single decode
+    // (e.g. one per iga_context_t) so that tools disassembling many
+    // kernels only pay for thread creation once.
+    class DecoderPool
+    {
+    public:
+        // a job gets its index and the index of the thread running it;
+        // thread indices are in [0, threads()) and the calling thread of
+        // run() is always thread 0
+        typedef std::function<void(size_t,unsigned)> Job;
+
+        explicit DecoderPool(unsigned threads);
+        ~DecoderPool();
+
+        unsigned threads() const {return (unsigned)m_workers.size() + 1;}
+
+        // runs job(0) ... job(jobs - 1) across the pool and the calling
+        // thread; returns once all of them have finished
+        void run(size_t jobs, const Job &job);
+
+    private:
+        std::vector<std::thread>      m_workers;
+        std::mutex                    m_lock;
+        std::condition_variable       m_wake;
+        std::condition_variable       m_done;
+
+        // the current batch; written under m_lock by run() only while
+        // no worker is busy
+        const Job                    *m_job = nullptr;
+        size_t                        m_jobs = 0;
+        std::atomic<size_t>           m_nextJob;
+        uint64_t                      m_batch = 0;
+        unsigned                      m_busy = 0;
+        bool                          m_exit = false;
+
+        void workerLoop(unsigned thread);
+        void drain(const Job &job, size_t jobs, unsigned thread);
+
+        DecoderPool(const DecoderPool &) = delete;
+        DecoderPool& operator=(const DecoderPool &) = delete;
+    }; // class DecoderPool
+} // namespace iga
+
+#endif // _IGA_BACKEND_GED_DECODERPOOL_HPP_
@@ -71,6 +71,7 @@ Kernel *iga::ged::Decode(
     Kernel *k = nullptr;
     try {
         iga::Decoder decoder(m, eh);
+        decoder.setDecoderPool(dopts.pool);
         k = dopts.useNumericLabels ?
             decoder.decodeKernelNumeric(bits, bitsLen) :
             decoder.decodeKernelBlocks(bits, bitsLen);
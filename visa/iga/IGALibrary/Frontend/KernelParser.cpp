@@ -3158,14 +3158,14 @@ Kernel *iga::ParseGenKernel(
     }
 
     auto &insts = h.getInsts();
-    auto blockStarts = Block::inferBlocks(
+    auto blocks = Block::inferBlocks(
         e,
         k->getMemManager(),
         insts);
     int id = 1;
-    for (auto bitr : blockStarts) {
-        bitr.second->setID(id++);
-        k->appendBlock(bitr.second);
+    for (Block *block : blocks) {
+        block->setID(id++);
+        k->appendBlock(block);
     }
 
 #if 0
@@ -30,7 +30,7 @@ IN THE SOFTWARE.
 #include "Block.hpp"
 #include "Instruction.hpp"
 
-#include <set>
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
@@ -41,8 +41,11 @@ struct BlockInference
 {
     MemManager *allocator;
 
-    std::map<int32_t, Block *> &blockStarts;
-    std::set<int32_t>           instStarts;
+    // block start PCs in ascending order and the block at each
+    std::vector<int32_t>        blockStarts;
+    std::vector<Block *>       &blocks;
+    // instruction start PCs in ascending order
+    std::vector<int32_t>        instStarts;
 
     struct ResolvedTarget {
         Loc     loc; // instruction location
@@ -53,18 +56,37 @@ struct BlockInference
     };
     std::vector<ResolvedTarget> resolved;
 
-    BlockInference(std::map<int32_t, Block *> &bs, MemManager *a)
-        : allocator(a), blockStarts(bs) { }
+    BlockInference(std::vector<Block *> &bs, MemManager *a)
+        : allocator(a), blocks(bs) { }
 
+    // only valid for PCs collected by the first pass of run()
     Block *getBlock(int32_t pc) {
-        auto itr = blockStarts.find(pc);
-        if (itr == blockStarts.end()) {
-            Block *blk      = new (allocator) Block(pc);
-            blockStarts[pc] = blk;
-            return blk;
-        } else {
-            return itr->second;
-        }
+        auto itr = std::lower_bound(blockStarts.begin(), blockStarts.end(), pc);
+        IGA_ASSERT(itr != blockStarts.end() && *itr == pc,
+            "BlockInference: block start not collected");
+        return blocks[itr - blockStarts.begin()];
+    }
+
+    static bool isLabel(const Instruction *inst, int srcIx, int32_t pc,
+        int32_t &targetPc)
+    {
+        const Operand &src = inst->getSource(srcIx);
+        if (src.getKind() != Operand::Kind::LABEL)
+            return false;
+        targetPc = src.getImmediateValue().s32;
+        if (!inst->getOpSpec().isJipAbsolute())
+            targetPc += pc;
+        return true;
+    }
+
+    static bool endsBlock(const Instruction *inst) {
+        // all branching instructions can redirect to next instruction;
+        // also treat EOT as the end of a BB
+        return inst->getOpSpec().isBranching() || inst->isMovWithLabel() ||
+            inst->hasInstOpt(InstOpt::EOT);
+    }
+    static bool hasLabels(const Instruction *inst) {
+        return inst->getOpSpec().isBranching() || inst->isMovWithLabel();
     }
 
     void replaceNumericLabel(
@@ -75,12 +97,10 @@ struct BlockInference
         Instruction *inst,
         int srcIx)
     {
-        Operand &src = inst->getSource(srcIx);
-        if (src.getKind() == Operand::Kind::LABEL)
+        int32_t targetPc;
+        if (isLabel(inst, srcIx, pc, targetPc))
         {
-            int32_t targetPc = src.getImmediateValue().s32;
-            if (!inst->getOpSpec().isJipAbsolute())
-                targetPc += pc;
+            Operand &src = inst->getSource(srcIx);
             if (targetPc < 0 || targetPc > (int32_t)binaryLength) {
                 std::stringstream ss;
                 ss << "src" << srcIx << " targets";
@@ -102,17 +122,48 @@ struct BlockInference
 
     void run(ErrorHandler &errHandler, int32_t binaryLength, InstList &insts)
     {
+        // collect every block start first; sorting a vector once is much
+        // cheaper than keeping a map ordered while we discover them
+        //
         // define start block to ensure at least one block exists
-        (void)getBlock(0);
+        blockStarts.push_back(0);
+        instStarts.reserve(insts.size());
 
         int32_t pc = 0;
         for (Instruction *inst : insts) {
-            instStarts.insert(inst->getPC());
+            instStarts.push_back(inst->getPC());
             int32_t instLen = inst->hasInstOpt(InstOpt::COMPACTED) ? 8 : 16;
-            if (inst->getOpSpec().isBranching() || inst->isMovWithLabel()) {
-                // all branching instructions can redirect to next instruction
+            if (endsBlock(inst)) {
                 // start a new block after this one
-                (void)getBlock(pc + instLen);
+                blockStarts.push_back(pc + instLen);
+            }
+            if (hasLabels(inst)) {
+                int32_t targetPc;
+                if (isLabel(inst, 0, pc, targetPc))
+                    blockStarts.push_back(targetPc);
+                if (inst->getSourceCount() > 1 &&
+                    isLabel(inst, 1, pc, targetPc))
+                {
+                    blockStarts.push_back(targetPc);
+                }
+            }
+            pc += instLen;
+        }
+        std::sort(blockStarts.begin(), blockStarts.end());
+        blockStarts.erase(
+            std::unique(blockStarts.begin(), blockStarts.end()),
+            blockStarts.end());
+        blocks.reserve(blockStarts.size());
+        for (int32_t blockPc : blockStarts) {
+            blocks.push_back(new (allocator) Block(blockPc));
+        }
+        std::sort(instStarts.begin(), instStarts.end());
+
+        // now that the blocks exist, bind the label operands
+        pc = 0;
+        for (Instruction *inst : insts) {
+            int32_t instLen = inst->hasInstOpt(InstOpt::COMPACTED) ? 8 : 16;
+            if (hasLabels(inst)) {
                 // replace src0
                 replaceNumericLabel(
                     errHandler,
@@ -131,24 +182,20 @@ struct BlockInference
                         inst,
                         1);
                 }
-            } else if (inst->hasInstOpt(InstOpt::EOT)) {
-                // also treat EOT as the end of a BB
-                (void)getBlock(pc + instLen);
             }
             pc += instLen;
         }
 
         // for each block, we need to append the following instructions
         pc               = 0;
-        auto bitr        = blockStarts.begin();
-        Block *currBlock = bitr->second;
-        bitr++;
+        size_t nextBlock = 1;
+        Block *currBlock = blocks[0];
 
         for (Instruction *inst : insts) {
             int32_t instLen = inst->hasInstOpt(InstOpt::COMPACTED) ? 8 : 16;
-            if (bitr != blockStarts.end() && pc >= bitr->first) {
-                currBlock = bitr->second;
-                bitr++;
+            if (nextBlock < blocks.size() && pc >= blockStarts[nextBlock]) {
+                currBlock = blocks[nextBlock];
+                nextBlock++;
             }
 
             currBlock->appendInstruction(inst);
@@ -158,7 +205,8 @@ struct BlockInference
 
         for (const ResolvedTarget &rt : resolved) {
             if (rt.targetPc != binaryLength && // EOF is also a valid target
-                instStarts.find(rt.targetPc) == instStarts.end())
+                !std::binary_search(
+                    instStarts.begin(), instStarts.end(), rt.targetPc))
             {
                 std::stringstream ss;
                 ss << "src" << rt.srcIx <<
@@ -208,13 +256,13 @@ static void traceOperand(const Operand &op) {
 }
 #endif
 
-std::map<int32_t, Block *> Block::inferBlocks(
+std::vector<Block *> Block::inferBlocks(
     ErrorHandler &errHandler,
     MemManager &mem,
     InstList &insts)
 {
-    std::map<int32_t, Block *> blockStarts;
-    BlockInference bi(blockStarts, &mem);
+    std::vector<Block *> blocks;
+    BlockInference bi(blocks, &mem);
     int32_t binaryLength = 0;
     if (!insts.empty()) {
         Instruction *i = insts.back();
@@ -224,12 +272,12 @@ std::map<int32_t, Block *> Block::inferBlocks(
     bi.run(errHandler, binaryLength, insts);
 
 #ifdef DEBUG_TRACE_ENABLED
-    for (auto bitr : blockStarts) {
-        auto instList = bitr.second->getInstList();
+    for (Block *b : blocks) {
+        auto instList = b->getInstList();
         DEBUG_TRACE(
             "BLOCK %5d (%d) => %d instrs   \n",
-            (int)bitr.first,
-            (int)bitr.second->getOffset(),
+            (int)b->getPC(),
+            (int)b->getOffset(),
             (int)instList.size());
         for (auto inst : instList) {
             DEBUG_TRACE(
@@ -248,7 +296,7 @@ std::map<int32_t, Block *> Block::inferBlocks(
     }
 #endif
 
-    return blockStarts;
+    return blocks;
 }
 
 void Block::insertInstBefore(
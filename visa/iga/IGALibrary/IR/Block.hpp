@@ -34,8 +34,8 @@ IN THE SOFTWARE.
 #include "../ErrorHandler.hpp"
 #include "Instruction.hpp"
 
-#include <map>
 #include <list>
+#include <vector>
 
 namespace iga
 {
@@ -82,7 +82,8 @@ namespace iga
 
         // infers the control flow graph
         // sets the Block* within these instructions
-        static std::map<int32_t,Block*> inferBlocks(
+        // returns the blocks in PC order
+        static std::vector<Block*> inferBlocks(
             ErrorHandler &errHandler,
             MemManager& mem,
             InstList &insts);
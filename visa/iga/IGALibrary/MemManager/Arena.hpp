@@ -190,6 +190,22 @@ private:
 
     void FreeArenas();
 
+    // appends other's arenas behind ours (so we keep allocating from our
+    // current arena) and leaves other empty
+    void AdoptArenas(ArenaManager &other)
+    {
+        if (other._arenas == NULL) {
+            return;
+        }
+        ArenaHeader *tail = other._arenas;
+        while (tail->_nextArena != NULL) {
+            tail = tail->_nextArena;
+        }
+        tail->_nextArena = _arenas->_nextArena;
+        _arenas->_nextArena = other._arenas;
+        other._arenas = NULL;
+    }
+
     // Data
 
     ArenaHeader  *_arenas;
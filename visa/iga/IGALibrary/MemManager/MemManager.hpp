@@ -44,6 +44,13 @@ public:
         return _arenaManager.AllocDataSpace(size);
     }
 
+    // takes ownership of everything allocated from other; other must not
+    // be used for allocation afterwards
+    void adopt(MemManager &other)
+    {
+        _arenaManager.AdoptArenas(other._arenaManager);
+    }
+
 private:
     ArenaManager   _arenaManager;
 
@@ -22,8 +22,8 @@ IN THE SOFTWARE.
 
 ============================= end_copyright_notice ===========================*/
 
-#ifndef _TIMER_H_
-#define _TIMER_H_
+#ifndef _IGA_TIMER_HPP_
+#define _IGA_TIMER_HPP_
 
 // Enable this macro by default but comment out calls that print out timer info.
 // Requirement by 3d team.
@@ -26,6 +26,7 @@ IN THE SOFTWARE.
 #include "igad.h"
 #include "iga.hpp"
 // IGA headers
+#include "../Backend/GED/DecoderPool.hpp"
 #include "../Backend/GED/Interface.hpp"
 #include "../Backend/Native/Interface.hpp"
 #include "../ErrorHandler.hpp"
@@ -43,6 +44,7 @@ IN THE SOFTWARE.
 #include <algorithm>
 #include <cstring>
 #include <map>
+#include <memory>
 #include <ostream>
 #include <sstream>
 #include <unordered_map>
@@ -239,6 +241,20 @@ private:
     // diagnostics from the last compile
     bool                            m_errorsValid, m_warningsValid;
     std::vector<iga_diagnostic_t>   m_errors, m_warnings;
+
+    // worker threads for decoding; kept across disassemble calls so
+    // callers disassembling many kernels only start them once
+    std::unique_ptr<DecoderPool>    m_decoderPool;
+
+    DecoderPool *decoderPool(uint32_t threads) {
+        if (threads <= 1) {
+            return nullptr;
+        }
+        if (!m_decoderPool || m_decoderPool->threads() != threads) {
+            m_decoderPool.reset(new DecoderPool(threads));
+        }
+        return m_decoderPool.get();
+    }
 public:
     static void clearDiagnostics(std::vector<iga_diagnostic_t> &api_ds) {
         for (auto &d : api_ds) {
@@ -499,7 +515,8 @@ public:
         k = nullptr;
         checkForLegacyFields(dopts, errHandler);
         DecoderOpts dopts2(
-            (dopts.formatting_opts & IGA_FORMATTING_OPT_NUMERIC_LABELS) != 0);
+            (dopts.formatting_opts & IGA_FORMATTING_OPT_NUMERIC_LABELS) != 0,
+            decoderPool(dopts.decoder_threads));
         if ((dopts.decoder_opts & IGA_DECODING_OPT_NATIVE) == 0) {
             if (!iga::ged::IsDecodeSupported(m_model,dopts2)) {
                 return IGA_UNSUPPORTED_PLATFORM;
@@ -400,11 +400,13 @@ typedef struct {
     uint32_t     _reserved0; /* use formatting_opts; set this to 0! */
     uint32_t     _reserved1; /* use formatting_opts; set this to 0! */
     uint32_t     decoder_opts; /* opts for the decoding phase */
+    uint32_t     decoder_threads; /* threads to decode large kernels on;
+                                   * 0 or 1 decodes serially (GED only) */
     /* ... future fields (ensure total size is a multiple of 8;
      * add "reserved" if needed) ... */
 } iga_disassemble_options_t;
 
-static_assert(sizeof(iga_disassemble_options_t) == 5*4,
+static_assert(sizeof(iga_disassemble_options_t) == 6*4,
     "wrong size for iga_disassemble_options_t");
 
 /* A default value for iga_disassemble_options_t */
@@ -413,7 +415,8 @@ static_assert(sizeof(iga_disassemble_options_t) == 5*4,
      IGA_FORMATTING_OPTS_DEFAULT, \
      0, /* _reserved0 */ \
      0,  /* _reserved1 */ \
-     IGA_DECODING_OPTS_DEFAULT, /* decoder_opts */ }
+     IGA_DECODING_OPTS_DEFAULT, /* decoder_opts */ \
+     0, /* decoder_threads */ }
 
 /* A default value for iga_disassemble_options_t that enables numeric labels */
 #define IGA_DISASSEMBLE_OPTIONS_INIT_NUMERIC_LABELS() \
@@ -421,7 +424,8 @@ static_assert(sizeof(iga_disassemble_options_t) == 5*4,
      IGA_FORMATTING_OPTS_DEFAULT|IGA_FORMATTING_OPT_NUMERIC_LABELS, \
      0, /* _reserved0 */ \
      0, /* _reserved1 */ \
-     IGA_DECODING_OPTS_DEFAULT, /* decoder_opts */ }
+     IGA_DECODING_OPTS_DEFAULT, /* decoder_opts */ \
+     0, /* decoder_threads */ }
 
 /*
  * options for the formatting phase (the syntax emitted / printed)
@@ -33,6 +33,7 @@ IN THE SOFTWARE.
 #include "../Frontend/Formatter.hpp"
 #include "../strings.hpp"
 
+#include <map>
 #include <mutex>
 #include <sstream>
 
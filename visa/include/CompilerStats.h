@@ -109,7 +109,13 @@ public:
     static constexpr const char* numSendStr() { return "NumSendInst"; };
     static constexpr const char* numGRFSpillStr() { return "NumGRFSpill"; };
     static constexpr const char* numGRFFillStr() { return "NumGRFFill"; };
+    static constexpr const char* numScratchSendsCoalescedStr() { return "NumScratchSendsCoalesced"; };
     static constexpr const char* numCyclesStr() { return "NumCycles"; };
+    static constexpr const char* numGlobalSchedCyclesSavedStr() { return "NumGlobalSchedCyclesSaved"; };
+    static constexpr const char* arenaPeakBytesStr() { return "ArenaPeakBytes"; };
+    static constexpr const char* arenaReservedBytesStr() { return "ArenaReservedBytes"; };
+    static constexpr const char* arenaUsedBytesStr() { return "ArenaUsedBytes"; };
+    static constexpr const char* arenaOverBudgetStr() { return "ArenaOverBudget"; };
 
 
     // Statistic collection is disabled by default.
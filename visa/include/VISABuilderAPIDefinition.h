@@ -846,6 +846,10 @@ public:
     VISA_BUILDER_API virtual int SetPrevKernel(VISAKernel*& prevKernel) = 0;
     VISA_BUILDER_API virtual int AddFunction(VISAFunction *& function, const char* functionName) = 0;
     VISA_BUILDER_API virtual int AddPayloadSection(VISAFunction *& function, const char* functionName) = 0;
+    /// Compile -- compile all kernels and functions added to this builder.
+    /// If vISA_NumCompileThreads (-j) is greater than 1 and the builder holds only
+    /// kernels, the kernels are compiled concurrently on that many threads; the
+    /// results are the same as compiling each kernel in a builder of its own.
     VISA_BUILDER_API virtual int Compile(const char * isaFileNameint, std::ostream* os = nullptr, bool emit_visa_only = false) = 0;
 
     VISA_BUILDER_API virtual void SetOption(vISAOptions option, bool val) = 0;
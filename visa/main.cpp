@@ -68,6 +68,19 @@ void parseWrapper(const char *fileName, int argc, const char *argv[], Options &o
 #define JIT_INVALID_PLATFORM            5
 
 #ifndef DLL_MODE
+// name given by -outputCisaBinaryName, or empty for the default output name
+static std::string getOutputBinaryName(CISA_IR_Builder* cisa_builder)
+{
+    std::string binFileName;
+    if (cisa_builder->m_options.getOption(vISA_OutputvISABinaryName))
+    {
+        const char* cisaBinaryName = NULL;
+        cisa_builder->m_options.getOption(vISA_GetvISABinaryName, cisaBinaryName);
+        binFileName = cisaBinaryName;
+    }
+    return binFileName;
+}
+
 void parse(const char *fileName, std::string testName, int argc, const char *argv[], Options &opt)
 {
     // read in common isa binary file
@@ -132,15 +145,62 @@ void parse(const char *fileName, std::string testName, int argc, const char *arg
 
     vector<VISAKernel*> kernels;
     readIsaBinaryNG(isafilebuf, cisa_builder, kernels, NULL, COMMON_ISA_MAJOR_VER, COMMON_ISA_MINOR_VER);
-    std::string binFileName;
+    std::string binFileName = getOutputBinaryName(cisa_builder);
 
-    if (cisa_builder->m_options.getOption(vISA_OutputvISABinaryName))
+    int result = cisa_builder->Compile((char*)binFileName.c_str());
+    CISA_IR_Builder::DestroyBuilder(cisa_builder);
+    if (result != VISA_SUCCESS)
     {
-        const char* cisaBinaryName = NULL;
-        cisa_builder->m_options.getOption(vISA_GetvISABinaryName, cisaBinaryName);
-        binFileName = cisaBinaryName;
+        exit(1);
+    }
+}
+#endif
+
+#ifndef DLL_MODE
+// Read all .isa inputs into one builder, so that their kernels are compiled
+// together on the builder's -j threads.
+void parseBatch(const std::list<std::string>& fileNames, int argc, const char *argv[])
+{
+    TARGET_PLATFORM platform = getGenxPlatform();
+    VISA_BUILDER_OPTION builderOption =
+        (platform == GENX_NONE) ? VISA_BUILDER_VISA : VISA_BUILDER_BOTH;
+    CISA_IR_Builder* cisa_builder = NULL;
+
+    CISA_IR_Builder::CreateBuilder(cisa_builder, vISA_DEFAULT, builderOption, platform, argc, argv);
+    MUST_BE_TRUE(cisa_builder, "cisa_builder is NULL.");
+
+    // the kernels refer to the input buffers until they are compiled
+    vISA::Mem_Manager mem(KERNEL_MEM_SIZE);
+    vector<VISAKernel*> kernels;
+    for (auto& fileName : fileNames)
+    {
+        FILE* isafile = fopen(fileName.c_str(), "rb");
+        if (!isafile)
+        {
+            fprintf(stderr, "Cannot open file %s\n", fileName.c_str());
+            exit(1);
+        }
+        fseek(isafile, 0, SEEK_END);
+        long isafilesize = ftell(isafile);
+        rewind(isafile);
+
+        char* isafilebuf = (char*)mem.alloc(isafilesize);
+        if (isafilesize != fread(isafilebuf, 1, isafilesize, isafile))
+        {
+            cerr << "Unable to read entire file into buffer." << endl;
+            exit(EXIT_FAILURE);
+        }
+        fclose(isafile);
+
+        if (!readIsaBinaryNG(isafilebuf, cisa_builder, kernels, NULL, COMMON_ISA_MAJOR_VER, COMMON_ISA_MINOR_VER))
+        {
+            fprintf(stderr, "Cannot read vISA binary %s\n", fileName.c_str());
+            exit(1);
+        }
     }
 
+    std::string binFileName = getOutputBinaryName(cisa_builder);
+
     int result = cisa_builder->Compile((char*)binFileName.c_str());
     CISA_IR_Builder::DestroyBuilder(cisa_builder);
     if (result != VISA_SUCCESS)
@@ -387,15 +447,22 @@ int main(int argc, const char *argv[])
         fileName[numChars] = '\0';
     }
 
-    for (auto fName : filesList)
+    if (!parserMode && opt.getuInt32Option(vISA_NumCompileThreads) > 1)
     {
-        if (parserMode)
-        {
-            parseWrapper(fName.c_str(), argc - startPos, &argv[startPos], opt);
-        }
-        else
+        parseBatch(filesList, argc - startPos, &argv[startPos]);
+    }
+    else
+    {
+        for (auto fName : filesList)
         {
-            parse(fName.c_str(), testName, argc - startPos, &argv[startPos], opt);
+            if (parserMode)
+            {
+                parseWrapper(fName.c_str(), argc - startPos, &argv[startPos], opt);
+            }
+            else
+            {
+                parse(fName.c_str(), testName, argc - startPos, &argv[startPos], opt);
+            }
         }
     }
 